@@ -25,7 +25,7 @@ src\client\*.cpp
 REM 1.5) Compile wrappers separately to control dependencies
 echo Compiling other wrappers...
 "%CL_PATH%" /EHsc /D_WIN32_WINNT=0x0601 /std:c++14 /MT /c /I"include\wrappers" /I"third_party\crypto++" /Fo:"build\client\\" ^
-src\wrappers\AESWrapper.cpp src\wrappers\Base64Wrapper.cpp src\wrappers\RSAWrapper.cpp
+src\wrappers\AESWrapper.cpp src\wrappers\Base64Wrapper.cpp src\wrappers\RSAWrapper.cpp src\wrappers\SecureRandom.cpp
 REM Now using real RSA implementation instead of stub
 REM src\wrappers\RSAWrapper_stub.cpp (REMOVED - using real implementation)
 
@@ -47,8 +47,10 @@ third_party\crypto++\fips140.cpp ^
 third_party\crypto++\cpu.cpp ^
 third_party\crypto++\rijndael.cpp ^
 third_party\crypto++\modes.cpp ^
+third_party\crypto++\gcm.cpp ^
 third_party\crypto++\osrng.cpp ^
 third_party\crypto++\sha.cpp ^
+third_party\crypto++\hmac.cpp ^
 third_party\crypto++\iterhash.cpp ^
 third_party\crypto++\hrtimer.cpp ^
 third_party\crypto++\rdtables.cpp ^
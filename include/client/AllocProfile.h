@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Heap allocation profile per transfer phase, for finding where a backup's memory peaks.
+// - Only an instrumentation build (CLIENT_ALLOC_PROFILE defined for every file in
+//   src/client) replaces the global operator new/delete. Each block then carries a 16-byte
+//   header with its size, and allocating or freeing is a few relaxed atomic adds.
+//   Otherwise nothing is hooked and AllocPhaseScope compiles to nothing.
+// - The phase is process-wide: an allocation made on any thread counts toward the phase the
+//   transfer is in. Peak live is the most heap held at once, by the whole process, while the
+//   phase was current.
+// - Over-aligned allocations (C++17 aligned new) and malloc() calls are not counted.
+enum class AllocPhase : int {
+    Init = 0,
+    Handshake,
+    Read,
+    Encrypt,
+    Send,
+    Verify,
+    Count
+};
+
+class AllocProfile {
+public:
+    struct PhaseStats {
+        uint64_t allocations;
+        uint64_t allocatedBytes;
+        uint64_t frees;
+        uint64_t freedBytes;
+        uint64_t peakLiveBytes;
+    };
+
+    static bool enabled();   // Built with CLIENT_ALLOC_PROFILE
+
+    static AllocPhase enterPhase(AllocPhase phase);   // Returns the previous phase
+    static AllocPhase phase();
+    static PhaseStats stats(AllocPhase phase);
+    static uint64_t liveBytes();
+    static uint64_t peakLiveBytes();   // Whole run
+    static void reset();               // Counts to zero, peaks to the current live bytes
+
+    static const char* phaseName(AllocPhase phase);
+    static std::string table();   // One row per phase plus the whole-run peak
+
+    // Called by the replaced operator new/delete
+    static void noteAllocation(size_t bytes);
+    static void noteFree(size_t bytes);
+};
+
+// Makes phase current for the scope, then restores the one before it
+#ifdef CLIENT_ALLOC_PROFILE
+class AllocPhaseScope {
+public:
+    explicit AllocPhaseScope(AllocPhase phase) : previous(AllocProfile::enterPhase(phase)) {}
+    ~AllocPhaseScope() { AllocProfile::enterPhase(previous); }
+
+private:
+    AllocPhaseScope(const AllocPhaseScope&) = delete;
+    AllocPhaseScope& operator=(const AllocPhaseScope&) = delete;
+
+    AllocPhase previous;
+};
+#else
+class AllocPhaseScope {
+public:
+    explicit AllocPhaseScope(AllocPhase) {}
+};
+#endif
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// Asynchronous console sink: the transfer thread queues a record and returns, and one
+// writer thread does the formatting, color changes, console and GUI calls.
+// - Records sit in a bounded lock-free ring (one sequence number per slot). Posting claims
+//   a slot with one compare-and-swap and moves the record in; it never blocks on the
+//   console. When the ring is full, records below Error are dropped and counted, and an
+//   Error waits for a free slot.
+// - A record is a render callback. It runs on the writer thread, so it must capture the
+//   values it prints rather than read state the poster keeps changing.
+// - Levels are filtered twice: CLIENT_LOG_MIN_LEVEL at compile time (CLIENT_LOG() with a
+//   lower level compiles to nothing, arguments included) and setLevel() at run time.
+// - flush() returns once everything posted before it has been rendered; stop() flushes
+//   and joins the writer, after which records render on the posting thread.
+enum class LogLevel : int {
+    Debug = 0,
+    Info = 1,
+    Warning = 2,
+    Error = 3,
+    Off = 4
+};
+
+#ifndef CLIENT_LOG_MIN_LEVEL
+#define CLIENT_LOG_MIN_LEVEL 1   // Info: debug records are compiled out
+#endif
+
+// CLIENT_LOG(sink, level, render): the render callback is only built when level passes both filters
+#define CLIENT_LOG(sink, level, ...)                                                               \
+    do {                                                                                           \
+        if (static_cast<int>(level) >= CLIENT_LOG_MIN_LEVEL && (sink).enabled(level)) {            \
+            (sink).post(level, __VA_ARGS__);                                                       \
+        }                                                                                          \
+    } while (0)
+
+class AsyncLog {
+public:
+    using Render = std::function<void()>;
+
+    static constexpr size_t DEFAULT_CAPACITY = 1024;
+
+    explicit AsyncLog(size_t capacity = DEFAULT_CAPACITY);   // Rounded up to a power of two
+    ~AsyncLog();
+
+    void setLevel(LogLevel level) { threshold.store(static_cast<int>(level), std::memory_order_relaxed); }
+    LogLevel level() const { return static_cast<LogLevel>(threshold.load(std::memory_order_relaxed)); }
+    bool enabled(LogLevel level) const {
+        return static_cast<int>(level) >= CLIENT_LOG_MIN_LEVEL &&
+               static_cast<int>(level) >= threshold.load(std::memory_order_relaxed);
+    }
+
+    // False when the record was filtered out or dropped
+    bool post(LogLevel level, Render render);
+    void flush();
+    void stop();
+
+    uint64_t dropped() const { return droppedRecords.load(std::memory_order_relaxed); }
+    size_t capacity() const { return slotCount; }
+
+    // "debug", "info", "warning", "error" or "off"
+    static bool parseLevel(const std::string& name, LogLevel& level);
+
+private:
+    AsyncLog(const AsyncLog&) = delete;
+    AsyncLog& operator=(const AsyncLog&) = delete;
+
+    struct Slot {
+        std::atomic<size_t> sequence;
+        Render render;
+    };
+
+    bool tryPush(Render& render);
+    bool tryPop(Render& render);
+    void writerLoop();
+
+    size_t slotCount;
+    std::unique_ptr<Slot[]> slots;
+    std::atomic<size_t> enqueuePosition{0};
+    size_t dequeuePosition = 0;                  // Writer thread only
+    std::atomic<size_t> renderedPosition{0};     // Records rendered, in ring order
+    std::atomic<int> threshold{static_cast<int>(LogLevel::Info)};
+    std::atomic<uint64_t> droppedRecords{0};
+
+    std::atomic<bool> running{false};
+    std::atomic<bool> stopping{false};
+    std::atomic<bool> writerIdle{false};
+    std::mutex wakeLock;                         // Writer sleep and flush() waits only
+    std::condition_variable wake;
+    std::condition_variable drained;
+    std::mutex inlineLock;                       // Serializes rendering after stop()
+    std::thread writer;
+};
+
+// Flushes a sink when the scope ends, on every return path
+class LogFlush {
+public:
+    explicit LogFlush(AsyncLog& sink) : sink(sink) {}
+    ~LogFlush() { sink.flush(); }
+
+private:
+    LogFlush(const LogFlush&) = delete;
+    LogFlush& operator=(const LogFlush&) = delete;
+
+    AsyncLog& sink;
+};
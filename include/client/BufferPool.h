@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Session-wide pool of packet and response buffers, so the transfer loop does not touch
+// the heap once it is running.
+// - One block holding bufferCount buffers is allocated by init(); every buffer starts on a
+//   cache line and is padded to a whole number of cache lines, so neighbouring buffers
+//   never share a line.
+// - With hugePages the block is an anonymous mapping advised MADV_HUGEPAGE (rounded to
+//   2MB), which keeps the TLB footprint of several 1MB packet buffers at a few entries.
+//   Windows and kernels without THP get ordinary pages.
+// - acquire() hands out a Lease that returns the buffer on destruction. A request larger
+//   than bufferSize() or made while every buffer is out is served from the heap instead
+//   and counted in heapAllocations(), which stays flat in steady state.
+// Not thread-safe: one pool per client, used from the transfer thread. Every lease must be
+// released before shutdown() or re-init().
+class BufferPool {
+public:
+    static constexpr size_t CACHE_LINE = 64;
+
+    class Lease {
+    public:
+        Lease();
+        Lease(Lease&& other) noexcept;
+        Lease& operator=(Lease&& other) noexcept;
+        ~Lease();
+
+        uint8_t* data() const { return buffer; }
+        size_t capacity() const { return bytes; }
+        bool valid() const { return buffer != nullptr; }
+        void release();
+
+    private:
+        friend class BufferPool;
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+
+        BufferPool* pool;
+        uint8_t* buffer;
+        size_t bytes;
+        int slot;            // Index in the pool, or -1 for a heap fallback
+    };
+
+    BufferPool();
+    ~BufferPool();
+
+    bool init(size_t bufferCount, size_t bufferSize, bool hugePages, std::string& error);
+    void shutdown();
+    bool isReady() const { return block != nullptr; }
+
+    Lease acquire(size_t bytes);
+
+    size_t bufferSize() const { return slotBytes; }
+    unsigned bufferCount() const { return slots; }
+    unsigned available() const { return static_cast<unsigned>(freeSlots.size()); }
+    bool hugePagesBacked() const { return hugePages; }
+
+    uint64_t acquisitions() const { return acquired; }
+    uint64_t heapAllocations() const { return fallbacks; }   // Leases served from the heap
+
+private:
+    BufferPool(const BufferPool&) = delete;
+    BufferPool& operator=(const BufferPool&) = delete;
+
+    void give(int slot);
+
+    uint8_t* block;
+    size_t blockBytes;
+    size_t slotBytes;
+    unsigned slots;
+    bool hugePages;
+    bool mapped;                 // block came from mmap rather than an aligned allocation
+    std::vector<int> freeSlots;  // Capacity reserved in init(), so give() never allocates
+    uint64_t acquired;
+    uint64_t fallbacks;
+};
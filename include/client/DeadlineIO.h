@@ -0,0 +1,41 @@
+#pragma once
+
+#include <boost/asio.hpp>
+#include <chrono>
+#include <vector>
+
+// Socket I/O with a deadline per operation. Each call starts an async operation plus a
+// steady_timer on the given io_context and runs it until one of them completes; if the
+// timer fires first the socket's pending operations are cancelled and the call returns
+// boost::asio::error::timed_out. After a timeout the stream position is unknown, so the
+// caller should close the connection and retry on a fresh one.
+namespace DeadlineIO {
+    boost::system::error_code write(boost::asio::io_context& ioContext, boost::asio::ip::tcp::socket& socket,
+                                    const std::vector<boost::asio::const_buffer>& buffers,
+                                    std::chrono::milliseconds timeout);
+
+    boost::system::error_code read(boost::asio::io_context& ioContext, boost::asio::ip::tcp::socket& socket,
+                                   boost::asio::mutable_buffer buffer, std::chrono::milliseconds timeout);
+
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+    // The same for AF_UNIX stream sockets
+    boost::system::error_code write(boost::asio::io_context& ioContext, boost::asio::local::stream_protocol::socket& socket,
+                                    const std::vector<boost::asio::const_buffer>& buffers,
+                                    std::chrono::milliseconds timeout);
+
+    boost::system::error_code read(boost::asio::io_context& ioContext, boost::asio::local::stream_protocol::socket& socket,
+                                   boost::asio::mutable_buffer buffer, std::chrono::milliseconds timeout);
+
+    boost::system::error_code connect(boost::asio::io_context& ioContext, boost::asio::local::stream_protocol::socket& socket,
+                                      const boost::asio::local::stream_protocol::endpoint& endpoint,
+                                      std::chrono::milliseconds timeout);
+#endif
+
+    // Wait until the socket is ready for wait_write / wait_read / wait_error (error queue)
+    boost::system::error_code wait(boost::asio::io_context& ioContext, boost::asio::ip::tcp::socket& socket,
+                                   boost::asio::socket_base::wait_type type, std::chrono::milliseconds timeout);
+
+    // Enable TCP keep-alive probing after idleSeconds without traffic, every intervalSeconds, giving up after probes
+    boost::system::error_code setKeepAlive(boost::asio::ip::tcp::socket& socket, int idleSeconds,
+                                           int intervalSeconds, int probes);
+} // namespace DeadlineIO
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+// How reading the input treats the page cache. A backup of a large file on a busy host
+// should not push the co-located service's working set out of memory.
+enum class InputCacheMode {
+    Cached,         // Normal reads; the file stays in the page cache afterwards
+    DropBehind,     // Pages the backup brought into the cache are evicted behind the cursor
+    Direct          // O_DIRECT into aligned buffers, bypassing the cache (io_uring path;
+                    // the mapped path cannot bypass the cache and uses DropBehind)
+};
+
+// Page-cache neutral reading for DropBehind: a mincore() snapshot taken before the backup
+// records which pages were already cached (by someone else), and dropBefore() evicts only
+// the other pages with posix_fadvise(DONTNEED), so the backup's cache footprint stays at
+// the readahead window without evicting pages the production service depends on.
+// POSIX only; on Windows both calls do nothing.
+class PageCacheTracker {
+public:
+    PageCacheTracker();
+
+    // Record residency for the first size bytes of fd. Returns false if it cannot be
+    // determined, in which case every page is treated as brought in by the backup.
+    bool snapshot(int fd, uint64_t size);
+    // The reader is done with everything before offset (monotonic); offset >= size drops the tail
+    void dropBefore(int fd, uint64_t offset);
+    void reset();
+
+    uint64_t droppedBytes() const { return dropped; }
+    uint64_t preservedBytes() const { return preserved; }   // Behind the cursor but cached before we started
+
+private:
+    bool wasResident(uint64_t pageIndex) const;
+
+    std::vector<uint64_t> residentPages;         // One bit per page
+    uint64_t fileSize;
+    uint64_t cursor;                             // Next page not yet considered, in bytes
+    uint64_t dropped;
+    uint64_t preserved;
+    size_t pageBytes;
+};
+
+// Read-only memory mapping of the file being backed up. The encryptor and the CRC read
+// straight from the mapping, so the file is never copied into a heap buffer.
+// - The whole file is mapped once with MADV_SEQUENTIAL, which doubles kernel readahead.
+// - populate (MAP_POPULATE) faults every page in up front: one long read instead of a
+//   page fault per 4KB, at the cost of holding the whole file resident.
+// - releaseBefore() drops the pages behind the transfer cursor (MADV_DONTNEED) so the
+//   process's resident set stays at a few MB regardless of file size. With dropBehind
+//   the pages are also evicted from the page cache (see PageCacheTracker).
+// - Large mappings ask for transparent huge pages where the filesystem supports them,
+//   which cuts TLB misses during the sequential scan.
+// On Windows the file is mapped with CreateFileMapping/MapViewOfFile; populate is ignored
+// and pages behind the cursor are trimmed from the working set with VirtualUnlock.
+struct MappedFileOptions {
+    bool populate = false;                       // Prefault the whole file (MAP_POPULATE)
+    bool sequential = true;                      // MADV_SEQUENTIAL readahead hint
+    bool dropBehind = false;                     // releaseBefore() also evicts the backup's pages from the page cache
+    size_t releaseWindow = 8 * 1024 * 1024;      // releaseBefore() works in steps of at least this many bytes
+};
+
+class MappedFile {
+public:
+    MappedFile();
+    ~MappedFile();
+
+    // Map path read-only. Returns false and sets error on failure. An empty file maps
+    // successfully with size() == 0 and data() == nullptr.
+    bool open(const std::string& path, const MappedFileOptions& options, std::string& error);
+    void close();
+
+    bool isOpen() const { return opened; }
+    const uint8_t* data() const { return base; }
+    size_t size() const { return length; }
+
+    // The caller is done with every byte before offset; the pages may be dropped
+    void releaseBefore(size_t offset);
+
+    const PageCacheTracker& cacheTracker() const { return cache; }
+
+    // Size of the file at path without opening a stream; false if it cannot be stat'ed
+    static bool fileSize(const std::string& path, uint64_t& size);
+
+private:
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const uint8_t* base;
+    size_t length;
+    size_t released;        // Bytes already handed back, always page aligned
+    size_t releaseWindow;
+    bool opened;
+    bool dropBehind;
+    PageCacheTracker cache;
+#ifdef _WIN32
+    HANDLE fileHandle;
+    HANDLE mappingHandle;
+#else
+    int descriptor;         // Kept open in dropBehind mode for posix_fadvise
+#endif
+};
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "protocol.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+class AESWrapper;
+
+// Request and response framing, shared by the client and tests/client_benchmark so the
+// benchmark times the same code that builds the client's frames.
+// - A request is the REQUEST_HEADER_SIZE header, then the payload. A file packet's payload
+//   starts with the FILE_PACKET_HEADER_SIZE metadata block (sizes, packet numbers and the
+//   zero-padded name, cut at MAX_FILENAME_SIZE).
+// - A GCM packet's content is nonce || ciphertext || tag. The nonce is the transfer sequence
+//   (4 bytes) || packet number (8 bytes), unique for one session key; the AAD is the
+//   original size, packet numbers and name from the metadata block, so none of them can be
+//   changed without failing the tag.
+namespace Framing {
+
+constexpr size_t GCM_AAD_SIZE = 8 + MAX_FILENAME_SIZE;   // original(4) + packet(2) + total(2) + name(255)
+
+void encodeRequestHeader(const uint8_t* clientId, uint16_t code, uint32_t payloadSize, uint8_t* out);
+
+// False if the version byte is not PROTOCOL_VERSION
+bool decodeResponseHeader(const uint8_t* in, uint16_t& code, uint32_t& payloadSize);
+
+void encodeFilePacketHeader(const std::string& filename, uint32_t encryptedSize, uint32_t originalSize,
+                            uint16_t packet, uint16_t totalPackets, uint8_t* out);
+
+// GCM_NONCE_SIZE bytes of nonce, and GCM_AAD_SIZE bytes of AAD from an encoded metadata block
+void gcmNonce(uint32_t sequence, uint16_t packet, uint8_t* nonce);
+void gcmAad(const uint8_t* filePacketHeader, uint8_t* aad);
+
+// One REQ_SEND_FILE GCM packet of length plaintext bytes. out must hold REQUEST_HEADER_SIZE +
+// FILE_PACKET_HEADER_SIZE + length + GCM nonce and tag. Returns the frame size; throws if
+// encryption fails.
+size_t buildGCMFrame(const AESWrapper& aes, const uint8_t* clientId, uint32_t sequence, const std::string& filename,
+                     uint16_t packet, uint16_t totalPackets, uint32_t originalSize, const uint8_t* plaintext,
+                     size_t length, uint8_t* out);
+
+} // namespace Framing
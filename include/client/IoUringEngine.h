@@ -0,0 +1,132 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+
+// io_uring is only compiled in on Linux with kernel headers that define it
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define CLIENT_HAVE_IO_URING 1
+#endif
+#endif
+
+// Minimal io_uring engine for the transfer pipeline, driven through the raw system calls
+// (no liburing dependency).
+// - One block of page-aligned buffers is registered with the kernel (IORING_REGISTER_BUFFERS)
+//   so file reads use READ_FIXED and skip the per-I/O page pinning. If registration fails
+//   (RLIMIT_MEMLOCK on older kernels) the same buffers are used with plain READ.
+// - The input file and the socket are registered as fixed files for the transfer.
+// - Operations are queued with queueRead()/queueSend() and handed to the kernel in one
+//   io_uring_enter() per submit(), so a packet's socket write and the next file read
+//   cost one system call together.
+// - Sends on one socket form an ordered stream: only the oldest is in the kernel, later
+//   ones wait in the engine, and a short send's remainder is resubmitted before the next,
+//   so frames queued back to back never interleave on the wire. A send completes once all
+//   its bytes are sent (result = length); after a failed send, the sends queued behind it
+//   on that socket complete with -ECANCELED.
+// - Sends use MSG_NOSIGNAL | MSG_WAITALL and an optional linked timeout, so a stalled peer
+//   completes the send with -ECANCELED instead of blocking the pipeline.
+// init() fails when the kernel lacks io_uring or an opcode we need (or when it is blocked
+// by seccomp/sysctl); callers then use the portable mmap + Asio path.
+struct IoUringCompletion {
+    uint64_t userData;
+    int32_t result;      // Bytes transferred, or -errno
+};
+
+class IoUringEngine {
+public:
+    IoUringEngine();
+    ~IoUringEngine();
+
+    // Set up a ring with `entries` submission slots and bufferCount buffers of bufferSize bytes
+    bool init(unsigned entries, unsigned bufferCount, size_t bufferSize, std::string& error);
+    void shutdown();
+    bool isReady() const { return ringFd >= 0; }
+    bool buffersRegistered() const { return fixedBuffers; }
+
+    uint8_t* buffer(unsigned index) const;
+    unsigned bufferCount() const { return static_cast<unsigned>(buffers.size()); }
+    size_t bufferSize() const { return bufferBytes; }
+
+    // Register fds as fixed files; operations refer to them by position in the list
+    bool registerFiles(const std::vector<int>& fds, std::string& error);
+    void unregisterFiles();
+
+    // Read length bytes at file offset into buffer(bufferIndex) + bufferOffset
+    bool queueRead(unsigned fileIndex, unsigned bufferIndex, size_t bufferOffset, size_t length,
+                   uint64_t fileOffset, uint64_t userData);
+    // Send length bytes from data (normally inside one of the buffers) on a socket, after
+    // every send already queued on it. data must stay valid until the send completes.
+    bool queueSend(unsigned fileIndex, const uint8_t* data, size_t length, uint64_t userData,
+                   std::chrono::milliseconds timeout = std::chrono::milliseconds(0));
+
+    // Submit everything queued and wait until at least waitFor completions are available.
+    // Returns false (with error) if the kernel rejected the submission.
+    bool submit(unsigned waitFor, std::string& error);
+    // Pop the next completion, if any
+    bool nextCompletion(IoUringCompletion& completion);
+
+    unsigned queued() const;                  // Queued and not yet submitted
+    uint64_t enterCalls() const { return enters; }
+    uint64_t operationsSubmitted() const { return submitted; }
+    uint64_t shortSends() const { return resubmits; }   // Remainders resubmitted after a short send
+
+private:
+    IoUringEngine(const IoUringEngine&) = delete;
+    IoUringEngine& operator=(const IoUringEngine&) = delete;
+
+    struct PendingSend {
+        const uint8_t* data;
+        size_t length;
+        size_t sent;
+        uint64_t userData;
+        std::chrono::milliseconds timeout;
+        bool inKernel;
+    };
+
+    void* nextEntry();                        // Free submission slot, or nullptr if the ring is full
+    bool issueSend(unsigned fileIndex);       // Queue the SQE for the oldest send on fileIndex
+    void issueWaitingSends();
+    bool submitPending(unsigned waitFor, std::string& error);
+
+    int ringFd;
+    unsigned entryCount;
+    bool fixedBuffers;
+    bool filesRegistered;
+
+    // Ring memory shared with the kernel
+    void* sqRing;
+    size_t sqRingSize;
+    void* cqRing;
+    size_t cqRingSize;
+    void* sqeArea;
+    size_t sqeAreaSize;
+    unsigned* sqHead;
+    unsigned* sqTail;
+    unsigned* sqMask;
+    unsigned* sqArray;
+    unsigned* cqHead;
+    unsigned* cqTail;
+    unsigned* cqMask;
+    void* cqes;
+    unsigned localTail;                       // Our SQ tail; published to the kernel on submit
+
+    // Registered buffers (one page-aligned block)
+    uint8_t* bufferBlock;
+    size_t bufferBytes;
+    std::vector<uint8_t*> buffers;
+    std::vector<int64_t> timeouts;            // __kernel_timespec per slot for linked timeouts (2 x int64)
+
+    // Send streams by fixed file index; the front send is the one in the kernel
+    std::map<unsigned, std::deque<PendingSend>> sendStreams;
+    std::deque<IoUringCompletion> readyCompletions;  // Sends cancelled behind a failed one
+
+    uint64_t enters;
+    uint64_t submitted;
+    uint64_t resubmits;
+};
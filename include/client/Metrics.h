@@ -0,0 +1,85 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Counters and latency histograms for fleet monitoring, exported in the Prometheus text
+// format (0.0.4) to a file that node_exporter's textfile collector scrapes.
+// - Metrics are registered once (name, help, optional label set such as code="1028") and
+//   the caller keeps the returned reference; updating one is a relaxed atomic add, with
+//   no lock, allocation or formatting on the hot path.
+// - MetricHistogram buckets microsecond values HDR-style, 16 linear sub-buckets per power
+//   of two (at most 6.25% relative error), and exports cumulative buckets at powers of two
+//   microseconds plus _sum and _count in seconds. Buckets are closed at the top, so every
+//   power of two is a bucket limit and a value equal to an exported bound counts under it. It is also the latency histogram of the
+//   load generator and capture replayer, which copy and merge per-session histograms.
+// - writeTextFile() writes a temporary file and renames it over the target (MoveFileEx on
+//   Windows), so a scrape never sees a partial or missing file.
+class MetricCounter {
+public:
+    void add(uint64_t amount = 1) { count.fetch_add(amount, std::memory_order_relaxed); }
+    uint64_t value() const { return count.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<uint64_t> count{0};
+};
+
+class MetricHistogram {
+public:
+    static constexpr size_t SUB_BUCKETS = 16;
+    static constexpr size_t BUCKETS = SUB_BUCKETS + 60 * SUB_BUCKETS;
+
+    MetricHistogram() = default;
+    MetricHistogram(const MetricHistogram& other) { merge(other); }
+    MetricHistogram& operator=(const MetricHistogram& other);
+
+    void observe(uint64_t micros);
+    void merge(const MetricHistogram& other);
+
+    uint64_t count() const { return total.load(std::memory_order_relaxed); }
+    uint64_t sumMicros() const { return sum.load(std::memory_order_relaxed); }
+    uint64_t max() const { return maximum.load(std::memory_order_relaxed); }
+    double mean() const { return count() ? static_cast<double>(sumMicros()) / count() : 0.0; }
+    uint64_t countAtMost(uint64_t micros) const;   // Observations up to and including micros (a power of two)
+    uint64_t percentile(double percent) const;     // Upper bound of the bucket holding it, at most max()
+
+    static size_t bucketOf(uint64_t micros);
+    static uint64_t bucketLimit(size_t bucket);   // Largest value in the bucket
+
+private:
+    std::array<std::atomic<uint64_t>, BUCKETS> buckets{};
+    std::atomic<uint64_t> total{0};
+    std::atomic<uint64_t> sum{0};
+    std::atomic<uint64_t> maximum{0};
+};
+
+class MetricsRegistry {
+public:
+    // Same name and labels return the same metric. labels is the inside of the braces,
+    // e.g. code="1028", or empty. Metrics live as long as the registry.
+    MetricCounter& counter(const std::string& name, const std::string& help, const std::string& labels = "");
+    MetricHistogram& histogram(const std::string& name, const std::string& help, const std::string& labels = "");
+
+    std::string exposition() const;
+    bool writeTextFile(const std::string& filename, std::string& error) const;
+
+private:
+    struct Entry {
+        std::string name;
+        std::string help;
+        std::string labels;
+        std::unique_ptr<MetricCounter> counter;
+        std::unique_ptr<MetricHistogram> histogram;
+    };
+
+    Entry& find(const std::string& name, const std::string& help, const std::string& labels, bool histogram);
+
+    mutable std::mutex lock;   // Registration and export only
+    std::vector<std::unique_ptr<Entry>> entries;
+};
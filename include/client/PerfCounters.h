@@ -0,0 +1,114 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Hardware performance counters per thread and per stage (Linux perf_event_open), for telling
+// whether AES, CRC or a copy is bound by compute or by memory.
+// - PerfCounterGroup counts the calling thread only: CPU time (task clock), cycles,
+//   instructions, last-level cache misses and branch misses, read together in one system
+//   call. Counters the CPU or hypervisor does not offer are left out and reported as
+//   unavailable. Kernel time is included when perf_event_paranoid allows it, else user only.
+// - PerfProfiler gives every thread its own group (opened on first use) and adds the counts
+//   of each PerfScope to a total per thread and stage. Nested scopes each count in full.
+// - Disabled, a PerfScope costs one relaxed atomic load. Enabled, it costs two counter reads
+//   (system calls), so put scopes around stages, not around single small operations.
+// - Elsewhere than Linux, enabling fails and every scope is inert.
+enum class PerfEvent : int {
+    TaskClock = 0,   // Nanoseconds on the CPU
+    Cycles,
+    Instructions,
+    LlcMisses,
+    BranchMisses,
+    Count
+};
+
+struct PerfCounts {
+    uint64_t values[static_cast<int>(PerfEvent::Count)] = {};
+
+    uint64_t operator[](PerfEvent event) const { return values[static_cast<int>(event)]; }
+    PerfCounts& operator+=(const PerfCounts& other);
+    PerfCounts operator-(const PerfCounts& other) const;   // Clamped at zero
+    double ipc() const;   // Instructions per cycle, 0 without both counters
+};
+
+class PerfCounterGroup {
+public:
+    PerfCounterGroup() = default;
+    ~PerfCounterGroup();
+
+    bool open(std::string& error);   // Counters for the calling thread, started immediately
+    void close();
+    bool isOpen() const { return leader >= 0; }
+    bool available(PerfEvent event) const { return slots[static_cast<int>(event)] >= 0; }
+    bool includesKernel() const { return kernel; }
+
+    // Totals since open(), scaled up if the kernel multiplexed the counters
+    bool read(PerfCounts& counts) const;
+
+    static const char* eventName(PerfEvent event);
+
+private:
+    PerfCounterGroup(const PerfCounterGroup&) = delete;
+    PerfCounterGroup& operator=(const PerfCounterGroup&) = delete;
+
+    int leader = -1;
+    int descriptors[static_cast<int>(PerfEvent::Count)] = {-1, -1, -1, -1, -1};
+    int slots[static_cast<int>(PerfEvent::Count)] = {-1, -1, -1, -1, -1};   // Position in a group read
+    int opened = 0;
+    bool kernel = false;
+};
+
+class PerfProfiler {
+public:
+    struct StageTotals {
+        std::string thread;
+        std::string stage;
+        uint64_t calls;
+        PerfCounts counts;
+    };
+
+    // Opens the calling thread's group to check that counting works
+    static bool enable(std::string& error);
+    static void disable();
+    static bool enabled() { return active.load(std::memory_order_relaxed); }
+    static void clear();
+
+    static void nameThread(const char* name);
+    static bool available(PerfEvent event);   // On the thread that called enable()
+    static bool includesKernel();
+
+    // Calling thread's counters; false if its group cannot be opened
+    static bool readThread(PerfCounts& counts);
+    static void record(const char* stage, const PerfCounts& delta);
+
+    static std::vector<StageTotals> totals();   // Every thread's stages, in first-use order
+    static bool stageTotals(const std::string& thread, const std::string& stage, StageTotals& totals);
+
+private:
+    static std::atomic<bool> active;
+};
+
+class PerfScope {
+public:
+    explicit PerfScope(const char* stage) : stage(PerfProfiler::enabled() && PerfProfiler::readThread(start) ? stage : nullptr) {}
+    ~PerfScope() { end(); }
+
+    // Close the scope before the end of its block
+    void end() {
+        PerfCounts now;
+        if (stage && PerfProfiler::readThread(now)) {
+            PerfProfiler::record(stage, now - start);
+        }
+        stage = nullptr;
+    }
+
+private:
+    PerfScope(const PerfScope&) = delete;
+    PerfScope& operator=(const PerfScope&) = delete;
+
+    PerfCounts start;
+    const char* stage;
+};
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+// Compact binary capture of a client's protocol framing and timing, for replaying realistic
+// traffic against a server later (tests/replay_capture).
+// - Records connection open/close, each request (code, payload size) and each response
+//   (code, payload size), stamped in microseconds since the previous record.
+// - File packets (1028, 1035) also keep original size, packet number and packet count,
+//   with the filename replaced by its index in order of first use.
+// - No payload bytes are stored: client IDs, names, keys, file contents and CRCs never
+//   reach the file, so a capture is safe to share. Replay registers fresh clients and
+//   encrypts synthetic content under the keys its own server hands out.
+// Layout: "BKUPCAP1", then records of kind(1) || delta(varint) || fields, integers as
+// LEB128 varints except the 2-byte little-endian codes.
+
+struct CaptureRecord {
+    enum class Kind : uint8_t { Open = 1, Request = 2, Response = 3, Close = 4 };
+
+    Kind kind = Kind::Open;
+    uint64_t micros = 0;          // Since the capture started
+    uint16_t code = 0;            // Request and Response
+    uint32_t payloadSize = 0;
+    bool filePacket = false;      // Request with file packet metadata:
+    uint32_t originalSize = 0;
+    uint16_t packet = 0;
+    uint16_t totalPackets = 0;
+    uint32_t fileIndex = 0;
+};
+
+class CaptureWriter {
+public:
+    static const char MAGIC[8];
+
+    CaptureWriter();
+    ~CaptureWriter();
+
+    bool open(const std::string& filename, std::string& error);
+    bool isOpen() const { return out.is_open(); }
+    void close();   // Flushes; also done by the destructor
+
+    void connectionOpened();
+    void connectionClosed();
+    // header is the 23-byte request header; fileMetadata the 267 bytes after it for file
+    // packets (encrypted size, original size, packet, total, name), else null
+    void request(const uint8_t* header, const uint8_t* fileMetadata);
+    void response(uint16_t code, uint32_t payloadSize);
+
+private:
+    void begin(CaptureRecord::Kind kind);
+    void putVarint(uint64_t value);
+
+    std::ofstream out;
+    std::vector<char> buffer;                        // Large stream buffer: one write per 256KB
+    std::chrono::steady_clock::time_point last;
+    std::map<std::string, uint32_t> fileIndexes;     // Filename field -> index
+};
+
+// Whole capture in order; false with error on a bad magic or a truncated record
+bool readCapture(const std::string& filename, std::vector<CaptureRecord>& records, std::string& error);
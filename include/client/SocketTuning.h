@@ -0,0 +1,69 @@
+#pragma once
+
+#include <boost/asio.hpp>
+#include <cstdint>
+#include <string>
+
+// Transport settings for the bulk upload socket, chosen per network profile.
+// - Send and receive buffers are sized to the profile's bandwidth-delay product, so a full
+//   window can be in flight. Where the kernel autotunes buffers (Linux up to tcp_wmem /
+//   tcp_rmem, Windows always) and the autotuner can already reach the BDP, the buffers
+//   are left alone: an explicit size switches autotuning off for that socket. An explicit
+//   size is also skipped when the kernel would clamp it below the BDP (Linux caps it at
+//   net.core.wmem_max / rmem_max): a small locked buffer is worse than autotuning, so the
+//   buffer stays autotuned and the result reports the shortfall.
+// - TCP_NOTSENT_LOWAT keeps the unsent part of the send queue small, so data the client
+//   writes is never stuck behind megabytes of its own backlog.
+// - Corking (TCP_CORK on Linux, TCP_NOPUSH on BSD/macOS) holds partial segments while a
+//   sequence of frames is written, so headers and payloads leave in full segments even
+//   with TCP_NODELAY set. Uncorking pushes whatever is pending; callers uncork before
+//   they wait for a reply.
+
+enum class NetworkProfile {
+    LAN,   // Low latency, high bandwidth: buffers stay autotuned
+    WAN    // Long fat pipe: buffers sized to a large BDP
+};
+
+struct SocketTuningOptions {
+    uint64_t bandwidthBitsPerSecond;  // Expected bottleneck bandwidth
+    uint32_t roundTripMs;             // Expected round-trip time
+    int minBufferBytes;               // Clamp for the BDP-derived buffer size
+    int maxBufferBytes;
+    int notSentLowatBytes;            // 0 leaves the kernel default (unlimited)
+    bool cork;
+};
+
+SocketTuningOptions profileOptions(NetworkProfile profile);
+bool parseNetworkProfile(const std::string& name, NetworkProfile& profile);   // "lan" or "wan"
+const char* networkProfileName(NetworkProfile profile);
+
+// What apply() did; buffer sizes are the effective values reported by the kernel
+struct SocketTuningResult {
+    uint64_t bandwidthDelayBytes = 0;
+    int requestedBufferBytes = 0;     // 0 when both buffers were left to autotuning
+    int sendBufferBytes = 0;
+    int receiveBufferBytes = 0;
+    bool sendAutotuned = false;
+    bool receiveAutotuned = false;
+    uint64_t sendLimitBytes = 0;      // Largest size the send buffer can reach, 0 if unknown
+    uint64_t receiveLimitBytes = 0;
+    bool sendShortfall = false;       // The buffer cannot reach the BDP: raise the limits above
+    bool receiveShortfall = false;
+    bool notSentLowat = false;
+    bool corkSupported = false;
+
+    std::string summary() const;      // "BDP 11.9MB, send 8MB, receive 6MB (autotuned), notsent-lowat, cork"
+    bool shortfall() const { return sendShortfall || receiveShortfall; }
+};
+
+namespace SocketTuning {
+    uint64_t bandwidthDelayProduct(const SocketTuningOptions& options);
+
+    // Apply buffer sizes and notsent-lowat to a connected socket. Failures of individual
+    // options are not errors; the result reports what took effect.
+    SocketTuningResult apply(boost::asio::ip::tcp::socket& socket, const SocketTuningOptions& options);
+
+    // Cork or uncork the socket; boost::asio::error::operation_not_supported where the
+    // platform has no corking option
+    boost::system::error_code setCork(boost::asio::ip::tcp::socket& socket, bool corked);
+} // namespace SocketTuning
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+// True if every byte of data[0, length) is zero. Scans 64 bytes per step with AVX2, SSE2
+// or NEON where the compiler targets them (8 bytes at a time otherwise) and stops at the
+// first non-zero block, so ordinary data costs a few loads and a zero 1MB chunk runs at
+// memory bandwidth.
+bool isAllZero(const uint8_t* data, size_t length);
+
+// Allocated extents of a file, so ranges that lie entirely in a hole can be skipped
+// without reading them: SEEK_DATA/SEEK_HOLE on POSIX, FSCTL_QUERY_ALLOCATED_RANGES on
+// Windows. Filesystems without hole reporting describe the whole file as one extent.
+class HoleMap {
+public:
+    HoleMap();
+
+    // Returns false (and treats the whole file as data) if the extents cannot be listed
+    bool load(const std::string& path, uint64_t size);
+
+    // True if [offset, offset + length) contains no allocated data
+    bool isHole(uint64_t offset, uint64_t length) const;
+
+    bool hasHoles() const { return holes > 0; }
+    uint64_t holeBytes() const { return holes; }
+
+private:
+    std::vector<std::pair<uint64_t, uint64_t>> extents;   // Sorted [start, end) data ranges
+    uint64_t holes;
+};
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Scoped-span tracer for the transfer hot path, exported as Chrome trace JSON (load it in
+// chrome://tracing or ui.perfetto.dev to see where a slow backup spent its time).
+// - Disabled, a TraceSpan costs one relaxed atomic load. Enabled, it takes two
+//   steady_clock readings and appends a 32-byte event to a ring owned by its thread: no
+//   allocation after the ring exists, and no lock other threads contend for.
+// - Each ring holds the last eventsPerThread spans; older ones are overwritten, so a long
+//   run keeps its most recent history in bounded memory.
+// - Span names must be string literals (only the pointer is stored). arg is one number
+//   shown with the span, such as a packet number or a byte count.
+// - writeChromeTrace() may be called at any time from any thread. requestDump() only sets
+//   a flag, so it is safe in a signal handler; the owner polls takeDumpRequest().
+class Tracer {
+public:
+    static constexpr size_t DEFAULT_EVENTS_PER_THREAD = 1 << 16;
+
+    static void enable(size_t eventsPerThread = DEFAULT_EVENTS_PER_THREAD);
+    static void disable();   // Recorded spans are kept for writeChromeTrace()
+    static bool enabled() { return active.load(std::memory_order_relaxed); }
+    static void clear();
+
+    static uint64_t now();   // Nanoseconds, steady clock
+    static void record(const char* name, uint64_t startNanos, uint64_t endNanos, uint64_t arg);
+    static void nameThread(const char* name);   // Label for the calling thread's track
+
+    static bool writeChromeTrace(const std::string& filename, std::string& error);
+    static size_t eventCount();   // Spans currently held, all threads
+
+    static void requestDump() { dumpRequested.store(true, std::memory_order_relaxed); }
+    static bool takeDumpRequest() { return dumpRequested.exchange(false, std::memory_order_relaxed); }
+
+private:
+    static std::atomic<bool> active;
+    static std::atomic<bool> dumpRequested;
+};
+
+class TraceSpan {
+public:
+    explicit TraceSpan(const char* name, uint64_t arg = 0)
+        : name(Tracer::enabled() ? name : nullptr), arg(arg), start(this->name ? Tracer::now() : 0) {}
+    ~TraceSpan() { end(); }
+
+    void setArg(uint64_t value) { arg = value; }
+    // Close the span before the end of its scope
+    void end() {
+        if (name) {
+            Tracer::record(name, start, Tracer::now(), arg);
+            name = nullptr;
+        }
+    }
+
+private:
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+    const char* name;
+    uint64_t arg;
+    uint64_t start;
+};
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <boost/asio.hpp>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Byte streams the client protocol runs over. Every transport reads and writes whole
+// buffers with a deadline (boost::asio::error::timed_out when it passes) and reports a
+// closed peer as boost::asio::error::eof, so request framing does not care which is used.
+// - TcpTransport: a connected TCP socket (see FastConnector), driven through DeadlineIO.
+// - UnixTransport: an AF_UNIX stream socket, for a backup server on the same host.
+// - MemoryTransport: one end of an in-process pipe made by MemoryTransport::createPair();
+//   no kernel involvement, so benchmarks see the cost of the protocol code alone.
+// TCP-only features (buffer tuning, corking, keep-alive, MSG_ZEROCOPY) go through
+// tcpSocket(); io_uring sends need nativeHandle(), which the memory pipe does not have.
+class Transport {
+public:
+    enum class Kind { Tcp, Unix, Memory };
+
+    virtual ~Transport() = default;
+
+    virtual Kind kind() const = 0;
+    virtual bool isOpen() const = 0;
+    virtual void close() = 0;
+    virtual std::string describe() const = 0;   // Endpoints for status output
+
+    virtual boost::system::error_code write(const std::vector<boost::asio::const_buffer>& buffers,
+                                            std::chrono::milliseconds timeout) = 0;
+    virtual boost::system::error_code read(boost::asio::mutable_buffer buffer, std::chrono::milliseconds timeout) = 0;
+
+    virtual boost::asio::ip::tcp::socket* tcpSocket() { return nullptr; }
+    virtual int nativeHandle() const { return -1; }
+};
+
+class TcpTransport : public Transport {
+public:
+    TcpTransport(boost::asio::io_context& ioContext, std::unique_ptr<boost::asio::ip::tcp::socket> socket);
+
+    Kind kind() const override { return Kind::Tcp; }
+    bool isOpen() const override;
+    void close() override;
+    std::string describe() const override;
+    boost::system::error_code write(const std::vector<boost::asio::const_buffer>& buffers,
+                                    std::chrono::milliseconds timeout) override;
+    boost::system::error_code read(boost::asio::mutable_buffer buffer, std::chrono::milliseconds timeout) override;
+    boost::asio::ip::tcp::socket* tcpSocket() override { return socket.get(); }
+    int nativeHandle() const override;
+
+private:
+    boost::asio::io_context& ioContext;
+    std::unique_ptr<boost::asio::ip::tcp::socket> socket;
+};
+
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+class UnixTransport : public Transport {
+public:
+    explicit UnixTransport(boost::asio::io_context& ioContext);
+
+    boost::system::error_code connect(const std::string& path, std::chrono::milliseconds timeout);
+    boost::asio::local::stream_protocol::socket& socket() { return stream; }   // For accepting ends
+
+    Kind kind() const override { return Kind::Unix; }
+    bool isOpen() const override { return stream.is_open(); }
+    void close() override;
+    std::string describe() const override;
+    boost::system::error_code write(const std::vector<boost::asio::const_buffer>& buffers,
+                                    std::chrono::milliseconds timeout) override;
+    boost::system::error_code read(boost::asio::mutable_buffer buffer, std::chrono::milliseconds timeout) override;
+    int nativeHandle() const override;
+
+private:
+    boost::asio::io_context& ioContext;
+    boost::asio::local::stream_protocol::socket stream;
+    std::string path;
+};
+#endif
+
+class MemoryTransport : public Transport {
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 4 * 1024 * 1024;   // Bytes buffered per direction
+
+    // Two connected ends; what one writes the other reads. Either end may be used from its
+    // own thread. Closing one end makes the other read eof once the data in flight is read.
+    static std::pair<std::unique_ptr<MemoryTransport>, std::unique_ptr<MemoryTransport>> createPair(
+        size_t capacity = DEFAULT_CAPACITY);
+
+    ~MemoryTransport() override;
+
+    Kind kind() const override { return Kind::Memory; }
+    bool isOpen() const override;
+    void close() override;
+    std::string describe() const override { return "in-process memory pipe"; }
+    boost::system::error_code write(const std::vector<boost::asio::const_buffer>& buffers,
+                                    std::chrono::milliseconds timeout) override;
+    boost::system::error_code read(boost::asio::mutable_buffer buffer, std::chrono::milliseconds timeout) override;
+
+    struct Channel;   // One direction: bounded ring buffer guarded by a mutex
+
+private:
+    MemoryTransport(std::shared_ptr<Channel> incoming, std::shared_ptr<Channel> outgoing);
+
+    std::shared_ptr<Channel> incoming;
+    std::shared_ptr<Channel> outgoing;
+    bool open;
+};
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <boost/asio.hpp>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <string>
+
+#include "BufferPool.h"
+
+// MSG_ZEROCOPY sends of large packet frames (Linux 4.14+).
+// - The kernel pins the frame's pages instead of copying them into the socket buffer, so
+//   the frame must not be reused until the kernel reports completion. send() takes the
+//   frame's pool lease and keeps it until then; reclaim() reads the completions from the
+//   socket error queue and hands finished buffers back to the pool.
+// - Each sendmsg() that queues data gets the next 32-bit notification id; a completion
+//   covers an id range, so one frame sent in several calls is freed when all its ids are in.
+// - When the kernel had to copy after all (loopback, devices without scatter-gather) the
+//   completion says so. After COPIED_PROBE completions that were all copied the sender
+//   stops using MSG_ZEROCOPY for the connection, as pinning would only add overhead.
+// Elsewhere enable() fails and callers keep to the copying path.
+class ZeroCopySender {
+public:
+    static constexpr size_t MIN_BYTES = 64 * 1024;   // Below this pinning costs more than the copy
+    static constexpr uint64_t COPIED_PROBE = 8;
+
+    ZeroCopySender();
+
+    bool enable(boost::asio::ip::tcp::socket& socket, std::string& error);   // SO_ZEROCOPY
+    void reset();                     // Connection closed: drop pending frames and counters' connection state
+    bool isEnabled() const { return enabled; }
+
+    // Write size bytes of frame with MSG_ZEROCOPY, bounded by the deadline. The lease is
+    // moved in and released once the kernel completes the frame (also on error).
+    boost::system::error_code send(boost::asio::io_context& ioContext, boost::asio::ip::tcp::socket& socket,
+                                   BufferPool::Lease&& frame, size_t size, std::chrono::milliseconds timeout);
+
+    // Collect completions. With a non-zero timeout, wait until at least one pending frame is released.
+    boost::system::error_code reclaim(boost::asio::io_context& ioContext, boost::asio::ip::tcp::socket& socket,
+                                      std::chrono::milliseconds timeout);
+
+    size_t pending() const { return frames.size(); }
+    uint64_t zeroCopyBytes() const { return sentBytes; }
+    uint64_t completedSends() const { return completed; }
+    uint64_t copiedSends() const { return copied; }   // Completions the kernel satisfied by copying
+
+private:
+    struct PendingFrame {
+        BufferPool::Lease lease;
+        uint32_t firstId;
+        uint32_t lastId;
+        uint32_t outstanding;         // Ids of this frame not yet completed
+    };
+
+    size_t readCompletions(int fd);   // Frames released
+    void complete(uint32_t low, uint32_t high, bool wasCopied);
+
+    bool enabled;
+    uint32_t nextId;                  // Id the kernel gives the next successful zero-copy sendmsg()
+    std::deque<PendingFrame> frames;
+    uint64_t sentBytes;
+    uint64_t completed;
+    uint64_t copied;
+};
@@ -6,3 +6,8 @@
 // CRC32 checksum functionality compatible with Linux cksum command
 uint32_t calculateCRC(const uint8_t* data, size_t size);
 uint32_t calculateCRC32(const uint8_t* data, size_t size);
+
+// Incremental form for data processed in pieces: crc = updateCRC(crc, piece, size) for each
+// piece in order, starting from 0, then finishCRC(crc, total size) gives calculateCRC's result
+uint32_t updateCRC(uint32_t crc, const uint8_t* data, size_t size);
+uint32_t finishCRC(uint32_t crc, uint64_t length);
@@ -5,30 +5,70 @@
 #include <cstdint>
 #include <iomanip>
 
+// Wire protocol shared by the client, its benchmark and the test servers and load tools:
+// one definition of the request/response codes and field sizes, so a test harness cannot
+// drift from what the client sends. All integers on the wire are little-endian.
+
 // Protocol constants
-extern const uint8_t PROTOCOL_VERSION;
-extern const size_t CLIENT_ID_SIZE;
-extern const size_t HEADER_SIZE;
-extern const size_t MAX_FILENAME_SIZE;
+constexpr uint8_t PROTOCOL_VERSION = 3;
+constexpr size_t CLIENT_ID_SIZE = 16;
+constexpr size_t MAX_FILENAME_SIZE = 255;
+constexpr size_t REQUEST_HEADER_SIZE = 23;      // client_id(16) + version(1) + code(2) + payload_size(4)
+constexpr size_t RESPONSE_HEADER_SIZE = 7;      // version(1) + code(2) + payload_size(4)
+constexpr size_t FILE_PACKET_HEADER_SIZE = 267; // encrypted(4) + original(4) + packet(2) + total(2) + name(255)
 
 // Request codes
-extern const uint16_t REQ_REGISTER;
-extern const uint16_t REQ_SEND_PUBLIC_KEY;
-extern const uint16_t REQ_RECONNECT;
-extern const uint16_t REQ_SEND_FILE;
-extern const uint16_t REQ_CRC_OK;
-extern const uint16_t REQ_CRC_RETRY;
-extern const uint16_t REQ_CRC_ABORT;
+constexpr uint16_t REQ_REGISTER = 1025;
+constexpr uint16_t REQ_SEND_PUBLIC_KEY = 1026;
+constexpr uint16_t REQ_RECONNECT = 1027;
+constexpr uint16_t REQ_SEND_FILE = 1028;
+constexpr uint16_t REQ_CRC_OK = 1029;
+constexpr uint16_t REQ_CRC_RETRY = 1030;
+constexpr uint16_t REQ_CRC_ABORT = 1031;
+constexpr uint16_t REQ_NEGOTIATE_CAPS = 1032;
+constexpr uint16_t REQ_RESUME_SESSION = 1033;
+constexpr uint16_t REQ_REGISTER_WITH_KEY = 1034;
+constexpr uint16_t REQ_SEND_ZERO_RUN = 1035;  // REQ_SEND_FILE layout; content authenticates the length of an all-zero packet
 
 // Response codes
-extern const uint16_t RESP_REGISTER_OK;
-extern const uint16_t RESP_REGISTER_FAIL;
-extern const uint16_t RESP_PUBKEY_AES_SENT;
-extern const uint16_t RESP_FILE_CRC;
-extern const uint16_t RESP_ACK;
-extern const uint16_t RESP_RECONNECT_AES_SENT;
-extern const uint16_t RESP_RECONNECT_FAIL;
-extern const uint16_t RESP_ERROR;
+constexpr uint16_t RESP_REGISTER_OK = 1600;
+constexpr uint16_t RESP_REGISTER_FAIL = 1601;
+constexpr uint16_t RESP_PUBKEY_AES_SENT = 1602;
+constexpr uint16_t RESP_FILE_CRC = 1603;
+constexpr uint16_t RESP_ACK = 1604;
+constexpr uint16_t RESP_RECONNECT_AES_SENT = 1605;
+constexpr uint16_t RESP_RECONNECT_FAIL = 1606;
+constexpr uint16_t RESP_ERROR = 1607;
+constexpr uint16_t RESP_CAPS_ACCEPTED = 1608;
+constexpr uint16_t RESP_RESUME_OK = 1609;
+constexpr uint16_t RESP_RESUME_FAIL = 1610;
+constexpr uint16_t RESP_REGISTER_KEY_AES_SENT = 1611;
+
+// Capability bits (REQ_NEGOTIATE_CAPS / RESP_CAPS_ACCEPTED payload, uint32 little-endian)
+constexpr uint32_t CAP_AES_GCM = 0x00000001;  // Per-packet AES-256-GCM instead of whole-file CBC + cksum
+constexpr uint32_t CAP_SESSION_TICKET = 0x00000002;  // Server issues a ticket to resume without the RSA key exchange
+constexpr uint32_t CAP_SPARSE_RUNS = 0x00000004;  // All-zero GCM packets are sent as REQ_SEND_ZERO_RUN records
+
+// Little-endian fields of 1 to 4 bytes
+inline void writeLE(uint8_t* out, uint32_t value, int bytes) {
+    for (int i = 0; i < bytes; i++) {
+        out[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+inline void appendLE(std::vector<uint8_t>& out, uint32_t value, int bytes) {
+    for (int i = 0; i < bytes; i++) {
+        out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+}
+
+inline uint32_t readLE(const uint8_t* in, int bytes) {
+    uint32_t value = 0;
+    for (int i = bytes - 1; i >= 0; i--) {
+        value = (value << 8) | in[i];
+    }
+    return value;
+}
 
 // Endianness conversion functions
 uint16_t hostToLittleEndian16(uint16_t value);
@@ -2,25 +2,57 @@
 
 #include <string>
 #include <vector>
+#include <memory>
+#include <cstdint>
 
+// AES-256 with the key schedule expanded once per key.
+// encrypt(plain, length, iv), decrypt() and the GCM functions are const and may be
+// called concurrently from several threads on one shared instance: each thread
+// keeps its own (cheap) mode objects that point at the shared schedule.
+// resynchronize() + encrypt(plain, length) use the instance IV and are single-threaded.
+// GCM keeps a per-thread key schedule (round keys + GHASH tables) tagged with its owning
+// instance. The destructor wipes the schedules of the thread it runs on; any other thread
+// that used the key keeps its copy until its next GCM call re-keys (wiping it first) or
+// the thread exits, so destroy the wrapper on the thread that did the work where possible.
 class AESWrapper
 {
 public:
     static const unsigned int DEFAULT_KEYLENGTH = 32;  // AES-256 requires 32-byte keys
+    static const unsigned int BLOCK_SIZE = 16;         // AES block / CBC IV size
+    static const unsigned int GCM_NONCE_SIZE = 12;     // 96-bit GCM nonce
+    static const unsigned int GCM_TAG_SIZE = 16;       // 128-bit GCM authentication tag
 private:
+    struct KeySchedule;                  // Expanded encryption/decryption round keys
     std::vector<unsigned char> keyData;
     std::vector<unsigned char> iv;
+    std::unique_ptr<KeySchedule> schedule;
+    uint64_t instanceId;                 // Identifies this key to the per-thread GCM contexts
     AESWrapper(const AESWrapper& aes);
 public:
     static void generateKey(unsigned char* buffer, size_t length);
 
-    AESWrapper() = default;
+    AESWrapper();
     // New: allow static IV of all zeros for protocol compliance
     AESWrapper(const unsigned char* key, size_t keyLength, bool useStaticZeroIV = false);
     ~AESWrapper();
 
     const unsigned char* getKey() const;
 
+    // Set the IV used by the next encrypt(plain, length) - no key expansion
+    void resynchronize(const unsigned char* newIv);
+
+    // CBC + PKCS#7, output is IV || ciphertext
     std::string encrypt(const char* plain, size_t length);
-    std::string decrypt(const char* cipher, size_t length);
+    std::string encrypt(const char* plain, size_t length, const unsigned char* explicitIv) const;
+    std::string decrypt(const char* cipher, size_t length) const;
+
+    // AES-256-GCM: no padding, output is ciphertext || tag (tag is GCM_TAG_SIZE bytes)
+    std::string encryptGCM(const unsigned char* nonce, const unsigned char* aad, size_t aadLength,
+                           const char* plain, size_t length) const;
+    // Same, writing length + GCM_TAG_SIZE bytes to out (e.g. straight into a send buffer)
+    void encryptGCM(const unsigned char* nonce, const unsigned char* aad, size_t aadLength,
+                    const char* plain, size_t length, unsigned char* out) const;
+    // Throws std::runtime_error if the tag does not verify
+    std::string decryptGCM(const unsigned char* nonce, const unsigned char* aad, size_t aadLength,
+                           const char* cipher, size_t length) const;
 };
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Fast cryptographically secure random bytes for keys, IVs and nonces.
+// Each thread owns a ChaCha20 DRBG (fast key erasure) seeded from the OS
+// (getrandom / RtlGenRandom) and reseeded after RESEED_BYTES of output,
+// after RESEED_INTERVAL_SECONDS, or when the process forks.
+class SecureRandom
+{
+public:
+    static constexpr size_t KEY_SIZE = 32;                       // ChaCha20 256-bit key
+    static constexpr size_t NONCE_SIZE = 12;                     // RFC 8439 96-bit nonce
+    static constexpr size_t BLOCK_SIZE = 64;                     // ChaCha20 block
+    static constexpr size_t BUFFER_BLOCKS = 16;                  // Keystream generated per refill
+    static constexpr uint64_t RESEED_BYTES = 1024 * 1024;        // Reseed after 1MB of output
+    static constexpr unsigned int RESEED_INTERVAL_SECONDS = 300; // ...or after 5 minutes
+
+    // Fill buffer with random bytes (thread-safe, no locking)
+    static void generate(unsigned char* buffer, size_t length);
+
+    // Force the calling thread's generator to mix in fresh OS entropy
+    static void reseed();
+
+    // Read seed material directly from the operating system (slow path)
+    static void systemRandom(unsigned char* buffer, size_t length);
+
+    // One ChaCha20 block with a 32-bit counter and 96-bit nonce (RFC 8439 section 2.3),
+    // for known-answer tests of the keystream
+    static void chachaBlock(const unsigned char* key, uint32_t counter, const unsigned char* nonce,
+                            unsigned char* out);
+
+private:
+    SecureRandom() = delete;
+};
@@ -28,7 +28,7 @@ if not exist "build\benchmark" mkdir "build\benchmark"
 
 echo.
 echo Compiling Crypto++ objects (if needed)...
-if not exist "build\crypto++\*.obj" (
+if not exist "build\third_party\crypto++\*.obj" (
     echo Crypto++ objects not found, building them first...
     call build.bat
     if %ERRORLEVEL% neq 0 (
@@ -40,17 +40,32 @@ if not exist "build\crypto++\*.obj" (
 echo.
 echo Compiling client benchmark source...
 
-REM Compile the benchmark executable
-cl /EHsc /D_WIN32_WINNT=0x0601 /std:c++17 ^
-   /I"client\include" ^
-   /I"crypto++" ^
+REM Compile the benchmark executable (client modules it measures, wrappers, Crypto++ objects from build.bat)
+cl /EHsc /O2 /D_WIN32_WINNT=0x0601 /std:c++17 /MT ^
+   /I"include\client" ^
+   /I"include\wrappers" ^
+   /I"third_party\crypto++" ^
+   /I"C:\Users\tom7s\Downloads\boost_1_88_0\boost_1_88_0" ^
+   /Fo:"build\benchmark\\" ^
    /Fe:"build\benchmark\client_benchmark.exe" ^
-   client_benchmark.cpp ^
-   client\src\RSAWrapper.cpp ^
-   client\src\AESWrapper.cpp ^
-   client\src\Base64Wrapper.cpp ^
-   client\src\protocol.cpp ^
-   build\crypto++\*.obj ^
+   tests\client_benchmark.cpp ^
+   tests\MockBackupServer.cpp ^
+   src\client\cksum.cpp ^
+   src\client\Framing.cpp ^
+   src\client\FileSource.cpp ^
+   src\client\SparseScan.cpp ^
+   src\client\BufferPool.cpp ^
+   src\client\DeadlineIO.cpp ^
+   src\client\SocketTuning.cpp ^
+   src\client\ZeroCopySend.cpp ^
+   src\client\Transport.cpp ^
+   src\client\IoUringEngine.cpp ^
+   src\client\PerfCounters.cpp ^
+   src\wrappers\AESWrapper.cpp ^
+   src\wrappers\RSAWrapper.cpp ^
+   src\wrappers\Base64Wrapper.cpp ^
+   src\wrappers\SecureRandom.cpp ^
+   build\third_party\crypto++\*.obj ^
    ws2_32.lib advapi32.lib user32.lib
 
 if %ERRORLEVEL% neq 0 (
@@ -66,6 +81,8 @@ echo ========================================
 echo Executable: build\benchmark\client_benchmark.exe
 echo.
 echo To run the benchmark:
-echo   build\benchmark\client_benchmark.exe
+echo   build\benchmark\client_benchmark.exe [--reps 5] [--max-size 4G] [--json results.json]
+echo To check for regressions against an earlier results file:
+echo   build\benchmark\client_benchmark.exe --sweep-only --baseline results.json
 echo.
 pause
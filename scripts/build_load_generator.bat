@@ -0,0 +1,57 @@
+@echo off
+REM Build script for the server load generator (simulated client sessions)
+
+echo ========================================
+echo Building Load Generator
+echo ========================================
+
+where cl >nul 2>&1
+if %ERRORLEVEL% neq 0 (
+    echo Setting up Visual Studio Build Tools...
+    if exist "C:\Program Files\Microsoft Visual Studio\2022\Community\VC\Auxiliary\Build\vcvars64.bat" (
+        call "C:\Program Files\Microsoft Visual Studio\2022\Community\VC\Auxiliary\Build\vcvars64.bat"
+    ) else if exist "C:\Program Files (x86)\Microsoft Visual Studio\2022\BuildTools\VC\Auxiliary\Build\vcvars64.bat" (
+        call "C:\Program Files (x86)\Microsoft Visual Studio\2022\BuildTools\VC\Auxiliary\Build\vcvars64.bat"
+    ) else (
+        echo WARNING: Visual Studio Build Tools not found in standard locations
+        echo Attempting to continue with existing environment...
+    )
+)
+
+if not exist "build\tools" mkdir "build\tools"
+
+if not exist "build\third_party\crypto++\*.obj" (
+    echo Crypto++ objects not found, building them first...
+    call build.bat
+)
+
+cl /EHsc /O2 /D_WIN32_WINNT=0x0601 /std:c++17 /MT ^
+   /I"include\client" ^
+   /I"include\wrappers" ^
+   /I"third_party\crypto++" ^
+   /I"C:\Users\tom7s\Downloads\boost_1_88_0\boost_1_88_0" ^
+   /Fo:"build\tools\\" ^
+   /Fe:"build\tools\load_generator.exe" ^
+   tests\load_generator.cpp ^
+   tests\LoadGenerator.cpp ^
+   src\client\cksum.cpp ^
+   src\client\Metrics.cpp ^
+   src\wrappers\AESWrapper.cpp ^
+   src\wrappers\RSAWrapper.cpp ^
+   src\wrappers\Base64Wrapper.cpp ^
+   src\wrappers\SecureRandom.cpp ^
+   build\third_party\crypto++\*.obj ^
+   ws2_32.lib advapi32.lib user32.lib
+
+if %ERRORLEVEL% neq 0 (
+    echo ERROR: Failed to compile load generator
+    pause
+    exit /b 1
+)
+
+echo.
+echo Executable: build\tools\load_generator.exe
+echo Example (2000 clients, 500 at a time, log-normal file sizes):
+echo   build\tools\load_generator.exe --sessions 2000 --concurrency 500 --sizes lognormal:256kb,1.5
+echo.
+pause
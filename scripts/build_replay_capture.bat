@@ -0,0 +1,61 @@
+@echo off
+REM Build script for the capture replayer (re-drives client session captures)
+
+echo ========================================
+echo Building Capture Replayer
+echo ========================================
+
+where cl >nul 2>&1
+if %ERRORLEVEL% neq 0 (
+    echo Setting up Visual Studio Build Tools...
+    if exist "C:\Program Files\Microsoft Visual Studio\2022\Community\VC\Auxiliary\Build\vcvars64.bat" (
+        call "C:\Program Files\Microsoft Visual Studio\2022\Community\VC\Auxiliary\Build\vcvars64.bat"
+    ) else if exist "C:\Program Files (x86)\Microsoft Visual Studio\2022\BuildTools\VC\Auxiliary\Build\vcvars64.bat" (
+        call "C:\Program Files (x86)\Microsoft Visual Studio\2022\BuildTools\VC\Auxiliary\Build\vcvars64.bat"
+    ) else (
+        echo WARNING: Visual Studio Build Tools not found in standard locations
+        echo Attempting to continue with existing environment...
+    )
+)
+
+if not exist "build\tools" mkdir "build\tools"
+
+if not exist "build\third_party\crypto++\*.obj" (
+    echo Crypto++ objects not found, building them first...
+    call build.bat
+)
+
+cl /EHsc /O2 /D_WIN32_WINNT=0x0601 /std:c++17 /MT ^
+   /I"include\client" ^
+   /I"include\wrappers" ^
+   /I"third_party\crypto++" ^
+   /I"C:\Users\tom7s\Downloads\boost_1_88_0\boost_1_88_0" ^
+   /Fo:"build\tools\\" ^
+   /Fe:"build\tools\replay_capture.exe" ^
+   tests\replay_capture.cpp ^
+   tests\CaptureReplayer.cpp ^
+   tests\LoadGenerator.cpp ^
+   src\client\SessionCapture.cpp ^
+   src\client\Transport.cpp ^
+   src\client\DeadlineIO.cpp ^
+   src\client\cksum.cpp ^
+   src\client\Metrics.cpp ^
+   src\wrappers\AESWrapper.cpp ^
+   src\wrappers\RSAWrapper.cpp ^
+   src\wrappers\Base64Wrapper.cpp ^
+   src\wrappers\SecureRandom.cpp ^
+   build\third_party\crypto++\*.obj ^
+   ws2_32.lib advapi32.lib user32.lib
+
+if %ERRORLEVEL% neq 0 (
+    echo ERROR: Failed to compile capture replayer
+    pause
+    exit /b 1
+)
+
+echo.
+echo Executable: build\tools\replay_capture.exe
+echo Example (three captured sessions at ten times their recorded pace):
+echo   build\tools\replay_capture.exe --speed 10 a.cap b.cap c.cap
+echo.
+pause
@@ -0,0 +1,43 @@
+@echo off
+REM Build script for the WAN emulator relay (latency, jitter, bandwidth, resets)
+
+echo ========================================
+echo Building WAN Emulator
+echo ========================================
+
+where cl >nul 2>&1
+if %ERRORLEVEL% neq 0 (
+    echo Setting up Visual Studio Build Tools...
+    if exist "C:\Program Files\Microsoft Visual Studio\2022\Community\VC\Auxiliary\Build\vcvars64.bat" (
+        call "C:\Program Files\Microsoft Visual Studio\2022\Community\VC\Auxiliary\Build\vcvars64.bat"
+    ) else if exist "C:\Program Files (x86)\Microsoft Visual Studio\2022\BuildTools\VC\Auxiliary\Build\vcvars64.bat" (
+        call "C:\Program Files (x86)\Microsoft Visual Studio\2022\BuildTools\VC\Auxiliary\Build\vcvars64.bat"
+    ) else (
+        echo WARNING: Visual Studio Build Tools not found in standard locations
+        echo Attempting to continue with existing environment...
+    )
+)
+
+if not exist "build\tools" mkdir "build\tools"
+
+cl /EHsc /O2 /D_WIN32_WINNT=0x0601 /std:c++17 /MT ^
+   /I"C:\Users\tom7s\Downloads\boost_1_88_0\boost_1_88_0" ^
+   /Fo:"build\tools\\" ^
+   /Fe:"build\tools\wan_emulator.exe" ^
+   tests\wan_emulator.cpp ^
+   tests\WanEmulator.cpp ^
+   ws2_32.lib
+
+if %ERRORLEVEL% neq 0 (
+    echo ERROR: Failed to compile WAN emulator
+    pause
+    exit /b 1
+)
+
+echo.
+echo Executable: build\tools\wan_emulator.exe
+echo Example (100 ms RTT, 50 Mbit/s, in front of the server on port 1256):
+echo   build\tools\wan_emulator.exe 1257 127.0.0.1:1256 latency=50ms jitter=5ms rate=50mbit
+echo and set transfer.info to 127.0.0.1:1257
+echo.
+pause
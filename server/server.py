@@ -9,8 +9,10 @@ import re
 import signal
 import sys
 import sqlite3
+import hmac
+import hashlib
 from datetime import datetime, timezone, timedelta
-from typing import Dict, Optional, Any, Tuple
+from typing import Dict, List, Optional, Any, Tuple
 
 from Crypto.Cipher import AES
 from Crypto.PublicKey import RSA
@@ -70,6 +72,11 @@ REQ_SEND_FILE = 1028
 REQ_CRC_OK = 1029
 REQ_CRC_INVALID_RETRY = 1030
 REQ_CRC_FAILED_ABORT = 1031
+REQ_NEGOTIATE_CAPS = 1032
+REQ_RESUME_SESSION = 1033
+REQ_REGISTER_WITH_KEY = 1034
+REQ_SEND_ZERO_RUN = 1035 # Same payload as REQ_SEND_FILE; content authenticates the length of an all-zero packet
+REGISTRATION_REQUEST_CODES = (REQ_REGISTER, REQ_REGISTER_WITH_KEY) # Sent with an all-zero client ID
 
 # Response codes to client
 RESP_REG_OK = 1600
@@ -80,6 +87,29 @@ RESP_ACK = 1604
 RESP_RECONNECT_AES_SENT = 1605
 RESP_RECONNECT_FAIL = 1606
 RESP_GENERIC_SERVER_ERROR = 1607
+RESP_CAPS_ACCEPTED = 1608
+RESP_RESUME_OK = 1609
+RESP_RESUME_FAIL = 1610
+RESP_REGISTER_KEY_AES_SENT = 1611
+
+# --- Capability Negotiation ---
+CAP_AES_GCM = 0x00000001 # Per-packet AES-256-GCM; authentication tags replace the CRC round trip
+CAP_SESSION_TICKET = 0x00000002 # Issue a session ticket so the next connection can skip the RSA key exchange
+CAP_SPARSE_RUNS = 0x00000004 # All-zero GCM packets arrive as REQ_SEND_ZERO_RUN records and are written as holes
+SERVER_CAPABILITIES = CAP_AES_GCM | CAP_SESSION_TICKET | CAP_SPARSE_RUNS
+CIPHER_MODE_CBC = "AES-256-CBC"
+CIPHER_MODE_GCM = "AES-256-GCM"
+GCM_NONCE_SIZE = 12
+GCM_TAG_SIZE = 16
+ZERO_RUN_LABEL = b"zero run" # Appended to a zero-run packet's AAD so it cannot be replayed as file data
+
+# --- Session Resumption ---
+TICKET_LIFETIME_SECONDS = 60 * 60 # Tickets are accepted for 1 hour after issue
+TICKET_ID_SIZE = 16
+RESUME_NONCE_SIZE = 16
+TICKET_PLAINTEXT_FORMAT = "<16sQ16s32sI" # client_id, issued_at (unix seconds), ticket_id, resumption_secret, capabilities
+RESUMPTION_SECRET_LABEL = b"backup resumption secret"
+RESUMED_KEY_LABEL = b"backup resumed session key"
 
 # --- Custom Exceptions ---
 class ServerError(Exception):
@@ -117,6 +147,8 @@ class Client:
         self.public_key_bytes: Optional[bytes] = public_key_bytes
         self.public_key_obj: Optional[RSA.RsaKey] = None # PyCryptodome RSA key object
         self.aes_key: Optional[bytes] = None # Current session AES key
+        self.cipher_mode: str = CIPHER_MODE_CBC # Negotiated per session via REQ_NEGOTIATE_CAPS
+        self.sparse_runs: bool = False # CAP_SPARSE_RUNS accepted (GCM sessions only)
         self.last_seen: float = time.monotonic() # Monotonic time for session timeout
         self.partial_files: Dict[str, Dict[str, Any]] = {} # For reassembling multi-packet files
         self.lock: threading.Lock = threading.Lock() # To protect concurrent access to client state
@@ -178,6 +210,8 @@ class Client:
             if len(aes_key_data) != AES_KEY_SIZE_BYTES:
                  raise ValueError(f"AES key size for client '{self.name}' is incorrect. Expected {AES_KEY_SIZE_BYTES}, got {len(aes_key_data)}.")
             self.aes_key = aes_key_data
+            self.cipher_mode = CIPHER_MODE_CBC # A new session key starts in legacy mode until renegotiated
+            self.sparse_runs = False
     
     def clear_partial_file(self, filename: str):
         """Removes partial file reassembly data for a given filename."""
@@ -256,10 +290,17 @@ class BackupServer:
         self.clients_lock: threading.Lock = threading.Lock() # Protects access to clients and clients_by_name
         self.port: int = self._read_port_config()
         self.server_socket: Optional[socket.socket] = None
+        self.unix_socket_path: Optional[str] = self._read_unix_socket_config()
+        self.unix_server_socket: Optional[socket.socket] = None
+        self.unix_accept_thread: Optional[threading.Thread] = None
         self.running: bool = False # Flag to control server main loop
         self.shutdown_event: threading.Event = threading.Event() # For coordinating graceful shutdown
         self.maintenance_thread: Optional[threading.Thread] = None
         self.client_connection_semaphore: threading.Semaphore = threading.Semaphore(MAX_CONCURRENT_CLIENTS)
+        # Session tickets are sealed with a key that only lives in memory: a restart invalidates every ticket
+        self.ticket_key: bytes = get_random_bytes(AES_KEY_SIZE_BYTES)
+        self.used_ticket_ids: Dict[bytes, float] = {} # ticket_id -> wall-clock expiry, rejects replayed tickets
+        self.used_ticket_ids_lock: threading.Lock = threading.Lock()
         
         # Initialize GUI
         self.gui = None
@@ -456,7 +497,7 @@ class BackupServer:
         """Reads server port from `port.info`, defaults to `DEFAULT_PORT` on error."""
         try:
             with open(PORT_CONFIG_FILE, 'r') as f:
-                port_str = f.read().strip()
+                port_str = f.readline().strip()
                 if not port_str: # Handle case where port.info is empty
                     raise ValueError("Port configuration file is empty.")
                 port = int(port_str)
@@ -476,6 +517,52 @@ class BackupServer:
             return DEFAULT_PORT
 
 
+    def _read_unix_socket_config(self) -> Optional[str]:
+        """Reads the optional second line of `port.info`, `unix:<path>`, for same-host clients."""
+        try:
+            with open(PORT_CONFIG_FILE, 'r') as f:
+                f.readline()
+                line = f.readline().strip()
+        except OSError:
+            return None
+        if not line:
+            return None
+        if not line.startswith("unix:") or len(line) <= len("unix:"):
+            logger.warning(f"Ignoring invalid Unix socket line '{line}' in '{PORT_CONFIG_FILE}' (expected unix:<path>).")
+            return None
+        if not hasattr(socket, "AF_UNIX"):
+            logger.warning("Unix sockets are not supported on this platform; listening on TCP only.")
+            return None
+        return line[len("unix:"):]
+
+
+    def _accept_unix_connections(self):
+        """Accepts clients on the Unix socket and hands them to the same handler as TCP clients."""
+        while not self.shutdown_event.is_set() and self.unix_server_socket:
+            try:
+                if not self.client_connection_semaphore.acquire(blocking=True, timeout=0.5):
+                    continue
+                try:
+                    client_conn, _ = self.unix_server_socket.accept()
+                except BaseException:
+                    self.client_connection_semaphore.release()
+                    raise
+                logger.info(f"Accepted new connection on Unix socket {self.unix_socket_path}. Starting handler thread.")
+                handler_thread = threading.Thread(
+                    target=self._handle_client_connection,
+                    args=(client_conn, ("unix", 0), self.client_connection_semaphore),
+                    daemon=True,
+                    name="ClientHandler-unix"
+                )
+                handler_thread.start()
+            except socket.timeout:
+                continue
+            except OSError as e:
+                if not self.shutdown_event.is_set():
+                    logger.error(f"Socket error occurred while accepting Unix socket connections: {e}")
+                break
+
+
     def _periodic_maintenance_job(self):
         """
         Runs periodically in a separate thread to perform maintenance tasks:
@@ -510,6 +597,13 @@ class BackupServer:
                     client_obj.cleanup_stale_partial_files() for client_obj in active_clients_list
                 )
 
+                # --- Forget replay-cache entries for tickets that have expired anyway ---
+                current_wall_time = time.time()
+                with self.used_ticket_ids_lock:
+                    expired_ticket_ids = [tid for tid, expiry in self.used_ticket_ids.items() if expiry < current_wall_time]
+                    for tid in expired_ticket_ids:
+                        del self.used_ticket_ids[tid]
+
                 # --- Console Status Update (Basic UI Element) ---
                 with self.clients_lock: # Get current count of active clients in memory
                     active_clients_in_memory = len(self.clients)
@@ -594,6 +688,24 @@ class BackupServer:
             if self.server_socket: self.server_socket.close() # Clean up the socket if it was created
             return
             
+        # Optional Unix socket listener for clients on this host (no TCP/IP stack in the path)
+        if self.unix_socket_path:
+            try:
+                if os.path.exists(self.unix_socket_path):
+                    os.unlink(self.unix_socket_path) # Stale socket file from a previous run
+                self.unix_server_socket = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+                self.unix_server_socket.bind(self.unix_socket_path)
+                self.unix_server_socket.listen(10)
+                self.unix_server_socket.settimeout(1.0)
+                self.unix_accept_thread = threading.Thread(target=self._accept_unix_connections, daemon=True, name="UnixAcceptThread")
+                self.unix_accept_thread.start()
+                logger.info(f"Also listening on Unix socket {self.unix_socket_path}.")
+            except OSError as e:
+                logger.error(f"Failed to listen on Unix socket {self.unix_socket_path}: {e}. Continuing with TCP only.")
+                if self.unix_server_socket:
+                    self.unix_server_socket.close()
+                self.unix_server_socket = None
+
         # Start the periodic maintenance thread
         self.maintenance_thread = threading.Thread(target=self._periodic_maintenance_job, daemon=True, name="MaintenanceThread")
         self.maintenance_thread.start()
@@ -665,6 +777,14 @@ class BackupServer:
             except OSError as e: # Catch potential errors if socket is already closed or in a bad state
                 logger.error(f"Error encountered while closing server socket: {e}")
             self.server_socket = None # Mark as closed
+
+        if self.unix_server_socket:
+            try:
+                self.unix_server_socket.close()
+                os.unlink(self.unix_socket_path)
+            except OSError as e:
+                logger.error(f"Error encountered while closing the Unix socket: {e}")
+            self.unix_server_socket = None
         
         # Note: Active client handler threads are daemon threads. They will be terminated automatically
         # when the main thread (or the last non-daemon thread) exits.
@@ -830,9 +950,9 @@ class BackupServer:
                 payload_bytes = self._read_exact(client_conn, payload_size_from_header) # Read payload based on size from header
                 
                 # --- Resolve Client Object & Update Last Seen Timestamp ---
-                # For REQ_REGISTER, client_id_from_header is all zeros; active_client_obj will remain None initially.
+                # For registration requests, client_id_from_header is all zeros; active_client_obj will remain None initially.
                 # For all other requests, client_id_from_header should be a valid client UUID.
-                if code_from_header != REQ_REGISTER:
+                if code_from_header not in REGISTRATION_REQUEST_CODES:
                     with self.clients_lock: # Ensure thread-safe access to shared self.clients dictionary
                         active_client_obj = self.clients.get(client_id_from_header)
                     
@@ -890,18 +1010,22 @@ class BackupServer:
         
         handler_map = {
             REQ_REGISTER: self._handle_registration,
+            REQ_REGISTER_WITH_KEY: self._handle_register_with_key,
             REQ_SEND_PUBLIC_KEY: self._handle_send_public_key,
             REQ_RECONNECT: self._handle_reconnect,
             REQ_SEND_FILE: self._handle_send_file,
+            REQ_SEND_ZERO_RUN: self._handle_send_zero_run,
             REQ_CRC_OK: self._handle_crc_ok,
             REQ_CRC_INVALID_RETRY: self._handle_crc_invalid_retry,
             REQ_CRC_FAILED_ABORT: self._handle_crc_failed_abort,
+            REQ_NEGOTIATE_CAPS: self._handle_negotiate_caps,
+            REQ_RESUME_SESSION: self._handle_resume_session,
         }
 
         handler_method = handler_map.get(code) # Get the method associated with the request code
 
         if handler_method:
-            if code == REQ_REGISTER:
+            if code in REGISTRATION_REQUEST_CODES:
                 # Registration is special: client_id_from_header is all zeros, and `client` object is not yet created/resolved.
                 # The handler itself will generate the new client ID and create the Client object.
                 handler_method(sock, payload) 
@@ -976,35 +1100,102 @@ class BackupServer:
             # Parse client name from payload, enforcing max actual length and character set
             client_name = self._parse_string_from_payload(payload, name_field_protocol_len, MAX_CLIENT_NAME_LENGTH, "Client Name")
             
-            with self.clients_lock: # Ensure thread-safe access to shared client dictionaries
-                if client_name in self.clients_by_name: # Check if username is already taken
-                    logger.warning(f"Registration attempt failed: Username '{client_name}' is already registered.")
-                    self._send_response(sock, RESP_REG_FAIL) # Send Registration Failed (1601), no payload
-                    return
-                
-                # Generate a new unique client ID (UUID version 4)
-                new_client_id_bytes = uuid.uuid4().bytes
-                new_client = Client(new_client_id_bytes, client_name) # Create a new Client object
-                
-                # Add the new client to in-memory tracking structures
-                self.clients[new_client_id_bytes] = new_client
-                self.clients_by_name[client_name] = new_client_id_bytes
-                
-                self._save_client_to_db(new_client) # Persist the new client's basic info to the database
-            
-            logger.info(f"Client '{client_name}' successfully registered with New Client ID: {new_client_id_bytes.hex()}.")
+            new_client = self._register_client(client_name)
+            if new_client is None:
+                self._send_response(sock, RESP_REG_FAIL) # Send Registration Failed (1601), no payload
+                return
             
-            # Update GUI with new client registration
-            self._update_gui_client_count()
-            self._update_gui_success(f"New client '{client_name}' registered successfully")
             # Send Registration Success (1600) response with the new client ID as payload
-            self._send_response(sock, RESP_REG_OK, new_client_id_bytes)
+            self._send_response(sock, RESP_REG_OK, new_client.id)
         
         except ProtocolError as e: # Catch errors from parsing or payload size validation
             logger.error(f"Registration protocol error: {e}")
             self._send_response(sock, RESP_REG_FAIL) # Send registration failure
 
 
+    def _register_client(self, client_name: str, public_key_bytes: Optional[bytes] = None) -> Optional[Client]:
+        """
+        Creates, tracks and persists a new client.
+
+        Returns:
+            The new Client object, or None if the username is already registered.
+        """
+        with self.clients_lock: # Ensure thread-safe access to shared client dictionaries
+            if client_name in self.clients_by_name: # Check if username is already taken
+                logger.warning(f"Registration attempt failed: Username '{client_name}' is already registered.")
+                return None
+            
+            # Generate a new unique client ID (UUID version 4)
+            new_client_id_bytes = uuid.uuid4().bytes
+            new_client = Client(new_client_id_bytes, client_name, public_key_bytes) # Create a new Client object
+            
+            # Add the new client to in-memory tracking structures
+            self.clients[new_client_id_bytes] = new_client
+            self.clients_by_name[client_name] = new_client_id_bytes
+            
+            self._save_client_to_db(new_client) # Persist the new client's basic info to the database
+        
+        logger.info(f"Client '{client_name}' successfully registered with New Client ID: {new_client_id_bytes.hex()}.")
+        
+        # Update GUI with new client registration
+        self._update_gui_client_count()
+        self._update_gui_success(f"New client '{client_name}' registered successfully")
+        return new_client
+
+
+    def _handle_register_with_key(self, sock: socket.socket, payload: bytes):
+        """
+        Handles combined registration + public key submission (Code 1034): one round trip instead of 1025 + 1026,
+        with capability negotiation folded in.
+        Payload: char name[255]; uint8_t public_key[162]; uint32_t offered_capabilities;
+        Response 1611 payload: client_id[16]; uint32_t accepted_capabilities; uint16_t encrypted_key_size;
+                               encrypted_aes_key[]; [uint32_t ticket_lifetime; uint8_t ticket[];]
+        Response 1601: username already registered or invalid request (nothing is registered).
+        Servers without this code answer 1607 and close the connection; clients then use 1025 + 1026.
+        """
+        name_field_protocol_len = 255
+        expected_payload_size = name_field_protocol_len + RSA_PUBLIC_KEY_SIZE + 4
+        if len(payload) != expected_payload_size:
+            raise ProtocolError(f"RegisterWithKey Request (1034): Invalid payload size. Expected {expected_payload_size} bytes, got {len(payload)}.")
+        
+        try:
+            client_name = self._parse_string_from_payload(payload, name_field_protocol_len, MAX_CLIENT_NAME_LENGTH, "Client Name")
+            public_key_bytes = payload[name_field_protocol_len:name_field_protocol_len + RSA_PUBLIC_KEY_SIZE]
+            offered_caps = struct.unpack("<I", payload[-4:])[0]
+            
+            # Validate the key before registering so a bad key never leaves a half-registered client behind
+            try:
+                public_key_obj = RSA.import_key(public_key_bytes)
+            except ValueError as e:
+                raise ProtocolError(f"Invalid RSA public key format in combined registration for '{client_name}': {e}")
+            
+            new_client = self._register_client(client_name, public_key_bytes)
+            if new_client is None:
+                self._send_response(sock, RESP_REG_FAIL)
+                return
+            
+            # Generate the session key and encrypt it with the client's public key (PKCS1_OAEP padding)
+            new_client.set_aes_key(get_random_bytes(AES_KEY_SIZE_BYTES))
+            encrypted_aes_key = PKCS1_OAEP.new(public_key_obj).encrypt(new_client.get_aes_key())
+            self._save_client_to_db(new_client) # Persist the session AES key
+            
+            accepted_caps = offered_caps & SERVER_CAPABILITIES
+            with new_client.lock:
+                new_client.cipher_mode = CIPHER_MODE_GCM if accepted_caps & CAP_AES_GCM else CIPHER_MODE_CBC
+                new_client.sparse_runs = bool(accepted_caps & CAP_AES_GCM and accepted_caps & CAP_SPARSE_RUNS)
+            
+            response_payload = (new_client.id + struct.pack("<IH", accepted_caps, len(encrypted_aes_key)) +
+                                encrypted_aes_key)
+            if accepted_caps & CAP_SESSION_TICKET:
+                response_payload += self._issue_session_ticket(new_client, accepted_caps)
+            self._send_response(sock, RESP_REGISTER_KEY_AES_SENT, response_payload)
+            logger.info(f"Client '{client_name}' registered with public key in one round trip, cipher mode {new_client.cipher_mode}.")
+        
+        except ProtocolError as e: # Name or key rejected before anything was registered
+            logger.error(f"Combined registration protocol error: {e}")
+            self._send_response(sock, RESP_REG_FAIL)
+
+
     def _handle_send_public_key(self, sock: socket.socket, client: Client, payload: bytes):
         """
         Handles client's public key submission (Code 1026).
@@ -1112,6 +1303,186 @@ class BackupServer:
             self._send_response(sock, RESP_RECONNECT_FAIL, client.id)
 
 
+    def _handle_negotiate_caps(self, sock: socket.socket, client: Client, payload: bytes):
+        """
+        Handles capability negotiation (Code 1032), sent after the key exchange or reconnection.
+        Payload: uint32_t offered_capabilities; (little-endian bitmask)
+        Response 1608 payload: uint32_t accepted_capabilities; (subset of the offered bits)
+        """
+        if len(payload) != 4:
+            raise ProtocolError(f"NegotiateCaps Request (1032): Invalid payload size. Expected 4 bytes, got {len(payload)}.")
+
+        if client.get_aes_key() is None:
+            logger.warning(f"Client '{client.name}': Capability negotiation attempted before a session key was established.")
+            self._send_response(sock, RESP_GENERIC_SERVER_ERROR)
+            return
+
+        offered_caps = struct.unpack("<I", payload)[0]
+        accepted_caps = offered_caps & SERVER_CAPABILITIES
+
+        with client.lock:
+            client.cipher_mode = CIPHER_MODE_GCM if accepted_caps & CAP_AES_GCM else CIPHER_MODE_CBC
+            client.sparse_runs = bool(accepted_caps & CAP_AES_GCM and accepted_caps & CAP_SPARSE_RUNS)
+
+        response_payload = struct.pack("<I", accepted_caps)
+        if accepted_caps & CAP_SESSION_TICKET:
+            response_payload += self._issue_session_ticket(client, accepted_caps)
+
+        logger.info(f"Client '{client.name}': Negotiated capabilities 0x{accepted_caps:08x} (offered 0x{offered_caps:08x}), cipher mode {client.cipher_mode}.")
+        self._send_response(sock, RESP_CAPS_ACCEPTED, response_payload)
+
+
+    def _derive_key(self, key: bytes, label: bytes, context: bytes = b'') -> bytes:
+        """HMAC-SHA256(key, label || context); both ends use it to derive resumption secrets and resumed session keys."""
+        return hmac.new(key, label + context, hashlib.sha256).digest()
+
+
+    def _issue_session_ticket(self, client: Client, capabilities: int) -> bytes:
+        """
+        Seals the state needed to resume the current session into an opaque ticket.
+        The resumption secret is derived from the session AES key, so the client can compute it
+        without it ever being sent.
+
+        Returns:
+            uint32_t lifetime_seconds + ticket[], where ticket = nonce[12] + AES-GCM(ticket_key, state) + tag[16].
+        """
+        aes_key = client.get_aes_key()
+        if aes_key is None:
+            raise ServerError("Internal Server Error: Cannot issue a session ticket without a session key.")
+        resumption_secret = self._derive_key(aes_key, RESUMPTION_SECRET_LABEL)
+        ticket_state = struct.pack(TICKET_PLAINTEXT_FORMAT, client.id, int(time.time()),
+                                   get_random_bytes(TICKET_ID_SIZE), resumption_secret, capabilities)
+        ticket_nonce = get_random_bytes(GCM_NONCE_SIZE)
+        cipher_aes = AES.new(self.ticket_key, AES.MODE_GCM, nonce=ticket_nonce, mac_len=GCM_TAG_SIZE)
+        cipher_aes.update(client.id) # A ticket is only valid for the client it was issued to
+        sealed_state, tag = cipher_aes.encrypt_and_digest(ticket_state)
+        return struct.pack("<I", TICKET_LIFETIME_SECONDS) + ticket_nonce + sealed_state + tag
+
+
+    def _open_session_ticket(self, client: Client, ticket: bytes) -> Optional[Tuple[bytes, int]]:
+        """
+        Authenticates a ticket and consumes it. Tickets are single use: the ticket ID is remembered
+        until the ticket would have expired, so a replayed ticket is rejected.
+
+        Returns:
+            (resumption_secret, capabilities), or None if the ticket is forged, expired, for another client, or replayed.
+        """
+        if len(ticket) != GCM_NONCE_SIZE + struct.calcsize(TICKET_PLAINTEXT_FORMAT) + GCM_TAG_SIZE:
+            return None
+        try:
+            cipher_aes = AES.new(self.ticket_key, AES.MODE_GCM, nonce=ticket[:GCM_NONCE_SIZE], mac_len=GCM_TAG_SIZE)
+            cipher_aes.update(client.id)
+            ticket_state = cipher_aes.decrypt_and_verify(ticket[GCM_NONCE_SIZE:-GCM_TAG_SIZE], ticket[-GCM_TAG_SIZE:])
+        except ValueError: # Tag mismatch: forged, corrupted, or sealed by a previous server run
+            return None
+
+        ticket_client_id, issued_at, ticket_id, resumption_secret, capabilities = struct.unpack(TICKET_PLAINTEXT_FORMAT, ticket_state)
+        expires_at = issued_at + TICKET_LIFETIME_SECONDS
+        if ticket_client_id != client.id or time.time() > expires_at:
+            return None
+
+        with self.used_ticket_ids_lock:
+            if ticket_id in self.used_ticket_ids:
+                logger.warning(f"Client '{client.name}': Replayed session ticket {ticket_id.hex()} rejected.")
+                return None
+            self.used_ticket_ids[ticket_id] = expires_at
+        return resumption_secret, capabilities
+
+
+    def _handle_resume_session(self, sock: socket.socket, client: Client, payload: bytes):
+        """
+        Handles session resumption (Code 1033), replacing reconnect + key exchange + capability negotiation.
+        Payload: uint32_t offered_capabilities; uint8_t client_nonce[16]; uint8_t ticket[];
+        Response 1609 payload: uint32_t accepted_capabilities; uint8_t server_nonce[16];
+                               [uint32_t ticket_lifetime; uint8_t ticket[];] (a fresh ticket if accepted)
+        The new session key is HMAC-SHA256(resumption_secret, label + client_nonce + server_nonce).
+        Response 1610 (empty): ticket rejected, the session stays open for a normal reconnect.
+        """
+        if len(payload) <= 4 + RESUME_NONCE_SIZE:
+            raise ProtocolError(f"ResumeSession Request (1033): Payload too short ({len(payload)} bytes).")
+
+        offered_caps = struct.unpack("<I", payload[:4])[0]
+        client_nonce = payload[4:4 + RESUME_NONCE_SIZE]
+        opened_ticket = self._open_session_ticket(client, payload[4 + RESUME_NONCE_SIZE:])
+        if opened_ticket is None:
+            logger.info(f"Client '{client.name}': Session ticket rejected, client will fall back to a full reconnect.")
+            self._send_response(sock, RESP_RESUME_FAIL)
+            return
+        resumption_secret, ticket_caps = opened_ticket
+
+        server_nonce = get_random_bytes(RESUME_NONCE_SIZE)
+        client.set_aes_key(self._derive_key(resumption_secret, RESUMED_KEY_LABEL, client_nonce + server_nonce))
+
+        # Capabilities can only stay the same or shrink across a resumption
+        accepted_caps = offered_caps & ticket_caps & SERVER_CAPABILITIES
+        with client.lock:
+            client.cipher_mode = CIPHER_MODE_GCM if accepted_caps & CAP_AES_GCM else CIPHER_MODE_CBC
+            client.sparse_runs = bool(accepted_caps & CAP_AES_GCM and accepted_caps & CAP_SPARSE_RUNS)
+
+        self._save_client_to_db(client)
+
+        response_payload = struct.pack("<I", accepted_caps) + server_nonce
+        if accepted_caps & CAP_SESSION_TICKET:
+            response_payload += self._issue_session_ticket(client, accepted_caps)
+        self._send_response(sock, RESP_RESUME_OK, response_payload)
+        logger.info(f"Client '{client.name}' resumed a session from a ticket (no RSA exchange), cipher mode {client.cipher_mode}.")
+
+
+    def _decrypt_gcm_packets(self, aes_key: bytes, file_state: Dict[str, Any], filename_bytes_padded: bytes) -> bytes:
+        """
+        Decrypts and authenticates the packets of a file sent in AES-GCM mode.
+        Each packet's content is nonce[12] + ciphertext + tag[16]; the associated data is
+        original_size[4] + packet_number[2] + total_packets[2] + filename[255].
+        Zero-run packets (REQ_SEND_ZERO_RUN) carry a uint32 run length as plaintext, with
+        ZERO_RUN_LABEL appended to the associated data; they expand to that many zero bytes
+        and their (offset, length) is recorded in file_state["zero_ranges"] for sparse writes.
+
+        Raises:
+            ValueError: If a packet is malformed or its authentication tag does not verify.
+        """
+        total_packets = file_state["total_packets"]
+        original_size = file_state["original_size"]
+        zero_runs = file_state.get("zero_runs", set())
+        file_state["zero_ranges"] = []
+        plaintext_chunks = []
+        offset = 0
+        for packet_number in range(1, total_packets + 1):
+            content = file_state["received_chunks"][packet_number]
+            if len(content) < GCM_NONCE_SIZE + GCM_TAG_SIZE:
+                raise ValueError(f"GCM packet {packet_number} is too short ({len(content)} bytes).")
+            cipher_aes = AES.new(aes_key, AES.MODE_GCM, nonce=content[:GCM_NONCE_SIZE], mac_len=GCM_TAG_SIZE)
+            aad = struct.pack("<IHH", original_size, packet_number, total_packets) + filename_bytes_padded
+            is_zero_run = packet_number in zero_runs
+            cipher_aes.update(aad + ZERO_RUN_LABEL if is_zero_run else aad)
+            plaintext = cipher_aes.decrypt_and_verify(content[GCM_NONCE_SIZE:-GCM_TAG_SIZE], content[-GCM_TAG_SIZE:])
+            if is_zero_run:
+                if len(plaintext) != 4:
+                    raise ValueError(f"Zero-run packet {packet_number} has a malformed record ({len(plaintext)} bytes).")
+                run_length = struct.unpack("<I", plaintext)[0]
+                if offset + run_length > original_size:
+                    raise ValueError(f"Zero-run packet {packet_number} extends past the end of the file.")
+                file_state["zero_ranges"].append((offset, run_length))
+                plaintext = bytes(run_length)
+            plaintext_chunks.append(plaintext)
+            offset += len(plaintext)
+        return b''.join(plaintext_chunks)
+
+
+    def _write_sparse(self, file_obj, data: bytes, zero_ranges: List[Tuple[int, int]]):
+        """
+        Writes data to file_obj, seeking over the zero ranges instead of writing them so the
+        filesystem can leave them as holes. Truncates to len(data) so a trailing hole counts.
+        """
+        position = 0
+        for offset, length in zero_ranges:
+            if offset > position:
+                file_obj.write(data[position:offset])
+            file_obj.seek(offset + length)
+            position = offset + length
+        file_obj.write(data[position:])
+        file_obj.truncate(len(data))
+
+
     def _is_valid_filename_for_storage(self, filename_str: str) -> bool:
         """
         Validates a filename string for storage on the server.
@@ -1154,7 +1525,19 @@ class BackupServer:
         return True # If all checks pass, filename is considered valid
 
 
-    def _handle_send_file(self, sock: socket.socket, client: Client, payload: bytes):
+    def _handle_send_zero_run(self, sock: socket.socket, client: Client, payload: bytes):
+        """
+        Handles a zero-run packet (Code 1035): a packet of a file whose plaintext is all zero.
+        The payload has the REQ_SEND_FILE layout; its content is nonce[12] + AES-GCM(run_length
+        uint32) + tag[16], authenticated with ZERO_RUN_LABEL appended to the usual AAD.
+        Only valid after CAP_SPARSE_RUNS was negotiated.
+        """
+        if not client.sparse_runs:
+            raise ProtocolError(f"SendZeroRun: Client '{client.name}' did not negotiate CAP_SPARSE_RUNS.")
+        self._handle_send_file(sock, client, payload, zero_run=True)
+
+
+    def _handle_send_file(self, sock: socket.socket, client: Client, payload: bytes, zero_run: bool = False):
         """
         Handles a file transfer packet (Code 1028) from a client.
         Manages multi-packet reassembly, decryption, CRC calculation, and storage.
@@ -1210,7 +1593,7 @@ class BackupServer:
             # before completing the public key exchange or a successful reconnect to get an AES key).
             raise ClientError(f"SendFile: Client '{client.name}' has no active AES key for file decryption. This is a critical protocol violation.")
         
-        logger.info(f"Client '{client.name}': Receiving file '{filename_str}', Packet {packet_number}/{total_packets} (EncSizeInPkt:{encrypted_packet_content_size}, OrigFileSize:{original_file_size}).")
+        logger.info(f"Client '{client.name}': Receiving file '{filename_str}', Packet {packet_number}/{total_packets}{' (zero run)' if zero_run else ''} (EncSizeInPkt:{encrypted_packet_content_size}, OrigFileSize:{original_file_size}).")
 
         # --- Multi-Packet Reassembly Logic ---
         with client.lock: # Ensure thread-safe access to this specific client's partial_files dictionary
@@ -1222,6 +1605,7 @@ class BackupServer:
                 client.partial_files[filename_str] = {
                     "total_packets": total_packets,
                     "received_chunks": {}, # Store encrypted chunks here, map: packet_number -> chunk_bytes
+                    "zero_runs": set(), # Packet numbers received as REQ_SEND_ZERO_RUN records
                     "original_size": original_file_size,
                     "timestamp": time.monotonic() # Track activity for stale cleanup
                 }
@@ -1242,6 +1626,10 @@ class BackupServer:
             
             # Store the received encrypted chunk for this packet number
             file_state["received_chunks"][packet_number] = actual_encrypted_content_in_payload
+            if zero_run:
+                file_state["zero_runs"].add(packet_number)
+            else:
+                file_state["zero_runs"].discard(packet_number)
             file_state["timestamp"] = time.monotonic() # Update timestamp on receiving any packet for this file
 
             # --- Check if all packets for the current file have been received ---
@@ -1260,10 +1648,15 @@ class BackupServer:
                     return
 
                 try:
-                    # Decrypt the fully reassembled encrypted data
-                    # AES-CBC mode, IV is all zeros (as per simplified spec), PKCS7 padding
-                    cipher_aes = AES.new(current_aes_key, AES.MODE_CBC, iv=b'\0' * 16)
-                    decrypted_data = unpad(cipher_aes.decrypt(full_encrypted_data), AES.block_size)
+                    gcm_mode = client.cipher_mode == CIPHER_MODE_GCM
+                    if gcm_mode:
+                        # AES-GCM mode: every packet is decrypted and authenticated on its own
+                        decrypted_data = self._decrypt_gcm_packets(current_aes_key, file_state, filename_bytes_padded)
+                    else:
+                        # Decrypt the fully reassembled encrypted data
+                        # AES-CBC mode, IV is all zeros (as per simplified spec), PKCS7 padding
+                        cipher_aes = AES.new(current_aes_key, AES.MODE_CBC, iv=b'\0' * 16)
+                        decrypted_data = unpad(cipher_aes.decrypt(full_encrypted_data), AES.block_size)
 
                     # Verify that the size of the decrypted data matches the original_file_size from metadata
                     if len(decrypted_data) != original_file_size:
@@ -1282,7 +1675,11 @@ class BackupServer:
                     
                     try:
                         with open(temp_save_path, 'wb') as f_temp: # Write decrypted data to temp file
-                            f_temp.write(decrypted_data)
+                            zero_ranges = file_state.get("zero_ranges") if gcm_mode else None
+                            if zero_ranges:
+                                self._write_sparse(f_temp, decrypted_data, zero_ranges)
+                            else:
+                                f_temp.write(decrypted_data)
                         os.rename(temp_save_path, final_save_path) # Atomically rename (on POSIX if same filesystem)
                         logger.info(f"Client '{client.name}': File '{filename_str}' (Original Size: {original_file_size} bytes) successfully decrypted and saved to storage path: '{final_save_path}'.")
                         
@@ -1292,6 +1689,13 @@ class BackupServer:
                     except OSError as e_os_save: # Catch errors during file write or rename
                         raise FileError(f"Failed to save decrypted file '{filename_str}' to server storage: {e_os_save}") from e_os_save
                     
+                    if gcm_mode:
+                        # Authentication tags already proved integrity, so there is no CRC round trip
+                        self._save_file_info_to_db(client.id, filename_str, final_save_path, True) # Verified=True
+                        self._send_response(sock, RESP_ACK, client.id)
+                        logger.info(f"Client '{client.name}': File '{filename_str}' authenticated (AES-GCM). Sent ACK without CRC exchange.")
+                        return
+
                     # Persist file information to the database (initially marked as not verified by client)
                     self._save_file_info_to_db(client.id, filename_str, final_save_path, False) # Verified=False
                     
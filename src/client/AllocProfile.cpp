@@ -0,0 +1,214 @@
+#include "../../include/client/AllocProfile.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <iomanip>
+#include <new>
+#include <sstream>
+
+namespace {
+
+constexpr size_t PHASES = static_cast<size_t>(AllocPhase::Count);
+constexpr size_t HEADER_SIZE = 16;   // Holds the block size; keeps malloc's 16-byte alignment
+
+// Constant-initialized, so allocations made before main() are counted safely
+struct PhaseCounters {
+    std::atomic<uint64_t> allocations{0};
+    std::atomic<uint64_t> allocatedBytes{0};
+    std::atomic<uint64_t> frees{0};
+    std::atomic<uint64_t> freedBytes{0};
+    std::atomic<uint64_t> peakLive{0};
+};
+
+PhaseCounters counters[PHASES];
+std::atomic<int> currentPhase{0};
+std::atomic<uint64_t> live{0};
+std::atomic<uint64_t> peakLive{0};
+
+void raise(std::atomic<uint64_t>& peak, uint64_t value) {
+    uint64_t seen = peak.load(std::memory_order_relaxed);
+    while (value > seen && !peak.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {
+    }
+}
+
+std::string megabytes(uint64_t bytes) {
+    std::ostringstream text;
+    text << std::fixed << std::setprecision(2) << bytes / (1024.0 * 1024.0) << " MB";
+    return text.str();
+}
+
+} // namespace
+
+bool AllocProfile::enabled() {
+#ifdef CLIENT_ALLOC_PROFILE
+    return true;
+#else
+    return false;
+#endif
+}
+
+AllocPhase AllocProfile::enterPhase(AllocPhase phase) {
+    raise(counters[static_cast<size_t>(phase)].peakLive, live.load(std::memory_order_relaxed));
+    return static_cast<AllocPhase>(currentPhase.exchange(static_cast<int>(phase), std::memory_order_relaxed));
+}
+
+AllocPhase AllocProfile::phase() {
+    return static_cast<AllocPhase>(currentPhase.load(std::memory_order_relaxed));
+}
+
+AllocProfile::PhaseStats AllocProfile::stats(AllocPhase phase) {
+    const PhaseCounters& phaseCounters = counters[static_cast<size_t>(phase)];
+    return PhaseStats{phaseCounters.allocations.load(std::memory_order_relaxed),
+                      phaseCounters.allocatedBytes.load(std::memory_order_relaxed),
+                      phaseCounters.frees.load(std::memory_order_relaxed),
+                      phaseCounters.freedBytes.load(std::memory_order_relaxed),
+                      phaseCounters.peakLive.load(std::memory_order_relaxed)};
+}
+
+uint64_t AllocProfile::liveBytes() {
+    return live.load(std::memory_order_relaxed);
+}
+
+uint64_t AllocProfile::peakLiveBytes() {
+    return peakLive.load(std::memory_order_relaxed);
+}
+
+void AllocProfile::reset() {
+    uint64_t now = live.load(std::memory_order_relaxed);
+    for (PhaseCounters& phaseCounters : counters) {
+        phaseCounters.allocations.store(0, std::memory_order_relaxed);
+        phaseCounters.allocatedBytes.store(0, std::memory_order_relaxed);
+        phaseCounters.frees.store(0, std::memory_order_relaxed);
+        phaseCounters.freedBytes.store(0, std::memory_order_relaxed);
+        phaseCounters.peakLive.store(0, std::memory_order_relaxed);
+    }
+    counters[currentPhase.load(std::memory_order_relaxed)].peakLive.store(now, std::memory_order_relaxed);
+    peakLive.store(now, std::memory_order_relaxed);
+}
+
+const char* AllocProfile::phaseName(AllocPhase phase) {
+    switch (phase) {
+        case AllocPhase::Init: return "init";
+        case AllocPhase::Handshake: return "handshake";
+        case AllocPhase::Read: return "read";
+        case AllocPhase::Encrypt: return "encrypt";
+        case AllocPhase::Send: return "send";
+        case AllocPhase::Verify: return "verify";
+        default: return "?";
+    }
+}
+
+std::string AllocProfile::table() {
+    std::ostringstream out;
+    out << std::left << std::setw(12) << "  Phase" << std::right << std::setw(12) << "Allocs" << std::setw(14)
+        << "Allocated" << std::setw(12) << "Frees" << std::setw(14) << "Freed" << std::setw(14) << "Peak live" << "\n";
+    for (size_t i = 0; i < PHASES; i++) {
+        PhaseStats phaseStats = stats(static_cast<AllocPhase>(i));
+        out << "  " << std::left << std::setw(10) << phaseName(static_cast<AllocPhase>(i)) << std::right
+            << std::setw(12) << phaseStats.allocations << std::setw(14) << megabytes(phaseStats.allocatedBytes)
+            << std::setw(12) << phaseStats.frees << std::setw(14) << megabytes(phaseStats.freedBytes) << std::setw(14)
+            << megabytes(phaseStats.peakLiveBytes) << "\n";
+    }
+    out << "  Peak live over the run: " << megabytes(peakLiveBytes()) << ", live now: " << megabytes(liveBytes()) << "\n";
+    return out.str();
+}
+
+void AllocProfile::noteAllocation(size_t bytes) {
+    PhaseCounters& phaseCounters = counters[currentPhase.load(std::memory_order_relaxed)];
+    phaseCounters.allocations.fetch_add(1, std::memory_order_relaxed);
+    phaseCounters.allocatedBytes.fetch_add(bytes, std::memory_order_relaxed);
+    uint64_t now = live.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    raise(phaseCounters.peakLive, now);
+    raise(peakLive, now);
+}
+
+void AllocProfile::noteFree(size_t bytes) {
+    PhaseCounters& phaseCounters = counters[currentPhase.load(std::memory_order_relaxed)];
+    phaseCounters.frees.fetch_add(1, std::memory_order_relaxed);
+    phaseCounters.freedBytes.fetch_add(bytes, std::memory_order_relaxed);
+    live.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+// ---------------------------------------------------------------------------
+// Global operator new/delete (instrumentation build only)
+
+#ifdef CLIENT_ALLOC_PROFILE
+
+namespace {
+
+void* profiledAllocate(size_t size) {
+    for (;;) {
+        void* block = std::malloc(size + HEADER_SIZE);
+        if (block) {
+            *static_cast<size_t*>(block) = size;
+            AllocProfile::noteAllocation(size);
+            return static_cast<char*>(block) + HEADER_SIZE;
+        }
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+void profiledFree(void* memory) noexcept {
+    if (!memory) {
+        return;
+    }
+    void* block = static_cast<char*>(memory) - HEADER_SIZE;
+    AllocProfile::noteFree(*static_cast<size_t*>(block));
+    std::free(block);
+}
+
+} // namespace
+
+void* operator new(std::size_t size) {
+    return profiledAllocate(size);
+}
+
+void* operator new[](std::size_t size) {
+    return profiledAllocate(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return profiledAllocate(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return profiledAllocate(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void operator delete(void* memory) noexcept {
+    profiledFree(memory);
+}
+
+void operator delete[](void* memory) noexcept {
+    profiledFree(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    profiledFree(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept {
+    profiledFree(memory);
+}
+
+void operator delete(void* memory, const std::nothrow_t&) noexcept {
+    profiledFree(memory);
+}
+
+void operator delete[](void* memory, const std::nothrow_t&) noexcept {
+    profiledFree(memory);
+}
+
+#endif
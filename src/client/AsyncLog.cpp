@@ -0,0 +1,183 @@
+#include "../../include/client/AsyncLog.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+
+namespace {
+
+constexpr int WRITER_IDLE_WAIT_MS = 100;   // Backstop only: posters wake an idle writer
+
+} // namespace
+
+AsyncLog::AsyncLog(size_t capacity) : slotCount(2) {
+    while (slotCount < capacity) {
+        slotCount <<= 1;
+    }
+    slots.reset(new Slot[slotCount]);
+    for (size_t i = 0; i < slotCount; i++) {
+        slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    running.store(true);
+    writer = std::thread(&AsyncLog::writerLoop, this);
+}
+
+AsyncLog::~AsyncLog() {
+    stop();
+}
+
+// ---------------------------------------------------------------------------
+// Ring: a slot is free for position p when its sequence is p, and holds the record
+// for p when its sequence is p + 1
+
+bool AsyncLog::tryPush(Render& render) {
+    size_t position = enqueuePosition.load(std::memory_order_relaxed);
+    for (;;) {
+        Slot& slot = slots[position & (slotCount - 1)];
+        size_t sequence = slot.sequence.load(std::memory_order_acquire);
+        if (sequence == position) {
+            if (enqueuePosition.compare_exchange_weak(position, position + 1)) {
+                slot.render = std::move(render);
+                slot.sequence.store(position + 1, std::memory_order_release);
+                return true;
+            }
+        } else if (sequence < position) {
+            return false;   // Full: the writer has not freed this slot yet
+        } else {
+            position = enqueuePosition.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+bool AsyncLog::tryPop(Render& render) {
+    Slot& slot = slots[dequeuePosition & (slotCount - 1)];
+    if (slot.sequence.load(std::memory_order_acquire) != dequeuePosition + 1) {
+        return false;   // Empty, or the next poster has claimed the slot but not filled it yet
+    }
+    render = std::move(slot.render);
+    slot.render = nullptr;
+    slot.sequence.store(dequeuePosition + slotCount, std::memory_order_release);
+    dequeuePosition++;
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Posting
+
+bool AsyncLog::post(LogLevel level, Render render) {
+    if (!enabled(level) || !render) {
+        return false;
+    }
+    if (!running.load(std::memory_order_acquire)) {
+        std::lock_guard<std::mutex> guard(inlineLock);
+        try {
+            render();
+        } catch (...) {
+        }
+        return true;
+    }
+    while (!tryPush(render)) {
+        if (level < LogLevel::Error) {
+            droppedRecords.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        std::this_thread::yield();
+    }
+    if (writerIdle.load()) {
+        std::lock_guard<std::mutex> guard(wakeLock);
+        wake.notify_one();
+    }
+    return true;
+}
+
+void AsyncLog::flush() {
+    if (!running.load(std::memory_order_acquire) || std::this_thread::get_id() == writer.get_id()) {
+        return;
+    }
+    const size_t target = enqueuePosition.load();
+    std::unique_lock<std::mutex> lock(wakeLock);
+    wake.notify_one();
+    drained.wait(lock, [&]() {
+        return renderedPosition.load(std::memory_order_acquire) >= target || !running.load(std::memory_order_acquire);
+    });
+}
+
+void AsyncLog::stop() {
+    if (!writer.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> guard(wakeLock);
+        stopping.store(true);
+        wake.notify_one();
+    }
+    writer.join();
+    running.store(false, std::memory_order_release);
+
+    // Records that raced with shutdown
+    std::lock_guard<std::mutex> guard(inlineLock);
+    Render render;
+    while (tryPop(render)) {
+        try {
+            render();
+        } catch (...) {
+        }
+    }
+    renderedPosition.store(dequeuePosition, std::memory_order_release);
+    std::lock_guard<std::mutex> wakeGuard(wakeLock);
+    drained.notify_all();
+}
+
+// ---------------------------------------------------------------------------
+// Writer thread
+
+void AsyncLog::writerLoop() {
+    Render render;
+    for (;;) {
+        bool rendered = false;
+        while (tryPop(render)) {
+            try {
+                render();
+            } catch (...) {
+                // A failing console or GUI call loses that record only
+            }
+            render = nullptr;
+            renderedPosition.store(dequeuePosition, std::memory_order_release);
+            rendered = true;
+        }
+        if (rendered) {
+            std::lock_guard<std::mutex> guard(wakeLock);
+            drained.notify_all();
+        }
+        if (stopping.load() && enqueuePosition.load() == dequeuePosition) {
+            return;
+        }
+
+        std::unique_lock<std::mutex> lock(wakeLock);
+        writerIdle.store(true);
+        if (enqueuePosition.load() == dequeuePosition && !stopping.load()) {
+            wake.wait_for(lock, std::chrono::milliseconds(WRITER_IDLE_WAIT_MS));
+        }
+        writerIdle.store(false);
+    }
+}
+
+bool AsyncLog::parseLevel(const std::string& name, LogLevel& level) {
+    std::string lower(name);
+    std::transform(lower.begin(), lower.end(), lower.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    if (lower == "debug") {
+        level = LogLevel::Debug;
+    } else if (lower == "info") {
+        level = LogLevel::Info;
+    } else if (lower == "warning" || lower == "warn") {
+        level = LogLevel::Warning;
+    } else if (lower == "error") {
+        level = LogLevel::Error;
+    } else if (lower == "off") {
+        level = LogLevel::Off;
+    } else {
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,185 @@
+#include "../../include/client/BufferPool.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef _WIN32
+#include <malloc.h>
+#else
+#include <sys/mman.h>
+#endif
+
+namespace {
+
+constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+uint8_t* alignedAllocate(size_t bytes) {
+#ifdef _WIN32
+    return static_cast<uint8_t*>(_aligned_malloc(bytes, BufferPool::CACHE_LINE));
+#else
+    void* memory = nullptr;
+    return posix_memalign(&memory, BufferPool::CACHE_LINE, bytes) == 0 ? static_cast<uint8_t*>(memory) : nullptr;
+#endif
+}
+
+void alignedFree(uint8_t* memory) {
+#ifdef _WIN32
+    _aligned_free(memory);
+#else
+    free(memory);
+#endif
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// Lease
+
+BufferPool::Lease::Lease() : pool(nullptr), buffer(nullptr), bytes(0), slot(-1) {
+}
+
+BufferPool::Lease::Lease(Lease&& other) noexcept : pool(other.pool), buffer(other.buffer), bytes(other.bytes), slot(other.slot) {
+    other.pool = nullptr;
+    other.buffer = nullptr;
+    other.bytes = 0;
+}
+
+BufferPool::Lease& BufferPool::Lease::operator=(Lease&& other) noexcept {
+    if (this != &other) {
+        release();
+        pool = other.pool;
+        buffer = other.buffer;
+        bytes = other.bytes;
+        slot = other.slot;
+        other.pool = nullptr;
+        other.buffer = nullptr;
+        other.bytes = 0;
+    }
+    return *this;
+}
+
+BufferPool::Lease::~Lease() {
+    release();
+}
+
+void BufferPool::Lease::release() {
+    if (buffer) {
+        if (pool) {
+            pool->give(slot);
+        } else {
+            alignedFree(buffer);
+        }
+    }
+    pool = nullptr;
+    buffer = nullptr;
+    bytes = 0;
+    slot = -1;
+}
+
+// ---------------------------------------------------------------------------
+// BufferPool
+
+BufferPool::BufferPool()
+    : block(nullptr), blockBytes(0), slotBytes(0), slots(0), hugePages(false), mapped(false),
+      acquired(0), fallbacks(0) {
+}
+
+BufferPool::~BufferPool() {
+    shutdown();
+}
+
+bool BufferPool::init(size_t bufferCount, size_t bufferSize, bool useHugePages, std::string& error) {
+    shutdown();
+    if (bufferCount == 0 || bufferSize == 0) {
+        error = "Buffer pool needs at least one non-empty buffer";
+        return false;
+    }
+    slotBytes = (bufferSize + CACHE_LINE - 1) / CACHE_LINE * CACHE_LINE;
+    blockBytes = slotBytes * bufferCount;
+
+#if defined(MADV_HUGEPAGE)
+    if (useHugePages) {
+        // Anonymous mappings are page aligned; THP needs the length in whole huge pages
+        size_t length = (blockBytes + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+        void* memory = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (memory != MAP_FAILED) {
+            hugePages = madvise(memory, length, MADV_HUGEPAGE) == 0;
+            block = static_cast<uint8_t*>(memory);
+            blockBytes = length;
+            mapped = true;
+        }
+    }
+#else
+    (void)useHugePages;
+    (void)HUGE_PAGE_SIZE;
+#endif
+    if (!block) {
+        block = alignedAllocate(blockBytes);
+        if (!block) {
+            error = "Cannot allocate " + std::to_string(blockBytes) + " bytes for the buffer pool";
+            blockBytes = 0;
+            slotBytes = 0;
+            return false;
+        }
+    }
+
+    // Touch every page now so the first packets do not pay for the page faults
+    std::memset(block, 0, slotBytes * bufferCount);
+
+    slots = static_cast<unsigned>(bufferCount);
+    freeSlots.reserve(bufferCount);
+    for (int slot = static_cast<int>(bufferCount) - 1; slot >= 0; slot--) {
+        freeSlots.push_back(slot);
+    }
+    acquired = 0;
+    fallbacks = 0;
+    return true;
+}
+
+void BufferPool::shutdown() {
+    if (block) {
+#ifndef _WIN32
+        if (mapped) {
+            munmap(block, blockBytes);
+        } else {
+            alignedFree(block);
+        }
+#else
+        alignedFree(block);
+#endif
+    }
+    block = nullptr;
+    blockBytes = 0;
+    slotBytes = 0;
+    slots = 0;
+    hugePages = false;
+    mapped = false;
+    freeSlots.clear();
+}
+
+BufferPool::Lease BufferPool::acquire(size_t bytes) {
+    Lease lease;
+    acquired++;
+    if (block && bytes <= slotBytes && !freeSlots.empty()) {
+        lease.slot = freeSlots.back();
+        freeSlots.pop_back();
+        lease.pool = this;
+        lease.buffer = block + static_cast<size_t>(lease.slot) * slotBytes;
+        lease.bytes = slotBytes;
+        return lease;
+    }
+
+    // Oversized or pool exhausted: a heap buffer the lease frees itself
+    fallbacks++;
+    size_t rounded = (std::max<size_t>(bytes, 1) + CACHE_LINE - 1) / CACHE_LINE * CACHE_LINE;
+    lease.buffer = alignedAllocate(rounded);
+    lease.bytes = lease.buffer ? rounded : 0;
+    return lease;
+}
+
+void BufferPool::give(int slot) {
+    if (slot >= 0 && static_cast<unsigned>(slot) < slots) {
+        freeSlots.push_back(slot);
+    }
+}
@@ -0,0 +1,144 @@
+#include "../../include/client/DeadlineIO.h"
+
+#include <cerrno>
+
+#ifdef _WIN32
+#include <mstcpip.h>   // SIO_KEEPALIVE_VALS
+#else
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#endif
+
+namespace {
+
+// Run the io_context until the operation finishes or the deadline cancels it
+template <typename Socket, typename StartOperation>
+boost::system::error_code runWithDeadline(boost::asio::io_context& ioContext, Socket& socket,
+                                          std::chrono::milliseconds timeout, StartOperation start) {
+    boost::system::error_code result = boost::asio::error::would_block;
+    bool expired = false;
+
+    boost::asio::steady_timer deadline(ioContext);
+    deadline.expires_after(timeout);
+    deadline.async_wait([&](const boost::system::error_code& timerError) {
+        if (!timerError) {
+            expired = true;
+            boost::system::error_code ignored;
+            socket.cancel(ignored);
+        }
+    });
+
+    start([&](const boost::system::error_code& ec, std::size_t) {
+        result = ec;
+        deadline.cancel();
+    });
+
+    ioContext.restart();
+    ioContext.run();
+
+    // The timer can fire in the same run() that completes the operation; that operation's
+    // result stands, and only one the cancel cut short (or never finished) has timed out
+    if (expired && (result == boost::asio::error::operation_aborted || result == boost::asio::error::would_block)) {
+        return boost::asio::error::timed_out;
+    }
+    return result;
+}
+
+} // namespace
+
+namespace DeadlineIO {
+
+boost::system::error_code write(boost::asio::io_context& ioContext, boost::asio::ip::tcp::socket& socket,
+                                const std::vector<boost::asio::const_buffer>& buffers,
+                                std::chrono::milliseconds timeout) {
+    return runWithDeadline(ioContext, socket, timeout, [&](auto done) {
+        boost::asio::async_write(socket, buffers, done);
+    });
+}
+
+boost::system::error_code read(boost::asio::io_context& ioContext, boost::asio::ip::tcp::socket& socket,
+                               boost::asio::mutable_buffer buffer, std::chrono::milliseconds timeout) {
+    return runWithDeadline(ioContext, socket, timeout, [&](auto done) {
+        boost::asio::async_read(socket, buffer, done);
+    });
+}
+
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+boost::system::error_code write(boost::asio::io_context& ioContext, boost::asio::local::stream_protocol::socket& socket,
+                                const std::vector<boost::asio::const_buffer>& buffers,
+                                std::chrono::milliseconds timeout) {
+    return runWithDeadline(ioContext, socket, timeout, [&](auto done) {
+        boost::asio::async_write(socket, buffers, done);
+    });
+}
+
+boost::system::error_code read(boost::asio::io_context& ioContext, boost::asio::local::stream_protocol::socket& socket,
+                               boost::asio::mutable_buffer buffer, std::chrono::milliseconds timeout) {
+    return runWithDeadline(ioContext, socket, timeout, [&](auto done) {
+        boost::asio::async_read(socket, buffer, done);
+    });
+}
+
+boost::system::error_code connect(boost::asio::io_context& ioContext, boost::asio::local::stream_protocol::socket& socket,
+                                  const boost::asio::local::stream_protocol::endpoint& endpoint,
+                                  std::chrono::milliseconds timeout) {
+    return runWithDeadline(ioContext, socket, timeout, [&](auto done) {
+        socket.async_connect(endpoint, [done](const boost::system::error_code& ec) mutable {
+            done(ec, 0);
+        });
+    });
+}
+#endif
+
+boost::system::error_code wait(boost::asio::io_context& ioContext, boost::asio::ip::tcp::socket& socket,
+                               boost::asio::socket_base::wait_type type, std::chrono::milliseconds timeout) {
+    return runWithDeadline(ioContext, socket, timeout, [&](auto done) {
+        socket.async_wait(type, [done](const boost::system::error_code& ec) mutable {
+            done(ec, 0);
+        });
+    });
+}
+
+boost::system::error_code setKeepAlive(boost::asio::ip::tcp::socket& socket, int idleSeconds,
+                                       int intervalSeconds, int probes) {
+    boost::system::error_code ec;
+    socket.set_option(boost::asio::socket_base::keep_alive(true), ec);
+    if (ec) {
+        return ec;
+    }
+
+#ifdef _WIN32
+    // Probe count is fixed by Windows (10 probes since Vista)
+    (void)probes;
+    tcp_keepalive settings;
+    settings.onoff = 1;
+    settings.keepalivetime = static_cast<ULONG>(idleSeconds) * 1000;
+    settings.keepaliveinterval = static_cast<ULONG>(intervalSeconds) * 1000;
+    DWORD returned = 0;
+    if (WSAIoctl(socket.native_handle(), SIO_KEEPALIVE_VALS, &settings, sizeof(settings),
+                 nullptr, 0, &returned, nullptr, nullptr) != 0) {
+        ec = boost::system::error_code(WSAGetLastError(), boost::asio::error::get_system_category());
+    }
+#else
+    int fd = socket.native_handle();
+#if defined(TCP_KEEPIDLE)
+    if (setsockopt(fd, IPPROTO_TCP, TCP_KEEPIDLE, &idleSeconds, sizeof(idleSeconds)) != 0) {
+        ec = boost::system::error_code(errno, boost::asio::error::get_system_category());
+    }
+#elif defined(TCP_KEEPALIVE)
+    if (setsockopt(fd, IPPROTO_TCP, TCP_KEEPALIVE, &idleSeconds, sizeof(idleSeconds)) != 0) {
+        ec = boost::system::error_code(errno, boost::asio::error::get_system_category());
+    }
+#endif
+#if defined(TCP_KEEPINTVL) && defined(TCP_KEEPCNT)
+    if (!ec && (setsockopt(fd, IPPROTO_TCP, TCP_KEEPINTVL, &intervalSeconds, sizeof(intervalSeconds)) != 0 ||
+                setsockopt(fd, IPPROTO_TCP, TCP_KEEPCNT, &probes, sizeof(probes)) != 0)) {
+        ec = boost::system::error_code(errno, boost::asio::error::get_system_category());
+    }
+#endif
+#endif
+    return ec;
+}
+
+} // namespace DeadlineIO
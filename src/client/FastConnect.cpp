@@ -0,0 +1,247 @@
+#include "../../include/client/FastConnect.h"
+
+#include <algorithm>
+#include <functional>
+#include <iomanip>
+#include <sstream>
+
+#ifndef _WIN32
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#endif
+
+using boost::asio::ip::tcp;
+
+// ---------------------------------------------------------------------------
+// ConnectLatencyStats
+
+ConnectLatencyStats::ConnectLatencyStats() : nextSlot(0) {
+}
+
+void ConnectLatencyStats::record(double milliseconds) {
+    if (samples.size() < MAX_SAMPLES) {
+        samples.push_back(milliseconds);
+    } else {
+        samples[nextSlot] = milliseconds;
+    }
+    nextSlot = (nextSlot + 1) % MAX_SAMPLES;
+}
+
+size_t ConnectLatencyStats::count() const {
+    return samples.size();
+}
+
+double ConnectLatencyStats::percentile(double p) const {
+    if (samples.empty()) {
+        return 0.0;
+    }
+    std::vector<double> sorted(samples);
+    std::sort(sorted.begin(), sorted.end());
+
+    // Nearest-rank percentile
+    double clamped = std::min(100.0, std::max(0.0, p));
+    size_t rank = static_cast<size_t>(clamped / 100.0 * (sorted.size() - 1) + 0.5);
+    return sorted[rank];
+}
+
+std::string ConnectLatencyStats::summary() const {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(1)
+        << "p50 " << percentile(50) << "ms p90 " << percentile(90) << "ms p99 " << percentile(99)
+        << "ms (n=" << count() << ")";
+    return out.str();
+}
+
+// ---------------------------------------------------------------------------
+// FastConnector
+
+FastConnector::FastConnector(boost::asio::io_context& ioContext, const ConnectOptions& options)
+    : ioContext(ioContext), options(options), jitter(std::random_device{}()),
+      hasPreferredEndpoint(false), usedFastOpen(false) {
+}
+
+std::chrono::milliseconds FastConnector::backoffDelay(int retry) {
+    if (retry < 1) {
+        return std::chrono::milliseconds(0);
+    }
+    // Full jitter: spreads out thousands of clients retrying against the same server
+    long long ceiling = options.backoffBase.count();
+    for (int i = 1; i < retry && ceiling < options.backoffCap.count(); i++) {
+        ceiling *= 2;
+    }
+    ceiling = std::min<long long>(ceiling, options.backoffCap.count());
+    std::uniform_int_distribution<long long> distribution(0, ceiling);
+    return std::chrono::milliseconds(distribution(jitter));
+}
+
+// RFC 8305 ordering: keep the resolver's order within each family, interleave the
+// families starting with the first one returned, and try the last winner first
+std::vector<tcp::endpoint> FastConnector::orderEndpoints(const tcp::resolver::results_type& results) const {
+    std::vector<tcp::endpoint> first, second;
+    bool firstIsV6 = results.begin() != results.end() && results.begin()->endpoint().address().is_v6();
+    for (const auto& entry : results) {
+        tcp::endpoint endpoint = entry.endpoint();
+        std::vector<tcp::endpoint>& family = (endpoint.address().is_v6() == firstIsV6) ? first : second;
+        if (std::find(family.begin(), family.end(), endpoint) == family.end()) {
+            family.push_back(endpoint);
+        }
+    }
+
+    std::vector<tcp::endpoint> ordered;
+    for (size_t i = 0; i < std::max(first.size(), second.size()); i++) {
+        if (i < first.size()) {
+            ordered.push_back(first[i]);
+        }
+        if (i < second.size()) {
+            ordered.push_back(second[i]);
+        }
+    }
+
+    if (hasPreferredEndpoint) {
+        auto it = std::find(ordered.begin(), ordered.end(), preferredEndpoint);
+        if (it != ordered.end()) {
+            std::rotate(ordered.begin(), it, it + 1);
+        }
+    }
+    return ordered;
+}
+
+bool FastConnector::enableFastOpen(tcp::socket& socket) const {
+#if defined(_WIN32) && defined(TCP_FASTOPEN)
+    DWORD enable = 1;
+    return setsockopt(socket.native_handle(), IPPROTO_TCP, TCP_FASTOPEN,
+                      reinterpret_cast<const char*>(&enable), sizeof(enable)) == 0;
+#elif defined(TCP_FASTOPEN_CONNECT)
+    int enable = 1;
+    return setsockopt(socket.native_handle(), IPPROTO_TCP, TCP_FASTOPEN_CONNECT, &enable, sizeof(enable)) == 0;
+#else
+    (void)socket;
+    return false;
+#endif
+}
+
+std::unique_ptr<tcp::socket> FastConnector::connect(const std::string& host, uint16_t port,
+                                                    boost::system::error_code& ec) {
+    auto start = std::chrono::steady_clock::now();
+    usedFastOpen = false;
+
+    tcp::resolver resolver(ioContext);
+    tcp::resolver::results_type results = resolver.resolve(host, std::to_string(port), ec);
+    if (ec) {
+        return nullptr;
+    }
+    std::vector<tcp::endpoint> candidates = orderEndpoints(results);
+    if (candidates.empty()) {
+        ec = boost::asio::error::host_not_found;
+        return nullptr;
+    }
+
+    std::vector<std::unique_ptr<tcp::socket>> sockets(candidates.size());
+    size_t nextCandidate = 0;
+    size_t pending = 0;
+    int winner = -1;
+    bool timedOut = false;
+    boost::system::error_code lastError = boost::asio::error::host_unreachable;
+
+    boost::asio::steady_timer attemptTimer(ioContext);
+    boost::asio::steady_timer deadline(ioContext);
+
+    auto closeAllExcept = [&](int keep) {
+        for (size_t i = 0; i < sockets.size(); i++) {
+            if (sockets[i] && static_cast<int>(i) != keep) {
+                boost::system::error_code ignored;
+                sockets[i]->close(ignored);
+            }
+        }
+    };
+
+    std::function<void()> startNext = [&]() {
+        while (winner < 0 && !timedOut && nextCandidate < candidates.size()) {
+            size_t index = nextCandidate++;
+            const tcp::endpoint& endpoint = candidates[index];
+
+            sockets[index].reset(new tcp::socket(ioContext));
+            boost::system::error_code openError;
+            sockets[index]->open(endpoint.protocol(), openError);
+            if (openError) {
+                lastError = openError;
+                continue;  // Try the next candidate right away
+            }
+
+            // Fast Open completes the connect before the handshake, so only use it when there is nothing to race
+            bool trusted = candidates.size() == 1 || (hasPreferredEndpoint && endpoint == preferredEndpoint);
+            bool fastOpen = options.tcpFastOpen && trusted && enableFastOpen(*sockets[index]);
+
+            pending++;
+            sockets[index]->async_connect(endpoint, [&, index, fastOpen](const boost::system::error_code& result) {
+                pending--;
+                if (winner >= 0 || timedOut) {
+                    return;  // Lost the race; closed by the winner or the deadline
+                }
+                if (!result) {
+                    winner = static_cast<int>(index);
+                    usedFastOpen = fastOpen;
+                    attemptTimer.cancel();
+                    deadline.cancel();
+                    closeAllExcept(winner);
+                    return;
+                }
+                lastError = result;
+                if (nextCandidate < candidates.size()) {
+                    startNext();  // Don't wait out the attempt delay after a failure
+                } else if (pending == 0) {
+                    deadline.cancel();  // Every candidate failed
+                }
+            });
+
+            // Give this attempt a head start before racing the next candidate
+            if (nextCandidate < candidates.size()) {
+                attemptTimer.expires_after(options.attemptDelay);
+                attemptTimer.async_wait([&](const boost::system::error_code& timerError) {
+                    if (!timerError) {
+                        startNext();
+                    }
+                });
+            }
+            return;
+        }
+        if (winner < 0 && pending == 0) {
+            deadline.cancel();  // Nothing could even be opened
+        }
+    };
+
+    deadline.expires_after(options.connectTimeout);
+    deadline.async_wait([&](const boost::system::error_code& timerError) {
+        if (!timerError && winner < 0) {
+            timedOut = true;
+            attemptTimer.cancel();
+            closeAllExcept(-1);
+        }
+    });
+
+    ioContext.restart();
+    startNext();
+    ioContext.run();  // Returns once the race is decided and every handler has completed
+
+    if (winner < 0) {
+        ec = timedOut ? boost::system::error_code(boost::asio::error::timed_out) : lastError;
+        return nullptr;
+    }
+
+    std::unique_ptr<tcp::socket> socket = std::move(sockets[winner]);
+    if (options.noDelay) {
+        boost::system::error_code ignored;
+        socket->set_option(tcp::no_delay(true), ignored);
+    }
+
+    preferredEndpoint = candidates[winner];
+    hasPreferredEndpoint = true;
+    if (!usedFastOpen) {
+        // A Fast Open connect returns before the handshake, so its time says nothing about latency
+        stats.record(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    ec = boost::system::error_code();
+    return socket;
+}
@@ -0,0 +1,352 @@
+#include "../../include/client/FileSource.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <limits>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+#ifdef MADV_HUGEPAGE
+constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+#endif
+
+#ifndef _WIN32
+// Largest page cache folio we expect to straddle a drop boundary (PMD size on x86-64)
+constexpr uint64_t FOLIO_LOOKBEHIND = 2 * 1024 * 1024;
+#endif
+
+size_t pageSize() {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwPageSize;
+#else
+    long size = sysconf(_SC_PAGESIZE);
+    return size > 0 ? static_cast<size_t>(size) : 4096;
+#endif
+}
+
+#ifdef _WIN32
+std::string lastErrorMessage(const std::string& operation) {
+    return operation + " failed (error " + std::to_string(GetLastError()) + ")";
+}
+#else
+std::string lastErrorMessage(const std::string& operation) {
+    return operation + " failed: " + std::strerror(errno);
+}
+#endif
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// PageCacheTracker
+
+PageCacheTracker::PageCacheTracker()
+    : fileSize(0), cursor(0), dropped(0), preserved(0), pageBytes(pageSize()) {
+}
+
+void PageCacheTracker::reset() {
+    residentPages.clear();
+    fileSize = 0;
+    cursor = 0;
+    dropped = 0;
+    preserved = 0;
+}
+
+bool PageCacheTracker::wasResident(uint64_t pageIndex) const {
+    size_t word = static_cast<size_t>(pageIndex / 64);
+    return word < residentPages.size() && (residentPages[word] >> (pageIndex % 64)) & 1;
+}
+
+#ifdef _WIN32
+
+bool PageCacheTracker::snapshot(int, uint64_t size) {
+    reset();
+    fileSize = size;
+    return false;
+}
+
+void PageCacheTracker::dropBefore(int, uint64_t) {
+}
+
+#else
+
+bool PageCacheTracker::snapshot(int fd, uint64_t size) {
+    reset();
+    fileSize = size;
+    uint64_t pages = (size + pageBytes - 1) / pageBytes;
+    residentPages.assign(static_cast<size_t>((pages + 63) / 64), 0);
+
+    // mincore() needs a mapping; map a window at a time without touching the pages
+    const uint64_t window = 256ULL * 1024 * 1024;
+    std::vector<unsigned char> residency(static_cast<size_t>(window / pageBytes));
+    for (uint64_t offset = 0; offset < size; offset += window) {
+        size_t bytes = static_cast<size_t>(std::min(window, size - offset));
+        void* mapping = mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, static_cast<off_t>(offset));
+        if (mapping == MAP_FAILED) {
+            residentPages.clear();
+            return false;
+        }
+        int result = mincore(mapping, bytes, residency.data());
+        munmap(mapping, bytes);
+        if (result != 0) {
+            residentPages.clear();
+            return false;
+        }
+        uint64_t first = offset / pageBytes;
+        for (size_t i = 0; i < (bytes + pageBytes - 1) / pageBytes; i++) {
+            if (residency[i] & 1) {
+                residentPages[static_cast<size_t>((first + i) / 64)] |= 1ULL << ((first + i) % 64);
+            }
+        }
+    }
+    return true;
+}
+
+void PageCacheTracker::dropBefore(int fd, uint64_t offset) {
+    // Only whole pages: the page holding offset is still being read unless we are at the end
+    uint64_t end = offset >= fileSize ? fileSize : offset - offset % pageBytes;
+    if (end <= cursor) {
+        return;
+    }
+
+    // The kernel only evicts folios that lie entirely inside the advised range, so a large
+    // folio straddling the previous cursor would survive both calls. Reach back over the
+    // pages dropped last time (re-advising evicted pages costs nothing).
+    uint64_t runStart = cursor;
+    while (runStart > 0 && cursor - runStart < FOLIO_LOOKBEHIND && !wasResident((runStart - 1) / pageBytes)) {
+        runStart -= pageBytes;
+    }
+    
+    // Evict runs of pages that were not cached before the backup started
+    for (uint64_t position = cursor; position < end; position += pageBytes) {
+        uint64_t pageEnd = std::min(position + pageBytes, end);
+        if (!wasResident(position / pageBytes)) {
+            dropped += pageEnd - position;
+            continue;
+        }
+        if (position > runStart) {
+            posix_fadvise(fd, static_cast<off_t>(runStart), static_cast<off_t>(position - runStart), POSIX_FADV_DONTNEED);
+        }
+        preserved += pageEnd - position;
+        runStart = pageEnd;
+    }
+    if (end > runStart) {
+        posix_fadvise(fd, static_cast<off_t>(runStart), static_cast<off_t>(end - runStart), POSIX_FADV_DONTNEED);
+    }
+    cursor = end;
+}
+
+#endif
+
+// ---------------------------------------------------------------------------
+// MappedFile
+
+MappedFile::MappedFile()
+    : base(nullptr), length(0), released(0), releaseWindow(0), opened(false), dropBehind(false)
+#ifdef _WIN32
+      , fileHandle(INVALID_HANDLE_VALUE), mappingHandle(nullptr)
+#else
+      , descriptor(-1)
+#endif
+{
+}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+bool MappedFile::open(const std::string& path, const MappedFileOptions& options, std::string& error) {
+    close();
+    releaseWindow = std::max(options.releaseWindow, pageSize());
+    dropBehind = options.dropBehind;
+
+#ifdef _WIN32
+    DWORD flags = options.sequential ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_ATTRIBUTE_NORMAL;
+    fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, flags, nullptr);
+    if (fileHandle == INVALID_HANDLE_VALUE) {
+        error = lastErrorMessage("CreateFile");
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(fileHandle, &fileSize)) {
+        error = lastErrorMessage("GetFileSizeEx");
+        close();
+        return false;
+    }
+    if (static_cast<unsigned long long>(fileSize.QuadPart) > std::numeric_limits<size_t>::max()) {
+        error = "File is too large to map";
+        close();
+        return false;
+    }
+    length = static_cast<size_t>(fileSize.QuadPart);
+
+    if (length > 0) {
+        // CreateFileMapping rejects empty files, so only map when there is something to read
+        mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mappingHandle) {
+            error = lastErrorMessage("CreateFileMapping");
+            close();
+            return false;
+        }
+        base = static_cast<const uint8_t*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+        if (!base) {
+            error = lastErrorMessage("MapViewOfFile");
+            close();
+            return false;
+        }
+    }
+#else
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        error = lastErrorMessage("open");
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        error = lastErrorMessage("fstat");
+        ::close(fd);
+        return false;
+    }
+    if (!S_ISREG(info.st_mode)) {
+        error = "Not a regular file";
+        ::close(fd);
+        return false;
+    }
+    if (static_cast<unsigned long long>(info.st_size) > std::numeric_limits<size_t>::max()) {
+        error = "File is too large to map";
+        ::close(fd);
+        return false;
+    }
+    length = static_cast<size_t>(info.st_size);
+
+    // Residency has to be recorded before the mapping (or MAP_POPULATE) pulls pages in
+    if (dropBehind) {
+        cache.snapshot(fd, length);
+    }
+
+    if (length > 0) {
+        int flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+        if (options.populate) {
+            flags |= MAP_POPULATE;
+        }
+#endif
+        void* mapping = mmap(nullptr, length, PROT_READ, flags, fd, 0);
+        if (mapping == MAP_FAILED) {
+            error = lastErrorMessage("mmap");
+            ::close(fd);
+            length = 0;
+            return false;
+        }
+        base = static_cast<const uint8_t*>(mapping);
+
+        // Advice is best effort; a filesystem that ignores it still reads correctly
+        if (options.sequential) {
+            madvise(mapping, length, MADV_SEQUENTIAL);
+        }
+#ifdef MADV_HUGEPAGE
+        if (length >= HUGE_PAGE_SIZE) {
+            madvise(mapping, length, MADV_HUGEPAGE);
+        }
+#endif
+    }
+    if (dropBehind) {
+        descriptor = fd;  // Needed for posix_fadvise behind the cursor
+    } else {
+        ::close(fd);      // The mapping keeps its own reference to the file
+    }
+#endif
+
+    opened = true;
+    return true;
+}
+
+void MappedFile::close() {
+#ifdef _WIN32
+    if (base) {
+        UnmapViewOfFile(base);
+    }
+    if (mappingHandle) {
+        CloseHandle(mappingHandle);
+        mappingHandle = nullptr;
+    }
+    if (fileHandle != INVALID_HANDLE_VALUE) {
+        CloseHandle(fileHandle);
+        fileHandle = INVALID_HANDLE_VALUE;
+    }
+#else
+    if (base) {
+        munmap(const_cast<uint8_t*>(base), length);
+    }
+    if (descriptor >= 0) {
+        ::close(descriptor);
+        descriptor = -1;
+    }
+#endif
+    base = nullptr;
+    length = 0;
+    released = 0;
+    opened = false;
+    cache.reset();
+}
+
+void MappedFile::releaseBefore(size_t offset) {
+    if (!base) {
+        return;
+    }
+
+    // Release whole pages in windows of releaseWindow bytes; the final call releases the tail
+    size_t end;
+    if (offset >= length) {
+        end = length;
+    } else {
+        end = offset - offset % pageSize();
+        if (end < released + releaseWindow) {
+            return;
+        }
+    }
+    if (end <= released) {
+        return;
+    }
+
+#ifdef _WIN32
+    // Unlocking pages that are not locked removes them from the working set
+    VirtualUnlock(const_cast<uint8_t*>(base) + released, end - released);
+#else
+    // Unmap first: posix_fadvise cannot evict pages that are still mapped
+    madvise(const_cast<uint8_t*>(base) + released, end - released, MADV_DONTNEED);
+    if (dropBehind && descriptor >= 0) {
+        cache.dropBefore(descriptor, end);
+    }
+#endif
+    released = end;
+}
+
+bool MappedFile::fileSize(const std::string& path, uint64_t& size) {
+#ifdef _WIN32
+    WIN32_FILE_ATTRIBUTE_DATA attributes;
+    if (!GetFileAttributesExA(path.c_str(), GetFileExInfoStandard, &attributes) ||
+        (attributes.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)) {
+        return false;
+    }
+    size = (static_cast<uint64_t>(attributes.nFileSizeHigh) << 32) | attributes.nFileSizeLow;
+#else
+    struct stat info;
+    if (stat(path.c_str(), &info) != 0 || !S_ISREG(info.st_mode)) {
+        return false;
+    }
+    size = static_cast<uint64_t>(info.st_size);
+#endif
+    return true;
+}
@@ -0,0 +1,56 @@
+#include "../../include/client/Framing.h"
+#include "../../include/wrappers/AESWrapper.h"
+
+#include <algorithm>
+#include <cstring>
+
+void Framing::encodeRequestHeader(const uint8_t* clientId, uint16_t code, uint32_t payloadSize, uint8_t* out) {
+    std::memcpy(out, clientId, CLIENT_ID_SIZE);
+    out[16] = PROTOCOL_VERSION;
+    writeLE(out + 17, code, 2);
+    writeLE(out + 19, payloadSize, 4);
+}
+
+bool Framing::decodeResponseHeader(const uint8_t* in, uint16_t& code, uint32_t& payloadSize) {
+    code = static_cast<uint16_t>(readLE(in + 1, 2));
+    payloadSize = readLE(in + 3, 4);
+    return in[0] == PROTOCOL_VERSION;
+}
+
+void Framing::encodeFilePacketHeader(const std::string& filename, uint32_t encryptedSize, uint32_t originalSize,
+                                     uint16_t packet, uint16_t totalPackets, uint8_t* out) {
+    writeLE(out, encryptedSize, 4);
+    writeLE(out + 4, originalSize, 4);
+    writeLE(out + 8, packet, 2);
+    writeLE(out + 10, totalPackets, 2);
+    std::memset(out + 12, 0, MAX_FILENAME_SIZE);
+    std::memcpy(out + 12, filename.data(), std::min(filename.size(), MAX_FILENAME_SIZE));
+}
+
+void Framing::gcmNonce(uint32_t sequence, uint16_t packet, uint8_t* nonce) {
+    std::memset(nonce, 0, AESWrapper::GCM_NONCE_SIZE);
+    writeLE(nonce, sequence, 4);
+    writeLE(nonce + 4, packet, 2);
+}
+
+void Framing::gcmAad(const uint8_t* filePacketHeader, uint8_t* aad) {
+    std::memcpy(aad, filePacketHeader + 4, 8);
+    std::memcpy(aad + 8, filePacketHeader + 12, MAX_FILENAME_SIZE);
+}
+
+size_t Framing::buildGCMFrame(const AESWrapper& aes, const uint8_t* clientId, uint32_t sequence,
+                              const std::string& filename, uint16_t packet, uint16_t totalPackets, uint32_t originalSize,
+                              const uint8_t* plaintext, size_t length, uint8_t* out) {
+    const uint32_t encryptedSize = static_cast<uint32_t>(length + AESWrapper::GCM_NONCE_SIZE + AESWrapper::GCM_TAG_SIZE);
+    encodeRequestHeader(clientId, REQ_SEND_FILE, static_cast<uint32_t>(FILE_PACKET_HEADER_SIZE + encryptedSize), out);
+    uint8_t* fileHeader = out + REQUEST_HEADER_SIZE;
+    encodeFilePacketHeader(filename, encryptedSize, originalSize, packet, totalPackets, fileHeader);
+
+    uint8_t aad[GCM_AAD_SIZE];
+    gcmAad(fileHeader, aad);
+    uint8_t* content = fileHeader + FILE_PACKET_HEADER_SIZE;
+    gcmNonce(sequence, packet, content);
+    aes.encryptGCM(content, aad, sizeof(aad), reinterpret_cast<const char*>(plaintext), length,
+                   content + AESWrapper::GCM_NONCE_SIZE);
+    return REQUEST_HEADER_SIZE + FILE_PACKET_HEADER_SIZE + encryptedSize;
+}
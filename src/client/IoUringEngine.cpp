@@ -0,0 +1,457 @@
+#include "../../include/client/IoUringEngine.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef CLIENT_HAVE_IO_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+#ifdef CLIENT_HAVE_IO_URING
+// Completions of linked timeouts and sends are consumed internally; a send's SQE carries
+// SEND_USER_DATA | fixed file index, and the caller's userData is reported once it is done
+constexpr uint64_t TIMEOUT_USER_DATA = ~0ULL;
+constexpr uint64_t SEND_USER_DATA = 0xFFFFFFFE00000000ULL;
+
+std::string systemError(const std::string& operation, int error) {
+    return operation + " failed: " + std::strerror(error);
+}
+
+int ioUringSetup(unsigned entries, io_uring_params* params) {
+    return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+int ioUringEnter(int fd, unsigned toSubmit, unsigned minComplete, unsigned flags) {
+    return static_cast<int>(syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, nullptr, 0));
+}
+
+int ioUringRegister(int fd, unsigned opcode, const void* arg, unsigned count) {
+    return static_cast<int>(syscall(__NR_io_uring_register, fd, opcode, arg, count));
+}
+
+// Every opcode the transfer pipeline issues (READ_FIXED/READ, SEND, LINK_TIMEOUT: 5.6+)
+bool supportsRequiredOpcodes(int fd) {
+    const unsigned opcodeCount = 64;
+    size_t size = sizeof(io_uring_probe) + opcodeCount * sizeof(io_uring_probe_op);
+    std::vector<uint8_t> storage(size, 0);
+    io_uring_probe* probe = reinterpret_cast<io_uring_probe*>(storage.data());
+    if (ioUringRegister(fd, IORING_REGISTER_PROBE, probe, opcodeCount) < 0) {
+        return false;  // Probing itself is 5.6+
+    }
+    const unsigned required[] = {IORING_OP_READ_FIXED, IORING_OP_READ, IORING_OP_SEND, IORING_OP_LINK_TIMEOUT};
+    for (unsigned opcode : required) {
+        if (opcode > probe->last_op || !(probe->ops[opcode].flags & IO_URING_OP_SUPPORTED)) {
+            return false;
+        }
+    }
+    return true;
+}
+#endif
+
+} // namespace
+
+IoUringEngine::IoUringEngine()
+    : ringFd(-1), entryCount(0), fixedBuffers(false), filesRegistered(false),
+      sqRing(nullptr), sqRingSize(0), cqRing(nullptr), cqRingSize(0), sqeArea(nullptr), sqeAreaSize(0),
+      sqHead(nullptr), sqTail(nullptr), sqMask(nullptr), sqArray(nullptr),
+      cqHead(nullptr), cqTail(nullptr), cqMask(nullptr), cqes(nullptr), localTail(0),
+      bufferBlock(nullptr), bufferBytes(0), enters(0), submitted(0), resubmits(0) {
+}
+
+IoUringEngine::~IoUringEngine() {
+    shutdown();
+}
+
+uint8_t* IoUringEngine::buffer(unsigned index) const {
+    return index < buffers.size() ? buffers[index] : nullptr;
+}
+
+#ifdef CLIENT_HAVE_IO_URING
+
+bool IoUringEngine::init(unsigned entries, unsigned bufferCount, size_t bufferSize, std::string& error) {
+    shutdown();
+
+    io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+    int fd = ioUringSetup(entries, &params);
+    if (fd < 0) {
+        error = systemError("io_uring_setup", errno);
+        return false;
+    }
+    ringFd = fd;
+    entryCount = params.sq_entries;
+
+    if (!supportsRequiredOpcodes(ringFd)) {
+        error = "kernel io_uring lacks READ_FIXED/SEND/LINK_TIMEOUT (needs Linux 5.6+)";
+        shutdown();
+        return false;
+    }
+
+    // Map the submission and completion rings (one mapping when the kernel allows it)
+    sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    bool singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (singleMap) {
+        sqRingSize = cqRingSize = std::max(sqRingSize, cqRingSize);
+    }
+    sqRing = mmap(nullptr, sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQ_RING);
+    if (sqRing == MAP_FAILED) {
+        sqRing = nullptr;
+        error = systemError("mmap(SQ ring)", errno);
+        shutdown();
+        return false;
+    }
+    if (singleMap) {
+        cqRing = sqRing;
+    } else {
+        cqRing = mmap(nullptr, cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_CQ_RING);
+        if (cqRing == MAP_FAILED) {
+            cqRing = nullptr;
+            error = systemError("mmap(CQ ring)", errno);
+            shutdown();
+            return false;
+        }
+    }
+    sqeAreaSize = params.sq_entries * sizeof(io_uring_sqe);
+    sqeArea = mmap(nullptr, sqeAreaSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQES);
+    if (sqeArea == MAP_FAILED) {
+        sqeArea = nullptr;
+        error = systemError("mmap(SQEs)", errno);
+        shutdown();
+        return false;
+    }
+
+    uint8_t* sq = static_cast<uint8_t*>(sqRing);
+    sqHead = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+    sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    sqMask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+    uint8_t* cq = static_cast<uint8_t*>(cqRing);
+    cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    cqMask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+    cqes = cq + params.cq_off.cqes;
+    localTail = *sqTail;
+    timeouts.assign(static_cast<size_t>(entryCount) * 2, 0);
+
+    // Buffers: one page-aligned block, each buffer rounded up to whole pages
+    const size_t page = 4096;
+    bufferBytes = bufferSize;
+    size_t stride = (bufferSize + page - 1) / page * page;
+    void* block = nullptr;
+    if (bufferCount > 0) {
+        if (posix_memalign(&block, page, stride * bufferCount) != 0) {
+            error = "Failed to allocate I/O buffers";
+            shutdown();
+            return false;
+        }
+    }
+    bufferBlock = static_cast<uint8_t*>(block);
+    std::vector<iovec> vectors(bufferCount);
+    for (unsigned i = 0; i < bufferCount; i++) {
+        buffers.push_back(bufferBlock + i * stride);
+        vectors[i].iov_base = buffers[i];
+        vectors[i].iov_len = stride;
+    }
+
+    // Pinning can fail under a small RLIMIT_MEMLOCK; the buffers still work with plain READ
+    fixedBuffers = bufferCount > 0 &&
+                   ioUringRegister(ringFd, IORING_REGISTER_BUFFERS, vectors.data(), bufferCount) == 0;
+    return true;
+}
+
+void IoUringEngine::shutdown() {
+    if (ringFd >= 0) {
+        close(ringFd);  // Also drops registered buffers and files
+        ringFd = -1;
+    }
+    if (sqeArea) {
+        munmap(sqeArea, sqeAreaSize);
+    }
+    if (cqRing && cqRing != sqRing) {
+        munmap(cqRing, cqRingSize);
+    }
+    if (sqRing) {
+        munmap(sqRing, sqRingSize);
+    }
+    sqRing = cqRing = sqeArea = cqes = nullptr;
+    sqHead = sqTail = sqMask = sqArray = cqHead = cqTail = cqMask = nullptr;
+    sqRingSize = cqRingSize = sqeAreaSize = 0;
+    std::free(bufferBlock);
+    bufferBlock = nullptr;
+    buffers.clear();
+    timeouts.clear();
+    sendStreams.clear();
+    readyCompletions.clear();
+    fixedBuffers = false;
+    filesRegistered = false;
+    entryCount = 0;
+}
+
+bool IoUringEngine::registerFiles(const std::vector<int>& fds, std::string& error) {
+    if (!isReady()) {
+        error = "io_uring is not initialised";
+        return false;
+    }
+    unregisterFiles();
+    if (ioUringRegister(ringFd, IORING_REGISTER_FILES, fds.data(), static_cast<unsigned>(fds.size())) < 0) {
+        error = systemError("IORING_REGISTER_FILES", errno);
+        return false;
+    }
+    filesRegistered = true;
+    return true;
+}
+
+void IoUringEngine::unregisterFiles() {
+    if (filesRegistered) {
+        ioUringRegister(ringFd, IORING_UNREGISTER_FILES, nullptr, 0);
+        filesRegistered = false;
+    }
+}
+
+unsigned IoUringEngine::queued() const {
+    return sqTail ? localTail - __atomic_load_n(sqTail, __ATOMIC_RELAXED) : 0;
+}
+
+void* IoUringEngine::nextEntry() {
+    if (!isReady() || localTail - __atomic_load_n(sqHead, __ATOMIC_ACQUIRE) >= entryCount) {
+        return nullptr;
+    }
+    unsigned index = localTail & *sqMask;
+    io_uring_sqe* sqe = static_cast<io_uring_sqe*>(sqeArea) + index;
+    std::memset(sqe, 0, sizeof(*sqe));
+    sqArray[index] = index;
+    localTail++;
+    return sqe;
+}
+
+bool IoUringEngine::queueRead(unsigned fileIndex, unsigned bufferIndex, size_t bufferOffset, size_t length,
+                              uint64_t fileOffset, uint64_t userData) {
+    if (bufferIndex >= buffers.size() || bufferOffset + length > bufferBytes) {
+        return false;
+    }
+    io_uring_sqe* sqe = static_cast<io_uring_sqe*>(nextEntry());
+    if (!sqe) {
+        return false;
+    }
+    sqe->opcode = fixedBuffers ? IORING_OP_READ_FIXED : IORING_OP_READ;
+    sqe->flags = IOSQE_FIXED_FILE;
+    sqe->fd = static_cast<int>(fileIndex);
+    sqe->addr = reinterpret_cast<uint64_t>(buffers[bufferIndex] + bufferOffset);
+    sqe->len = static_cast<uint32_t>(length);
+    sqe->off = fileOffset;
+    sqe->buf_index = static_cast<uint16_t>(bufferIndex);
+    sqe->user_data = userData;
+    return true;
+}
+
+bool IoUringEngine::queueSend(unsigned fileIndex, const uint8_t* data, size_t length, uint64_t userData,
+                              std::chrono::milliseconds timeout) {
+    if (!isReady() || length == 0) {
+        return false;
+    }
+    std::deque<PendingSend>& stream = sendStreams[fileIndex];
+    stream.push_back(PendingSend{data, length, 0, userData, timeout, false});
+    if (stream.size() == 1 && !issueSend(fileIndex)) {
+        stream.pop_back();
+        return false;
+    }
+    return true;
+}
+
+bool IoUringEngine::issueSend(unsigned fileIndex) {
+    PendingSend& send = sendStreams[fileIndex].front();
+
+    // A linked timeout needs a second slot right behind the send
+    unsigned slotsNeeded = send.timeout.count() > 0 ? 2 : 1;
+    if (localTail + slotsNeeded - __atomic_load_n(sqHead, __ATOMIC_ACQUIRE) > entryCount) {
+        return false;
+    }
+
+    io_uring_sqe* sqe = static_cast<io_uring_sqe*>(nextEntry());
+    sqe->opcode = IORING_OP_SEND;
+    sqe->flags = IOSQE_FIXED_FILE;
+    sqe->fd = static_cast<int>(fileIndex);
+    sqe->addr = reinterpret_cast<uint64_t>(send.data + send.sent);
+    sqe->len = static_cast<uint32_t>(send.length - send.sent);
+    sqe->msg_flags = MSG_NOSIGNAL | MSG_WAITALL;   // 5.19+ finishes a short send itself
+    sqe->user_data = SEND_USER_DATA | fileIndex;
+
+    if (slotsNeeded == 2) {
+        sqe->flags |= IOSQE_IO_LINK;
+        unsigned slot = localTail & *sqMask;
+        io_uring_sqe* timer = static_cast<io_uring_sqe*>(nextEntry());
+        __kernel_timespec* spec = reinterpret_cast<__kernel_timespec*>(&timeouts[static_cast<size_t>(slot) * 2]);
+        spec->tv_sec = send.timeout.count() / 1000;
+        spec->tv_nsec = (send.timeout.count() % 1000) * 1000000;
+        timer->opcode = IORING_OP_LINK_TIMEOUT;
+        timer->fd = -1;
+        timer->addr = reinterpret_cast<uint64_t>(spec);
+        timer->len = 1;
+        timer->user_data = TIMEOUT_USER_DATA;
+    }
+    send.inKernel = true;
+    return true;
+}
+
+// Sends that found the submission queue full when their turn came
+void IoUringEngine::issueWaitingSends() {
+    for (auto& stream : sendStreams) {
+        if (!stream.second.empty() && !stream.second.front().inKernel) {
+            issueSend(stream.first);
+        }
+    }
+}
+
+bool IoUringEngine::submitPending(unsigned waitFor, std::string& error) {
+    issueWaitingSends();
+    unsigned toSubmit = queued();
+    __atomic_store_n(sqTail, localTail, __ATOMIC_RELEASE);
+
+    while (toSubmit > 0 || waitFor > 0) {
+        int result = ioUringEnter(ringFd, toSubmit, waitFor, waitFor > 0 ? IORING_ENTER_GETEVENTS : 0);
+        enters++;
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            error = systemError("io_uring_enter", errno);
+            return false;
+        }
+        submitted += static_cast<unsigned>(result);
+        toSubmit -= std::min<unsigned>(toSubmit, static_cast<unsigned>(result));
+        if (toSubmit == 0) {
+            break;  // The kernel waited for waitFor completions before returning
+        }
+    }
+    return true;
+}
+
+bool IoUringEngine::submit(unsigned waitFor, std::string& error) {
+    if (!isReady()) {
+        error = "io_uring is not initialised";
+        return false;
+    }
+    return submitPending(waitFor, error);
+}
+
+bool IoUringEngine::nextCompletion(IoUringCompletion& completion) {
+    if (!readyCompletions.empty()) {
+        completion = readyCompletions.front();
+        readyCompletions.pop_front();
+        return true;
+    }
+    while (cqHead) {
+        unsigned head = *cqHead;
+        if (head == __atomic_load_n(cqTail, __ATOMIC_ACQUIRE)) {
+            return false;
+        }
+        const io_uring_cqe* cqe = static_cast<const io_uring_cqe*>(cqes) + (head & *cqMask);
+        uint64_t userData = cqe->user_data;
+        int32_t result = cqe->res;
+        __atomic_store_n(cqHead, head + 1, __ATOMIC_RELEASE);
+        if (userData == TIMEOUT_USER_DATA) {
+            continue;
+        }
+        if ((userData & ~0xFFFFFFFFULL) != SEND_USER_DATA) {
+            completion.userData = userData;
+            completion.result = result;
+            return true;
+        }
+
+        unsigned fileIndex = static_cast<unsigned>(userData & 0xFFFFFFFF);
+        std::deque<PendingSend>& stream = sendStreams[fileIndex];
+        PendingSend send = stream.front();
+        stream.pop_front();
+        if (result > 0 && send.sent + result < send.length) {
+            // Short send: the remainder goes out before anything queued behind it
+            send.sent += static_cast<size_t>(result);
+            send.inKernel = false;
+            stream.push_front(send);
+            resubmits++;
+            issueSend(fileIndex);
+            continue;
+        }
+        completion.userData = send.userData;
+        if (result > 0) {
+            completion.result = static_cast<int32_t>(send.length);
+            if (!stream.empty()) {
+                issueSend(fileIndex);
+            }
+        } else {
+            // The stream has a gap now: nothing queued behind the failed send may follow it
+            completion.result = result < 0 ? result : -EPIPE;
+            for (const PendingSend& behind : stream) {
+                readyCompletions.push_back(IoUringCompletion{behind.userData, -ECANCELED});
+            }
+            stream.clear();
+        }
+        return true;
+    }
+    return false;
+}
+
+#else // !CLIENT_HAVE_IO_URING
+
+bool IoUringEngine::init(unsigned, unsigned, size_t, std::string& error) {
+    error = "io_uring is not available on this platform";
+    return false;
+}
+
+void IoUringEngine::shutdown() {
+}
+
+bool IoUringEngine::registerFiles(const std::vector<int>&, std::string& error) {
+    error = "io_uring is not available on this platform";
+    return false;
+}
+
+void IoUringEngine::unregisterFiles() {
+}
+
+unsigned IoUringEngine::queued() const {
+    return 0;
+}
+
+void* IoUringEngine::nextEntry() {
+    return nullptr;
+}
+
+bool IoUringEngine::queueRead(unsigned, unsigned, size_t, size_t, uint64_t, uint64_t) {
+    return false;
+}
+
+bool IoUringEngine::queueSend(unsigned, const uint8_t*, size_t, uint64_t, std::chrono::milliseconds) {
+    return false;
+}
+
+bool IoUringEngine::issueSend(unsigned) {
+    return false;
+}
+
+void IoUringEngine::issueWaitingSends() {
+}
+
+bool IoUringEngine::submitPending(unsigned, std::string& error) {
+    error = "io_uring is not available on this platform";
+    return false;
+}
+
+bool IoUringEngine::submit(unsigned waitFor, std::string& error) {
+    return submitPending(waitFor, error);
+}
+
+bool IoUringEngine::nextCompletion(IoUringCompletion&) {
+    return false;
+}
+
+#endif // CLIENT_HAVE_IO_URING
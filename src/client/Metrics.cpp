@@ -0,0 +1,218 @@
+#include "../../include/client/Metrics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#endif
+
+namespace {
+
+constexpr int FIRST_EXPORTED_POWER = 4;    // 16us
+constexpr int LAST_EXPORTED_POWER = 27;    // ~134s
+
+// Exact decimal seconds: 1024us -> "0.001024"
+std::string seconds(uint64_t micros) {
+    std::ostringstream text;
+    text << micros / 1000000;
+    uint64_t fraction = micros % 1000000;
+    if (fraction != 0) {
+        std::string digits = std::to_string(1000000 + fraction).substr(1);
+        text << "." << digits.substr(0, digits.find_last_not_of('0') + 1);
+    }
+    return text.str();
+}
+
+std::string withLabel(const std::string& labels, const std::string& extra) {
+    if (labels.empty()) {
+        return "{" + extra + "}";
+    }
+    return "{" + labels + "," + extra + "}";
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// MetricHistogram
+
+// Buckets are laid out over micros - 1, which closes each one at the top: (1024, 1088]
+// rather than [1024, 1088), so a power of two is the last value of its bucket
+size_t MetricHistogram::bucketOf(uint64_t micros) {
+    uint64_t offset = micros == 0 ? 0 : micros - 1;
+    if (offset < SUB_BUCKETS) {
+        return static_cast<size_t>(offset);
+    }
+    int msb = 63;
+    while (!(offset >> msb)) {
+        msb--;
+    }
+    int shift = msb - 4;   // offset >> shift is in [16, 32)
+    return SUB_BUCKETS + static_cast<size_t>(shift) * SUB_BUCKETS + static_cast<size_t>((offset >> shift) - SUB_BUCKETS);
+}
+
+uint64_t MetricHistogram::bucketLimit(size_t bucket) {
+    if (bucket < SUB_BUCKETS) {
+        return bucket + 1;
+    }
+    size_t shift = (bucket - SUB_BUCKETS) / SUB_BUCKETS;
+    uint64_t sub = (bucket - SUB_BUCKETS) % SUB_BUCKETS + SUB_BUCKETS;
+    uint64_t last = ((sub + 1) << shift) - 1;
+    return last == UINT64_MAX ? last : last + 1;
+}
+
+MetricHistogram& MetricHistogram::operator=(const MetricHistogram& other) {
+    if (this != &other) {
+        for (size_t i = 0; i < BUCKETS; i++) {
+            buckets[i].store(other.buckets[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+        total.store(other.count(), std::memory_order_relaxed);
+        sum.store(other.sumMicros(), std::memory_order_relaxed);
+        maximum.store(other.max(), std::memory_order_relaxed);
+    }
+    return *this;
+}
+
+void MetricHistogram::observe(uint64_t micros) {
+    buckets[bucketOf(micros)].fetch_add(1, std::memory_order_relaxed);
+    total.fetch_add(1, std::memory_order_relaxed);
+    sum.fetch_add(micros, std::memory_order_relaxed);
+    uint64_t largest = maximum.load(std::memory_order_relaxed);
+    while (micros > largest && !maximum.compare_exchange_weak(largest, micros, std::memory_order_relaxed)) {
+    }
+}
+
+void MetricHistogram::merge(const MetricHistogram& other) {
+    for (size_t i = 0; i < BUCKETS; i++) {
+        buckets[i].fetch_add(other.buckets[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+    total.fetch_add(other.count(), std::memory_order_relaxed);
+    sum.fetch_add(other.sumMicros(), std::memory_order_relaxed);
+    uint64_t largest = maximum.load(std::memory_order_relaxed);
+    uint64_t theirs = other.max();
+    while (theirs > largest && !maximum.compare_exchange_weak(largest, theirs, std::memory_order_relaxed)) {
+    }
+}
+
+uint64_t MetricHistogram::countAtMost(uint64_t micros) const {
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKETS && bucketLimit(i) <= micros; i++) {
+        seen += buckets[i].load(std::memory_order_relaxed);
+    }
+    return seen;
+}
+
+uint64_t MetricHistogram::percentile(double percent) const {
+    uint64_t observed = count();
+    if (observed == 0) {
+        return 0;
+    }
+    uint64_t rank = std::max<uint64_t>(static_cast<uint64_t>(std::ceil(percent / 100.0 * observed)), 1);
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKETS; i++) {
+        seen += buckets[i].load(std::memory_order_relaxed);
+        if (seen >= rank) {
+            return std::min(bucketLimit(i), max());
+        }
+    }
+    return max();
+}
+
+// ---------------------------------------------------------------------------
+// MetricsRegistry
+
+MetricsRegistry::Entry& MetricsRegistry::find(const std::string& name, const std::string& help,
+                                              const std::string& labels, bool histogram) {
+    std::lock_guard<std::mutex> guard(lock);
+    for (auto& entry : entries) {
+        if (entry->name == name && entry->labels == labels && static_cast<bool>(entry->histogram) == histogram) {
+            return *entry;
+        }
+    }
+    std::unique_ptr<Entry> entry(new Entry);
+    entry->name = name;
+    entry->help = help;
+    entry->labels = labels;
+    if (histogram) {
+        entry->histogram.reset(new MetricHistogram);
+    } else {
+        entry->counter.reset(new MetricCounter);
+    }
+    entries.push_back(std::move(entry));
+    return *entries.back();
+}
+
+MetricCounter& MetricsRegistry::counter(const std::string& name, const std::string& help, const std::string& labels) {
+    return *find(name, help, labels, false).counter;
+}
+
+MetricHistogram& MetricsRegistry::histogram(const std::string& name, const std::string& help, const std::string& labels) {
+    return *find(name, help, labels, true).histogram;
+}
+
+// One HELP/TYPE block per name, its label sets grouped under it in registration order
+std::string MetricsRegistry::exposition() const {
+    std::lock_guard<std::mutex> guard(lock);
+    std::vector<const Entry*> ordered;
+    for (const auto& entry : entries) {
+        ordered.push_back(entry.get());
+    }
+    std::stable_sort(ordered.begin(), ordered.end(), [](const Entry* a, const Entry* b) { return a->name < b->name; });
+
+    std::ostringstream out;
+    for (size_t i = 0; i < ordered.size(); i++) {
+        const Entry& entry = *ordered[i];
+        if (i == 0 || ordered[i - 1]->name != entry.name) {
+            out << "# HELP " << entry.name << " " << entry.help << "\n";
+            out << "# TYPE " << entry.name << " " << (entry.histogram ? "histogram" : "counter") << "\n";
+        }
+        std::string labels = entry.labels.empty() ? "" : "{" + entry.labels + "}";
+        if (entry.counter) {
+            out << entry.name << labels << " " << entry.counter->value() << "\n";
+            continue;
+        }
+        const MetricHistogram& histogram = *entry.histogram;
+        uint64_t count = histogram.count();
+        uint64_t sum = histogram.sumMicros();
+        for (int power = FIRST_EXPORTED_POWER; power <= LAST_EXPORTED_POWER; power++) {
+            uint64_t bound = 1ull << power;
+            out << entry.name << "_bucket" << withLabel(entry.labels, "le=\"" + seconds(bound) + "\"") << " "
+                << std::min(histogram.countAtMost(bound), count) << "\n";
+        }
+        out << entry.name << "_bucket" << withLabel(entry.labels, "le=\"+Inf\"") << " " << count << "\n";
+        out << entry.name << "_sum" << labels << " " << seconds(sum) << "\n";
+        out << entry.name << "_count" << labels << " " << count << "\n";
+    }
+    return out.str();
+}
+
+bool MetricsRegistry::writeTextFile(const std::string& filename, std::string& error) const {
+    std::string text = exposition();
+    std::string temporary = filename + ".tmp";
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        out << text;
+        out.close();
+        if (!out) {
+            error = "Cannot write metrics file " + temporary;
+            return false;
+        }
+    }
+#ifdef _WIN32
+    // rename() does not replace on Windows, and remove() first would leave a gap with no file
+    if (!MoveFileExA(temporary.c_str(), filename.c_str(), MOVEFILE_REPLACE_EXISTING)) {
+#else
+    if (std::rename(temporary.c_str(), filename.c_str()) != 0) {
+#endif
+        std::remove(temporary.c_str());
+        error = "Cannot replace metrics file " + filename;
+        return false;
+    }
+    return true;
+}
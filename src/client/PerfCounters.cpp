@@ -0,0 +1,295 @@
+#include "../../include/client/PerfCounters.h"
+
+#include <cstring>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+
+#ifdef __linux__
+#include <cerrno>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr int EVENTS = static_cast<int>(PerfEvent::Count);
+
+#ifdef __linux__
+struct EventSpec {
+    uint32_t type;
+    uint64_t config;
+};
+
+// Same order as PerfEvent. The task clock leads the group because every kernel offers it;
+// the hardware counters join it where the CPU (or hypervisor) exposes them.
+const EventSpec EVENT_SPECS[EVENTS] = {
+    {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},   // Last-level cache on x86 and most ARM cores
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+};
+
+int openEvent(const EventSpec& spec, int groupFd, bool kernel) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = spec.type;
+    attr.config = spec.config;
+    attr.disabled = groupFd < 0 ? 1 : 0;   // The leader starts the whole group once it is complete
+    attr.exclude_kernel = kernel ? 0 : 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, groupFd, PERF_FLAG_FD_CLOEXEC));
+}
+#endif
+
+// One thread's group and stage totals. The owner opens and reads the group without a
+// lock; the lock covers the totals, which other threads read.
+struct ThreadCounters {
+    std::mutex lock;
+    PerfCounterGroup group;
+    bool tried = false;
+    bool ok = false;
+    std::string openError;
+    unsigned threadId = 0;
+    std::string threadName;
+    std::vector<PerfProfiler::StageTotals> stages;
+};
+
+std::mutex registryLock;
+std::vector<std::unique_ptr<ThreadCounters>> threads;   // Kept after their threads exit
+thread_local ThreadCounters* localCounters = nullptr;
+
+ThreadCounters& threadCounters() {
+    if (!localCounters) {
+        std::unique_ptr<ThreadCounters> counters(new ThreadCounters);
+        std::lock_guard<std::mutex> guard(registryLock);
+        counters->threadId = static_cast<unsigned>(threads.size() + 1);
+        localCounters = counters.get();
+        threads.push_back(std::move(counters));
+    }
+    return *localCounters;
+}
+
+bool openThreadGroup(ThreadCounters& counters) {
+    if (!counters.tried) {
+        counters.tried = true;
+        counters.ok = counters.group.open(counters.openError);
+    }
+    return counters.ok;
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// PerfCounts
+
+PerfCounts& PerfCounts::operator+=(const PerfCounts& other) {
+    for (int i = 0; i < EVENTS; i++) {
+        values[i] += other.values[i];
+    }
+    return *this;
+}
+
+PerfCounts PerfCounts::operator-(const PerfCounts& other) const {
+    PerfCounts difference;
+    for (int i = 0; i < EVENTS; i++) {
+        difference.values[i] = values[i] > other.values[i] ? values[i] - other.values[i] : 0;
+    }
+    return difference;
+}
+
+double PerfCounts::ipc() const {
+    uint64_t cycles = (*this)[PerfEvent::Cycles];
+    return cycles > 0 ? static_cast<double>((*this)[PerfEvent::Instructions]) / cycles : 0.0;
+}
+
+// ---------------------------------------------------------------------------
+// PerfCounterGroup
+
+PerfCounterGroup::~PerfCounterGroup() {
+    close();
+}
+
+bool PerfCounterGroup::open(std::string& error) {
+    close();
+#ifdef __linux__
+    int openErrno = 0;
+    for (bool withKernel : {true, false}) {
+        leader = openEvent(EVENT_SPECS[0], -1, withKernel);
+        if (leader >= 0) {
+            kernel = withKernel;
+            break;
+        }
+        openErrno = errno;
+        if (openErrno != EACCES && openErrno != EPERM) {
+            break;   // Retrying user-only only helps with a permission error
+        }
+    }
+    if (leader < 0) {
+        error = std::string("perf_event_open failed: ") + std::strerror(openErrno);
+        if (openErrno == EACCES || openErrno == EPERM) {
+            error += " (see /proc/sys/kernel/perf_event_paranoid)";
+        }
+        return false;
+    }
+    descriptors[0] = leader;
+    slots[0] = 0;
+    opened = 1;
+    for (int i = 1; i < EVENTS; i++) {
+        int fd = openEvent(EVENT_SPECS[i], leader, kernel);
+        if (fd >= 0) {
+            descriptors[i] = fd;
+            slots[i] = opened++;
+        }
+    }
+    ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    return true;
+#else
+    error = "Hardware counters need Linux perf_event_open";
+    return false;
+#endif
+}
+
+void PerfCounterGroup::close() {
+    for (int i = 0; i < EVENTS; i++) {
+#ifdef __linux__
+        if (descriptors[i] >= 0) {
+            ::close(descriptors[i]);
+        }
+#endif
+        descriptors[i] = -1;
+        slots[i] = -1;
+    }
+    leader = -1;
+    opened = 0;
+    kernel = false;
+}
+
+bool PerfCounterGroup::read(PerfCounts& counts) const {
+    counts = PerfCounts();
+#ifdef __linux__
+    if (leader < 0) {
+        return false;
+    }
+    // nr || time enabled || time running || one value per opened counter
+    uint64_t buffer[3 + EVENTS];
+    const ssize_t expected = static_cast<ssize_t>((3 + opened) * sizeof(uint64_t));
+    if (::read(leader, buffer, sizeof(buffer)) < expected) {
+        return false;
+    }
+    const uint64_t enabledTime = buffer[1];
+    const uint64_t runningTime = buffer[2];
+    const double scale = runningTime > 0 && runningTime < enabledTime ? static_cast<double>(enabledTime) / runningTime : 1.0;
+    for (int i = 0; i < EVENTS; i++) {
+        if (slots[i] >= 0) {
+            counts.values[i] = static_cast<uint64_t>(buffer[3 + slots[i]] * scale);
+        }
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+const char* PerfCounterGroup::eventName(PerfEvent event) {
+    switch (event) {
+        case PerfEvent::TaskClock: return "task_clock_ns";
+        case PerfEvent::Cycles: return "cycles";
+        case PerfEvent::Instructions: return "instructions";
+        case PerfEvent::LlcMisses: return "llc_misses";
+        case PerfEvent::BranchMisses: return "branch_misses";
+        default: return "?";
+    }
+}
+
+// ---------------------------------------------------------------------------
+// PerfProfiler
+
+std::atomic<bool> PerfProfiler::active{false};
+
+bool PerfProfiler::enable(std::string& error) {
+    ThreadCounters& counters = threadCounters();
+    if (!openThreadGroup(counters)) {
+        error = counters.openError;
+        return false;
+    }
+    active.store(true, std::memory_order_relaxed);
+    return true;
+}
+
+void PerfProfiler::disable() {
+    active.store(false, std::memory_order_relaxed);
+}
+
+void PerfProfiler::clear() {
+    std::lock_guard<std::mutex> guard(registryLock);
+    for (auto& counters : threads) {
+        std::lock_guard<std::mutex> threadGuard(counters->lock);
+        counters->stages.clear();
+    }
+}
+
+void PerfProfiler::nameThread(const char* name) {
+    ThreadCounters& counters = threadCounters();
+    std::lock_guard<std::mutex> guard(counters.lock);
+    counters.threadName = name;
+}
+
+bool PerfProfiler::available(PerfEvent event) {
+    ThreadCounters& counters = threadCounters();
+    return openThreadGroup(counters) && counters.group.available(event);
+}
+
+bool PerfProfiler::includesKernel() {
+    ThreadCounters& counters = threadCounters();
+    return openThreadGroup(counters) && counters.group.includesKernel();
+}
+
+bool PerfProfiler::readThread(PerfCounts& counts) {
+    ThreadCounters& counters = threadCounters();
+    return openThreadGroup(counters) && counters.group.read(counts);
+}
+
+void PerfProfiler::record(const char* stage, const PerfCounts& delta) {
+    ThreadCounters& counters = threadCounters();
+    std::lock_guard<std::mutex> guard(counters.lock);
+    for (StageTotals& totals : counters.stages) {
+        if (totals.stage == stage) {
+            totals.calls++;
+            totals.counts += delta;
+            return;
+        }
+    }
+    counters.stages.push_back(StageTotals{"", stage, 1, delta});
+}
+
+std::vector<PerfProfiler::StageTotals> PerfProfiler::totals() {
+    std::vector<StageTotals> all;
+    std::lock_guard<std::mutex> guard(registryLock);
+    for (auto& counters : threads) {
+        std::lock_guard<std::mutex> threadGuard(counters->lock);
+        const std::string thread =
+            counters->threadName.empty() ? "thread " + std::to_string(counters->threadId) : counters->threadName;
+        for (const StageTotals& totals : counters->stages) {
+            all.push_back(totals);
+            all.back().thread = thread;
+        }
+    }
+    return all;
+}
+
+bool PerfProfiler::stageTotals(const std::string& thread, const std::string& stage, StageTotals& totals) {
+    for (const StageTotals& candidate : PerfProfiler::totals()) {
+        if (candidate.thread == thread && candidate.stage == stage) {
+            totals = candidate;
+            return true;
+        }
+    }
+    return false;
+}
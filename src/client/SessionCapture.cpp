@@ -0,0 +1,160 @@
+#include "../../include/client/SessionCapture.h"
+#include "../../include/client/protocol.h"
+
+#include <cstring>
+
+namespace {
+
+constexpr size_t STREAM_BUFFER_SIZE = 256 * 1024;
+
+bool getVarint(std::istream& in, uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        int byte = in.get();
+        if (byte == EOF) {
+            return false;
+        }
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool getCode(std::istream& in, uint16_t& code) {
+    int low = in.get();
+    int high = in.get();
+    code = static_cast<uint16_t>((low & 0xFF) | ((high & 0xFF) << 8));
+    return high != EOF;
+}
+
+} // namespace
+
+const char CaptureWriter::MAGIC[8] = {'B', 'K', 'U', 'P', 'C', 'A', 'P', '1'};
+
+CaptureWriter::CaptureWriter() : buffer(STREAM_BUFFER_SIZE) {
+}
+
+CaptureWriter::~CaptureWriter() {
+    close();
+}
+
+bool CaptureWriter::open(const std::string& filename, std::string& error) {
+    close();
+    out.rdbuf()->pubsetbuf(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    out.open(filename, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        error = "Cannot create capture file " + filename;
+        return false;
+    }
+    out.write(MAGIC, sizeof(MAGIC));
+    last = std::chrono::steady_clock::now();
+    fileIndexes.clear();
+    return true;
+}
+
+void CaptureWriter::close() {
+    if (out.is_open()) {
+        out.close();
+    }
+}
+
+void CaptureWriter::connectionOpened() {
+    begin(CaptureRecord::Kind::Open);
+}
+
+void CaptureWriter::connectionClosed() {
+    begin(CaptureRecord::Kind::Close);
+}
+
+void CaptureWriter::request(const uint8_t* header, const uint8_t* fileMetadata) {
+    if (!out.is_open()) {
+        return;
+    }
+    begin(CaptureRecord::Kind::Request);
+    out.write(reinterpret_cast<const char*>(header + 17), 2);   // Code
+    putVarint(readLE(header + 19, 4));                          // Payload size
+    out.put(fileMetadata ? 1 : 0);
+    if (fileMetadata) {
+        std::string name(reinterpret_cast<const char*>(fileMetadata + 12), MAX_FILENAME_SIZE);
+        auto index = fileIndexes.emplace(name, static_cast<uint32_t>(fileIndexes.size())).first->second;
+        putVarint(readLE(fileMetadata + 4, 4));   // Original size
+        putVarint(readLE(fileMetadata + 8, 2));   // Packet
+        putVarint(readLE(fileMetadata + 10, 2));  // Total packets
+        putVarint(index);
+    }
+}
+
+void CaptureWriter::response(uint16_t code, uint32_t payloadSize) {
+    if (!out.is_open()) {
+        return;
+    }
+    begin(CaptureRecord::Kind::Response);
+    out.put(static_cast<char>(code & 0xFF));
+    out.put(static_cast<char>(code >> 8));
+    putVarint(payloadSize);
+}
+
+void CaptureWriter::begin(CaptureRecord::Kind kind) {
+    if (!out.is_open()) {
+        return;
+    }
+    auto now = std::chrono::steady_clock::now();
+    out.put(static_cast<char>(kind));
+    putVarint(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(now - last).count()));
+    last = now;
+}
+
+void CaptureWriter::putVarint(uint64_t value) {
+    while (value >= 0x80) {
+        out.put(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.put(static_cast<char>(value));
+}
+
+// ---------------------------------------------------------------------------
+// Reading
+
+bool readCapture(const std::string& filename, std::vector<CaptureRecord>& records, std::string& error) {
+    std::ifstream in(filename, std::ios::binary);
+    char magic[sizeof(CaptureWriter::MAGIC)] = {};
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, CaptureWriter::MAGIC, sizeof(magic)) != 0) {
+        error = filename + " is not a session capture";
+        return false;
+    }
+    records.clear();
+    uint64_t micros = 0;
+    for (int kind; (kind = in.get()) != EOF; ) {
+        CaptureRecord record;
+        record.kind = static_cast<CaptureRecord::Kind>(kind);
+        uint64_t delta = 0, value = 0;
+        bool ok = kind >= 1 && kind <= 4 && getVarint(in, delta);
+        micros += delta;
+        record.micros = micros;
+        if (ok && (record.kind == CaptureRecord::Kind::Request || record.kind == CaptureRecord::Kind::Response)) {
+            ok = getCode(in, record.code) && getVarint(in, value);
+            record.payloadSize = static_cast<uint32_t>(value);
+        }
+        if (ok && record.kind == CaptureRecord::Kind::Request) {
+            int flag = in.get();
+            record.filePacket = flag == 1;
+            ok = flag == 0 || flag == 1;
+            uint64_t fields[4] = {};
+            for (int i = 0; ok && record.filePacket && i < 4; i++) {
+                ok = getVarint(in, fields[i]);
+            }
+            record.originalSize = static_cast<uint32_t>(fields[0]);
+            record.packet = static_cast<uint16_t>(fields[1]);
+            record.totalPackets = static_cast<uint16_t>(fields[2]);
+            record.fileIndex = static_cast<uint32_t>(fields[3]);
+        }
+        if (!ok) {
+            error = filename + ": truncated or corrupt record " + std::to_string(records.size() + 1);
+            return false;
+        }
+        records.push_back(record);
+    }
+    return true;
+}
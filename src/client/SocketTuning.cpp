@@ -0,0 +1,226 @@
+#include "../../include/client/SocketTuning.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <fstream>
+#include <sstream>
+
+#ifndef _WIN32
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#endif
+
+namespace {
+
+// Largest buffer the kernel's autotuner may grow a socket to: 0 if it does not autotune,
+// -1 if it autotunes without a configured ceiling
+long long autotuneLimit(bool send) {
+#if defined(_WIN32)
+    // Receive window autotuning and ideal send backlog both follow the measured BDP
+    (void)send;
+    return -1;
+#elif defined(__linux__)
+    // Third field of tcp_wmem / tcp_rmem: "min default max"
+    std::ifstream limits(send ? "/proc/sys/net/ipv4/tcp_wmem" : "/proc/sys/net/ipv4/tcp_rmem");
+    long long minimum = 0, initial = 0, maximum = 0;
+    if (limits >> minimum >> initial >> maximum) {
+        return maximum;
+    }
+    return 0;
+#else
+    (void)send;
+    return 0;
+#endif
+}
+
+bool autotuneReaches(bool send, uint64_t bytes) {
+    long long limit = autotuneLimit(send);
+    return limit < 0 || (limit > 0 && bytes <= static_cast<uint64_t>(limit));
+}
+
+// Largest size SO_SNDBUF / SO_RCVBUF may set before the kernel clamps it, -1 if unknown
+long long explicitLimit(bool send) {
+#if defined(__linux__)
+    std::ifstream limit(send ? "/proc/sys/net/core/wmem_max" : "/proc/sys/net/core/rmem_max");
+    long long maximum = 0;
+    return limit >> maximum ? maximum : -1;
+#else
+    (void)send;
+    return -1;
+#endif
+}
+
+// Size one buffer: leave it autotuned if that reaches wanted, set it if the kernel allows
+// wanted, else leave autotuning on and flag the shortfall. Returns true if it was set.
+bool sizeBuffer(boost::asio::ip::tcp::socket& socket, bool send, uint64_t wanted, bool& autotuned,
+                uint64_t& limitBytes, bool& shortfall) {
+    long long autotune = autotuneLimit(send);
+    long long cap = explicitLimit(send);
+    autotuned = autotuneReaches(send, wanted);
+    limitBytes = autotune > 0 ? static_cast<uint64_t>(autotune) : 0;
+    if (autotuned) {
+        return false;
+    }
+    if (cap >= 0 && static_cast<uint64_t>(cap) < wanted) {
+        autotuned = autotune != 0;
+        limitBytes = std::max<uint64_t>(limitBytes, static_cast<uint64_t>(cap));
+        shortfall = true;
+        return false;
+    }
+    boost::system::error_code ec;
+    if (send) {
+        socket.set_option(boost::asio::socket_base::send_buffer_size(static_cast<int>(wanted)), ec);
+    } else {
+        socket.set_option(boost::asio::socket_base::receive_buffer_size(static_cast<int>(wanted)), ec);
+    }
+    limitBytes = wanted;
+    return !ec;
+}
+
+std::string megabytes(uint64_t bytes) {
+    std::ostringstream out;
+    if (bytes >= 1024 * 1024) {
+        out << static_cast<double>(bytes * 10 / (1024 * 1024)) / 10 << "MB";
+    } else {
+        out << bytes / 1024 << "KB";
+    }
+    return out.str();
+}
+
+} // namespace
+
+SocketTuningOptions profileOptions(NetworkProfile profile) {
+    SocketTuningOptions options;
+    if (profile == NetworkProfile::WAN) {
+        // 1 Gbit/s at 100ms: 12.5MB in flight. A 1MB low-water mark still keeps a whole
+        // packet queued behind the window, so the pipe never waits for the client.
+        options.bandwidthBitsPerSecond = 1000000000ULL;
+        options.roundTripMs = 100;
+        options.minBufferBytes = 256 * 1024;
+        options.maxBufferBytes = 64 * 1024 * 1024;
+        options.notSentLowatBytes = 1024 * 1024;
+    } else {
+        // 10 Gbit/s at 1ms: 1.25MB, within what autotuning reaches on its own
+        options.bandwidthBitsPerSecond = 10000000000ULL;
+        options.roundTripMs = 1;
+        options.minBufferBytes = 128 * 1024;
+        options.maxBufferBytes = 16 * 1024 * 1024;
+        options.notSentLowatBytes = 256 * 1024;
+    }
+    options.cork = true;
+    return options;
+}
+
+bool parseNetworkProfile(const std::string& name, NetworkProfile& profile) {
+    if (name == "lan") {
+        profile = NetworkProfile::LAN;
+        return true;
+    }
+    if (name == "wan") {
+        profile = NetworkProfile::WAN;
+        return true;
+    }
+    return false;
+}
+
+const char* networkProfileName(NetworkProfile profile) {
+    return profile == NetworkProfile::WAN ? "WAN" : "LAN";
+}
+
+std::string SocketTuningResult::summary() const {
+    auto buffer = [](int bytes, bool autotuned, bool shortfall, uint64_t limit, const char* sysctl) {
+        std::string text = megabytes(static_cast<uint64_t>(bytes));
+        if (shortfall) {
+            return text + (autotuned ? " (autotuned" : " (") + " up to " + megabytes(limit) + ", below the BDP: raise " +
+                   sysctl + ")";
+        }
+        return text + (autotuned ? " (autotuned)" : "");
+    };
+    std::string text = "BDP " + megabytes(bandwidthDelayBytes) +
+                       ", send " + buffer(sendBufferBytes, sendAutotuned, sendShortfall, sendLimitBytes, "net.core.wmem_max") +
+                       ", receive " + buffer(receiveBufferBytes, receiveAutotuned, receiveShortfall, receiveLimitBytes,
+                                             "net.core.rmem_max");
+    if (notSentLowat) {
+        text += ", notsent-lowat";
+    }
+    if (corkSupported) {
+        text += ", cork";
+    }
+    return text;
+}
+
+namespace SocketTuning {
+
+uint64_t bandwidthDelayProduct(const SocketTuningOptions& options) {
+    return options.bandwidthBitsPerSecond / 8 * options.roundTripMs / 1000;
+}
+
+SocketTuningResult apply(boost::asio::ip::tcp::socket& socket, const SocketTuningOptions& options) {
+    SocketTuningResult result;
+    result.bandwidthDelayBytes = bandwidthDelayProduct(options);
+    uint64_t wanted = std::min<uint64_t>(std::max<uint64_t>(result.bandwidthDelayBytes, options.minBufferBytes),
+                                         options.maxBufferBytes);
+
+    // Linux doubles the requested size to cover bookkeeping and caps it at wmem_max /
+    // rmem_max, so asking for the BDP leaves room for a BDP of payload
+    bool sendSet = sizeBuffer(socket, true, wanted, result.sendAutotuned, result.sendLimitBytes, result.sendShortfall);
+    bool receiveSet = sizeBuffer(socket, false, wanted, result.receiveAutotuned, result.receiveLimitBytes,
+                                 result.receiveShortfall);
+    if (sendSet || receiveSet) {
+        result.requestedBufferBytes = static_cast<int>(wanted);
+    }
+
+    boost::system::error_code ec;
+    boost::asio::socket_base::send_buffer_size sendBuffer;
+    boost::asio::socket_base::receive_buffer_size receiveBuffer;
+    socket.get_option(sendBuffer, ec);
+    result.sendBufferBytes = ec ? 0 : sendBuffer.value();
+    socket.get_option(receiveBuffer, ec);
+    result.receiveBufferBytes = ec ? 0 : receiveBuffer.value();
+
+    // A set buffer is locked: it must hold at least what autotuning would have grown to
+    long long sendAutotune = autotuneLimit(true);
+    long long receiveAutotune = autotuneLimit(false);
+    if (sendSet && sendAutotune > 0 && result.sendBufferBytes < sendAutotune) {
+        result.sendShortfall = true;
+    }
+    if (receiveSet && receiveAutotune > 0 && result.receiveBufferBytes < receiveAutotune) {
+        result.receiveShortfall = true;
+    }
+
+#if defined(TCP_NOTSENT_LOWAT)
+    if (options.notSentLowatBytes > 0) {
+        int lowat = options.notSentLowatBytes;
+        result.notSentLowat = setsockopt(socket.native_handle(), IPPROTO_TCP, TCP_NOTSENT_LOWAT,
+                                         &lowat, sizeof(lowat)) == 0;
+    }
+#endif
+
+    // Probe corking once so the summary says whether it is available
+    if (options.cork) {
+        result.corkSupported = !setCork(socket, false);
+    }
+    return result;
+}
+
+boost::system::error_code setCork(boost::asio::ip::tcp::socket& socket, bool corked) {
+#if defined(TCP_CORK) || defined(TCP_NOPUSH)
+#if defined(TCP_CORK)
+    const int option = TCP_CORK;
+#else
+    const int option = TCP_NOPUSH;
+#endif
+    int value = corked ? 1 : 0;
+    if (setsockopt(socket.native_handle(), IPPROTO_TCP, option, &value, sizeof(value)) != 0) {
+        return boost::system::error_code(errno, boost::asio::error::get_system_category());
+    }
+    return boost::system::error_code();
+#else
+    (void)socket;
+    (void)corked;
+    return boost::asio::error::operation_not_supported;
+#endif
+}
+
+} // namespace SocketTuning
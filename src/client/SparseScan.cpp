@@ -0,0 +1,158 @@
+#include "../../include/client/SparseScan.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SPARSE_SCAN_SSE2 1
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define SPARSE_SCAN_NEON 1
+#endif
+
+#ifdef _WIN32
+#include <windows.h>
+#include <winioctl.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+bool isAllZero(const uint8_t* data, size_t length) {
+    size_t i = 0;
+#if defined(__AVX2__)
+    for (; i + 64 <= length; i += 64) {
+        __m256i block = _mm256_or_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)),
+                                        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + 32)));
+        if (!_mm256_testz_si256(block, block)) {
+            return false;
+        }
+    }
+#elif defined(SPARSE_SCAN_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 64 <= length; i += 64) {
+        __m128i block = _mm_or_si128(
+            _mm_or_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)),
+                         _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + 16))),
+            _mm_or_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + 32)),
+                         _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + 48))));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(block, zero)) != 0xFFFF) {
+            return false;
+        }
+    }
+#elif defined(SPARSE_SCAN_NEON)
+    for (; i + 64 <= length; i += 64) {
+        uint8x16_t block = vorrq_u8(vorrq_u8(vld1q_u8(data + i), vld1q_u8(data + i + 16)),
+                                    vorrq_u8(vld1q_u8(data + i + 32), vld1q_u8(data + i + 48)));
+        if (vmaxvq_u8(block) != 0) {
+            return false;
+        }
+    }
+#endif
+    for (; i + 8 <= length; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, data + i, sizeof(word));
+        if (word != 0) {
+            return false;
+        }
+    }
+    for (; i < length; i++) {
+        if (data[i] != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+HoleMap::HoleMap() : holes(0) {
+}
+
+bool HoleMap::load(const std::string& path, uint64_t size) {
+    extents.clear();
+    holes = 0;
+    bool listed = true;
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        listed = false;
+    }
+    FILE_ALLOCATED_RANGE_BUFFER query;
+    query.FileOffset.QuadPart = 0;
+    query.Length.QuadPart = static_cast<LONGLONG>(size);
+    while (listed && static_cast<uint64_t>(query.FileOffset.QuadPart) < size) {
+        FILE_ALLOCATED_RANGE_BUFFER ranges[64];
+        DWORD bytes = 0;
+        BOOL complete = DeviceIoControl(file, FSCTL_QUERY_ALLOCATED_RANGES, &query, sizeof(query),
+                                        ranges, sizeof(ranges), &bytes, nullptr);
+        if (!complete && GetLastError() != ERROR_MORE_DATA) {
+            listed = false;
+            break;
+        }
+        DWORD count = bytes / sizeof(FILE_ALLOCATED_RANGE_BUFFER);
+        for (DWORD i = 0; i < count; i++) {
+            uint64_t start = static_cast<uint64_t>(ranges[i].FileOffset.QuadPart);
+            extents.emplace_back(start, std::min(size, start + static_cast<uint64_t>(ranges[i].Length.QuadPart)));
+        }
+        if (complete || count == 0) {
+            break;
+        }
+        // More ranges than fit: continue after the last one returned
+        uint64_t resume = extents.back().second;
+        query.FileOffset.QuadPart = static_cast<LONGLONG>(resume);
+        query.Length.QuadPart = static_cast<LONGLONG>(size - resume);
+    }
+    if (file != INVALID_HANDLE_VALUE) {
+        CloseHandle(file);
+    }
+#else
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    listed = fd >= 0;
+    off_t position = 0;
+    while (listed && static_cast<uint64_t>(position) < size) {
+        off_t data = lseek(fd, position, SEEK_DATA);
+        if (data < 0) {
+            listed = errno == ENXIO;   // No data after position: the rest is a hole
+            break;
+        }
+        off_t hole = lseek(fd, data, SEEK_HOLE);
+        if (hole < 0) {
+            listed = false;
+            break;
+        }
+        extents.emplace_back(static_cast<uint64_t>(data), std::min(size, static_cast<uint64_t>(hole)));
+        position = hole;
+    }
+    if (fd >= 0) {
+        close(fd);
+    }
+#endif
+
+    if (!listed) {
+        extents.assign(1, std::make_pair(uint64_t(0), size));
+        return false;
+    }
+    uint64_t allocated = 0;
+    for (const auto& extent : extents) {
+        allocated += extent.second - extent.first;
+    }
+    holes = size > allocated ? size - allocated : 0;
+    return true;
+}
+
+bool HoleMap::isHole(uint64_t offset, uint64_t length) const {
+    if (extents.empty() && holes == 0) {
+        return false;   // Not loaded
+    }
+    // First extent that ends after offset; the range is a hole if it starts at or past the range's end
+    auto extent = std::upper_bound(extents.begin(), extents.end(), offset,
+                                   [](uint64_t value, const std::pair<uint64_t, uint64_t>& range) {
+                                       return value < range.second;
+                                   });
+    return extent == extents.end() || extent->first >= offset + length;
+}
@@ -0,0 +1,173 @@
+#include "../../include/client/Tracer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+struct TraceEvent {
+    const char* name;
+    uint64_t start;
+    uint64_t duration;
+    uint64_t arg;
+};
+
+// One thread's spans. The owner takes the lock for every event, uncontended unless a
+// trace is being written at that moment.
+struct TraceRing {
+    std::mutex lock;
+    std::vector<TraceEvent> events;
+    uint64_t written = 0;
+    unsigned threadId = 0;
+    std::string threadName;
+};
+
+std::mutex registryLock;
+std::vector<std::unique_ptr<TraceRing>> rings;   // Kept after their threads exit
+size_t ringCapacity = Tracer::DEFAULT_EVENTS_PER_THREAD;
+std::atomic<uint64_t> epoch{0};                  // Trace time zero: the first enable()
+thread_local TraceRing* localRing = nullptr;
+
+TraceRing& threadRing() {
+    if (!localRing) {
+        std::unique_ptr<TraceRing> ring(new TraceRing);
+        std::lock_guard<std::mutex> guard(registryLock);
+        ring->events.resize(ringCapacity);
+        ring->threadId = static_cast<unsigned>(rings.size() + 1);
+        localRing = ring.get();
+        rings.push_back(std::move(ring));
+    }
+    return *localRing;
+}
+
+void writeJsonString(std::ostream& out, const std::string& text) {
+    out << '"';
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out << '\\' << c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec
+                << std::setfill(' ');
+        } else {
+            out << c;
+        }
+    }
+    out << '"';
+}
+
+} // namespace
+
+std::atomic<bool> Tracer::active{false};
+std::atomic<bool> Tracer::dumpRequested{false};
+
+void Tracer::enable(size_t eventsPerThread) {
+    {
+        std::lock_guard<std::mutex> guard(registryLock);
+        if (eventsPerThread == 0) {
+            eventsPerThread = 1;
+        }
+        if (eventsPerThread != ringCapacity) {
+            ringCapacity = eventsPerThread;
+            for (auto& ring : rings) {
+                std::lock_guard<std::mutex> ringGuard(ring->lock);
+                ring->events.assign(ringCapacity, TraceEvent{});
+                ring->written = 0;
+            }
+        }
+    }
+    uint64_t unset = 0;
+    epoch.compare_exchange_strong(unset, now());
+    active.store(true, std::memory_order_relaxed);
+}
+
+void Tracer::disable() {
+    active.store(false, std::memory_order_relaxed);
+}
+
+void Tracer::clear() {
+    std::lock_guard<std::mutex> guard(registryLock);
+    for (auto& ring : rings) {
+        std::lock_guard<std::mutex> ringGuard(ring->lock);
+        ring->written = 0;
+    }
+}
+
+uint64_t Tracer::now() {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void Tracer::record(const char* name, uint64_t startNanos, uint64_t endNanos, uint64_t arg) {
+    TraceRing& ring = threadRing();
+    std::lock_guard<std::mutex> guard(ring.lock);
+    ring.events[ring.written % ring.events.size()] =
+        TraceEvent{name, startNanos, endNanos > startNanos ? endNanos - startNanos : 0, arg};
+    ring.written++;
+}
+
+void Tracer::nameThread(const char* name) {
+    TraceRing& ring = threadRing();
+    std::lock_guard<std::mutex> guard(ring.lock);
+    ring.threadName = name;
+}
+
+size_t Tracer::eventCount() {
+    std::lock_guard<std::mutex> guard(registryLock);
+    size_t count = 0;
+    for (auto& ring : rings) {
+        std::lock_guard<std::mutex> ringGuard(ring->lock);
+        count += static_cast<size_t>(std::min<uint64_t>(ring->written, ring->events.size()));
+    }
+    return count;
+}
+
+// Complete ("X") events in microseconds since the first enable(), one track per thread
+bool Tracer::writeChromeTrace(const std::string& filename, std::string& error) {
+    std::ofstream out(filename, std::ios::trunc);
+    if (!out) {
+        error = "Cannot create trace file " + filename;
+        return false;
+    }
+    const uint64_t zero = epoch.load();
+    out << std::fixed << std::setprecision(3);
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    std::vector<TraceEvent> events;
+    std::lock_guard<std::mutex> guard(registryLock);
+    for (auto& ring : rings) {
+        std::string threadName;
+        {
+            std::lock_guard<std::mutex> ringGuard(ring->lock);
+            size_t held = static_cast<size_t>(std::min<uint64_t>(ring->written, ring->events.size()));
+            events.clear();
+            for (uint64_t i = ring->written - held; i < ring->written; i++) {
+                events.push_back(ring->events[i % ring->events.size()]);
+            }
+            threadName = ring->threadName.empty() ? "thread " + std::to_string(ring->threadId) : ring->threadName;
+        }
+        out << (first ? "\n" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << ring->threadId
+            << ",\"args\":{\"name\":";
+        writeJsonString(out, threadName);
+        out << "}}";
+        first = false;
+        for (const TraceEvent& event : events) {
+            out << ",\n{\"name\":";
+            writeJsonString(out, event.name);
+            out << ",\"cat\":\"client\",\"ph\":\"X\",\"pid\":1,\"tid\":" << ring->threadId
+                << ",\"ts\":" << (event.start >= zero ? event.start - zero : 0) / 1000.0
+                << ",\"dur\":" << event.duration / 1000.0 << ",\"args\":{\"arg\":" << event.arg << "}}";
+        }
+    }
+    out << "\n]}\n";
+    out.close();
+    if (!out) {
+        error = "Failed to write trace file " + filename;
+        return false;
+    }
+    return true;
+}
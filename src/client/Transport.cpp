@@ -0,0 +1,196 @@
+#include "../../include/client/Transport.h"
+#include "../../include/client/DeadlineIO.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+
+// ---------------------------------------------------------------------------
+// TcpTransport
+
+TcpTransport::TcpTransport(boost::asio::io_context& ioContext, std::unique_ptr<boost::asio::ip::tcp::socket> socket)
+    : ioContext(ioContext), socket(std::move(socket)) {
+}
+
+bool TcpTransport::isOpen() const {
+    return socket && socket->is_open();
+}
+
+void TcpTransport::close() {
+    if (socket && socket->is_open()) {
+        boost::system::error_code ignored;
+        socket->close(ignored);
+    }
+}
+
+std::string TcpTransport::describe() const {
+    // A Fast Open socket may not know its peer until the handshake completes
+    boost::system::error_code ec;
+    auto local = socket->local_endpoint(ec);
+    auto remote = socket->remote_endpoint(ec);
+    if (ec) {
+        return "TCP (peer not yet confirmed)";
+    }
+    return "Local: " + local.address().to_string() + ":" + std::to_string(local.port()) +
+           " -> Remote: " + remote.address().to_string() + ":" + std::to_string(remote.port());
+}
+
+boost::system::error_code TcpTransport::write(const std::vector<boost::asio::const_buffer>& buffers,
+                                              std::chrono::milliseconds timeout) {
+    return DeadlineIO::write(ioContext, *socket, buffers, timeout);
+}
+
+boost::system::error_code TcpTransport::read(boost::asio::mutable_buffer buffer, std::chrono::milliseconds timeout) {
+    return DeadlineIO::read(ioContext, *socket, buffer, timeout);
+}
+
+int TcpTransport::nativeHandle() const {
+    return static_cast<int>(socket->native_handle());
+}
+
+// ---------------------------------------------------------------------------
+// UnixTransport
+
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+UnixTransport::UnixTransport(boost::asio::io_context& ioContext) : ioContext(ioContext), stream(ioContext) {
+}
+
+boost::system::error_code UnixTransport::connect(const std::string& socketPath, std::chrono::milliseconds timeout) {
+    path = socketPath;
+    return DeadlineIO::connect(ioContext, stream, boost::asio::local::stream_protocol::endpoint(socketPath), timeout);
+}
+
+void UnixTransport::close() {
+    if (stream.is_open()) {
+        boost::system::error_code ignored;
+        stream.close(ignored);
+    }
+}
+
+std::string UnixTransport::describe() const {
+    return "Unix socket " + (path.empty() ? std::string("(accepted)") : path);
+}
+
+boost::system::error_code UnixTransport::write(const std::vector<boost::asio::const_buffer>& buffers,
+                                               std::chrono::milliseconds timeout) {
+    return DeadlineIO::write(ioContext, stream, buffers, timeout);
+}
+
+boost::system::error_code UnixTransport::read(boost::asio::mutable_buffer buffer, std::chrono::milliseconds timeout) {
+    return DeadlineIO::read(ioContext, stream, buffer, timeout);
+}
+
+int UnixTransport::nativeHandle() const {
+    return const_cast<boost::asio::local::stream_protocol::socket&>(stream).native_handle();
+}
+#endif
+
+// ---------------------------------------------------------------------------
+// MemoryTransport
+
+struct MemoryTransport::Channel {
+    std::mutex lock;
+    std::condition_variable changed;
+    std::vector<uint8_t> ring;
+    size_t head = 0;          // Next byte to read
+    size_t used = 0;
+    bool closed = false;      // Either end closed
+
+    explicit Channel(size_t capacity) : ring(capacity) {
+    }
+};
+
+std::pair<std::unique_ptr<MemoryTransport>, std::unique_ptr<MemoryTransport>> MemoryTransport::createPair(size_t capacity) {
+    auto forward = std::make_shared<Channel>(std::max<size_t>(capacity, 1));
+    auto backward = std::make_shared<Channel>(std::max<size_t>(capacity, 1));
+    return std::make_pair(std::unique_ptr<MemoryTransport>(new MemoryTransport(backward, forward)),
+                          std::unique_ptr<MemoryTransport>(new MemoryTransport(forward, backward)));
+}
+
+MemoryTransport::MemoryTransport(std::shared_ptr<Channel> incoming, std::shared_ptr<Channel> outgoing)
+    : incoming(std::move(incoming)), outgoing(std::move(outgoing)), open(true) {
+}
+
+MemoryTransport::~MemoryTransport() {
+    close();
+}
+
+bool MemoryTransport::isOpen() const {
+    return open;
+}
+
+void MemoryTransport::close() {
+    if (!open) {
+        return;
+    }
+    open = false;
+    for (Channel* channel : {incoming.get(), outgoing.get()}) {
+        std::lock_guard<std::mutex> guard(channel->lock);
+        channel->closed = true;
+        channel->changed.notify_all();
+    }
+}
+
+boost::system::error_code MemoryTransport::write(const std::vector<boost::asio::const_buffer>& buffers,
+                                                 std::chrono::milliseconds timeout) {
+    if (!open) {
+        return boost::asio::error::bad_descriptor;
+    }
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    Channel& channel = *outgoing;
+    std::unique_lock<std::mutex> guard(channel.lock);
+    for (const auto& buffer : buffers) {
+        const uint8_t* data = static_cast<const uint8_t*>(buffer.data());
+        size_t remaining = buffer.size();
+        while (remaining > 0) {
+            if (!channel.changed.wait_until(guard, deadline, [&channel]() {
+                    return channel.closed || channel.used < channel.ring.size();
+                })) {
+                return boost::asio::error::timed_out;
+            }
+            if (channel.closed) {
+                return boost::asio::error::broken_pipe;
+            }
+            // Copy into the free space, which may wrap around the end of the ring
+            size_t capacity = channel.ring.size();
+            size_t tail = (channel.head + channel.used) % capacity;
+            size_t chunk = std::min(remaining, std::min(capacity - channel.used, capacity - tail));
+            std::memcpy(channel.ring.data() + tail, data, chunk);
+            channel.used += chunk;
+            data += chunk;
+            remaining -= chunk;
+            channel.changed.notify_all();
+        }
+    }
+    return boost::system::error_code();
+}
+
+boost::system::error_code MemoryTransport::read(boost::asio::mutable_buffer buffer, std::chrono::milliseconds timeout) {
+    if (!open) {
+        return boost::asio::error::bad_descriptor;
+    }
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    Channel& channel = *incoming;
+    std::unique_lock<std::mutex> guard(channel.lock);
+    uint8_t* data = static_cast<uint8_t*>(buffer.data());
+    size_t remaining = buffer.size();
+    while (remaining > 0) {
+        if (!channel.changed.wait_until(guard, deadline, [&channel]() {
+                return channel.closed || channel.used > 0;
+            })) {
+            return boost::asio::error::timed_out;
+        }
+        if (channel.used == 0) {
+            return boost::asio::error::eof;   // Closed and drained
+        }
+        size_t chunk = std::min(remaining, std::min(channel.used, channel.ring.size() - channel.head));
+        std::memcpy(data, channel.ring.data() + channel.head, chunk);
+        channel.head = (channel.head + chunk) % channel.ring.size();
+        channel.used -= chunk;
+        data += chunk;
+        remaining -= chunk;
+        channel.changed.notify_all();
+    }
+    return boost::system::error_code();
+}
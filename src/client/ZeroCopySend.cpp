@@ -0,0 +1,190 @@
+#include "../../include/client/ZeroCopySend.h"
+#include "../../include/client/DeadlineIO.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/errqueue.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#ifndef SO_ZEROCOPY
+#define SO_ZEROCOPY 60
+#endif
+#ifndef MSG_ZEROCOPY
+#define MSG_ZEROCOPY 0x4000000
+#endif
+#ifndef SO_EE_ORIGIN_ZEROCOPY
+#define SO_EE_ORIGIN_ZEROCOPY 5
+#endif
+#ifndef SO_EE_CODE_ZEROCOPY_COPIED
+#define SO_EE_CODE_ZEROCOPY_COPIED 1
+#endif
+#define CLIENT_HAVE_MSG_ZEROCOPY 1
+#endif
+
+ZeroCopySender::ZeroCopySender() : enabled(false), nextId(0), sentBytes(0), completed(0), copied(0) {
+}
+
+bool ZeroCopySender::enable(boost::asio::ip::tcp::socket& socket, std::string& error) {
+    reset();
+#ifdef CLIENT_HAVE_MSG_ZEROCOPY
+    int one = 1;
+    if (setsockopt(socket.native_handle(), SOL_SOCKET, SO_ZEROCOPY, &one, sizeof(one)) != 0) {
+        error = std::string("SO_ZEROCOPY: ") + std::strerror(errno);
+        return false;
+    }
+    enabled = true;
+    return true;
+#else
+    (void)socket;
+    error = "MSG_ZEROCOPY is Linux-only";
+    return false;
+#endif
+}
+
+void ZeroCopySender::reset() {
+    // A closed socket completes nothing more; the kernel keeps its own page references
+    frames.clear();
+    enabled = false;
+    nextId = 0;
+    sentBytes = 0;
+    completed = 0;
+    copied = 0;
+}
+
+boost::system::error_code ZeroCopySender::send(boost::asio::io_context& ioContext, boost::asio::ip::tcp::socket& socket,
+                                               BufferPool::Lease&& frame, size_t size, std::chrono::milliseconds timeout) {
+#ifdef CLIENT_HAVE_MSG_ZEROCOPY
+    // The frame is tracked from the start, so completions read while it is still being
+    // sent are credited to it; the extra outstanding count holds it until the send ends.
+    // It stays frames.back() throughout: complete() only erases frames without that hold.
+    frames.push_back(PendingFrame{std::move(frame), nextId, nextId, 1});
+    boost::system::error_code ec;
+    socket.native_non_blocking(true, ec);
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    auto remaining = [&deadline]() {
+        return std::max(std::chrono::milliseconds(1), std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now()));
+    };
+
+    const int fd = socket.native_handle();
+    size_t offset = 0;
+    while (!ec && offset < size) {
+        ssize_t sent = ::send(fd, frames.back().lease.data() + offset, size - offset, MSG_ZEROCOPY | MSG_NOSIGNAL);
+        if (sent > 0) {
+            offset += static_cast<size_t>(sent);
+            frames.back().lastId = nextId++;
+            frames.back().outstanding++;
+            continue;
+        }
+        if (sent < 0 && errno == EINTR) {
+            continue;
+        }
+        if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            readCompletions(fd);
+            ec = DeadlineIO::wait(ioContext, socket, boost::asio::socket_base::wait_write, remaining());
+        } else if (sent < 0 && errno == ENOBUFS) {
+            // Too many notifications queued (optmem limit): drain them, or wait for one
+            if (readCompletions(fd) == 0) {
+                ec = DeadlineIO::wait(ioContext, socket, boost::asio::socket_base::wait_error, remaining());
+            }
+        } else {
+            ec = boost::system::error_code(sent < 0 ? errno : EPIPE, boost::asio::error::get_system_category());
+        }
+        if (ec == boost::asio::error::operation_aborted) {
+            ec = boost::asio::error::timed_out;   // The deadline cancelled the wait
+        }
+    }
+
+    sentBytes += offset;
+    if (--frames.back().outstanding == 0) {
+        frames.pop_back();
+    }
+    readCompletions(fd);
+    return ec;
+#else
+    (void)ioContext;
+    (void)socket;
+    (void)frame;
+    (void)size;
+    (void)timeout;
+    return boost::asio::error::operation_not_supported;
+#endif
+}
+
+boost::system::error_code ZeroCopySender::reclaim(boost::asio::io_context& ioContext, boost::asio::ip::tcp::socket& socket,
+                                                  std::chrono::milliseconds timeout) {
+#ifdef CLIENT_HAVE_MSG_ZEROCOPY
+    const int fd = socket.native_handle();
+    size_t released = readCompletions(fd);
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (released == 0 && !frames.empty() && timeout.count() > 0) {
+        auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+        if (left.count() <= 0) {
+            return boost::asio::error::timed_out;
+        }
+        boost::system::error_code ec = DeadlineIO::wait(ioContext, socket, boost::asio::socket_base::wait_error, left);
+        if (ec) {
+            return ec == boost::asio::error::operation_aborted ? boost::asio::error::timed_out : ec;
+        }
+        released = readCompletions(fd);
+    }
+#else
+    (void)ioContext;
+    (void)socket;
+    (void)timeout;
+#endif
+    return boost::system::error_code();
+}
+
+size_t ZeroCopySender::readCompletions(int fd) {
+    size_t before = frames.size();
+#ifdef CLIENT_HAVE_MSG_ZEROCOPY
+    while (!frames.empty()) {
+        char control[128];
+        msghdr message{};
+        message.msg_control = control;
+        message.msg_controllen = sizeof(control);
+        if (recvmsg(fd, &message, MSG_ERRQUEUE | MSG_DONTWAIT) < 0) {
+            break;   // EAGAIN: nothing queued
+        }
+        for (cmsghdr* header = CMSG_FIRSTHDR(&message); header; header = CMSG_NXTHDR(&message, header)) {
+            bool recvErr = (header->cmsg_level == SOL_IP && header->cmsg_type == IP_RECVERR) ||
+                           (header->cmsg_level == SOL_IPV6 && header->cmsg_type == IPV6_RECVERR);
+            if (!recvErr) {
+                continue;
+            }
+            sock_extended_err error;
+            std::memcpy(&error, CMSG_DATA(header), sizeof(error));
+            if (error.ee_origin == SO_EE_ORIGIN_ZEROCOPY && error.ee_errno == 0) {
+                complete(error.ee_info, error.ee_data, (error.ee_code & SO_EE_CODE_ZEROCOPY_COPIED) != 0);
+            }
+        }
+    }
+#else
+    (void)fd;
+#endif
+    return before - frames.size();
+}
+
+void ZeroCopySender::complete(uint32_t low, uint32_t high, bool wasCopied) {
+    uint64_t ids = static_cast<uint64_t>(high - low) + 1;
+    completed += ids;
+    if (wasCopied) {
+        copied += ids;
+    }
+    // Completions usually arrive in order but may be coalesced or, rarely, reordered
+    for (auto frame = frames.begin(); frame != frames.end(); ) {
+        uint32_t first = std::max(frame->firstId, low);
+        uint32_t last = std::min(frame->lastId, high);
+        if (first <= last) {
+            frame->outstanding -= std::min(frame->outstanding, last - first + 1);
+        }
+        frame = frame->outstanding == 0 ? frames.erase(frame) : frame + 1;
+    }
+    if (enabled && completed >= COPIED_PROBE && copied == completed) {
+        enabled = false;   // The kernel copies on this path anyway
+    }
+}
@@ -70,15 +70,19 @@ static const uint32_t crc_table[256] = {
 
 // Linux cksum compatible implementation
 uint32_t calculateCRC(const uint8_t* data, size_t size) {
-    uint32_t crc = 0x00000000;
-    
+    return finishCRC(updateCRC(0, data, size), size);
+}
+
+uint32_t updateCRC(uint32_t crc, const uint8_t* data, size_t size) {
     // Process file data
     for (size_t i = 0; i < size; i++) {
         crc = (crc << 8) ^ crc_table[(crc >> 24) ^ data[i]];
     }
-    
+    return crc;
+}
+
+uint32_t finishCRC(uint32_t crc, uint64_t length) {
     // Process file length
-    size_t length = size;
     while (length > 0) {
         crc = (crc << 8) ^ crc_table[(crc >> 24) ^ (length & 0xFF)];
         length >>= 8;
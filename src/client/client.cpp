@@ -9,13 +9,21 @@
 #include <string>
 #include <vector>
 #include <array>
+#include <map>
 #include <cstring>
+#include <cstdint>
+#include <cstdio>
 #include <algorithm>
+#include <functional>
 #include <chrono>
 #include <thread>
 //#include <filesystem>
 #include <atomic>
+#include <memory>
+#include <new>
 #include <ctime>
+#include <csignal>
+#include <cstdlib>
 
 // Boost.Asio for cross-platform networking
 #include <boost/asio.hpp>
@@ -29,53 +37,93 @@
 #include <fcntl.h>
 #endif
 
+#ifdef CLIENT_HAVE_IO_URING
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 // Required wrapper includes (provided by project)
+#include "../../include/client/protocol.h"
+#include "../../include/client/Framing.h"
 #include "../../include/client/cksum.h"
+#include "../../include/client/FastConnect.h"
+#include "../../include/client/DeadlineIO.h"
+#include "../../include/client/FileSource.h"
+#include "../../include/client/IoUringEngine.h"
+#include "../../include/client/BufferPool.h"
+#include "../../include/client/SparseScan.h"
+#include "../../include/client/SocketTuning.h"
+#include "../../include/client/ZeroCopySend.h"
+#include "../../include/client/Transport.h"
+#include "../../include/client/SessionCapture.h"
+#include "../../include/client/Tracer.h"
+#include "../../include/client/Metrics.h"
+#include "../../include/client/AsyncLog.h"
+#include "../../include/client/AllocProfile.h"
 #include "../../include/wrappers/AESWrapper.h"
+#include "../../include/wrappers/SecureRandom.h"
 #include "../../include/wrappers/Base64Wrapper.h"
 #include "../../include/wrappers/RSAWrapper.h"
+#include "../../third_party/crypto++/hmac.h"
+#include "../../third_party/crypto++/sha.h"
 
 // Optional GUI support
 #ifdef _WIN32
 #include "../../include/client/ClientGUI.h"
 #endif
 
-// Protocol constants
-constexpr uint8_t CLIENT_VERSION = 3;
-constexpr uint8_t SERVER_VERSION = 3;
-
-// Request codes
-constexpr uint16_t REQ_REGISTER = 1025;
-constexpr uint16_t REQ_SEND_PUBLIC_KEY = 1026;
-constexpr uint16_t REQ_RECONNECT = 1027;
-constexpr uint16_t REQ_SEND_FILE = 1028;
-constexpr uint16_t REQ_CRC_OK = 1029;
-constexpr uint16_t REQ_CRC_RETRY = 1030;
-constexpr uint16_t REQ_CRC_ABORT = 1031;
-
-// Response codes
-constexpr uint16_t RESP_REGISTER_OK = 1600;
-constexpr uint16_t RESP_REGISTER_FAIL = 1601;
-constexpr uint16_t RESP_PUBKEY_AES_SENT = 1602;
-constexpr uint16_t RESP_FILE_OK = 1603;
-constexpr uint16_t RESP_ACK = 1604;
-constexpr uint16_t RESP_RECONNECT_AES_SENT = 1605;
-constexpr uint16_t RESP_RECONNECT_FAIL = 1606;
-constexpr uint16_t RESP_ERROR = 1607;
+// Protocol constants (request/response codes, header sizes and capability bits: protocol.h)
+constexpr uint8_t CLIENT_VERSION = PROTOCOL_VERSION;
+
+// Capabilities offered in REQ_NEGOTIATE_CAPS
+constexpr bool SPARSE_DETECTION_ENABLED = true;     // Skip file holes and all-zero packets (GCM sessions only)
+constexpr uint32_t CLIENT_CAPABILITIES = CAP_AES_GCM | (SPARSE_DETECTION_ENABLED ? CAP_SPARSE_RUNS : 0);
+
+// Session resumption
+constexpr size_t RESUME_NONCE_SIZE = 16;
+constexpr char RESUMPTION_SECRET_LABEL[] = "backup resumption secret";
+constexpr char RESUMED_KEY_LABEL[] = "backup resumed session key";
 
 // Size constants
-constexpr size_t CLIENT_ID_SIZE = 16;
-constexpr size_t MAX_NAME_SIZE = 255;
+constexpr size_t MAX_NAME_SIZE = MAX_FILENAME_SIZE;
 constexpr size_t RSA_KEY_SIZE = 162; // Updated for 1024-bit keys in DER format
 constexpr size_t AES_KEY_SIZE = 32;
 constexpr size_t MAX_PACKET_SIZE = 1024 * 1024;  // 1MB per packet
-constexpr size_t OPTIMAL_BUFFER_SIZE = 64 * 1024; // 64KB for file reading
+constexpr bool PREFAULT_INPUT_FILE = false;       // MAP_POPULATE: fault the whole file in before encrypting
+constexpr size_t INPUT_RELEASE_WINDOW = 8 * 1024 * 1024; // Drop mapped input pages behind the cursor in 8MB steps
+constexpr bool IO_URING_ENABLED = true;           // Linux: GCM transfers through io_uring (falls back to mmap + Asio)
+constexpr unsigned IO_URING_QUEUE_DEPTH = 16;     // Submission slots (each send uses two: send + linked timeout)
+constexpr unsigned IO_URING_READ_AHEAD = 4;       // File reads in flight ahead of the packet being encrypted
+constexpr unsigned IO_URING_SEND_BUFFERS = 2;     // Packets queued to the socket (sent in order) while the next is encrypted
+constexpr unsigned PACKET_POOL_BUFFERS = 4;       // Packet frames + responses in flight at once on the portable path
+constexpr bool PACKET_POOL_HUGE_PAGES = true;     // Back the pool with transparent huge pages where available
+constexpr bool ZEROCOPY_SEND_ENABLED = true;      // Linux: large packet frames sent with MSG_ZEROCOPY
+constexpr unsigned ZEROCOPY_POOL_BUFFERS = 16;    // Frames pinned until ACKed: cover a full send buffer
+constexpr size_t DIRECT_IO_ALIGNMENT = 4096;      // O_DIRECT offset/length/buffer alignment (covers 512B and 4KB sectors)
+constexpr size_t GCM_PACKET_OVERHEAD = AESWrapper::GCM_NONCE_SIZE + AESWrapper::GCM_TAG_SIZE;
+constexpr size_t GCM_CHUNK_SIZE = MAX_PACKET_SIZE - GCM_PACKET_OVERHEAD; // Plaintext per GCM packet
+constexpr size_t ZERO_RUN_CONTENT_SIZE = GCM_PACKET_OVERHEAD + 4;          // nonce || encrypted run length || tag
+constexpr char ZERO_RUN_LABEL[] = "zero run";  // Appended to a zero-run packet's AAD
 
 // Other constants
 constexpr int MAX_RETRIES = 3;
-constexpr int SOCKET_TIMEOUT_MS = 30000; // 30 seconds
-constexpr int RECONNECT_DELAY_MS = 5000; // 5 seconds between reconnect attempts
-constexpr int KEEPALIVE_INTERVAL = 60;   // 60 seconds
+constexpr int SOCKET_TIMEOUT_MS = 30000; // 30 seconds per request/response exchange
+constexpr int PACKET_WRITE_TIMEOUT_MS = 60000;  // Per file packet (1MB): fails below ~17KB/s
+constexpr int CRC_WAIT_TIMEOUT_MS = 120000;     // Server decrypts + checksums the whole file first
+constexpr int MAX_CONNECT_ATTEMPTS = 5;
+constexpr int CONNECT_ATTEMPT_DELAY_MS = 250;   // Happy Eyeballs head start per endpoint
+constexpr int CONNECT_TIMEOUT_MS = 10000;       // Per connection race
+constexpr int RETRY_BACKOFF_BASE_MS = 100;      // Retries wait up to base * 2^n (full jitter)...
+constexpr int RETRY_BACKOFF_CAP_MS = 5000;      // ...capped at 5 seconds
+constexpr int KEEPALIVE_INTERVAL = 60;   // 60 seconds idle before the first keep-alive probe
+constexpr int KEEPALIVE_PROBE_INTERVAL = 10;    // Seconds between unanswered probes
+constexpr int KEEPALIVE_PROBES = 5;             // Unanswered probes before the connection is dropped
+constexpr int METRICS_WRITE_INTERVAL_MS = 10000; // Metrics file refresh during a transfer (and at exit)
+constexpr int PROGRESS_FRAME_RATE = 10;         // Progress bar redraws per second at most
+constexpr int STATS_INTERVAL_MS = 1000;         // Speed/ETA line at most once a second during a transfer
+constexpr const char* LOG_LEVEL_ENV = "BACKUP_CLIENT_LOG_LEVEL"; // debug, info (default), warning, error or off
+constexpr const char* SESSION_TICKET_ENV = "BACKUP_CLIENT_SESSION_TICKET"; // Ticket file path; resumption is off unless set
 
 // Protocol structures
 #pragma pack(push, 1)
@@ -143,6 +191,46 @@ struct TransferStats {
     }
 };
 
+// Counters and histograms exported for monitoring (transfer.info metrics=)
+struct ClientMetrics {
+    explicit ClientMetrics(MetricsRegistry& registry)
+        : registry(registry),
+          bytesRead(registry.counter("backup_client_read_bytes_total", "File bytes read for upload")),
+          bytesEncrypted(registry.counter("backup_client_encrypted_bytes_total", "Plaintext bytes encrypted")),
+          bytesSent(registry.counter("backup_client_sent_bytes_total", "Bytes written to the server connection")),
+          packetsSent(registry.counter("backup_client_packets_sent_total", "File packets sent")),
+          connectRetries(registry.counter("backup_client_retries_total", "Retried operations", "operation=\"connect\"")),
+          fileRetries(registry.counter("backup_client_retries_total", "Retried operations", "operation=\"transfer\"")),
+          crcRetries(registry.counter("backup_client_retries_total", "Retried operations", "operation=\"crc\"")),
+          crcMismatches(registry.counter("backup_client_crc_mismatches_total", "Server CRCs that did not match the file")),
+          filesVerified(registry.counter("backup_client_files_verified_total", "Files confirmed by the server")),
+          packetWrite(registry.histogram("backup_client_packet_write_seconds", "Time to write one file packet")) {}
+
+    // Request to response time, registered per request code on first use
+    MetricHistogram& roundTrip(uint16_t code) {
+        MetricHistogram*& histogram = roundTrips[code];
+        if (!histogram) {
+            histogram = &registry.histogram("backup_client_request_rtt_seconds",
+                                            "Time from a request to its response, by request code",
+                                            "code=\"" + std::to_string(code) + "\"");
+        }
+        return *histogram;
+    }
+
+    MetricsRegistry& registry;
+    MetricCounter& bytesRead;
+    MetricCounter& bytesEncrypted;
+    MetricCounter& bytesSent;
+    MetricCounter& packetsSent;
+    MetricCounter& connectRetries;
+    MetricCounter& fileRetries;
+    MetricCounter& crcRetries;
+    MetricCounter& crcMismatches;
+    MetricCounter& filesVerified;
+    MetricHistogram& packetWrite;
+    std::map<uint16_t, MetricHistogram*> roundTrips;
+};
+
 // Enhanced error codes for better debugging
 enum class ErrorType {
     NONE,
@@ -155,24 +243,54 @@ enum class ErrorType {
     SERVER_ERROR
 };
 
+// Negotiated file encryption mode
+enum class CipherMode {
+    AES_CBC,    // Legacy: whole file AES-256-CBC, verified by cksum round trip
+    AES_GCM     // Per-packet AES-256-GCM, verified by authentication tags
+};
+
 class Client {
 private:
     // Boost.Asio networking
     boost::asio::io_context ioContext;
-    std::unique_ptr<boost::asio::ip::tcp::socket> socket;
+    std::unique_ptr<Transport> transport;     // TCP, AF_UNIX for a server on this host, or injected
+    std::unique_ptr<Transport> injectedTransport;  // Given to the constructor; used by the first connect
+    std::string injectedDescription;          // Its describe(), for status output once it is in use
+    FastConnector connector;
+    std::unique_ptr<IoUringEngine> ioEngine;  // Created on the first GCM transfer, kept for retries
+    bool ioEngineUnavailable;                 // io_uring setup failed once; stay on the portable path
+    BufferPool packetPool;                    // Packet frames and transfer responses, reused for the session
+    ZeroCopySender zeroCopy;                  // Holds MSG_ZEROCOPY frames until the kernel completes them
+    std::vector<boost::asio::const_buffer> sendBuffers;  // Gather list for the request being written
+    std::vector<uint8_t> zeroRunAad;          // Scratch AAD for zero-run records
     std::string serverIP;
     uint16_t serverPort;
+    std::string socketPath;                   // transfer.info line 1 "unix:<path>" instead of host:port
     bool connected;
+    bool corkWrites;                          // Profile corks and the platform supports it
+    bool corked;                              // Writes are being coalesced; uncorked before every response wait
     std::atomic<bool> keepAliveEnabled;
     
     // Client info
     std::array<uint8_t, CLIENT_ID_SIZE> clientID;
     std::string username;
     std::string filepath;
+    InputCacheMode inputCacheMode;           // transfer.info read=: cached (default), dropbehind or direct
+    NetworkProfile networkProfile;           // transfer.info profile=: lan (default) or wan
+    std::string capturePath;                 // transfer.info capture=: session capture file (optional)
+    CaptureWriter capture;                   // Request/response framing and timing, when capturePath is set
+    std::string tracePath;                   // transfer.info trace=: Chrome trace of the run (optional)
+    std::string metricsPath;                 // transfer.info metrics=: Prometheus text file (optional)
+    std::string sessionTicketPath;           // BACKUP_CLIENT_SESSION_TICKET: opts in to session resumption
     
     // Crypto
     RSAPrivateWrapper* rsaPrivate;
     std::string aesKey;
+    std::unique_ptr<AESWrapper> aesContext;  // Key schedule for aesKey, expanded once per session key
+    CipherMode cipherMode;
+    uint32_t transferSequence;
+    bool capabilitiesNegotiated;             // Capabilities already agreed in the key handshake
+    bool sparseRuns;                         // CAP_SPARSE_RUNS accepted: zero packets go as REQ_SEND_ZERO_RUN
     
     // Retry counters
     int fileRetries;
@@ -181,8 +299,16 @@ private:
     
     // Transfer statistics
     TransferStats stats;
+    MetricsRegistry metricsRegistry;
+    ClientMetrics metrics;
+    std::chrono::steady_clock::time_point lastMetricsWrite;
+    uint16_t pendingRequestCode;              // Request awaiting a response, for the round-trip metric
+    std::chrono::steady_clock::time_point pendingRequestSent;
     
     // Console output control
+    AsyncLog consoleLog;                      // Every display* call is rendered by its writer thread
+    std::chrono::steady_clock::time_point lastProgressFrame;
+    std::chrono::steady_clock::time_point lastStatsFrame;
     HANDLE hConsole;
     CONSOLE_SCREEN_BUFFER_INFO consoleInfo;
     WORD savedAttributes;
@@ -196,6 +322,10 @@ private:
 
 public:
     Client();
+    // Run the protocol over an already connected transport (e.g. a MemoryTransport end from
+    // MockBackupServer::connectInProcess) instead of the address in transfer.info. It serves
+    // one connection: a reconnect after it is closed fails rather than falling back to TCP.
+    explicit Client(std::unique_ptr<Transport> injected);
     ~Client();
     
     // Main interface
@@ -213,38 +343,70 @@ private:
       // Network operations
     bool connectToServer();
     void closeConnection();
-    bool sendRequest(uint16_t code, const std::vector<uint8_t>& payload = {});
-    bool receiveResponse(ResponseHeader& header, std::vector<uint8_t>& payload);
+    bool sendRequest(uint16_t code, const std::vector<uint8_t>& payload = {}, int timeoutMs = SOCKET_TIMEOUT_MS);
+    bool sendFrame(const uint8_t* frame, size_t size, int timeoutMs);
+    bool sendPacketFrame(BufferPool::Lease& frame, size_t size, int timeoutMs);
+    bool writeSendBuffers(int timeoutMs);
+    void corkSocket();
+    bool checkSend(const boost::system::error_code& ec, int timeoutMs);
+    bool receiveResponse(ResponseHeader& header, std::vector<uint8_t>& payload, bool allowServerError = false,
+                         int timeoutMs = SOCKET_TIMEOUT_MS);
+    bool receiveResponse(ResponseHeader& header, BufferPool::Lease& payload, bool allowServerError = false,
+                         int timeoutMs = SOCKET_TIMEOUT_MS);
+    bool receiveResponseInto(ResponseHeader& header, const std::function<uint8_t*(size_t)>& storage,
+                             bool allowServerError, int timeoutMs);
     bool testConnection();
     void enableKeepAlive();
     
     // Protocol operations
+    bool authenticate();
     bool performRegistration();
+    bool performCombinedRegistration(bool& unsupported);
     bool performReconnection();
     bool sendPublicKey();
+    bool negotiateCapabilities();
+    void applyCapabilities(uint32_t accepted);
+    uint32_t offeredCapabilities() const;
+    bool resumeSession();
+    bool saveSessionTicket(const std::vector<uint8_t>& payload, size_t offset);
     bool transferFile();
-    bool sendFilePacket(const std::string& filename, const std::string& encryptedData, 
-                       uint32_t originalSize, uint16_t packetNum, uint16_t totalPackets);
-    bool verifyCRC(uint32_t serverCRC, const std::vector<uint8_t>& originalData, const std::string& filename);
+    bool transferFileGCM(MappedFile& input, const std::string& filename);
+    bool transferFileGCMUring(const std::string& filename, bool& unsupported);
+    void encryptZeroRun(const std::array<uint8_t, AESWrapper::GCM_NONCE_SIZE>& nonce, const std::vector<uint8_t>& aad,
+                        uint32_t runLength, uint8_t* content);
+    size_t buildGCMFrame(uint8_t* out, const std::string& filename, uint16_t packet, uint16_t totalPackets,
+                         uint32_t originalSize, const uint8_t* plaintext, size_t chunkSize, bool zeroRun,
+                         std::array<uint8_t, AESWrapper::GCM_NONCE_SIZE>& nonce, std::vector<uint8_t>& aad);
+    void ensurePacketPool();
+    BufferPool::Lease acquirePacketBuffer(size_t bytes);
+    void displayPoolStats(uint64_t acquisitionsBefore, uint64_t heapBefore, uint16_t packets);
+    void writeTrace();
+    void writeMetrics();
+    void pollExports();
+    void markRequestSent(uint16_t code);
+    bool verifyCRC(uint32_t serverCRC, uint32_t clientCRC, const std::string& filename);
     
     // Crypto operations
     bool generateRSAKeys();
     bool decryptAESKey(const std::vector<uint8_t>& encryptedKey);
-    std::string encryptFile(const std::vector<uint8_t>& data);
+    bool setSessionKey(const std::string& key);
+    std::string deriveKey(const std::string& key, const std::string& label, const std::vector<uint8_t>& context = {});
+    std::string encryptFile(MappedFile& input, uint32_t& crc);
     
     // Utility functions
-    std::vector<uint8_t> readFile(const std::string& path);
+    bool mapInputFile(MappedFile& input);
     std::string bytesToHex(const uint8_t* data, size_t size);
     std::vector<uint8_t> hexToBytes(const std::string& hex);
     uint32_t calculateCRC32(const uint8_t* data, size_t size);
     std::string formatBytes(size_t bytes);
+    std::string serverAddress() const;
     std::string formatDuration(int seconds);
-    std::string getCurrentTimestamp();
+    std::string getCurrentTimestamp(std::chrono::system_clock::time_point when = std::chrono::system_clock::now());
     
     // Visual feedback
     void displayStatus(const std::string& operation, bool success, const std::string& details = "");
     void displayProgress(const std::string& operation, size_t current, size_t total);
-    void displayTransferStats();
+    void displayTransferStats(bool final);
     void displaySplashScreen();
     void clearLine();
     void displayConnectionInfo();
@@ -254,9 +416,23 @@ private:
     void displaySummary();
 };
 
+// Connection racing and retry policy
+static ConnectOptions makeConnectOptions() {
+    ConnectOptions options;
+    options.attemptDelay = std::chrono::milliseconds(CONNECT_ATTEMPT_DELAY_MS);
+    options.connectTimeout = std::chrono::milliseconds(CONNECT_TIMEOUT_MS);
+    options.backoffBase = std::chrono::milliseconds(RETRY_BACKOFF_BASE_MS);
+    options.backoffCap = std::chrono::milliseconds(RETRY_BACKOFF_CAP_MS);
+    return options;
+}
+
 // Constructor
-Client::Client() : socket(nullptr), connected(false), rsaPrivate(nullptr), 
+Client::Client() : transport(nullptr), connector(ioContext, makeConnectOptions()), ioEngineUnavailable(false),
+                   connected(false), corkWrites(false), corked(false), inputCacheMode(InputCacheMode::Cached),
+                   networkProfile(NetworkProfile::LAN), rsaPrivate(nullptr), 
+                   cipherMode(CipherMode::AES_CBC), transferSequence(0), capabilitiesNegotiated(false), sparseRuns(false),
                    fileRetries(0), crcRetries(0), reconnectAttempts(0),
+                   metrics(metricsRegistry), pendingRequestCode(0),
                    keepAliveEnabled(false), lastError(ErrorType::NONE) {
     std::fill(clientID.begin(), clientID.end(), 0);
     
@@ -274,10 +450,33 @@ Client::Client() : socket(nullptr), connected(false), rsaPrivate(nullptr),
 #endif
 }
 
+Client::Client(std::unique_ptr<Transport> injected) : Client() {
+    if (!injected) {
+        throw std::invalid_argument("Client needs a transport to inject");
+    }
+    injectedDescription = injected->describe();
+    injectedTransport = std::move(injected);
+}
+
 // Destructor
 Client::~Client() {
     keepAliveEnabled = false;
     closeConnection();
+    if (!tracePath.empty()) {
+        writeTrace();
+    }
+    if (!metricsPath.empty()) {
+        writeMetrics();
+    }
+    if (AllocProfile::enabled()) {
+        displayPhase("Heap allocations by phase");
+        consoleLog.post(LogLevel::Info, [table = AllocProfile::table()]() { std::cout << table; });
+    }
+    consoleLog.stop();   // Anything displayed from here on is written directly
+    if (consoleLog.dropped() > 0) {
+        displayStatus("Console output", false, std::to_string(consoleLog.dropped()) +
+                      " messages dropped while the console was behind");
+    }
     if (rsaPrivate) {
         delete rsaPrivate;
     }
@@ -295,12 +494,24 @@ Client::~Client() {
 
 // Initialize client
 bool Client::initialize() {
+    LogFlush flushOnReturn(consoleLog);   // Console is caught up before the caller writes to it
+    AllocPhaseScope allocPhase(AllocPhase::Init);
     operationStartTime = std::chrono::steady_clock::now();
+    LogLevel logLevel = LogLevel::Info;
+    const char* logLevelName = std::getenv(LOG_LEVEL_ENV);
+    bool logLevelValid = !logLevelName || AsyncLog::parseLevel(logLevelName, logLevel);
+    consoleLog.setLevel(logLevel);
+    const char* ticketPath = std::getenv(SESSION_TICKET_ENV);
+    sessionTicketPath = ticketPath ? ticketPath : "";
     displaySplashScreen();
     
     displayPhase("Initialization");
     
     displayStatus("System initialization", true, "Starting client v1.0");
+    if (!logLevelValid) {
+        displayStatus("Log level", false, std::string(LOG_LEVEL_ENV) + "=" + logLevelName +
+                      " not recognized (expected debug, info, warning, error or off) - using info");
+    }
     
     if (!readTransferInfo()) {
         return false;
@@ -310,10 +521,36 @@ bool Client::initialize() {
         return false;
     }
 
+    if (!capturePath.empty()) {
+        std::string error;
+        if (!capture.open(capturePath, error)) {
+            displayError(error, ErrorType::CONFIG);
+            return false;
+        }
+        displayStatus("Session capture", true, "Recording framing and timing to " + capturePath);
+    }
+
+    if (!tracePath.empty()) {
+        Tracer::enable();
+        Tracer::nameThread("client");
+#ifndef _WIN32
+        std::signal(SIGUSR1, [](int) { Tracer::requestDump(); });
+        displayStatus("Tracing", true, "Spans written to " + tracePath + " at exit and on SIGUSR1");
+#else
+        displayStatus("Tracing", true, "Spans written to " + tracePath + " at exit");
+#endif
+    }
+    
+    if (!metricsPath.empty()) {
+        displayStatus("Metrics", true, "Prometheus text file " + metricsPath);
+        writeMetrics();
+    }
+
     // Pre-generate or load RSA keys during initialization to avoid delays during registration
     displayStatus("Preparing RSA keys", true, "1024-bit key pair for encryption");
 
     // Try to load existing keys first to avoid regeneration
+    TraceSpan keySpan("rsa keys");
     if (loadPrivateKey()) {
         displayStatus("RSA keys loaded", true, "Using cached key pair");
     } else {
@@ -331,16 +568,20 @@ bool Client::initialize() {
 
 // Main client run function
 bool Client::run() {
+    LogFlush flushOnReturn(consoleLog);
     displayPhase("Connection Setup");
     
-    displayStatus("Connecting to server", true, serverIP + ":" + std::to_string(serverPort));
+    displayStatus("Connecting to server", true, serverAddress());
     
-    // Try to connect with retries
+    // Try to connect with retries (exponential backoff with jitter between attempts)
     bool connectedSuccessfully = false;
-    for (int attempt = 1; attempt <= 3 && !connectedSuccessfully; attempt++) {
+    for (int attempt = 1; attempt <= MAX_CONNECT_ATTEMPTS && !connectedSuccessfully; attempt++) {
         if (attempt > 1) {
-            displayStatus("Connection attempt", true, "Retry " + std::to_string(attempt) + " of 3");
-            std::this_thread::sleep_for(std::chrono::milliseconds(RECONNECT_DELAY_MS));
+            metrics.connectRetries.add();
+            auto delay = connector.backoffDelay(attempt - 1);
+            displayStatus("Connection attempt", true, "Retry " + std::to_string(attempt) + " of " +
+                         std::to_string(MAX_CONNECT_ATTEMPTS) + " in " + std::to_string(delay.count()) + "ms");
+            std::this_thread::sleep_for(delay);
         }
         
         if (connectToServer()) {
@@ -349,7 +590,7 @@ bool Client::run() {
     }
     
     if (!connectedSuccessfully) {
-        displayError("Failed to connect after 3 attempts", ErrorType::NETWORK);
+        displayError("Failed to connect after " + std::to_string(MAX_CONNECT_ATTEMPTS) + " attempts", ErrorType::NETWORK);
         return false;
     }
       displayConnectionInfo();
@@ -362,13 +603,70 @@ bool Client::run() {
     // Enable keep-alive for long transfers
     enableKeepAlive();
     
+    if (!authenticate()) {
+        return false;
+    }
+    
+    displayPhase("File Transfer");
+    
+    // Transfer the file with retry logic
+    bool transferSuccess = false;
+    fileRetries = 0;
+    
+    while (fileRetries < MAX_RETRIES && !transferSuccess) {
+        if (fileRetries > 0) {
+            metrics.fileRetries.add();
+            displayStatus("File transfer", false, "Retrying (attempt " + 
+                         std::to_string(fileRetries + 1) + " of " + std::to_string(MAX_RETRIES) + ")");
+            std::this_thread::sleep_for(connector.backoffDelay(fileRetries));
+        }
+        
+        // A deadline expired or the server dropped us: start over on a fresh session
+        if (!connected) {
+            displayStatus("Session", false, "Connection lost - reconnecting");
+            if (!connectToServer() || !authenticate()) {
+                fileRetries++;
+                continue;
+            }
+            enableKeepAlive();
+        }
+        
+        if (transferFile()) {
+            transferSuccess = true;
+        } else {
+            fileRetries++;
+        }
+    }
+    
+    if (!transferSuccess) {
+        displayError("File transfer failed after " + std::to_string(MAX_RETRIES) + " attempts", ErrorType::NETWORK);
+        return false;
+    }
+    
+    displayPhase("Transfer Complete");
+    displaySummary();
+    
+    return true;
+}
+
+// Establish a session key on the current connection: resume, reconnect, or register
+bool Client::authenticate() {
+    TraceSpan span("handshake");
+    AllocPhaseScope allocPhase(AllocPhase::Handshake);
     displayPhase("Authentication");
+    capabilitiesNegotiated = false;
     
     // Check if we have existing registration
     bool hasRegistration = loadMeInfo();
     
     if (hasRegistration) {
         displayStatus("Client credentials", true, "Found existing registration");
+    }
+    
+    // A valid session ticket restores the AES session in one round trip without any RSA work
+    if (hasRegistration && !sessionTicketPath.empty() && resumeSession()) {
+        displayStatus("Session resumption", true, "Skipped RSA key exchange");
+    } else if (hasRegistration) {
         displayStatus("Attempting reconnection", true, "Client: " + username);
         
         // Load private key
@@ -387,43 +685,37 @@ bool Client::run() {
     if (!hasRegistration) {
         displayStatus("Registering new client", true, username);
         
-        if (!performRegistration()) {
-            return false;
-        }
-        
-        if (!sendPublicKey()) {
-            return false;
-        }
-    }
-    
-    displayPhase("File Transfer");
-    
-    // Transfer the file with retry logic
-    bool transferSuccess = false;
-    fileRetries = 0;
-    
-    while (fileRetries < MAX_RETRIES && !transferSuccess) {
-        if (fileRetries > 0) {
-            displayStatus("File transfer", false, "Retrying (attempt " + 
-                         std::to_string(fileRetries + 1) + " of " + std::to_string(MAX_RETRIES) + ")");
-            std::this_thread::sleep_for(std::chrono::seconds(2));
-        }
-        
-        if (transferFile()) {
-            transferSuccess = true;
-        } else {
-            fileRetries++;
+        // One round trip for registration + key exchange; older servers close the
+        // connection on the unknown request, so reconnect and use the two-step flow
+        bool unsupported = false;
+        if (!performCombinedRegistration(unsupported)) {
+            if (!unsupported) {
+                return false;
+            }
+            
+            displayStatus("Combined registration", false, "Not supported by server - using two-step registration");
+            closeConnection();
+            if (!connectToServer()) {
+                return false;
+            }
+            enableKeepAlive();
+            
+            if (!performRegistration()) {
+                return false;
+            }
+            
+            if (!sendPublicKey()) {
+                return false;
+            }
         }
     }
     
-    if (!transferSuccess) {
-        displayError("File transfer failed after " + std::to_string(MAX_RETRIES) + " attempts", ErrorType::NETWORK);
+    // Optional: agree on AES-GCM (old servers reject the request and we stay on CBC).
+    // Resumed sessions and combined registrations already agreed on them in their handshake.
+    if (!capabilitiesNegotiated && !negotiateCapabilities()) {
         return false;
     }
     
-    displayPhase("Transfer Complete");
-    displaySummary();
-    
     return true;
 }
 
@@ -437,24 +729,33 @@ bool Client::readTransferInfo() {
     
     std::string line;
     
-    // Line 1: server:port
+    // Line 1: server:port, or unix:<path> for a server on this host
     if (!std::getline(file, line)) {
         displayError("Invalid transfer.info format - missing server address", ErrorType::CONFIG);
         return false;
     }
     
-    size_t colonPos = line.find(':');
-    if (colonPos == std::string::npos) {
-        displayError("Invalid server address format (expected IP:port)", ErrorType::CONFIG);
-        return false;
-    }
-    
-    serverIP = line.substr(0, colonPos);
-    try {
-        serverPort = static_cast<uint16_t>(std::stoi(line.substr(colonPos + 1)));
-    } catch (...) {
-        displayError("Invalid port number", ErrorType::CONFIG);
-        return false;
+    if (line.compare(0, 5, "unix:") == 0) {
+        socketPath = line.substr(5);
+        socketPath.erase(socketPath.find_last_not_of(" \t\r") + 1);
+        if (socketPath.empty()) {
+            displayError("Invalid Unix socket address (expected unix:<path>)", ErrorType::CONFIG);
+            return false;
+        }
+    } else {
+        size_t colonPos = line.find(':');
+        if (colonPos == std::string::npos) {
+            displayError("Invalid server address format (expected IP:port)", ErrorType::CONFIG);
+            return false;
+        }
+        
+        serverIP = line.substr(0, colonPos);
+        try {
+            serverPort = static_cast<uint16_t>(std::stoi(line.substr(colonPos + 1)));
+        } catch (...) {
+            displayError("Invalid port number", ErrorType::CONFIG);
+            return false;
+        }
     }
     
     // Line 2: username
@@ -474,6 +775,54 @@ bool Client::readTransferInfo() {
         return false;
     }
     
+    // Remaining lines (optional): key=value settings, blank lines ignored
+    while (std::getline(file, line)) {
+        line.erase(line.find_last_not_of(" \t\r") + 1);
+        if (line.empty()) {
+            continue;
+        }
+        size_t equals = line.find('=');
+        if (equals == std::string::npos) {
+            displayError("Invalid transfer.info setting: " + line + " (expected key=value)", ErrorType::CONFIG);
+            return false;
+        }
+        std::string key = line.substr(0, equals);
+        std::string value = line.substr(equals + 1);
+        
+        if (key == "read") {
+            // Read mode for background backups of large, hot files
+            if (value.empty() || value == "cached") {
+                inputCacheMode = InputCacheMode::Cached;
+            } else if (value == "dropbehind") {
+                inputCacheMode = InputCacheMode::DropBehind;
+            } else if (value == "direct") {
+                inputCacheMode = InputCacheMode::Direct;
+            } else {
+                displayError("Invalid read mode: " + value + " (expected cached, dropbehind or direct)", ErrorType::CONFIG);
+                return false;
+            }
+        } else if (key == "profile") {
+            // Network profile for socket tuning
+            if (!value.empty() && !parseNetworkProfile(value, networkProfile)) {
+                displayError("Invalid network profile: " + value + " (expected lan or wan)", ErrorType::CONFIG);
+                return false;
+            }
+        } else if (key == "capture") {
+            // Record protocol framing and timing for tests/replay_capture
+            capturePath = value;
+        } else if (key == "trace") {
+            // Chrome trace JSON of connect, handshake and transfer stages
+            tracePath = value;
+        } else if (key == "metrics") {
+            // Prometheus text file for node_exporter's textfile collector
+            metricsPath = value;
+        } else {
+            displayError("Unknown transfer.info setting: " + key +
+                         " (expected read, profile, capture, trace or metrics)", ErrorType::CONFIG);
+            return false;
+        }
+    }
+    
     displayStatus("Configuration loaded", true, "transfer.info parsed successfully");
     return true;
 }
@@ -483,27 +832,24 @@ bool Client::validateConfiguration() {
     displayStatus("Validating configuration", true, "Checking parameters");
     
     // Validate server IP (Boost.Asio will handle IP validation during connect)
-    if (serverIP.empty()) {
+    if (socketPath.empty() && serverIP.empty()) {
         displayError("Invalid IP address: empty", ErrorType::CONFIG);
         return false;
     }
     
     // Validate port
-    if (serverPort == 0 || serverPort > 65535) {
+    if (socketPath.empty() && (serverPort == 0 || serverPort > 65535)) {
         displayError("Invalid port number: " + std::to_string(serverPort), ErrorType::CONFIG);
         return false;
     }
     
     // Validate file exists and get size
-    std::ifstream testFile(filepath, std::ios::binary);
-    if (!testFile.is_open()) {
+    uint64_t fileSize = 0;
+    if (!MappedFile::fileSize(filepath, fileSize)) {
         displayError("File not found: " + filepath, ErrorType::FILE_IO);
         return false;
     }
-    
-    testFile.seekg(0, std::ios::end);
-    stats.totalBytes = testFile.tellg();
-    testFile.close();
+    stats.totalBytes = static_cast<size_t>(fileSize);
     
     if (stats.totalBytes == 0) {
         displayError("File is empty: " + filepath, ErrorType::FILE_IO);
@@ -511,8 +857,13 @@ bool Client::validateConfiguration() {
     }
     
     displayStatus("File validation", true, filepath + " (" + formatBytes(stats.totalBytes) + ")");
-    displayStatus("Server validation", true, serverIP + ":" + std::to_string(serverPort));
+    displayStatus("Server validation", true, serverAddress());
     displayStatus("Username validation", true, username);
+    if (inputCacheMode != InputCacheMode::Cached) {
+        displayStatus("Read mode", true, inputCacheMode == InputCacheMode::Direct
+                                             ? "direct (O_DIRECT, page cache bypassed)"
+                                             : "dropbehind (page cache footprint kept constant)");
+    }
     
     return true;
 }
@@ -642,39 +993,59 @@ bool Client::savePrivateKey() {
 
 // Connect to server
 bool Client::connectToServer() {
+    TraceSpan span("connect");
+    AllocPhaseScope allocPhase(AllocPhase::Handshake);
     try {
-        socket = std::make_unique<boost::asio::ip::tcp::socket>(ioContext);
-        
-        boost::asio::ip::tcp::resolver resolver(ioContext);
-        boost::asio::ip::tcp::resolver::results_type endpoints = 
-            resolver.resolve(serverIP, std::to_string(serverPort));
-        
-        displayStatus("Connecting", true, "Establishing TCP connection...");
-        
-        boost::asio::connect(*socket, endpoints);
-
-        // Verify the connection is actually established
-        if (!socket->is_open()) {
-            displayError("Socket failed to open", ErrorType::NETWORK);
-            return false;
+        boost::system::error_code ec;
+        if (!injectedDescription.empty()) {
+            if (!injectedTransport) {
+                throw std::runtime_error("Injected transport was closed and cannot be reconnected");
+            }
+            transport = std::move(injectedTransport);
+            displayStatus("Connection verified", true, transport->describe());
+        } else if (!socketPath.empty()) {
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+            displayStatus("Connecting", true, "Unix socket " + socketPath);
+            std::unique_ptr<UnixTransport> local(new UnixTransport(ioContext));
+            ec = local->connect(socketPath, std::chrono::milliseconds(CONNECT_TIMEOUT_MS));
+            if (ec) {
+                throw boost::system::system_error(ec);
+            }
+            transport = std::move(local);
+            displayStatus("Connection verified", true, transport->describe());
+#else
+            throw std::runtime_error("Unix sockets are not supported on this platform");
+#endif
+        } else {
+            displayStatus("Connecting", true, "Racing resolved endpoints...");
+            
+            // Resolve and race all endpoints; TCP_NODELAY is set on the winning socket
+            std::unique_ptr<boost::asio::ip::tcp::socket> tcpSocket = connector.connect(serverIP, serverPort, ec);
+            if (!tcpSocket) {
+                throw boost::system::system_error(ec);
+            }
+            transport.reset(new TcpTransport(ioContext, std::move(tcpSocket)));
+            displayStatus("Connection verified", true, transport->describe());
+            displayStatus("Connect latency", true, connector.latencyStats().summary() +
+                         (connector.lastConnectUsedFastOpen() ? ", TCP Fast Open" : ""));
+            
+            // Buffers, notsent-lowat and corking for the profile; nothing has been sent yet
+            boost::asio::ip::tcp::socket& socket = *transport->tcpSocket();
+            SocketTuningOptions tuning = profileOptions(networkProfile);
+            SocketTuningResult tuned = SocketTuning::apply(socket, tuning);
+            corkWrites = tuning.cork && tuned.corkSupported;
+            std::string zeroCopyError;
+            bool zeroCopyEnabled = ZEROCOPY_SEND_ENABLED && zeroCopy.enable(socket, zeroCopyError);
+            displayStatus("Socket tuning", !tuned.shortfall(), std::string(networkProfileName(networkProfile)) + " profile: " +
+                         tuned.summary() + (zeroCopyEnabled ? ", zero-copy" : ""));
         }
-
-        // Get the actual connected endpoint for verification
-        auto localEndpoint = socket->local_endpoint();
-        auto remoteEndpoint = socket->remote_endpoint();
-
-        displayStatus("Connection verified", true,
-                     "Local: " + localEndpoint.address().to_string() + ":" + std::to_string(localEndpoint.port()) +
-                     " -> Remote: " + remoteEndpoint.address().to_string() + ":" + std::to_string(remoteEndpoint.port()));
-
-        // Set socket options for timeouts and keep-alive
-        socket->set_option(boost::asio::ip::tcp::no_delay(true));
-
-        // Small delay to ensure connection is fully established
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        corked = false;
 
         connected = true;
-        displayStatus("Connected", true, "TCP connection established");
+        capture.connectionOpened();
+        displayStatus("Connected", true, !injectedDescription.empty() ? "Injected transport in use"
+                                         : socketPath.empty() ? "TCP connection established"
+                                                              : "Unix socket connection established");
         
         // Update GUI connection status (optional)
         try {
@@ -686,7 +1057,7 @@ bool Client::connectToServer() {
         return true;
         
     } catch (const std::exception& e) {        displayError("Connection failed: " + std::string(e.what()), ErrorType::NETWORK);
-        socket.reset();
+        transport.reset();
         connected = false;
         
         // Update GUI connection status (optional)
@@ -718,27 +1089,30 @@ bool Client::testConnection() {
 
 // Enable keep-alive
 void Client::enableKeepAlive() {
-    if (socket && socket->is_open()) {
-        try {
-            socket->set_option(boost::asio::socket_base::keep_alive(true));
+    // A Unix socket peer on this host cannot vanish silently; keep-alive is TCP-only
+    if (transport && transport->isOpen() && transport->tcpSocket()) {
+        // Detect a dead peer after KEEPALIVE_INTERVAL + KEEPALIVE_PROBES * KEEPALIVE_PROBE_INTERVAL seconds of silence
+        boost::system::error_code ec = DeadlineIO::setKeepAlive(*transport->tcpSocket(), KEEPALIVE_INTERVAL, KEEPALIVE_PROBE_INTERVAL, KEEPALIVE_PROBES);
+        if (!ec) {
             keepAliveEnabled = true;
-            displayStatus("Keep-alive", true, "Enabled for stable connection");
-        } catch (const std::exception& e) {
-            displayStatus("Keep-alive", false, "Could not enable: " + std::string(e.what()));
+            displayStatus("Keep-alive", true, "Probing after " + std::to_string(KEEPALIVE_INTERVAL) + "s idle");
+        } else {
+            displayStatus("Keep-alive", false, "Could not enable: " + ec.message());
         }
     }
 }
 
 // Close connection
 void Client::closeConnection() {
-    if (socket && socket->is_open()) {
-        try {
-            socket->close();
-        } catch (const std::exception&) {
-            // Ignore errors during close
-        }    }
-    socket.reset();
+    zeroCopy.reset();
+    if (transport) {
+        transport->close();   // Errors during close are ignored
+        capture.connectionClosed();
+    }
+    transport.reset();
+    corkWrites = false;
     connected = false;
+    corked = false;
     
     // Update GUI connection status (optional)
     try {
@@ -749,8 +1123,8 @@ void Client::closeConnection() {
 }
 
 // Send request to server
-bool Client::sendRequest(uint16_t code, const std::vector<uint8_t>& payload) {
-    if (!connected || !socket || !socket->is_open()) {
+bool Client::sendRequest(uint16_t code, const std::vector<uint8_t>& payload, int timeoutMs) {
+    if (!connected || !transport || !transport->isOpen()) {
         displayError("Not connected to server", ErrorType::NETWORK);
         return false;
     }
@@ -758,67 +1132,34 @@ bool Client::sendRequest(uint16_t code, const std::vector<uint8_t>& payload) {
     try {
         // CRITICAL FIX: Manually construct header bytes in little-endian format
         // The Python server expects little-endian format explicitly
-        std::vector<uint8_t> headerBytes(23);  // RequestHeader is 23 bytes total
-
-        // Client ID (16 bytes) - copy as-is
-        std::copy(clientID.begin(), clientID.end(), headerBytes.begin());
-
-        // Version (1 byte) - byte 16
-        headerBytes[16] = CLIENT_VERSION;
-
-        // Code (2 bytes, little-endian) - bytes 17-18
-        headerBytes[17] = code & 0xFF;        // Low byte
-        headerBytes[18] = (code >> 8) & 0xFF; // High byte
-
-        // Payload size (4 bytes, little-endian) - bytes 19-22
+        std::array<uint8_t, REQUEST_HEADER_SIZE> headerBytes;
         uint32_t payload_size_val = static_cast<uint32_t>(payload.size());
-        headerBytes[19] = payload_size_val & 0xFF;         // Byte 0
-        headerBytes[20] = (payload_size_val >> 8) & 0xFF;  // Byte 1
-        headerBytes[21] = (payload_size_val >> 16) & 0xFF; // Byte 2
-        headerBytes[22] = (payload_size_val >> 24) & 0xFF; // Byte 3
-        
-        // Debug: show header values for important requests
-        if (code == REQ_REGISTER || code == REQ_RECONNECT || code == REQ_SEND_PUBLIC_KEY) {
-            displayStatus("Debug: Request header", true,
-                         "Version=" + std::to_string(CLIENT_VERSION) +
-                         ", Code=" + std::to_string(code) +
-                         ", PayloadSize=" + std::to_string(payload_size_val));
-
-            // Add hex dump of header bytes for debugging
-            std::stringstream hexDump;
-            hexDump << "Header hex: ";
-            for (size_t i = 0; i < headerBytes.size(); ++i) {
-                hexDump << std::hex << std::setfill('0') << std::setw(2) << static_cast<int>(headerBytes[i]) << " ";
-            }
-            displayStatus("Debug: Header bytes", true, hexDump.str());
-        }
+        Framing::encodeRequestHeader(clientID.data(), code, payload_size_val, headerBytes.data());
         
-        // Send header
-        size_t headerBytesSent = boost::asio::write(*socket, boost::asio::buffer(headerBytes));
-        if (headerBytesSent != headerBytes.size()) {
-            displayError("Failed to send complete header", ErrorType::NETWORK);
-            return false;
-        }
-
-        // Send payload if any
+        // Debug builds (CLIENT_LOG_MIN_LEVEL=0): header values and bytes, formatted by the log writer
+        CLIENT_LOG(consoleLog, LogLevel::Debug, [this, code, payload_size_val, headerBytes]() {
+            std::cout << "[DEBUG] Request header - Version=" << static_cast<int>(CLIENT_VERSION) << ", Code=" << code
+                      << ", PayloadSize=" << payload_size_val << ", hex: " << bytesToHex(headerBytes.data(), headerBytes.size())
+                      << std::endl;
+        });
+        
+        // Send header and payload in one gathered write, bounded by the deadline
+        capture.request(headerBytes.data(), nullptr);
+        markRequestSent(code);
+        sendBuffers.clear();
+        sendBuffers.push_back(boost::asio::buffer(headerBytes));
         if (!payload.empty()) {
-            size_t payloadBytes = boost::asio::write(*socket, boost::asio::buffer(payload));
-            if (payloadBytes != payload.size()) {
-                displayError("Failed to send complete payload", ErrorType::NETWORK);
-                return false;
-            }
+            sendBuffers.push_back(boost::asio::buffer(payload));
         }
-
-        // Force flush the socket to ensure data is sent immediately
-        ioContext.poll();
-
-        // Debug: confirm data was sent for important requests
-        if (code == REQ_REGISTER || code == REQ_RECONNECT || code == REQ_SEND_PUBLIC_KEY) {
-            displayStatus("Debug: Data sent", true,
-                         "Header: " + std::to_string(headerBytesSent) + " bytes, " +
-                         "Payload: " + std::to_string(payload.size()) + " bytes");
+        if (!writeSendBuffers(timeoutMs)) {
+            return false;
         }
 
+        CLIENT_LOG(consoleLog, LogLevel::Debug, [code, headerSize = headerBytes.size(), payloadSize = payload.size()]() {
+            std::cout << "[DEBUG] Request " << code << " sent - Header: " << headerSize << " bytes, Payload: "
+                      << payloadSize << " bytes" << std::endl;
+        });
+
         return true;
         
     } catch (const std::exception& e) {
@@ -827,38 +1168,171 @@ bool Client::sendRequest(uint16_t code, const std::vector<uint8_t>& payload) {
     }
 }
 
+// Send a request that is already framed (header + payload) in one buffer
+bool Client::sendFrame(const uint8_t* frame, size_t size, int timeoutMs) {
+    if (!connected || !transport || !transport->isOpen()) {
+        displayError("Not connected to server", ErrorType::NETWORK);
+        return false;
+    }
+    sendBuffers.clear();
+    sendBuffers.push_back(boost::asio::buffer(frame, size));
+    return writeSendBuffers(timeoutMs);
+}
+
+// Send a packet frame held in a pooled buffer. Large frames go out with MSG_ZEROCOPY when
+// it is enabled; the lease then stays with zeroCopy until the kernel is done with the pages.
+bool Client::sendPacketFrame(BufferPool::Lease& frame, size_t size, int timeoutMs) {
+    TraceSpan span("send", size);
+    capture.request(frame.data(), frame.data() + REQUEST_HEADER_SIZE);
+    markRequestSent(static_cast<uint16_t>(frame.data()[17] | (frame.data()[18] << 8)));
+    metrics.packetsSent.add();
+    auto start = std::chrono::steady_clock::now();
+    bool sent;
+    if (!zeroCopy.isEnabled() || size < ZeroCopySender::MIN_BYTES) {
+        sent = sendFrame(frame.data(), size, timeoutMs);
+    } else if (!connected || !transport || !transport->isOpen()) {
+        displayError("Not connected to server", ErrorType::NETWORK);
+        return false;
+    } else {
+        corkSocket();
+        sent = checkSend(zeroCopy.send(ioContext, *transport->tcpSocket(), std::move(frame), size,
+                                       std::chrono::milliseconds(timeoutMs)),
+                         timeoutMs);
+        if (sent) {
+            metrics.bytesSent.add(size);
+        }
+    }
+    metrics.packetWrite.observe(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count()));
+    return sent;
+}
+
+// Write sendBuffers, bounded by the deadline; a failed write drops the connection
+bool Client::writeSendBuffers(int timeoutMs) {
+    corkSocket();
+    if (!checkSend(transport->write(sendBuffers, std::chrono::milliseconds(timeoutMs)), timeoutMs)) {
+        return false;
+    }
+    metrics.bytesSent.add(boost::asio::buffer_size(sendBuffers));
+    return true;
+}
+
+// Cork until the next response wait, so consecutive frames leave in full segments
+void Client::corkSocket() {
+    if (corkWrites && !corked) {
+        corked = !SocketTuning::setCork(*transport->tcpSocket(), true);
+    }
+}
+
+// Report a failed write and drop the connection: the stream position is unknown
+bool Client::checkSend(const boost::system::error_code& ec, int timeoutMs) {
+    if (ec) {
+        displayError(ec == boost::asio::error::timed_out
+                         ? "Send timed out after " + std::to_string(timeoutMs) + "ms - dropping connection"
+                         : "Failed to send request: " + ec.message(),
+                     ErrorType::NETWORK);
+        closeConnection();
+        return false;
+    }
+    return true;
+}
+
 // Receive response from server
-bool Client::receiveResponse(ResponseHeader& header, std::vector<uint8_t>& payload) {
-    if (!connected || !socket || !socket->is_open()) {
+bool Client::receiveResponse(ResponseHeader& header, std::vector<uint8_t>& payload, bool allowServerError,
+                             int timeoutMs) {
+    payload.clear();
+    return receiveResponseInto(header, [&payload](size_t size) {
+        payload.resize(size);
+        return payload.data();
+    }, allowServerError, timeoutMs);
+}
+
+// Receive a response into a pooled buffer (payload.capacity() >= header.payload_size on success)
+bool Client::receiveResponse(ResponseHeader& header, BufferPool::Lease& payload, bool allowServerError,
+                             int timeoutMs) {
+    payload.release();
+    return receiveResponseInto(header, [this, &payload](size_t size) {
+        payload = acquirePacketBuffer(size);
+        return payload.data();
+    }, allowServerError, timeoutMs);
+}
+
+// storage(size) returns where the payload goes once its size is known
+bool Client::receiveResponseInto(ResponseHeader& header, const std::function<uint8_t*(size_t)>& storage,
+                                 bool allowServerError, int timeoutMs) {
+    if (!connected || !transport || !transport->isOpen()) {
         displayError("Not connected to server", ErrorType::NETWORK);
         return false;
     }
     
+    // Push out anything still held by the cork before waiting on the server
+    if (corked) {
+        SocketTuning::setCork(*transport->tcpSocket(), false);
+        corked = false;
+    }
+    
     try {
+        // The deadline covers the whole response (header + payload)
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+        auto remaining = [&deadline]() {
+            return std::max(std::chrono::milliseconds(1), std::chrono::duration_cast<std::chrono::milliseconds>(
+                deadline - std::chrono::steady_clock::now()));
+        };
+        
         // Receive header
-        boost::asio::read(*socket, boost::asio::buffer(&header, sizeof(header)));
+        uint8_t headerBytes[RESPONSE_HEADER_SIZE];
+        boost::system::error_code ec = transport->read(boost::asio::buffer(headerBytes), remaining());
+        if (ec) {
+            throw boost::system::system_error(ec);
+        }
+        uint16_t code = 0;
+        uint32_t payloadSize = 0;
+        bool versionMatches = Framing::decodeResponseHeader(headerBytes, code, payloadSize);
+        header.version = headerBytes[0];
+        header.code = code;
+        header.payload_size = payloadSize;
         
-        // Check version
-        if (header.version != SERVER_VERSION) {
-            displayError("Invalid server version: " + std::to_string(header.version), ErrorType::PROTOCOL);
-            return false;
+        capture.response(header.code, header.payload_size);
+        if (pendingRequestCode != 0) {
+            metrics.roundTrip(pendingRequestCode).observe(static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() -
+                                                                      pendingRequestSent).count()));
+            pendingRequestCode = 0;
         }
         
-        // Check for error response
-        if (header.code == RESP_ERROR) {
-            displayError("Server returned general error", ErrorType::SERVER_ERROR);
+        // Check version
+        if (!versionMatches) {
+            displayError("Invalid server version: " + std::to_string(header.version), ErrorType::PROTOCOL);
             return false;
         }
         
         // Receive payload if any
-        payload.clear();
         if (header.payload_size > 0) {
-            payload.resize(header.payload_size);
-            boost::asio::read(*socket, boost::asio::buffer(payload));
+            uint8_t* payload = storage(header.payload_size);
+            if (!payload) {
+                throw std::bad_alloc();
+            }
+            ec = transport->read(boost::asio::buffer(payload, header.payload_size), remaining());
+            if (ec) {
+                throw boost::system::system_error(ec);
+            }
+        }
+        
+        // Check for error response (callers probing optional features handle it themselves)
+        if (header.code == RESP_ERROR && !allowServerError) {
+            displayError("Server returned general error", ErrorType::SERVER_ERROR);
+            return false;
         }
         
         return true;
         
+    } catch (const boost::system::system_error& e) {
+        displayError(e.code() == boost::asio::error::timed_out
+                         ? "No response within " + std::to_string(timeoutMs) + "ms - dropping connection"
+                         : "Failed to receive response: " + std::string(e.what()),
+                     ErrorType::NETWORK);
+        closeConnection();
+        return false;
     } catch (const std::exception& e) {
         displayError("Failed to receive response: " + std::string(e.what()), ErrorType::NETWORK);
         return false;
@@ -880,10 +1354,10 @@ bool Client::performRegistration() {
     std::copy(username.begin(), username.end(), payload.begin());
       displayStatus("Sending registration", true, "Username: " + username);
     
-    // Debug: show what we're sending
-    displayStatus("Debug: Registration packet", true, 
-                 "Payload size=" + std::to_string(payload.size()) + 
-                 " bytes, Username='" + username + "'");
+    CLIENT_LOG(consoleLog, LogLevel::Debug, [payloadSize = payload.size(), name = username]() {
+        std::cout << "[DEBUG] Registration packet - Payload size=" << payloadSize << " bytes, Username='" << name << "'"
+                  << std::endl;
+    });
     
     // Send registration request
     if (!sendRequest(REQ_REGISTER, payload)) {
@@ -920,42 +1394,128 @@ bool Client::performRegistration() {
     return true;
 }
 
-// Perform reconnection
-bool Client::performReconnection() {
-    // Prepare reconnection payload
-    std::vector<uint8_t> payload(MAX_NAME_SIZE, 0);
+// Register and exchange keys in one round trip (request 1034).
+// Sets unsupported when the server does not know the request, so the caller can fall back.
+bool Client::performCombinedRegistration(bool& unsupported) {
+    unsupported = false;
+    
+    if (!rsaPrivate) {
+        displayError("RSA keys not available for registration", ErrorType::CRYPTO);
+        return false;
+    }
+    
+    // Payload: name[255] || public key[162] || offered capabilities(4)
+    std::vector<uint8_t> payload(MAX_NAME_SIZE + RSA_KEY_SIZE + 4, 0);
     std::copy(username.begin(), username.end(), payload.begin());
     
-    displayStatus("Sending reconnection", true, "Client ID: " + bytesToHex(clientID.data(), 8) + "...");
+    char publicKeyBuffer[RSAPublicWrapper::KEYSIZE];
+    rsaPrivate->getPublicKey(publicKeyBuffer, RSAPublicWrapper::KEYSIZE);
+    std::copy(publicKeyBuffer, publicKeyBuffer + RSAPublicWrapper::KEYSIZE, payload.begin() + MAX_NAME_SIZE);
     
-    // Send reconnection request
-    if (!sendRequest(REQ_RECONNECT, payload)) {
+    size_t capsOffset = MAX_NAME_SIZE + RSA_KEY_SIZE;
+    const uint32_t capabilities = offeredCapabilities();
+    payload[capsOffset] = capabilities & 0xFF;
+    payload[capsOffset + 1] = (capabilities >> 8) & 0xFF;
+    payload[capsOffset + 2] = (capabilities >> 16) & 0xFF;
+    payload[capsOffset + 3] = (capabilities >> 24) & 0xFF;
+    
+    displayStatus("Sending registration", true, "Username + RSA 1024-bit public key in one request");
+    
+    if (!sendRequest(REQ_REGISTER_WITH_KEY, payload)) {
         return false;
     }
     
-    // Receive response
     ResponseHeader header;
     std::vector<uint8_t> responsePayload;
-    if (!receiveResponse(header, responsePayload)) {
+    if (!receiveResponse(header, responsePayload, true)) {
         return false;
     }
     
-    if (header.code == RESP_RECONNECT_FAIL) {
+    if (header.code == RESP_ERROR) {
+        unsupported = true;
         return false;
     }
     
-    if (header.code != RESP_RECONNECT_AES_SENT || responsePayload.size() <= CLIENT_ID_SIZE) {
-        displayError("Invalid reconnection response", ErrorType::PROTOCOL);
+    if (header.code == RESP_REGISTER_FAIL) {
+        displayError("Registration failed: Username already exists", ErrorType::AUTHENTICATION);
         return false;
     }
     
-    // Extract encrypted AES key
-    std::vector<uint8_t> encryptedKey(responsePayload.begin() + CLIENT_ID_SIZE, responsePayload.end());
-    
-    displayStatus("Decrypting AES key", true, "Using stored RSA private key");
-    
-    // Decrypt AES key
-    if (!decryptAESKey(encryptedKey)) {
+    // Response: client ID(16) || accepted capabilities(4) || key size(2) || encrypted AES key || [ticket]
+    const size_t keyOffset = CLIENT_ID_SIZE + 4 + 2;
+    if (header.code != RESP_REGISTER_KEY_AES_SENT || responsePayload.size() < keyOffset) {
+        displayError("Invalid registration response", ErrorType::PROTOCOL);
+        return false;
+    }
+    
+    uint32_t accepted = static_cast<uint32_t>(responsePayload[CLIENT_ID_SIZE]) |
+                        (static_cast<uint32_t>(responsePayload[CLIENT_ID_SIZE + 1]) << 8) |
+                        (static_cast<uint32_t>(responsePayload[CLIENT_ID_SIZE + 2]) << 16) |
+                        (static_cast<uint32_t>(responsePayload[CLIENT_ID_SIZE + 3]) << 24);
+    size_t keySize = static_cast<size_t>(responsePayload[CLIENT_ID_SIZE + 4]) |
+                     (static_cast<size_t>(responsePayload[CLIENT_ID_SIZE + 5]) << 8);
+    if (keySize == 0 || responsePayload.size() < keyOffset + keySize) {
+        displayError("Invalid registration response", ErrorType::PROTOCOL);
+        return false;
+    }
+    
+    std::copy(responsePayload.begin(), responsePayload.begin() + CLIENT_ID_SIZE, clientID.begin());
+    if (!saveMeInfo() || !savePrivateKey()) {
+        displayError("Failed to save registration info", ErrorType::FILE_IO);
+        return false;
+    }
+    displayStatus("Registration", true, "New client ID: " + bytesToHex(clientID.data(), 8) + "...");
+    
+    std::vector<uint8_t> encryptedKey(responsePayload.begin() + keyOffset, responsePayload.begin() + keyOffset + keySize);
+    if (!decryptAESKey(encryptedKey)) {
+        return false;
+    }
+    displayStatus("Key exchange", true, "AES-256 key established");
+    
+    applyCapabilities(accepted);
+    if (accepted & CAP_SESSION_TICKET) {
+        saveSessionTicket(responsePayload, keyOffset + keySize);
+    }
+    capabilitiesNegotiated = true;
+    return true;
+}
+
+// Perform reconnection
+bool Client::performReconnection() {
+    // Prepare reconnection payload
+    std::vector<uint8_t> payload(MAX_NAME_SIZE, 0);
+    std::copy(username.begin(), username.end(), payload.begin());
+    
+    displayStatus("Sending reconnection", true, "Client ID: " + bytesToHex(clientID.data(), 8) + "...");
+    
+    // Send reconnection request
+    if (!sendRequest(REQ_RECONNECT, payload)) {
+        return false;
+    }
+    
+    // Receive response
+    ResponseHeader header;
+    std::vector<uint8_t> responsePayload;
+    if (!receiveResponse(header, responsePayload)) {
+        return false;
+    }
+    
+    if (header.code == RESP_RECONNECT_FAIL) {
+        return false;
+    }
+    
+    if (header.code != RESP_RECONNECT_AES_SENT || responsePayload.size() <= CLIENT_ID_SIZE) {
+        displayError("Invalid reconnection response", ErrorType::PROTOCOL);
+        return false;
+    }
+    
+    // Extract encrypted AES key
+    std::vector<uint8_t> encryptedKey(responsePayload.begin() + CLIENT_ID_SIZE, responsePayload.end());
+    
+    displayStatus("Decrypting AES key", true, "Using stored RSA private key");
+    
+    // Decrypt AES key
+    if (!decryptAESKey(encryptedKey)) {
         return false;
     }
     
@@ -1014,17 +1574,196 @@ bool Client::sendPublicKey() {
     return true;
 }
 
+// Negotiate optional protocol capabilities (falls back to AES-CBC on old servers)
+bool Client::negotiateCapabilities() {
+    cipherMode = CipherMode::AES_CBC;
+    sparseRuns = false;
+    
+    const uint32_t capabilities = offeredCapabilities();
+    std::vector<uint8_t> payload(4);
+    payload[0] = capabilities & 0xFF;
+    payload[1] = (capabilities >> 8) & 0xFF;
+    payload[2] = (capabilities >> 16) & 0xFF;
+    payload[3] = (capabilities >> 24) & 0xFF;
+    
+    if (!sendRequest(REQ_NEGOTIATE_CAPS, payload)) {
+        return false;
+    }
+    
+    ResponseHeader header;
+    std::vector<uint8_t> responsePayload;
+    if (!receiveResponse(header, responsePayload, true)) {
+        return false;
+    }
+    
+    // Servers without capability support answer with a general error and keep the session open
+    if (header.code != RESP_CAPS_ACCEPTED || responsePayload.size() < 4) {
+        displayStatus("Cipher negotiation", true, "Server does not support capabilities - using AES-256-CBC");
+        return true;
+    }
+    
+    uint32_t accepted = static_cast<uint32_t>(responsePayload[0]) |
+                        (static_cast<uint32_t>(responsePayload[1]) << 8) |
+                        (static_cast<uint32_t>(responsePayload[2]) << 16) |
+                        (static_cast<uint32_t>(responsePayload[3]) << 24);
+    
+    applyCapabilities(accepted);
+    if (accepted & CAP_SESSION_TICKET) {
+        saveSessionTicket(responsePayload, 4);
+    }
+    return true;
+}
+
+// Switch to the cipher the server accepted
+void Client::applyCapabilities(uint32_t accepted) {
+    if (accepted & CAP_AES_GCM) {
+        cipherMode = CipherMode::AES_GCM;
+        displayStatus("Cipher negotiation", true, "AES-256-GCM with per-packet authentication");
+    } else {
+        cipherMode = CipherMode::AES_CBC;
+        displayStatus("Cipher negotiation", true, "AES-256-GCM declined - using AES-256-CBC");
+    }
+    sparseRuns = cipherMode == CipherMode::AES_GCM && (accepted & CAP_SPARSE_RUNS);
+}
+
+// Resume the previous session from sessionTicketPath: one round trip, no RSA operations.
+// Returns false (and leaves the connection usable for a normal reconnect) if there is no
+// ticket or the server rejects it.
+bool Client::resumeSession() {
+    std::ifstream file(sessionTicketPath);
+    if (!file.is_open()) {
+        return false;
+    }
+    
+    // Line 1: username, line 2: client ID hex, line 3: expiry (unix seconds),
+    // line 4: resumption secret base64, line 5: ticket base64
+    std::string name, idHex, expiryLine, secretLine, ticketLine;
+    bool complete = std::getline(file, name) && std::getline(file, idHex) && std::getline(file, expiryLine) &&
+                    std::getline(file, secretLine) && std::getline(file, ticketLine);
+    file.close();
+    
+    // Tickets are single use: whatever happens next, this one is spent
+    std::remove(sessionTicketPath.c_str());
+    
+    if (!complete || name != username || idHex != bytesToHex(clientID.data(), CLIENT_ID_SIZE)) {
+        return false;
+    }
+    
+    std::string resumptionSecret;
+    std::string ticket;
+    try {
+        if (std::stoll(expiryLine) <= static_cast<long long>(std::time(nullptr))) {
+            displayStatus("Session ticket", false, "Expired - using full reconnection");
+            return false;
+        }
+        resumptionSecret = Base64Wrapper::decode(secretLine);
+        ticket = Base64Wrapper::decode(ticketLine);
+    } catch (...) {
+        return false;
+    }
+    if (resumptionSecret.size() != AES_KEY_SIZE || ticket.empty()) {
+        return false;
+    }
+    
+    std::vector<uint8_t> clientNonce(RESUME_NONCE_SIZE);
+    SecureRandom::generate(clientNonce.data(), clientNonce.size());
+    
+    // Payload: capabilities(4) || client nonce(16) || ticket
+    const uint32_t capabilities = offeredCapabilities();
+    std::vector<uint8_t> payload(4);
+    payload[0] = capabilities & 0xFF;
+    payload[1] = (capabilities >> 8) & 0xFF;
+    payload[2] = (capabilities >> 16) & 0xFF;
+    payload[3] = (capabilities >> 24) & 0xFF;
+    payload.insert(payload.end(), clientNonce.begin(), clientNonce.end());
+    payload.insert(payload.end(), ticket.begin(), ticket.end());
+    
+    displayStatus("Resuming session", true, "Client ID: " + idHex.substr(0, 16) + "...");
+    
+    if (!sendRequest(REQ_RESUME_SESSION, payload)) {
+        return false;
+    }
+    
+    ResponseHeader header;
+    std::vector<uint8_t> responsePayload;
+    if (!receiveResponse(header, responsePayload, true)) {
+        return false;
+    }
+    
+    // RESP_RESUME_FAIL: unknown/expired/replayed ticket; RESP_ERROR: server without resumption support
+    if (header.code != RESP_RESUME_OK || responsePayload.size() < 4 + RESUME_NONCE_SIZE) {
+        displayStatus("Session ticket", false, "Rejected by server - using full reconnection");
+        return false;
+    }
+    
+    uint32_t accepted = static_cast<uint32_t>(responsePayload[0]) |
+                        (static_cast<uint32_t>(responsePayload[1]) << 8) |
+                        (static_cast<uint32_t>(responsePayload[2]) << 16) |
+                        (static_cast<uint32_t>(responsePayload[3]) << 24);
+    
+    // Session key = HMAC-SHA256(resumption secret, label || client nonce || server nonce)
+    std::vector<uint8_t> context(clientNonce);
+    context.insert(context.end(), responsePayload.begin() + 4, responsePayload.begin() + 4 + RESUME_NONCE_SIZE);
+    if (!setSessionKey(deriveKey(resumptionSecret, RESUMED_KEY_LABEL, context))) {
+        return false;
+    }
+    
+    applyCapabilities(accepted);
+    if (accepted & CAP_SESSION_TICKET) {
+        saveSessionTicket(responsePayload, 4 + RESUME_NONCE_SIZE);
+    }
+    
+    capabilitiesNegotiated = true;
+    return true;
+}
+
+// Capabilities sent to the server; tickets only when session resumption is opted in
+uint32_t Client::offeredCapabilities() const {
+    return CLIENT_CAPABILITIES | (sessionTicketPath.empty() ? 0 : CAP_SESSION_TICKET);
+}
+
+// Store the ticket at payload[offset]: lifetime(4) || ticket, with the resumption secret for the current key
+bool Client::saveSessionTicket(const std::vector<uint8_t>& payload, size_t offset) {
+    if (payload.size() <= offset + 4 || aesKey.size() != AES_KEY_SIZE) {
+        return false;
+    }
+    
+    uint32_t lifetime = static_cast<uint32_t>(payload[offset]) |
+                        (static_cast<uint32_t>(payload[offset + 1]) << 8) |
+                        (static_cast<uint32_t>(payload[offset + 2]) << 16) |
+                        (static_cast<uint32_t>(payload[offset + 3]) << 24);
+    std::string ticket(payload.begin() + offset + 4, payload.end());
+    std::string resumptionSecret = deriveKey(aesKey, RESUMPTION_SECRET_LABEL);
+    
+    std::ofstream file(sessionTicketPath, std::ios::trunc);
+    if (!file.is_open()) {
+        displayStatus("Session ticket", false, "Cannot create " + sessionTicketPath);
+        return false;
+    }
+    
+    file << username << "\n";
+    file << bytesToHex(clientID.data(), CLIENT_ID_SIZE) << "\n";
+    file << (static_cast<long long>(std::time(nullptr)) + lifetime) << "\n";
+    file << Base64Wrapper::encode(resumptionSecret) << "\n";
+    file << Base64Wrapper::encode(ticket) << "\n";
+    
+    displayStatus("Session ticket", true, "Valid for " + formatDuration(static_cast<int>(lifetime)));
+    return true;
+}
+
 // Transfer file
 bool Client::transferFile() {
-    // Read file
+    TraceSpan span("transfer", static_cast<uint64_t>(fileRetries) + 1);
+    AllocPhaseScope allocPhase(AllocPhase::Read);
+    
+    // Map file
     displayStatus("Reading file", true, filepath);
-    auto fileData = readFile(filepath);
-    if (fileData.empty()) {
-        displayError("Cannot read file or file is empty", ErrorType::FILE_IO);
+    MappedFile input;
+    if (!mapInputFile(input)) {
         return false;
     }
     
-    stats.totalBytes = fileData.size();
+    stats.totalBytes = input.size();
     stats.reset();
     
     // Extract filename
@@ -1035,54 +1774,93 @@ bool Client::transferFile() {
     }
     
     displayStatus("File details", true, "Name: " + filename + ", Size: " + formatBytes(stats.totalBytes));
-    displayStatus("Encrypting file", true, "AES-256-CBC encryption");
     
-    // Encrypt file
-    std::string encryptedData = encryptFile(fileData);
+    if (cipherMode == CipherMode::AES_GCM) {
+        bool unsupported = false;
+        bool result = transferFileGCMUring(filename, unsupported);
+        if (!unsupported) {
+            return result;
+        }
+        return transferFileGCM(input, filename);
+    }
+    
+    if (inputCacheMode == InputCacheMode::Direct) {
+        displayStatus("Read mode", false, "Direct reads need AES-GCM - dropping pages behind the cursor instead");
+    }
+    displayStatus("Encrypting file", true, "AES-256-CBC encryption + cksum, " + formatBytes(INPUT_RELEASE_WINDOW) +
+                  " at a time");
+    
+    // Encrypt and checksum window by window, releasing each before the next, then unmap
+    // before the network phase
+    uint32_t clientCRC = 0;
+    std::string encryptedData = encryptFile(input, clientCRC);
     if (encryptedData.empty()) {
         return false;
     }
     
     displayStatus("Encryption complete", true, "Encrypted size: " + formatBytes(encryptedData.size()));
+    if (inputCacheMode != InputCacheMode::Cached) {
+        const PageCacheTracker& cache = input.cacheTracker();
+        displayStatus("Page cache", true, "Dropped " + formatBytes(static_cast<size_t>(cache.droppedBytes())) + ", kept " +
+                      formatBytes(static_cast<size_t>(cache.preservedBytes())) + " cached by other processes");
+    }
+    uint32_t originalSize = static_cast<uint32_t>(input.size());
+    input.close();
     
     // Calculate packets
+    AllocPhaseScope sendPhase(AllocPhase::Send);
     size_t encryptedSize = encryptedData.size();
     uint16_t totalPackets = static_cast<uint16_t>((encryptedSize + MAX_PACKET_SIZE - 1) / MAX_PACKET_SIZE);
     
     displayStatus("Transfer preparation", true, "Splitting into " + std::to_string(totalPackets) + " packets");
     displaySeparator();
     
-    // Send packets
+    // Send packets, each framed in a pooled buffer
+    ensurePacketPool();
+    uint64_t acquisitionsBefore = packetPool.acquisitions();
+    uint64_t heapBefore = packetPool.heapAllocations();
     for (uint16_t packet = 1; packet <= totalPackets; packet++) {
         size_t offset = (packet - 1) * MAX_PACKET_SIZE;
         size_t chunkSize = std::min(MAX_PACKET_SIZE, encryptedSize - offset);
         
-        std::string chunk = encryptedData.substr(offset, chunkSize);
+        BufferPool::Lease frame = acquirePacketBuffer(REQUEST_HEADER_SIZE + FILE_PACKET_HEADER_SIZE + chunkSize);
+        if (!frame.valid()) {
+            displayError("Out of memory for packet " + std::to_string(packet), ErrorType::FILE_IO);
+            return false;
+        }
+        Framing::encodeRequestHeader(clientID.data(), REQ_SEND_FILE, static_cast<uint32_t>(FILE_PACKET_HEADER_SIZE + chunkSize),
+                                     frame.data());
+        Framing::encodeFilePacketHeader(filename, static_cast<uint32_t>(chunkSize), originalSize, packet, totalPackets,
+                                        frame.data() + REQUEST_HEADER_SIZE);
+        std::memcpy(frame.data() + REQUEST_HEADER_SIZE + FILE_PACKET_HEADER_SIZE, encryptedData.data() + offset, chunkSize);
         
-        if (!sendFilePacket(filename, chunk, static_cast<uint32_t>(fileData.size()), packet, totalPackets)) {
+        if (!sendPacketFrame(frame, REQUEST_HEADER_SIZE + FILE_PACKET_HEADER_SIZE + chunkSize, PACKET_WRITE_TIMEOUT_MS)) {
             return false;
         }
         
         stats.update(offset + chunkSize);
         displayProgress("Transferring", stats.transferredBytes, encryptedData.size());
+        pollExports();
         
-        if (packet % 10 == 0 || packet == totalPackets) {
-            displayTransferStats();
-        }
+        displayTransferStats(packet == totalPackets);
     }
     
     displaySeparator();
     displayStatus("Transfer complete", true, "All packets sent successfully");
+    displayPoolStats(acquisitionsBefore, heapBefore, totalPackets);
     displayStatus("Waiting for server", true, "Server calculating CRC...");
     
     // Receive CRC response
     ResponseHeader header;
-    std::vector<uint8_t> responsePayload;
-    if (!receiveResponse(header, responsePayload)) {
+    BufferPool::Lease responsePayload;
+    AllocPhaseScope verifyPhase(AllocPhase::Verify);
+    TraceSpan waitSpan("crc wait");
+    if (!receiveResponse(header, responsePayload, false, CRC_WAIT_TIMEOUT_MS)) {
         return false;
     }
+    waitSpan.end();
     
-    if (header.code != RESP_FILE_OK || responsePayload.size() < 279) {
+    if (header.code != RESP_FILE_CRC || header.payload_size < 279) {
         displayError("Invalid file transfer response", ErrorType::PROTOCOL);
         return false;
     }
@@ -1092,46 +1870,526 @@ bool Client::transferFile() {
     std::memcpy(&serverCRC, responsePayload.data() + 275, 4);
     
     // Verify CRC
-    return verifyCRC(serverCRC, fileData, filename);
+    return verifyCRC(serverCRC, clientCRC, filename);
 }
 
-// Send file packet
-bool Client::sendFilePacket(const std::string& filename, const std::string& encryptedData,
-                           uint32_t originalSize, uint16_t packetNum, uint16_t totalPackets) {
-    // Create payload
-    std::vector<uint8_t> payload;
+// Transfer file with per-packet AES-GCM: each packet is encrypted just before it is sent,
+// carries its own nonce and tag, and the server acknowledges the authenticated file directly
+bool Client::transferFileGCM(MappedFile& input, const std::string& filename) {
+    if (aesKey.size() != AES_KEY_SIZE || !aesContext) {
+        displayError("No AES key available", ErrorType::CRYPTO);
+        return false;
+    }
     
-    // Add metadata
-    uint32_t encryptedSize = static_cast<uint32_t>(encryptedData.size());
-    payload.insert(payload.end(), reinterpret_cast<uint8_t*>(&encryptedSize),
-                   reinterpret_cast<uint8_t*>(&encryptedSize) + 4);
+    size_t fileSize = input.size();
+    uint16_t totalPackets = static_cast<uint16_t>((fileSize + GCM_CHUNK_SIZE - 1) / GCM_CHUNK_SIZE);
+    uint32_t originalSize = static_cast<uint32_t>(fileSize);
     
-    payload.insert(payload.end(), reinterpret_cast<uint8_t*>(&originalSize),
-                   reinterpret_cast<uint8_t*>(&originalSize) + 4);
+    // Nonce = transfer sequence (4 bytes) || packet number (8 bytes); unique for this session key
+    transferSequence++;
     
-    payload.insert(payload.end(), reinterpret_cast<uint8_t*>(&packetNum),
-                   reinterpret_cast<uint8_t*>(&packetNum) + 2);
+    displayStatus("Encrypting file", true, "AES-256-GCM, " + std::to_string(totalPackets) + " authenticated packets");
+    displaySeparator();
+    
+    std::array<uint8_t, AESWrapper::GCM_NONCE_SIZE> nonce;   // Zero-run records (data packets build their own)
+    std::vector<uint8_t> aad(Framing::GCM_AAD_SIZE);
+    
+    // Packets inside a hole are never read; other packets are scanned for zeros
+    HoleMap holes;
+    if (sparseRuns) {
+        holes.load(filepath, fileSize);
+    }
+    uint16_t zeroRunPackets = 0;
+    uint64_t holeBytes = 0;
+    uint64_t zeroBytes = 0;
+    
+    // Each packet is encrypted straight into a pooled frame behind its headers
+    ensurePacketPool();
+    uint64_t acquisitionsBefore = packetPool.acquisitions();
+    uint64_t heapBefore = packetPool.heapAllocations();
+    
+    AllocPhaseScope sendPhase(AllocPhase::Send);   // Encryption below is counted separately
+    for (uint16_t packet = 1; packet <= totalPackets; packet++) {
+        size_t offset = static_cast<size_t>(packet - 1) * GCM_CHUNK_SIZE;
+        size_t chunkSize = std::min(GCM_CHUNK_SIZE, fileSize - offset);
+        bool hole = sparseRuns && holes.isHole(offset, chunkSize);
+        bool zeroRun = hole || (sparseRuns && isAllZero(input.data() + offset, chunkSize));
+        
+        BufferPool::Lease frame = acquirePacketBuffer(REQUEST_HEADER_SIZE + FILE_PACKET_HEADER_SIZE + chunkSize +
+                                                      GCM_PACKET_OVERHEAD);
+        if (!frame.valid()) {
+            displayError("Out of memory for packet " + std::to_string(packet), ErrorType::FILE_IO);
+            return false;
+        }
+        size_t frameSize;
+        try {
+            AllocPhaseScope encryptPhase(AllocPhase::Encrypt);
+            TraceSpan encryptSpan("encrypt", packet);
+            frameSize = buildGCMFrame(frame.data(), filename, packet, totalPackets, originalSize,
+                                      input.data() + offset, chunkSize, zeroRun, nonce, aad);
+        } catch (const std::exception& e) {
+            displayError("Failed to encrypt packet " + std::to_string(packet) + ": " + e.what(), ErrorType::CRYPTO);
+            return false;
+        }
+        
+        if (!sendPacketFrame(frame, frameSize, PACKET_WRITE_TIMEOUT_MS)) {
+            return false;
+        }
+        if (zeroRun) {
+            zeroRunPackets++;
+            (hole ? holeBytes : zeroBytes) += chunkSize;
+        }
+        if (!hole) {
+            metrics.bytesRead.add(chunkSize);
+        }
+        input.releaseBefore(offset + chunkSize);
+        
+        stats.update(offset + chunkSize);
+        displayProgress("Transferring", stats.transferredBytes, fileSize);
+        pollExports();
+        
+        displayTransferStats(packet == totalPackets);
+    }
     
-    payload.insert(payload.end(), reinterpret_cast<uint8_t*>(&totalPackets),
-                   reinterpret_cast<uint8_t*>(&totalPackets) + 2);
+    displaySeparator();
+    displayStatus("Transfer complete", true, "All packets sent successfully");
+    displayPoolStats(acquisitionsBefore, heapBefore, totalPackets);
+    if (zeroRunPackets > 0) {
+        displayStatus("Sparse file", true, std::to_string(zeroRunPackets) + " packets sent as zero runs (" +
+                      formatBytes(static_cast<size_t>(holeBytes)) + " in holes, " +
+                      formatBytes(static_cast<size_t>(zeroBytes)) + " zero blocks)");
+    }
+    if (inputCacheMode != InputCacheMode::Cached) {
+        const PageCacheTracker& cache = input.cacheTracker();
+        displayStatus("Page cache", true, "Dropped " + formatBytes(static_cast<size_t>(cache.droppedBytes())) + ", kept " +
+                      formatBytes(static_cast<size_t>(cache.preservedBytes())) + " cached by other processes");
+    }
+    displayStatus("Waiting for server", true, "Server verifying authentication tags...");
     
-    // Add filename (255 bytes)
-    std::vector<uint8_t> filenameBytes(255, 0);
-    std::copy(filename.begin(), filename.end(), filenameBytes.begin());
-    payload.insert(payload.end(), filenameBytes.begin(), filenameBytes.end());
+    // Tags replace the cksum round trip: the server acknowledges a fully authenticated file
+    ResponseHeader header;
+    BufferPool::Lease responsePayload;
+    AllocPhaseScope verifyPhase(AllocPhase::Verify);
+    TraceSpan waitSpan("crc wait");
+    if (!receiveResponse(header, responsePayload, false, CRC_WAIT_TIMEOUT_MS)) {
+        return false;
+    }
+    waitSpan.end();
     
-    // Add encrypted data
-    payload.insert(payload.end(), encryptedData.begin(), encryptedData.end());
+    if (header.code != RESP_ACK) {
+        displayError("Invalid file transfer response", ErrorType::PROTOCOL);
+        return false;
+    }
     
-    return sendRequest(REQ_SEND_FILE, payload);
+    metrics.filesVerified.add();
+    displayStatus("Integrity verification", true, "✓ All packets authenticated by server");
+    return true;
 }
 
-// Verify CRC
-bool Client::verifyCRC(uint32_t serverCRC, const std::vector<uint8_t>& originalData, const std::string& filename) {
-    displayStatus("Calculating CRC", true, "Using cksum algorithm");
+// Zero-run record for an all-zero packet: the plaintext is the run length (uint32) and the
+// AAD carries ZERO_RUN_LABEL, so the record cannot be replayed as a data packet. Writes
+// nonce || ciphertext || tag (ZERO_RUN_CONTENT_SIZE bytes) to content.
+void Client::encryptZeroRun(const std::array<uint8_t, AESWrapper::GCM_NONCE_SIZE>& nonce, const std::vector<uint8_t>& aad,
+                            uint32_t runLength, uint8_t* content) {
+    zeroRunAad.assign(aad.begin(), aad.end());
+    zeroRunAad.insert(zeroRunAad.end(), ZERO_RUN_LABEL, ZERO_RUN_LABEL + sizeof(ZERO_RUN_LABEL) - 1);
+    char length[4];
+    std::memcpy(length, &runLength, 4);
+    std::copy(nonce.begin(), nonce.end(), content);
+    aesContext->encryptGCM(nonce.data(), zeroRunAad.data(), zeroRunAad.size(), length, sizeof(length),
+                           content + nonce.size());
+}
+
+// GCM transfer pipelined through io_uring: IO_URING_READ_AHEAD file reads stay in flight
+// ahead of the packet being encrypted, each packet is encrypted straight into a
+// registered send buffer, and its socket write is submitted together with the read that
+// refills the freed input buffer in one io_uring_enter(). Sets unsupported (and sends
+// nothing) when io_uring cannot be used, so the caller can take the mmap + Asio path.
+bool Client::transferFileGCMUring(const std::string& filename, bool& unsupported) {
+    unsupported = true;
+#ifdef CLIENT_HAVE_IO_URING
+    if (!IO_URING_ENABLED || ioEngineUnavailable || !connected || !transport || transport->nativeHandle() < 0) {
+        return false;
+    }
+    if (aesKey.size() != AES_KEY_SIZE || !aesContext) {
+        return false;  // The portable path reports the missing key
+    }
+    
+    // Read buffers also hold an O_DIRECT span: the chunk widened to alignment on both ends
+    const size_t bufferSize = std::max(REQUEST_HEADER_SIZE + FILE_PACKET_HEADER_SIZE + MAX_PACKET_SIZE,
+                                       GCM_CHUNK_SIZE + 2 * DIRECT_IO_ALIGNMENT);
+    std::string error;
+    if (!ioEngine) {
+        std::unique_ptr<IoUringEngine> engine(new IoUringEngine());
+        if (!engine->init(IO_URING_QUEUE_DEPTH, IO_URING_READ_AHEAD + IO_URING_SEND_BUFFERS, bufferSize, error)) {
+            displayStatus("io_uring", false, error + " - using mmap + Asio");
+            ioEngineUnavailable = true;
+            return false;
+        }
+        ioEngine = std::move(engine);
+    }
+    IoUringEngine& engine = *ioEngine;
+    
+    // Direct reads bypass the page cache; filesystems without O_DIRECT get drop-behind instead
+    bool direct = false;
+    int fileFd = -1;
+    if (inputCacheMode == InputCacheMode::Direct) {
+        fileFd = open(filepath.c_str(), O_RDONLY | O_CLOEXEC | O_DIRECT);
+        direct = fileFd >= 0;
+    }
+    if (fileFd < 0) {
+        fileFd = open(filepath.c_str(), O_RDONLY | O_CLOEXEC);
+    }
+    struct stat info;
+    if (fileFd < 0 || fstat(fileFd, &info) != 0 || static_cast<size_t>(info.st_size) != stats.totalBytes) {
+        if (fileFd >= 0) {
+            close(fileFd);
+        }
+        return false;
+    }
+    posix_fadvise(fileFd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    
+    // Fixed file slots: 0 = input file, 1 = socket
+    const unsigned FILE_SLOT = 0;
+    const unsigned SOCKET_SLOT = 1;
+    if (!engine.registerFiles({fileFd, transport->nativeHandle()}, error)) {
+        close(fileFd);
+        displayStatus("io_uring", false, error + " - using mmap + Asio");
+        return false;
+    }
+    unsupported = false;
+    
+    size_t fileSize = stats.totalBytes;
+    uint16_t totalPackets = static_cast<uint16_t>((fileSize + GCM_CHUNK_SIZE - 1) / GCM_CHUNK_SIZE);
+    uint32_t originalSize = static_cast<uint32_t>(fileSize);
+    transferSequence++;
+    
+    PageCacheTracker cacheTracker;
+    bool dropBehind = !direct && inputCacheMode != InputCacheMode::Cached;
+    if (dropBehind) {
+        cacheTracker.snapshot(fileFd, fileSize);
+    }
+    
+    displayStatus("Encrypting file", true, "AES-256-GCM, " + std::to_string(totalPackets) +
+                  " authenticated packets (io_uring" + (engine.buffersRegistered() ? ", registered buffers" : "") +
+                  (direct ? ", O_DIRECT)" : dropBehind ? ", drop-behind)" : ")"));
+    displaySeparator();
+    
+    // Buffers [0, READ_AHEAD) hold plaintext, the rest hold complete wire packets. A read
+    // covers [begin, begin + span); the packet's plaintext starts skip bytes in.
+    struct ReadSlot { uint16_t packet; uint64_t begin; size_t skip; size_t length; size_t span; size_t filled; bool done; bool hole; };
+    struct SendSlot { size_t length; bool busy; std::chrono::steady_clock::time_point queued; };
+    std::vector<ReadSlot> reads(IO_URING_READ_AHEAD, ReadSlot{0, 0, 0, 0, 0, 0, false, false});
+    std::vector<SendSlot> sends(IO_URING_SEND_BUFFERS, SendSlot{0, false, {}});
+    const uint64_t READ_TAG = 1ULL << 32;
+    const uint64_t SEND_TAG = 2ULL << 32;
+    const std::chrono::milliseconds sendTimeout(PACKET_WRITE_TIMEOUT_MS);
+    
+    std::string failure;
+    ErrorType failureType = ErrorType::NETWORK;
+    uint64_t operationsBefore = engine.operationsSubmitted();
+    uint64_t callsBefore = engine.enterCalls();
+    auto queueRead = [&](unsigned slot) {
+        ReadSlot& read = reads[slot];
+        if (!engine.queueRead(FILE_SLOT, slot, read.filled, read.span - read.filled, read.begin + read.filled, READ_TAG | slot)) {
+            failure = "io_uring submission queue full";
+        }
+    };
+    auto queueSend = [&](unsigned slot) {
+        // The engine keeps the socket's sends in order and finishes short ones before the next
+        if (!engine.queueSend(SOCKET_SLOT, engine.buffer(IO_URING_READ_AHEAD + slot), sends[slot].length,
+                              SEND_TAG | slot, sendTimeout)) {
+            failure = "io_uring submission queue full";
+        }
+    };
+    // Reap completions until ready() holds; short reads are requeued
+    auto waitUntil = [&](const std::function<bool()>& ready) {
+        IoUringCompletion completion;
+        while (failure.empty() && !ready()) {
+            while (failure.empty() && engine.nextCompletion(completion)) {
+                unsigned slot = static_cast<unsigned>(completion.userData & 0xFFFFFFFF);
+                if ((completion.userData & ~0xFFFFFFFFULL) == READ_TAG) {
+                    ReadSlot& read = reads[slot];
+                    if (completion.result > 0) {
+                        read.filled += completion.result;
+                        metrics.bytesRead.add(static_cast<uint64_t>(completion.result));
+                    }
+                    if (read.filled >= read.skip + read.length) {
+                        read.done = true;  // An O_DIRECT span may run past EOF
+                    } else if (completion.result <= 0) {
+                        failureType = ErrorType::FILE_IO;
+                        failure = completion.result == 0 ? "Unexpected end of file"
+                                                         : "File read failed: " + std::string(std::strerror(-completion.result));
+                    } else {
+                        queueRead(slot);
+                    }
+                } else {
+                    if (completion.result < 0) {
+                        failure = completion.result == -ECANCELED
+                                      ? "Send timed out after " + std::to_string(PACKET_WRITE_TIMEOUT_MS) + "ms - dropping connection"
+                                      : "Failed to send request: " + std::string(std::strerror(-completion.result));
+                    } else {
+                        metrics.bytesSent.add(static_cast<uint64_t>(completion.result));
+                        metrics.packetWrite.observe(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+                            std::chrono::steady_clock::now() - sends[slot].queued).count()));
+                        sends[slot].busy = false;
+                    }
+                }
+            }
+            if (failure.empty() && !ready() && !engine.submit(1, failure)) {
+                break;
+            }
+        }
+        return failure.empty();
+    };
+    // Packets inside a hole are never read; other packets are scanned for zeros
+    HoleMap holes;
+    if (sparseRuns) {
+        holes.load(filepath, fileSize);
+    }
+    uint16_t zeroRunPackets = 0;
+    uint64_t holeBytes = 0;
+    uint64_t zeroBytes = 0;
+    
+    auto startRead = [&](unsigned slot, uint16_t packet) {
+        uint64_t offset = static_cast<uint64_t>(packet - 1) * GCM_CHUNK_SIZE;
+        size_t length = std::min<size_t>(GCM_CHUNK_SIZE, fileSize - offset);
+        uint64_t begin = direct ? offset - offset % DIRECT_IO_ALIGNMENT : offset;
+        size_t skip = static_cast<size_t>(offset - begin);
+        size_t span = direct ? (skip + length + DIRECT_IO_ALIGNMENT - 1) / DIRECT_IO_ALIGNMENT * DIRECT_IO_ALIGNMENT
+                             : length;
+        bool hole = sparseRuns && holes.isHole(offset, length);
+        reads[slot] = ReadSlot{packet, begin, skip, length, span, 0, hole, hole};
+        if (!hole) {
+            queueRead(slot);
+        }
+    };
+    
+    // Prime the read-ahead window
+    uint16_t nextRead = 1;
+    for (unsigned slot = 0; slot < IO_URING_READ_AHEAD && nextRead <= totalPackets; slot++) {
+        startRead(slot, nextRead++);
+    }
+    
+    std::array<uint8_t, AESWrapper::GCM_NONCE_SIZE> nonce;   // Zero-run records (data packets build their own)
+    std::vector<uint8_t> aad(Framing::GCM_AAD_SIZE);
+    
+    AllocPhaseScope sendPhase(AllocPhase::Send);   // Encryption below is counted separately
+    for (uint16_t packet = 1; packet <= totalPackets && failure.empty(); packet++) {
+        unsigned readSlot = (packet - 1) % IO_URING_READ_AHEAD;
+        unsigned sendSlot = (packet - 1) % IO_URING_SEND_BUFFERS;
+        TraceSpan waitSpan("read wait", packet);   // Input read and a free send buffer
+        if (!waitUntil([&]() { return reads[readSlot].done && !sends[sendSlot].busy; })) {
+            break;
+        }
+        waitSpan.end();
+        
+        size_t chunkSize = reads[readSlot].length;
+        const uint8_t* plaintext = engine.buffer(readSlot) + reads[readSlot].skip;
+        bool hole = reads[readSlot].hole;
+        bool zeroRun = hole || (sparseRuns && isAllZero(plaintext, chunkSize));
+        size_t frameSize = 0;
+        try {
+            AllocPhaseScope encryptPhase(AllocPhase::Encrypt);
+            TraceSpan encryptSpan("encrypt", packet);
+            frameSize = buildGCMFrame(engine.buffer(IO_URING_READ_AHEAD + sendSlot), filename, packet, totalPackets,
+                                      originalSize, plaintext, chunkSize, zeroRun, nonce, aad);
+            capture.request(engine.buffer(IO_URING_READ_AHEAD + sendSlot),
+                            engine.buffer(IO_URING_READ_AHEAD + sendSlot) + REQUEST_HEADER_SIZE);
+            markRequestSent(zeroRun ? REQ_SEND_ZERO_RUN : REQ_SEND_FILE);
+            if (zeroRun) {
+                zeroRunPackets++;
+                (hole ? holeBytes : zeroBytes) += chunkSize;
+            }
+        } catch (const std::exception& e) {
+            failureType = ErrorType::CRYPTO;
+            failure = "Failed to encrypt packet " + std::to_string(packet) + ": " + e.what();
+            break;
+        }
+        if (dropBehind) {
+            cacheTracker.dropBefore(fileFd, static_cast<uint64_t>(packet - 1) * GCM_CHUNK_SIZE + chunkSize);
+        }
+        
+        // The plaintext buffer is free again: refill it with the next packet not yet requested
+        if (nextRead <= totalPackets) {
+            startRead(readSlot, nextRead++);
+        }
+        sends[sendSlot] = SendSlot{frameSize, true, std::chrono::steady_clock::now()};
+        metrics.packetsSent.add();
+        TraceSpan sendSpan("send", frameSize);
+        queueSend(sendSlot);
+        if (failure.empty()) {
+            engine.submit(0, failure);  // Send + refill read in one system call
+        }
+        sendSpan.end();
+        
+        stats.update(static_cast<size_t>(packet - 1) * GCM_CHUNK_SIZE + chunkSize);
+        displayProgress("Transferring", stats.transferredBytes, fileSize);
+        pollExports();
+        
+        displayTransferStats(packet == totalPackets);
+    }
+    
+    if (failure.empty()) {
+        TraceSpan drainSpan("send drain");
+        waitUntil([&]() {
+            return std::none_of(sends.begin(), sends.end(), [](const SendSlot& send) { return send.busy; });
+        });
+    }
     
-    uint32_t clientCRC = calculateCRC32(originalData.data(), originalData.size());
+    close(fileFd);
+    if (!failure.empty()) {
+        // Operations may still be in flight: drop the ring (the kernel cancels them) and the stream
+        ioEngine.reset();
+        displayError(failure, failureType);
+        closeConnection();
+        return false;
+    }
+    engine.unregisterFiles();
+    
+    displaySeparator();
+    displayStatus("Transfer complete", true, "All packets sent successfully");
+    displayStatus("io_uring", true, std::to_string(engine.operationsSubmitted() - operationsBefore) + " operations in " +
+                  std::to_string(engine.enterCalls() - callsBefore) + " system calls");
+    if (zeroRunPackets > 0) {
+        displayStatus("Sparse file", true, std::to_string(zeroRunPackets) + " packets sent as zero runs (" +
+                      formatBytes(static_cast<size_t>(holeBytes)) + " in holes, " +
+                      formatBytes(static_cast<size_t>(zeroBytes)) + " zero blocks)");
+    }
+    if (dropBehind) {
+        displayStatus("Page cache", true, "Dropped " + formatBytes(static_cast<size_t>(cacheTracker.droppedBytes())) + ", kept " +
+                      formatBytes(static_cast<size_t>(cacheTracker.preservedBytes())) + " cached by other processes");
+    }
+    displayStatus("Waiting for server", true, "Server verifying authentication tags...");
     
+    ResponseHeader header;
+    std::vector<uint8_t> responsePayload;
+    AllocPhaseScope verifyPhase(AllocPhase::Verify);
+    TraceSpan waitSpan("crc wait");
+    if (!receiveResponse(header, responsePayload, false, CRC_WAIT_TIMEOUT_MS)) {
+        return false;
+    }
+    waitSpan.end();
+    
+    if (header.code != RESP_ACK) {
+        displayError("Invalid file transfer response", ErrorType::PROTOCOL);
+        return false;
+    }
+    
+    metrics.filesVerified.add();
+    displayStatus("Integrity verification", true, "✓ All packets authenticated by server");
+    return true;
+#else
+    (void)filename;
+    return false;
+#endif
+}
+
+// One GCM packet as it goes on the wire: request header, file packet metadata, then
+// nonce || ciphertext || tag (or a zero-run record). Returns the frame size; throws if
+// encryption fails. out must hold REQUEST_HEADER_SIZE + FILE_PACKET_HEADER_SIZE +
+// chunkSize + GCM_PACKET_OVERHEAD bytes.
+size_t Client::buildGCMFrame(uint8_t* out, const std::string& filename, uint16_t packet, uint16_t totalPackets,
+                             uint32_t originalSize, const uint8_t* plaintext, size_t chunkSize, bool zeroRun,
+                             std::array<uint8_t, AESWrapper::GCM_NONCE_SIZE>& nonce, std::vector<uint8_t>& aad) {
+    if (!zeroRun) {
+        size_t frameSize = Framing::buildGCMFrame(*aesContext, clientID.data(), transferSequence, filename, packet,
+                                                  totalPackets, originalSize, plaintext, chunkSize, out);
+        metrics.bytesEncrypted.add(chunkSize);
+        return frameSize;
+    }
+    Framing::encodeRequestHeader(clientID.data(), REQ_SEND_ZERO_RUN,
+                                 static_cast<uint32_t>(FILE_PACKET_HEADER_SIZE + ZERO_RUN_CONTENT_SIZE), out);
+    uint8_t* fileHeader = out + REQUEST_HEADER_SIZE;
+    Framing::encodeFilePacketHeader(filename, static_cast<uint32_t>(ZERO_RUN_CONTENT_SIZE), originalSize, packet,
+                                    totalPackets, fileHeader);
+    Framing::gcmNonce(transferSequence, packet, nonce.data());
+    Framing::gcmAad(fileHeader, aad.data());
+    encryptZeroRun(nonce, aad, static_cast<uint32_t>(chunkSize), fileHeader + FILE_PACKET_HEADER_SIZE);
+    return REQUEST_HEADER_SIZE + FILE_PACKET_HEADER_SIZE + ZERO_RUN_CONTENT_SIZE;
+}
+
+// Set up the session's packet pool on first use; without it every lease falls back to the heap
+void Client::ensurePacketPool() {
+    if (packetPool.isReady()) {
+        return;
+    }
+    std::string error;
+    unsigned buffers = zeroCopy.isEnabled() ? ZEROCOPY_POOL_BUFFERS : PACKET_POOL_BUFFERS;
+    if (!packetPool.init(buffers, REQUEST_HEADER_SIZE + FILE_PACKET_HEADER_SIZE + MAX_PACKET_SIZE,
+                         PACKET_POOL_HUGE_PAGES, error)) {
+        displayStatus("Buffer pool", false, error + " - using heap buffers");
+        return;
+    }
+    zeroRunAad.reserve(Framing::GCM_AAD_SIZE + sizeof(ZERO_RUN_LABEL));
+}
+
+// Pool buffer for a packet frame or response. Zero-copy frames hold their buffers until the
+// peer has ACKed them, so when the pool runs dry wait for a completion rather than use the heap.
+BufferPool::Lease Client::acquirePacketBuffer(size_t bytes) {
+    if (zeroCopy.pending() > 0 && transport && transport->tcpSocket()) {
+        zeroCopy.reclaim(ioContext, *transport->tcpSocket(),
+                         std::chrono::milliseconds(packetPool.available() == 0 ? PACKET_WRITE_TIMEOUT_MS : 0));
+    }
+    return packetPool.acquire(bytes);
+}
+
+// Heap allocations by the packet pool during a transfer (zero once the pool is warm)
+void Client::displayPoolStats(uint64_t acquisitionsBefore, uint64_t heapBefore, uint16_t packets) {
+    uint64_t heap = packetPool.heapAllocations() - heapBefore;
+    displayStatus("Buffer pool", heap == 0,
+                  std::to_string(packetPool.acquisitions() - acquisitionsBefore) + " buffers for " +
+                  std::to_string(packets) + " packets, " + std::to_string(heap) + " heap allocations" +
+                  (packetPool.hugePagesBacked() ? " (huge pages)" : ""));
+    if (zeroCopy.zeroCopyBytes() > 0) {
+        displayStatus("Zero-copy send", zeroCopy.copiedSends() < zeroCopy.completedSends() || zeroCopy.completedSends() == 0,
+                      formatBytes(static_cast<size_t>(zeroCopy.zeroCopyBytes())) + " pinned, " +
+                      std::to_string(zeroCopy.copiedSends()) + " of " + std::to_string(zeroCopy.completedSends()) +
+                      " completions copied by the kernel" + (zeroCopy.isEnabled() ? "" : " - switched to copying sends"));
+    }
+}
+
+// Write the spans recorded so far to tracePath (transfer.info trace=)
+void Client::writeTrace() {
+    std::string error;
+    if (Tracer::writeChromeTrace(tracePath, error)) {
+        displayStatus("Trace written", true, tracePath + " (" + std::to_string(Tracer::eventCount()) + " spans)");
+    } else {
+        displayError(error, ErrorType::FILE_IO);
+    }
+}
+
+// Refresh metricsPath (transfer.info metrics=); the file is replaced atomically
+void Client::writeMetrics() {
+    std::string error;
+    if (!metricsRegistry.writeTextFile(metricsPath, error)) {
+        displayError(error, ErrorType::FILE_IO);
+    }
+    lastMetricsWrite = std::chrono::steady_clock::now();
+}
+
+// Between packets, on the transfer thread: a trace dump requested by SIGUSR1, and the
+// periodic metrics refresh
+void Client::pollExports() {
+    if (!tracePath.empty() && Tracer::takeDumpRequest()) {
+        writeTrace();
+    }
+    if (!metricsPath.empty() &&
+        std::chrono::steady_clock::now() - lastMetricsWrite >= std::chrono::milliseconds(METRICS_WRITE_INTERVAL_MS)) {
+        writeMetrics();
+    }
+}
+
+// Start the round-trip clock for the response to this request
+void Client::markRequestSent(uint16_t code) {
+    pendingRequestCode = code;
+    pendingRequestSent = std::chrono::steady_clock::now();
+}
+
+// Verify CRC
+bool Client::verifyCRC(uint32_t serverCRC, uint32_t clientCRC, const std::string& filename) {
+    TraceSpan span("verify", serverCRC == clientCRC);
+    AllocPhaseScope allocPhase(AllocPhase::Verify);
     displayStatus("CRC verification", true, "Server: " + std::to_string(serverCRC) + 
                   ", Client: " + std::to_string(clientCRC));
     
@@ -1140,6 +2398,7 @@ bool Client::verifyCRC(uint32_t serverCRC, const std::vector<uint8_t>& originalD
     std::copy(filename.begin(), filename.end(), payload.begin());
     
     if (serverCRC == clientCRC) {
+        metrics.filesVerified.add();
         displayStatus("CRC verification", true, "✓ Checksums match - file integrity confirmed");
         sendRequest(REQ_CRC_OK, payload);
         
@@ -1150,8 +2409,10 @@ bool Client::verifyCRC(uint32_t serverCRC, const std::vector<uint8_t>& originalD
         
         return true;
     } else {
+        metrics.crcMismatches.add();
         crcRetries++;
         if (crcRetries < MAX_RETRIES) {
+            metrics.crcRetries.add();
             displayStatus("CRC verification", false, "Mismatch - Retry " + std::to_string(crcRetries) + " of " + std::to_string(MAX_RETRIES));
             sendRequest(REQ_CRC_RETRY, payload);
             
@@ -1204,10 +2465,7 @@ bool Client::decryptAESKey(const std::vector<uint8_t>& encryptedKey) {
     
     try {
         std::string encrypted(reinterpret_cast<const char*>(encryptedKey.data()), encryptedKey.size());
-        aesKey = rsaPrivate->decrypt(encrypted);
-        
-        if (aesKey.size() != AES_KEY_SIZE) {
-            displayError("Invalid AES key size: " + std::to_string(aesKey.size()) + " bytes (expected 32)", ErrorType::CRYPTO);
+        if (!setSessionKey(rsaPrivate->decrypt(encrypted))) {
             return false;
         }
         
@@ -1219,9 +2477,39 @@ bool Client::decryptAESKey(const std::vector<uint8_t>& encryptedKey) {
     }
 }
 
-// Encrypt file with AES
-std::string Client::encryptFile(const std::vector<uint8_t>& data) {
-    if (aesKey.empty()) {
+// Install a new session key and expand its schedule
+bool Client::setSessionKey(const std::string& key) {
+    if (key.size() != AES_KEY_SIZE) {
+        displayError("Invalid AES key size: " + std::to_string(key.size()) + " bytes (expected 32)", ErrorType::CRYPTO);
+        return false;
+    }
+    
+    aesKey = key;
+    transferSequence = 0;
+    
+    // Static IV of all zeros for protocol compliance; reused by every encryption with this key
+    aesContext.reset(new AESWrapper(reinterpret_cast<const unsigned char*>(aesKey.data()), AES_KEY_SIZE, true));
+    return true;
+}
+
+// HMAC-SHA256(key, label || context) - matches the server's key derivation
+std::string Client::deriveKey(const std::string& key, const std::string& label, const std::vector<uint8_t>& context) {
+    CryptoPP::HMAC<CryptoPP::SHA256> hmac(reinterpret_cast<const CryptoPP::byte*>(key.data()), key.size());
+    hmac.Update(reinterpret_cast<const CryptoPP::byte*>(label.data()), label.size());
+    if (!context.empty()) {
+        hmac.Update(context.data(), context.size());
+    }
+    std::string digest(CryptoPP::HMAC<CryptoPP::SHA256>::DIGESTSIZE, '\0');
+    hmac.Final(reinterpret_cast<CryptoPP::byte*>(&digest[0]));
+    return digest;
+}
+
+// Encrypt file with AES-CBC and take its cksum in the same pass, one release window at a
+// time: each window's pages are dropped before the next is touched, so the page-cache and
+// resident footprint stay at one window whatever the file size
+std::string Client::encryptFile(MappedFile& input, uint32_t& crc) {
+    static_assert(INPUT_RELEASE_WINDOW % AESWrapper::BLOCK_SIZE == 0, "CBC windows must be whole blocks");
+    if (aesKey.empty() || !aesContext) {
         displayError("No AES key available", ErrorType::CRYPTO);
         return "";
     }
@@ -1235,13 +2523,43 @@ std::string Client::encryptFile(const std::vector<uint8_t>& data) {
             return "";
         }
         
-        // Use 32-byte key and static IV of all zeros for protocol compliance
-        AESWrapper aes(reinterpret_cast<const unsigned char*>(aesKey.c_str()), 32, true);
-        std::string result = aes.encrypt(reinterpret_cast<const char*>(data.data()), data.size());
+        // Session context: 32-byte key and static IV of all zeros for protocol compliance.
+        // Output is IV || ciphertext of the whole file: every window after the first is
+        // chained from the last ciphertext block before it, and every window but the last
+        // drops the padding block encrypt() appends.
+        AllocPhaseScope allocPhase(AllocPhase::Encrypt);
+        const size_t size = input.size();
+        const size_t block = AESWrapper::BLOCK_SIZE;
+        std::string result;
+        result.reserve(block + (size / block + 1) * block);
+        std::array<unsigned char, AESWrapper::BLOCK_SIZE> chain;
+        uint32_t runningCRC = 0;
+        for (size_t offset = 0; offset < size; offset += INPUT_RELEASE_WINDOW) {
+            const size_t length = std::min(INPUT_RELEASE_WINDOW, size - offset);
+            const char* window = reinterpret_cast<const char*>(input.data() + offset);
+            const bool last = offset + length == size;
+            
+            TraceSpan span("encrypt", length);
+            std::string part = offset == 0 ? aesContext->encrypt(window, length)
+                                           : aesContext->encrypt(window, length, chain.data());
+            const size_t keep = last ? part.size() - block : length;
+            result.append(part, offset == 0 ? 0 : block, (offset == 0 ? block : 0) + keep);
+            std::memcpy(chain.data(), part.data() + keep, block);   // Last kept ciphertext block
+            span.end();
+            
+            TraceSpan crcSpan("crc", length);
+            runningCRC = updateCRC(runningCRC, input.data() + offset, length);
+            crcSpan.end();
+            
+            metrics.bytesRead.add(length);
+            metrics.bytesEncrypted.add(length);
+            input.releaseBefore(offset + length);
+        }
+        crc = finishCRC(runningCRC, size);
         auto end = std::chrono::steady_clock::now();
         
         auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
-        double speed = (data.size() / 1024.0 / 1024.0) / (duration / 1000.0);
+        double speed = (size / 1024.0 / 1024.0) / (duration / 1000.0);
         
         displayStatus("Encryption performance", true, 
                      std::to_string(duration) + "ms (" + 
@@ -1254,28 +2572,29 @@ std::string Client::encryptFile(const std::vector<uint8_t>& data) {
     }
 }
 
-// Read file
-std::vector<uint8_t> Client::readFile(const std::string& path) {
-    std::ifstream file(path, std::ios::binary);
-    if (!file.is_open()) {
-        return {};
+// Map the input file; the encryptor and CRC read the mapping directly
+bool Client::mapInputFile(MappedFile& input) {
+    TraceSpan span("read");
+    AllocPhaseScope allocPhase(AllocPhase::Read);
+    MappedFileOptions options;
+    options.populate = PREFAULT_INPUT_FILE;
+    options.releaseWindow = INPUT_RELEASE_WINDOW;
+    options.dropBehind = inputCacheMode != InputCacheMode::Cached;  // A mapping cannot bypass the cache
+    
+    std::string error;
+    if (!input.open(filepath, options, error)) {
+        displayError("Cannot read file: " + error, ErrorType::FILE_IO);
+        return false;
     }
-    
-    file.seekg(0, std::ios::end);
-    size_t size = file.tellg();
-    file.seekg(0, std::ios::beg);
-    
-    std::vector<uint8_t> data(size);
-    
-    // Read in chunks for better performance
-    size_t bytesRead = 0;
-    while (bytesRead < size) {
-        size_t toRead = std::min(OPTIMAL_BUFFER_SIZE, size - bytesRead);
-        file.read(reinterpret_cast<char*>(data.data() + bytesRead), toRead);
-        bytesRead += file.gcount();
+    if (input.size() == 0) {
+        displayError("Cannot read file or file is empty", ErrorType::FILE_IO);
+        return false;
     }
-    
-    return data;
+    if (input.size() > UINT32_MAX) {
+        displayError("File too large: " + formatBytes(input.size()) + " (protocol limit is 4 GB)", ErrorType::FILE_IO);
+        return false;
+    }
+    return true;
 }
 
 // Convert bytes to hex string
@@ -1335,145 +2654,182 @@ std::string Client::formatDuration(int seconds) {
 }
 
 // Get current timestamp
-std::string Client::getCurrentTimestamp() {
-    auto now = std::chrono::system_clock::now();
-    auto time_t = std::chrono::system_clock::to_time_t(now);
+std::string Client::getCurrentTimestamp(std::chrono::system_clock::time_point when) {
+    auto time_t = std::chrono::system_clock::to_time_t(when);
     std::stringstream ss;
     ss << std::put_time(std::localtime(&time_t), "%H:%M:%S");
     return ss.str();
 }
 
-// Visual feedback functions
+// Visual feedback functions. Each one captures what it shows and queues it on consoleLog;
+// the console, its colors and the GUI are only touched by the log writer thread.
 void Client::displayStatus(const std::string& operation, bool success, const std::string& details) {
-#ifdef _WIN32
-    clearLine();
-    
-    std::cout << "[" << getCurrentTimestamp() << "] ";
-    
-    if (success) {
-        SetConsoleTextAttribute(hConsole, FOREGROUND_GREEN | FOREGROUND_INTENSITY);
-        std::cout << "[OK] ";
-    } else {
-        SetConsoleTextAttribute(hConsole, FOREGROUND_RED | FOREGROUND_INTENSITY);
-        std::cout << "[FAIL] ";
+    // A failure posts at Error so a full log ring waits for it instead of dropping it
+    const LogLevel level = success ? LogLevel::Info : LogLevel::Error;
+    if (!consoleLog.enabled(level)) {
+        return;
     }
-    
-    SetConsoleTextAttribute(hConsole, savedAttributes);
-    std::cout << operation;
-    
-    if (!details.empty()) {
-        SetConsoleTextAttribute(hConsole, FOREGROUND_INTENSITY);
-        std::cout << " - " << details;
+    const auto when = std::chrono::system_clock::now();
+    consoleLog.post(level, [this, operation, success, details, when]() {
+#ifdef _WIN32
+        clearLine();
+        
+        std::cout << "[" << getCurrentTimestamp(when) << "] ";
+        
+        if (success) {
+            SetConsoleTextAttribute(hConsole, FOREGROUND_GREEN | FOREGROUND_INTENSITY);
+            std::cout << "[OK] ";
+        } else {
+            SetConsoleTextAttribute(hConsole, FOREGROUND_RED | FOREGROUND_INTENSITY);
+            std::cout << "[FAIL] ";
+        }
+        
         SetConsoleTextAttribute(hConsole, savedAttributes);
-    }
-    std::cout << std::endl;
-    
-    // Update GUI operation status (optional)
-    try {
-        ClientGUIHelpers::updateOperation(operation, success, details);
-    } catch (...) {
-        // GUI update failed - continue without GUI
-    }
+        std::cout << operation;
+        
+        if (!details.empty()) {
+            SetConsoleTextAttribute(hConsole, FOREGROUND_INTENSITY);
+            std::cout << " - " << details;
+            SetConsoleTextAttribute(hConsole, savedAttributes);
+        }
+        std::cout << std::endl;
+        
+        // Update GUI operation status (optional)
+        try {
+            ClientGUIHelpers::updateOperation(operation, success, details);
+        } catch (...) {
+            // GUI update failed - continue without GUI
+        }
 #else
-    std::cout << "[" << getCurrentTimestamp() << "] ";
-    std::cout << (success ? "[OK] " : "[FAIL] ") << operation;
-    if (!details.empty()) {
-        std::cout << " - " << details;
-    }
-    std::cout << std::endl;
+        std::cout << "[" << getCurrentTimestamp(when) << "] ";
+        std::cout << (success ? "[OK] " : "[FAIL] ") << operation;
+        if (!details.empty()) {
+            std::cout << " - " << details;
+        }
+        std::cout << std::endl;
 #endif
+    });
 }
 
+// Redrawn at most PROGRESS_FRAME_RATE times a second; the final 100% is always drawn
 void Client::displayProgress(const std::string& operation, size_t current, size_t total) {
-    if (total == 0) return;
-    
-    int percentage = static_cast<int>((current * 100) / total);
-    
-#ifdef _WIN32
-    clearLine();
-    std::cout << operation << " [";
-    
-    const int barWidth = 40;
-    int pos = (barWidth * current) / total;
-    
-    SetConsoleTextAttribute(hConsole, FOREGROUND_GREEN | FOREGROUND_INTENSITY);
-    for (int i = 0; i < pos; i++) std::cout << "█";
-    
-    SetConsoleTextAttribute(hConsole, FOREGROUND_GREEN);
-    for (int i = pos; i < barWidth; i++) std::cout << "░";
-    
-    SetConsoleTextAttribute(hConsole, savedAttributes);
-    std::cout << "] " << std::setw(3) << percentage << "% (" 
-              << formatBytes(current) << "/" << formatBytes(total) << ")\r";
-    std::cout.flush();
+    if (total == 0 || !consoleLog.enabled(LogLevel::Info)) return;
     
-    if (current >= total) {
-        std::cout << std::endl;
+    const auto now = std::chrono::steady_clock::now();
+    if (current < total && now - lastProgressFrame < std::chrono::milliseconds(1000 / PROGRESS_FRAME_RATE)) {
+        return;
     }
+    lastProgressFrame = now;
     
-    // Update GUI progress (optional)
-    try {
-        std::string speed = "";
-        std::string eta = "";
-        if (stats.currentSpeed > 0) {
-            speed = formatBytes(static_cast<size_t>(stats.currentSpeed)) + "/s";
+#ifdef _WIN32
+    const double currentSpeed = stats.currentSpeed;
+    const int secondsRemaining = stats.estimatedTimeRemaining;
+    consoleLog.post(LogLevel::Info, [this, operation, current, total, currentSpeed, secondsRemaining]() {
+        int percentage = static_cast<int>((current * 100) / total);
+        clearLine();
+        std::cout << operation << " [";
+        
+        const int barWidth = 40;
+        int pos = (barWidth * current) / total;
+        
+        SetConsoleTextAttribute(hConsole, FOREGROUND_GREEN | FOREGROUND_INTENSITY);
+        for (int i = 0; i < pos; i++) std::cout << "█";
+        
+        SetConsoleTextAttribute(hConsole, FOREGROUND_GREEN);
+        for (int i = pos; i < barWidth; i++) std::cout << "░";
+        
+        SetConsoleTextAttribute(hConsole, savedAttributes);
+        std::cout << "] " << std::setw(3) << percentage << "% (" 
+                  << formatBytes(current) << "/" << formatBytes(total) << ")\r";
+        std::cout.flush();
+        
+        if (current >= total) {
+            std::cout << std::endl;
         }
-        if (stats.estimatedTimeRemaining > 0) {
-            eta = formatDuration(stats.estimatedTimeRemaining);
+        
+        // Update GUI progress (optional)
+        try {
+            std::string speed = "";
+            std::string eta = "";
+            if (currentSpeed > 0) {
+                speed = formatBytes(static_cast<size_t>(currentSpeed)) + "/s";
+            }
+            if (secondsRemaining > 0) {
+                eta = formatDuration(secondsRemaining);
+            }
+            ClientGUIHelpers::updateProgress(static_cast<int>(current), static_cast<int>(total), speed, eta);
+        } catch (...) {
+            // GUI update failed - continue without GUI
         }
-        ClientGUIHelpers::updateProgress(static_cast<int>(current), static_cast<int>(total), speed, eta);
-    } catch (...) {
-        // GUI update failed - continue without GUI
-    }
+    });
 #else
-    std::cout << "\r" << operation << " " << percentage << "% (" 
-              << formatBytes(current) << "/" << formatBytes(total) << ")";
-    std::cout.flush();
-    if (current >= total) {
-        std::cout << std::endl;
-    }
+    consoleLog.post(LogLevel::Info, [this, operation, current, total]() {
+        int percentage = static_cast<int>((current * 100) / total);
+        std::cout << "\r" << operation << " " << percentage << "% (" 
+                  << formatBytes(current) << "/" << formatBytes(total) << ")";
+        std::cout.flush();
+        if (current >= total) {
+            std::cout << std::endl;
+        }
+    });
 #endif
 }
 
-void Client::displayTransferStats() {
-#ifdef _WIN32
-    SetConsoleTextAttribute(hConsole, FOREGROUND_BLUE | FOREGROUND_GREEN | FOREGROUND_INTENSITY);
-    std::cout << "\r[STATS] ";
-    SetConsoleTextAttribute(hConsole, savedAttributes);
+// At most once per STATS_INTERVAL_MS during a transfer, plus the final line
+void Client::displayTransferStats(bool final) {
+    const auto now = std::chrono::steady_clock::now();
+    if ((!final && now - lastStatsFrame < std::chrono::milliseconds(STATS_INTERVAL_MS)) ||
+        !consoleLog.enabled(LogLevel::Info)) {
+        return;
+    }
+    lastStatsFrame = now;
     
-    std::cout << "Speed: " << formatBytes(static_cast<size_t>(stats.currentSpeed)) << "/s | "
-              << "Avg: " << formatBytes(static_cast<size_t>(stats.averageSpeed)) << "/s | "
-              << "ETA: " << formatDuration(stats.estimatedTimeRemaining) << "    " << std::endl;
+    const double currentSpeed = stats.currentSpeed;
+    const double averageSpeed = stats.averageSpeed;
+    const int secondsRemaining = stats.estimatedTimeRemaining;
+    consoleLog.post(LogLevel::Info, [this, currentSpeed, averageSpeed, secondsRemaining]() {
+#ifdef _WIN32
+        SetConsoleTextAttribute(hConsole, FOREGROUND_BLUE | FOREGROUND_GREEN | FOREGROUND_INTENSITY);
+        std::cout << "\r[STATS] ";
+        SetConsoleTextAttribute(hConsole, savedAttributes);
+        
+        std::cout << "Speed: " << formatBytes(static_cast<size_t>(currentSpeed)) << "/s | "
+                  << "Avg: " << formatBytes(static_cast<size_t>(averageSpeed)) << "/s | "
+                  << "ETA: " << formatDuration(secondsRemaining) << "    " << std::endl;
 #else
-    std::cout << "\n[STATS] Speed: " << formatBytes(static_cast<size_t>(stats.currentSpeed)) << "/s | "
-              << "Avg: " << formatBytes(static_cast<size_t>(stats.averageSpeed)) << "/s | "
-              << "ETA: " << formatDuration(stats.estimatedTimeRemaining) << std::endl;
+        std::cout << "\n[STATS] Speed: " << formatBytes(static_cast<size_t>(currentSpeed)) << "/s | "
+                  << "Avg: " << formatBytes(static_cast<size_t>(averageSpeed)) << "/s | "
+                  << "ETA: " << formatDuration(secondsRemaining) << std::endl;
 #endif
+    });
 }
 
 void Client::displaySplashScreen() {
+    consoleLog.post(LogLevel::Info, [this]() {
 #ifdef _WIN32
-    system("cls");
-    
-    SetConsoleTextAttribute(hConsole, FOREGROUND_BLUE | FOREGROUND_GREEN | FOREGROUND_INTENSITY);
-    std::cout << "\n╔════════════════════════════════════════════╗\n";
-    std::cout << "║     ENCRYPTED FILE BACKUP CLIENT v1.0      ║\n";
-    std::cout << "╚════════════════════════════════════════════╝\n";
-    
-    SetConsoleTextAttribute(hConsole, savedAttributes);
-    std::cout << "  Build Date: " << __DATE__ << " " << __TIME__ << "\n";
-    std::cout << "  Protocol Version: " << static_cast<int>(CLIENT_VERSION) << "\n";
-    std::cout << "  Encryption: RSA-1024 + AES-256-CBC\n\n";
+        system("cls");
+        
+        SetConsoleTextAttribute(hConsole, FOREGROUND_BLUE | FOREGROUND_GREEN | FOREGROUND_INTENSITY);
+        std::cout << "\n╔════════════════════════════════════════════╗\n";
+        std::cout << "║     ENCRYPTED FILE BACKUP CLIENT v1.0      ║\n";
+        std::cout << "╚════════════════════════════════════════════╝\n";
+        
+        SetConsoleTextAttribute(hConsole, savedAttributes);
+        std::cout << "  Build Date: " << __DATE__ << " " << __TIME__ << "\n";
+        std::cout << "  Protocol Version: " << static_cast<int>(CLIENT_VERSION) << "\n";
+        std::cout << "  Encryption: RSA-1024 + AES-256-CBC\n\n";
 #else
-    std::cout << "\n============================================\n";
-    std::cout << "     ENCRYPTED FILE BACKUP CLIENT v1.0      \n";
-    std::cout << "============================================\n";
-    std::cout << "  Build Date: " << __DATE__ << " " << __TIME__ << "\n";
-    std::cout << "  Protocol Version: " << static_cast<int>(CLIENT_VERSION) << "\n";
-    std::cout << "  Encryption: RSA-1024 + AES-256-CBC\n\n";
+        std::cout << "\n============================================\n";
+        std::cout << "     ENCRYPTED FILE BACKUP CLIENT v1.0      \n";
+        std::cout << "============================================\n";
+        std::cout << "  Build Date: " << __DATE__ << " " << __TIME__ << "\n";
+        std::cout << "  Protocol Version: " << static_cast<int>(CLIENT_VERSION) << "\n";
+        std::cout << "  Encryption: RSA-1024 + AES-256-CBC\n\n";
 #endif
+    });
 }
 
+// Log writer thread only (called from queued records)
 void Client::clearLine() {
 #ifdef _WIN32
     std::cout << "\r" << std::string(120, ' ') << "\r";
@@ -1484,13 +2840,24 @@ void Client::clearLine() {
 #endif
 }
 
+// Server address as configured: host:port or unix:<path>
+std::string Client::serverAddress() const {
+    if (!injectedDescription.empty()) {
+        return injectedDescription;
+    }
+    return socketPath.empty() ? serverIP + ":" + std::to_string(serverPort) : "unix:" + socketPath;
+}
+
 void Client::displayConnectionInfo() {
     displaySeparator();
-    std::cout << "Connection Details:\n";
-    std::cout << "  Server Address: " << serverIP << ":" << serverPort << "\n";
-    std::cout << "  Client Name: " << username << "\n";
-    std::cout << "  File to Transfer: " << filepath << "\n";
-    std::cout << "  File Size: " << formatBytes(stats.totalBytes) << "\n";
+    consoleLog.post(LogLevel::Info, [this, address = serverAddress(), name = username, file = filepath,
+                                     size = stats.totalBytes]() {
+        std::cout << "Connection Details:\n";
+        std::cout << "  Server Address: " << address << "\n";
+        std::cout << "  Client Name: " << name << "\n";
+        std::cout << "  File to Transfer: " << file << "\n";
+        std::cout << "  File Size: " << formatBytes(size) << "\n";
+    });
     displaySeparator();
 }
 
@@ -1505,6 +2872,7 @@ void Client::displayError(const std::string& message, ErrorType type) {
     //     type == ErrorType::SERVER_ERROR) {
     //     std::cerr << "server responded with an error" << std::endl;
     // } else {
+    consoleLog.post(LogLevel::Error, [this, message, type]() {
 #ifdef _WIN32
         SetConsoleTextAttribute(hConsole, FOREGROUND_RED | FOREGROUND_INTENSITY);
         std::cerr << "[ERROR] ";
@@ -1528,84 +2896,97 @@ void Client::displayError(const std::string& message, ErrorType type) {
                 break;
             case ErrorType::CONFIG:
                 std::cerr << "[CONFIG] ";
-                break;            case ErrorType::AUTHENTICATION:
+                break;
+            case ErrorType::AUTHENTICATION:
                 std::cerr << "[AUTH] ";
                 break;
             default:
                 break;
         }
-          std::cerr << message << std::endl;
-    
-    // Update GUI error status and show notification (optional)
-    try {
-        ClientGUIHelpers::updateError(message);
-        ClientGUIHelpers::showNotification("Backup Error", message);
-    } catch (...) {
-        // GUI update failed - continue without GUI
-    }
+        std::cerr << message << std::endl;
+        
+        // Update GUI error status and show notification (optional)
+        try {
+            ClientGUIHelpers::updateError(message);
+            ClientGUIHelpers::showNotification("Backup Error", message);
+        } catch (...) {
+            // GUI update failed - continue without GUI
+        }
+    });
     // }
 }
 
 void Client::displaySeparator() {
+    consoleLog.post(LogLevel::Info, [this]() {
 #ifdef _WIN32
-    SetConsoleTextAttribute(hConsole, FOREGROUND_INTENSITY);
-    std::cout << std::string(60, '─') << std::endl;
-    SetConsoleTextAttribute(hConsole, savedAttributes);
+        SetConsoleTextAttribute(hConsole, FOREGROUND_INTENSITY);
+        std::cout << std::string(60, '─') << std::endl;
+        SetConsoleTextAttribute(hConsole, savedAttributes);
 #else
-    std::cout << std::string(60, '-') << std::endl;
+        std::cout << std::string(60, '-') << std::endl;
 #endif
+    });
 }
 
 void Client::displayPhase(const std::string& phase) {
+    consoleLog.post(LogLevel::Info, [this, phase]() {
 #ifdef _WIN32
-    std::cout << "\n";
-    SetConsoleTextAttribute(hConsole, FOREGROUND_BLUE | FOREGROUND_GREEN | FOREGROUND_INTENSITY);
-    std::cout << "▶ " << phase << std::endl;
-    SetConsoleTextAttribute(hConsole, savedAttributes);
-    displaySeparator();
-    
-    // Update GUI phase (optional)
-    try {
-        ClientGUIHelpers::updatePhase(phase);
-    } catch (...) {
-        // GUI update failed - continue without GUI
-    }
+        std::cout << "\n";
+        SetConsoleTextAttribute(hConsole, FOREGROUND_BLUE | FOREGROUND_GREEN | FOREGROUND_INTENSITY);
+        std::cout << "▶ " << phase << std::endl;
+        SetConsoleTextAttribute(hConsole, savedAttributes);
+        
+        // Update GUI phase (optional)
+        try {
+            ClientGUIHelpers::updatePhase(phase);
+        } catch (...) {
+            // GUI update failed - continue without GUI
+        }
 #else
-    std::cout << "\n> " << phase << std::endl;
-    displaySeparator();
+        std::cout << "\n> " << phase << std::endl;
 #endif
+    });
+    displaySeparator();
 }
 
 void Client::displaySummary() {
     auto endTime = std::chrono::steady_clock::now();
     auto totalDuration = std::chrono::duration_cast<std::chrono::seconds>(endTime - operationStartTime).count();
+    const int duration = static_cast<int>(totalDuration);
     
     displaySeparator();
+    consoleLog.post(LogLevel::Info, [this, file = filepath, size = stats.totalBytes, duration,
+                                     averageSpeed = stats.averageSpeed, address = serverAddress(),
+                                     when = std::chrono::system_clock::now()]() {
 #ifdef _WIN32
-    SetConsoleTextAttribute(hConsole, FOREGROUND_GREEN | FOREGROUND_INTENSITY);
-    std::cout << "✓ BACKUP COMPLETED SUCCESSFULLY\n";
-    SetConsoleTextAttribute(hConsole, savedAttributes);
+        SetConsoleTextAttribute(hConsole, FOREGROUND_GREEN | FOREGROUND_INTENSITY);
+        std::cout << "✓ BACKUP COMPLETED SUCCESSFULLY\n";
+        SetConsoleTextAttribute(hConsole, savedAttributes);
 #else
-    std::cout << "✓ BACKUP COMPLETED SUCCESSFULLY\n";
+        std::cout << "✓ BACKUP COMPLETED SUCCESSFULLY\n";
 #endif
-    
-    std::cout << "\nTransfer Summary:\n";
-    std::cout << "  File: " << filepath << "\n";
-    std::cout << "  Size: " << formatBytes(stats.totalBytes) << "\n";
-    std::cout << "  Duration: " << formatDuration(static_cast<int>(totalDuration)) << "\n";
-    std::cout << "  Average Speed: " << formatBytes(static_cast<size_t>(stats.averageSpeed)) << "/s\n";    std::cout << "  Server: " << serverIP << ":" << serverPort << "\n";
-    std::cout << "  Timestamp: " << getCurrentTimestamp() << "\n";
+        
+        std::cout << "\nTransfer Summary:\n";
+        std::cout << "  File: " << file << "\n";
+        std::cout << "  Size: " << formatBytes(size) << "\n";
+        std::cout << "  Duration: " << formatDuration(duration) << "\n";
+        std::cout << "  Average Speed: " << formatBytes(static_cast<size_t>(averageSpeed)) << "/s\n";
+        std::cout << "  Server: " << address << "\n";
+        std::cout << "  Timestamp: " << getCurrentTimestamp(when) << "\n";
+    });
     displaySeparator();
     
     // Show GUI completion notification (optional)
-    try {
-        std::string successMessage = "File backup completed successfully!\n\nFile: " + filepath + 
-                                   "\nSize: " + formatBytes(stats.totalBytes) + 
-                                   "\nDuration: " + formatDuration(static_cast<int>(totalDuration));
-        ClientGUIHelpers::showNotification("Backup Complete", successMessage);
-    } catch (...) {
-        // GUI notification failed - continue without GUI
-    }
+    consoleLog.post(LogLevel::Info, [this, file = filepath, size = stats.totalBytes, duration]() {
+        try {
+            std::string successMessage = "File backup completed successfully!\n\nFile: " + file + 
+                                       "\nSize: " + formatBytes(size) + 
+                                       "\nDuration: " + formatDuration(duration);
+            ClientGUIHelpers::showNotification("Backup Complete", successMessage);
+        } catch (...) {
+            // GUI notification failed - continue without GUI
+        }
+    });
 }
 
 // Main function
@@ -5,31 +5,6 @@
 #include <cstring>
 #include <stdexcept>
 
-// Protocol constants
-constexpr uint8_t PROTOCOL_VERSION = 3;
-constexpr size_t CLIENT_ID_SIZE = 16;
-constexpr size_t HEADER_SIZE = 23;
-constexpr size_t MAX_FILENAME_SIZE = 255;
-
-// Request codes
-constexpr uint16_t REQ_REGISTER = 1025;
-constexpr uint16_t REQ_SEND_PUBLIC_KEY = 1026;
-constexpr uint16_t REQ_RECONNECT = 1027;
-constexpr uint16_t REQ_SEND_FILE = 1028;
-constexpr uint16_t REQ_CRC_OK = 1029;
-constexpr uint16_t REQ_CRC_RETRY = 1030;
-constexpr uint16_t REQ_CRC_ABORT = 1031;
-
-// Response codes
-constexpr uint16_t RESP_REGISTER_OK = 1600;
-constexpr uint16_t RESP_REGISTER_FAIL = 1601;
-constexpr uint16_t RESP_PUBKEY_AES_SENT = 1602;
-constexpr uint16_t RESP_FILE_CRC = 1603;
-constexpr uint16_t RESP_ACK = 1604;
-constexpr uint16_t RESP_RECONNECT_AES_SENT = 1605;
-constexpr uint16_t RESP_RECONNECT_FAIL = 1606;
-constexpr uint16_t RESP_ERROR = 1607;
-
 // Protocol structures (packed)
 #pragma pack(push, 1)
 struct RequestHeader {
@@ -1,31 +1,103 @@
 #include "../../include/wrappers/AESWrapper.h"
+#include "../../include/wrappers/SecureRandom.h"
 #include "../../third_party/crypto++/aes.h"
 #include "../../third_party/crypto++/modes.h"
-#include "../../third_party/crypto++/filters.h"
-#include "../../third_party/crypto++/hex.h"
+#include "../../third_party/crypto++/gcm.h"
 #include <stdexcept>
 #include <cstring>
-#include <random>
+#include <atomic>
 
 using namespace CryptoPP;
 
-AESWrapper::AESWrapper(const unsigned char* key, size_t keyLength, bool useStaticZeroIV) {
+// Round keys are expanded once in the constructor; ProcessBlock on them is const,
+// so one schedule can drive any number of per-thread mode objects
+struct AESWrapper::KeySchedule {
+    AES::Encryption encryption;
+    AES::Decryption decryption;
+};
+
+namespace {
+
+std::atomic<uint64_t> nextInstanceId(1);
+
+// Per-thread CBC mode objects: re-pointed at a schedule + IV per message, never re-keyed
+struct CBCContext {
+    CBC_Mode_ExternalCipher::Encryption encryption;
+    CBC_Mode_ExternalCipher::Decryption decryption;
+};
+
+// Per-thread GCM objects: GCM precomputes its GHASH tables from the key, so they are
+// only re-keyed when this thread starts using a different AESWrapper instance
+struct GCMContext {
+    uint64_t encryptionOwner = 0;
+    uint64_t decryptionOwner = 0;
+    GCM<AES>::Encryption encryption;
+    GCM<AES>::Decryption decryption;
+};
+
+thread_local CBCContext cbcContext;
+thread_local GCMContext gcmContext;
+
+// Overwrite a GCM object's round keys and GHASH tables with ones derived from an all-zero
+// key, so nothing expanded from a session key stays behind in thread-local storage
+template <class Mode>
+void wipeKey(Mode& mode, uint64_t& owner) {
+    static const unsigned char zeroKey[AESWrapper::DEFAULT_KEYLENGTH] = {0};
+    mode.SetKey(zeroKey, sizeof(zeroKey));
+    owner = 0;
+}
+
+// For destructors and error paths, which must not throw
+template <class Mode>
+void discardKey(Mode& mode, uint64_t& owner) {
+    try {
+        wipeKey(mode, owner);
+    } catch (const Exception&) {
+        owner = 0;
+    }
+}
+
+// Key this thread's GCM object for instanceId; the previous owner's schedule is wiped
+// first, so a failed SetKey cannot leave part of it in place
+template <class Mode>
+void bindKey(Mode& mode, uint64_t& owner, uint64_t instanceId, const std::vector<unsigned char>& key) {
+    if (owner == instanceId) {
+        return;
+    }
+    if (owner != 0) {
+        wipeKey(mode, owner);
+    }
+    mode.SetKey(key.data(), key.size());
+    owner = instanceId;
+}
+
+} // namespace
+
+AESWrapper::AESWrapper() : instanceId(0) {
+}
+
+AESWrapper::AESWrapper(const unsigned char* key, size_t keyLength, bool useStaticZeroIV)
+    : instanceId(nextInstanceId.fetch_add(1)) {
     if (!key || keyLength != AESWrapper::DEFAULT_KEYLENGTH) {
         throw std::invalid_argument("Invalid key or key length");
     }
-    
+
     keyData.assign(key, key + keyLength);
-    
+
+    try {
+        schedule.reset(new KeySchedule);
+        schedule->encryption.SetKey(keyData.data(), keyData.size());
+        schedule->decryption.SetKey(keyData.data(), keyData.size());
+    } catch (const Exception& e) {
+        throw std::runtime_error("AES key setup failed: " + std::string(e.what()));
+    }
+
     iv.resize(AES::BLOCKSIZE);
     if (useStaticZeroIV) {
         std::fill(iv.begin(), iv.end(), 0);
-    } else {        // Generate random IV using standard library
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        std::uniform_int_distribution<int> dist(0, 255);
-        for (size_t i = 0; i < iv.size(); ++i) {
-            iv[i] = static_cast<unsigned char>(dist(gen));
-        }
+    } else {
+        // Random IV from the thread-local ChaCha20 DRBG
+        SecureRandom::generate(iv.data(), iv.size());
     }
 }
 
@@ -33,78 +105,164 @@ AESWrapper::~AESWrapper() {
     // Clear sensitive data
     std::fill(keyData.begin(), keyData.end(), 0);
     std::fill(iv.begin(), iv.end(), 0);
+
+    // Wipe this thread's GCM schedules for the key; other threads wipe theirs when they
+    // next see an owner mismatch, or when they exit
+    if (instanceId != 0 && gcmContext.encryptionOwner == instanceId) {
+        discardKey(gcmContext.encryption, gcmContext.encryptionOwner);
+    }
+    if (instanceId != 0 && gcmContext.decryptionOwner == instanceId) {
+        discardKey(gcmContext.decryption, gcmContext.decryptionOwner);
+    }
 }
 
 const unsigned char* AESWrapper::getKey() const {
     return keyData.empty() ? nullptr : keyData.data();
 }
 
+void AESWrapper::resynchronize(const unsigned char* newIv) {
+    if (!newIv) {
+        throw std::invalid_argument("Invalid IV");
+    }
+    iv.assign(newIv, newIv + AES::BLOCKSIZE);
+}
+
 std::string AESWrapper::encrypt(const char* plain, size_t length) {
-    if (!plain || length == 0) {
+    return encrypt(plain, length, iv.data());
+}
+
+std::string AESWrapper::encrypt(const char* plain, size_t length, const unsigned char* explicitIv) const {
+    if (!plain || length == 0 || !explicitIv) {
         throw std::invalid_argument("Invalid input data");
     }
-    
+    if (!schedule) {
+        throw std::runtime_error("AES encryption failed: no key set");
+    }
+
     try {
-        std::string ciphertext;
-        
-        CBC_Mode<AES>::Encryption encryption;
-        encryption.SetKeyWithIV(keyData.data(), keyData.size(), iv.data());
-        
-        StringSource ss(reinterpret_cast<const unsigned char*>(plain), length, true,
-            new StreamTransformationFilter(encryption,
-                new StringSink(ciphertext)
-            )
-        );
-        
-        // Prepend IV to ciphertext
-        std::string result;
-        result.reserve(iv.size() + ciphertext.size());
-        result.append(reinterpret_cast<const char*>(iv.data()), iv.size());
-        result.append(ciphertext);
-        
+        // Single allocation: IV || plaintext || PKCS#7 padding, then encrypt in place
+        size_t padding = AES::BLOCKSIZE - (length % AES::BLOCKSIZE);
+        size_t paddedLength = length + padding;
+
+        std::string result(AES::BLOCKSIZE + paddedLength, '\0');
+        unsigned char* out = reinterpret_cast<unsigned char*>(&result[0]);
+        std::memcpy(out, explicitIv, AES::BLOCKSIZE);
+        std::memcpy(out + AES::BLOCKSIZE, plain, length);
+        std::memset(out + AES::BLOCKSIZE + length, static_cast<int>(padding), padding);
+
+        cbcContext.encryption.SetCipherWithIV(schedule->encryption, explicitIv);
+        cbcContext.encryption.ProcessData(out + AES::BLOCKSIZE, out + AES::BLOCKSIZE, paddedLength);
+
         return result;
     } catch (const Exception& e) {
         throw std::runtime_error("AES encryption failed: " + std::string(e.what()));
     }
 }
 
-std::string AESWrapper::decrypt(const char* cipher, size_t length) {
+std::string AESWrapper::decrypt(const char* cipher, size_t length) const {
     if (!cipher || length < AES::BLOCKSIZE) {
         throw std::invalid_argument("Invalid cipher data or length too short");
     }
-    
+    if (!schedule) {
+        throw std::runtime_error("AES decryption failed: no key set");
+    }
+
+    // IV is the first block, the rest must be whole blocks
+    size_t actualLength = length - AES::BLOCKSIZE;
+    if (actualLength == 0 || actualLength % AES::BLOCKSIZE != 0) {
+        throw std::runtime_error("AES decryption failed: ciphertext length is not a multiple of the block size");
+    }
+
+    std::string plaintext(cipher + AES::BLOCKSIZE, actualLength);
+    unsigned char* data = reinterpret_cast<unsigned char*>(&plaintext[0]);
     try {
-        // Extract IV from the beginning of cipher
-        std::vector<unsigned char> extractedIv(cipher, cipher + AES::BLOCKSIZE);
-        
-        // Extract actual ciphertext
-        const char* actualCipher = cipher + AES::BLOCKSIZE;
-        size_t actualLength = length - AES::BLOCKSIZE;
-        
-        std::string plaintext;
-        
-        CBC_Mode<AES>::Decryption decryption;
-        decryption.SetKeyWithIV(keyData.data(), keyData.size(), extractedIv.data());
-        
-        StringSource ss(reinterpret_cast<const unsigned char*>(actualCipher), actualLength, true,
-            new StreamTransformationFilter(decryption,
-                new StringSink(plaintext)
-            )
-        );
-        
-        return plaintext;
+        cbcContext.decryption.SetCipherWithIV(schedule->decryption,
+                                              reinterpret_cast<const unsigned char*>(cipher));
+        cbcContext.decryption.ProcessData(data, data, actualLength);
     } catch (const Exception& e) {
         throw std::runtime_error("AES decryption failed: " + std::string(e.what()));
     }
+
+    // Validate and strip PKCS#7 padding
+    unsigned char padding = data[actualLength - 1];
+    bool validPadding = padding >= 1 && padding <= AES::BLOCKSIZE;
+    for (size_t i = 0; validPadding && i < padding; i++) {
+        validPadding = data[actualLength - 1 - i] == padding;
+    }
+    if (!validPadding) {
+        throw std::runtime_error("AES decryption failed: invalid PKCS #7 block padding found");
+    }
+    plaintext.resize(actualLength - padding);
+
+    return plaintext;
+}
+
+std::string AESWrapper::encryptGCM(const unsigned char* nonce, const unsigned char* aad, size_t aadLength,
+                                   const char* plain, size_t length) const {
+    // Ciphertext is the same length as the plaintext, tag is appended
+    std::string result(length + GCM_TAG_SIZE, '\0');
+    encryptGCM(nonce, aad, aadLength, plain, length, reinterpret_cast<unsigned char*>(&result[0]));
+    return result;
+}
+
+void AESWrapper::encryptGCM(const unsigned char* nonce, const unsigned char* aad, size_t aadLength,
+                            const char* plain, size_t length, unsigned char* out) const {
+    if (!nonce || !plain || length == 0 || !out) {
+        throw std::invalid_argument("Invalid input data");
+    }
+    if (!schedule) {
+        throw std::runtime_error("AES-GCM encryption failed: no key set");
+    }
+
+    try {
+        GCM<AES>::Encryption& encryption = gcmContext.encryption;
+        bindKey(encryption, gcmContext.encryptionOwner, instanceId, keyData);
+
+        encryption.EncryptAndAuthenticate(out, out + length, GCM_TAG_SIZE,
+                                          nonce, GCM_NONCE_SIZE,
+                                          aad, aadLength,
+                                          reinterpret_cast<const unsigned char*>(plain), length);
+    } catch (const Exception& e) {
+        discardKey(gcmContext.encryption, gcmContext.encryptionOwner);
+        throw std::runtime_error("AES-GCM encryption failed: " + std::string(e.what()));
+    }
+}
+
+std::string AESWrapper::decryptGCM(const unsigned char* nonce, const unsigned char* aad, size_t aadLength,
+                                   const char* cipher, size_t length) const {
+    if (!nonce || !cipher || length < GCM_TAG_SIZE) {
+        throw std::invalid_argument("Invalid cipher data or length too short");
+    }
+    if (!schedule) {
+        throw std::runtime_error("AES-GCM decryption failed: no key set");
+    }
+
+    bool verified = false;
+    std::string plaintext(length - GCM_TAG_SIZE, '\0');
+    try {
+        GCM<AES>::Decryption& decryption = gcmContext.decryption;
+        bindKey(decryption, gcmContext.decryptionOwner, instanceId, keyData);
+
+        const unsigned char* in = reinterpret_cast<const unsigned char*>(cipher);
+        verified = decryption.DecryptAndVerify(reinterpret_cast<unsigned char*>(&plaintext[0]),
+                                               in + plaintext.size(), GCM_TAG_SIZE,
+                                               nonce, GCM_NONCE_SIZE,
+                                               aad, aadLength,
+                                               in, plaintext.size());
+    } catch (const Exception& e) {
+        discardKey(gcmContext.decryption, gcmContext.decryptionOwner);
+        throw std::runtime_error("AES-GCM decryption failed: " + std::string(e.what()));
+    }
+
+    if (!verified) {
+        throw std::runtime_error("AES-GCM authentication tag mismatch");
+    }
+    return plaintext;
 }
 
 void AESWrapper::generateKey(unsigned char* buffer, size_t length) {
     if (!buffer || length != AESWrapper::DEFAULT_KEYLENGTH) {
         throw std::invalid_argument("Invalid buffer or length");
-    }    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<int> dist(0, 255);
-    for (size_t i = 0; i < length; ++i) {
-        buffer[i] = static_cast<unsigned char>(dist(gen));
     }
-}
\ No newline at end of file
+    SecureRandom::generate(buffer, length);
+}
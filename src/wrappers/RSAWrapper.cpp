@@ -1,4 +1,5 @@
 #include "../../include/wrappers/RSAWrapper.h"
+#include "../../include/wrappers/SecureRandom.h"
 #include <fstream>
 #include <stdexcept>
 #include <iostream>
@@ -8,7 +9,6 @@
 
 // Crypto++ includes for real RSA implementation
 #include "../../third_party/crypto++/rsa.h"
-#include "../../third_party/crypto++/osrng.h"
 #include "../../third_party/crypto++/oaep.h"
 #include "../../third_party/crypto++/sha.h"
 #include "../../third_party/crypto++/filters.h"
@@ -19,6 +19,15 @@
 
 using namespace CryptoPP;
 
+// Crypto++ RNG interface over the client's thread-local ChaCha20 DRBG
+// (AutoSeededRandomPool re-seeds from the OS on every construction)
+class SecureRandomGenerator : public RandomNumberGenerator {
+public:
+    void GenerateBlock(byte* output, size_t size) override {
+        SecureRandom::generate(output, size);
+    }
+};
+
 // RSAPublicWrapper implementation
 RSAPublicWrapper::RSAPublicWrapper(const char* key, size_t keylen) {
     if (!key || keylen == 0) {
@@ -90,7 +99,7 @@ std::string RSAPublicWrapper::encrypt(const std::string& plain) {
 
     try {
         // Use RSA-OAEP with SHA-256 as per specification
-        AutoSeededRandomPool rng;
+        SecureRandomGenerator rng;
         RSAES_OAEP_SHA_Encryptor encryptor(publicKey);
         
         std::string result;
@@ -118,7 +127,7 @@ RSAPrivateWrapper::RSAPrivateWrapper() {
 
     try {
         // Generate a new 1024-bit RSA key pair using Crypto++
-        AutoSeededRandomPool rng;
+        SecureRandomGenerator rng;
         
         // Create private key
         privateKey.GenerateRandomWithKeySize(rng, 1024);
@@ -256,7 +265,7 @@ std::string RSAPrivateWrapper::decrypt(const std::string& cipher) {
     
     try {
         // Use RSA-OAEP with SHA-256 as per specification
-        AutoSeededRandomPool rng;
+        SecureRandomGenerator rng;
         RSAES_OAEP_SHA_Decryptor decryptor(privateKey);
         
         std::string result;
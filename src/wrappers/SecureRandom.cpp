@@ -0,0 +1,267 @@
+#include "../../include/wrappers/SecureRandom.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <ntsecapi.h>   // RtlGenRandom (SystemFunction036, exported by advapi32)
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <pthread.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/random.h>
+#endif
+#endif
+
+constexpr size_t SecureRandom::KEY_SIZE;
+constexpr size_t SecureRandom::NONCE_SIZE;
+constexpr size_t SecureRandom::BLOCK_SIZE;
+constexpr size_t SecureRandom::BUFFER_BLOCKS;
+constexpr uint64_t SecureRandom::RESEED_BYTES;
+constexpr unsigned int SecureRandom::RESEED_INTERVAL_SECONDS;
+
+namespace {
+
+const size_t BUFFER_SIZE = SecureRandom::BUFFER_BLOCKS * SecureRandom::BLOCK_SIZE;
+
+// Per-thread generator state. The first KEY_SIZE bytes of every refill become the
+// next key (fast key erasure), so earlier output cannot be recovered from the state.
+struct DrbgState {
+    uint32_t key[8];
+    unsigned char buffer[BUFFER_SIZE];
+    size_t available;              // Unread bytes at the end of buffer
+    uint64_t outputSinceReseed;
+    std::chrono::steady_clock::time_point lastReseed;
+    unsigned int forkGeneration;
+    bool seeded;
+
+    DrbgState() : available(0), outputSinceReseed(0), forkGeneration(0), seeded(false) {
+        std::memset(key, 0, sizeof(key));
+        std::memset(buffer, 0, sizeof(buffer));
+    }
+    ~DrbgState();
+};
+
+thread_local DrbgState threadState;
+
+void secureZero(void* data, size_t length) {
+    volatile unsigned char* p = static_cast<volatile unsigned char*>(data);
+    while (length--) {
+        *p++ = 0;
+    }
+}
+
+DrbgState::~DrbgState() {
+    secureZero(key, sizeof(key));
+    secureZero(buffer, sizeof(buffer));
+}
+
+// Bumped in the child after fork() so a forked process never replays the parent's buffered output
+std::atomic<unsigned int> forkGeneration(0);
+
+#ifndef _WIN32
+void onForkChild() {
+    forkGeneration.fetch_add(1, std::memory_order_relaxed);
+}
+
+const int forkHandlerRegistered = pthread_atfork(nullptr, nullptr, onForkChild);
+#endif
+
+inline uint32_t rotl32(uint32_t value, int shift) {
+    return (value << shift) | (value >> (32 - shift));
+}
+
+inline uint32_t load32(const unsigned char* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+inline void store32(unsigned char* p, uint32_t value) {
+    p[0] = value & 0xFF;
+    p[1] = (value >> 8) & 0xFF;
+    p[2] = (value >> 16) & 0xFF;
+    p[3] = (value >> 24) & 0xFF;
+}
+
+inline void quarterRound(uint32_t* x, int a, int b, int c, int d) {
+    x[a] += x[b]; x[d] = rotl32(x[d] ^ x[a], 16);
+    x[c] += x[d]; x[b] = rotl32(x[b] ^ x[c], 12);
+    x[a] += x[b]; x[d] = rotl32(x[d] ^ x[a], 8);
+    x[c] += x[d]; x[b] = rotl32(x[b] ^ x[c], 7);
+}
+
+// ChaCha20 block function (RFC 8439 layout); tail is state words 12-15 (counter and nonce)
+void chachaBlockWords(const uint32_t key[8], const uint32_t tail[4], unsigned char* out) {
+    uint32_t input[16] = {
+        0x61707865, 0x3320646e, 0x79622d32, 0x6b206574,
+        key[0], key[1], key[2], key[3], key[4], key[5], key[6], key[7],
+        tail[0], tail[1], tail[2], tail[3]
+    };
+    uint32_t x[16];
+    std::memcpy(x, input, sizeof(x));
+
+    for (int round = 0; round < 10; round++) {
+        quarterRound(x, 0, 4, 8, 12);
+        quarterRound(x, 1, 5, 9, 13);
+        quarterRound(x, 2, 6, 10, 14);
+        quarterRound(x, 3, 7, 11, 15);
+        quarterRound(x, 0, 5, 10, 15);
+        quarterRound(x, 1, 6, 11, 12);
+        quarterRound(x, 2, 7, 8, 13);
+        quarterRound(x, 3, 4, 9, 14);
+    }
+
+    for (int i = 0; i < 16; i++) {
+        store32(out + 4 * i, x[i] + input[i]);
+    }
+    secureZero(x, sizeof(x));
+}
+
+void refill(DrbgState& state) {
+    // 64-bit block counter, zero nonce
+    for (size_t block = 0; block < SecureRandom::BUFFER_BLOCKS; block++) {
+        const uint32_t tail[4] = {static_cast<uint32_t>(block), 0, 0, 0};
+        chachaBlockWords(state.key, tail, state.buffer + block * SecureRandom::BLOCK_SIZE);
+    }
+
+    // Rekey from the head of the keystream and never hand those bytes out
+    for (int i = 0; i < 8; i++) {
+        state.key[i] = load32(state.buffer + 4 * i);
+    }
+    secureZero(state.buffer, SecureRandom::KEY_SIZE);
+    state.available = BUFFER_SIZE - SecureRandom::KEY_SIZE;
+}
+
+void reseedState(DrbgState& state) {
+    unsigned char seed[SecureRandom::KEY_SIZE];
+    SecureRandom::systemRandom(seed, sizeof(seed));
+
+    // Mix fresh entropy into the existing key so a weak reseed never lowers strength
+    for (int i = 0; i < 8; i++) {
+        state.key[i] = (state.seeded ? state.key[i] : 0) ^ load32(seed + 4 * i);
+    }
+    secureZero(seed, sizeof(seed));
+    secureZero(state.buffer, sizeof(state.buffer));
+
+    state.available = 0;
+    state.outputSinceReseed = 0;
+    state.lastReseed = std::chrono::steady_clock::now();
+    state.forkGeneration = forkGeneration.load(std::memory_order_relaxed);
+    state.seeded = true;
+}
+
+// Cheap checks, done on every request
+bool needsReseed(const DrbgState& state) {
+    return !state.seeded ||
+           state.outputSinceReseed >= SecureRandom::RESEED_BYTES ||
+           state.forkGeneration != forkGeneration.load(std::memory_order_relaxed);
+}
+
+// Clock check, done only when the keystream buffer runs dry
+bool reseedIntervalElapsed(const DrbgState& state) {
+    return std::chrono::steady_clock::now() - state.lastReseed >
+           std::chrono::seconds(SecureRandom::RESEED_INTERVAL_SECONDS);
+}
+
+} // namespace
+
+void SecureRandom::generate(unsigned char* buffer, size_t length) {
+    if (!buffer && length > 0) {
+        throw std::invalid_argument("Invalid buffer");
+    }
+
+    DrbgState& state = threadState;
+    if (needsReseed(state)) {
+        reseedState(state);
+    }
+
+    size_t produced = 0;
+    while (produced < length) {
+        if (state.available == 0) {
+            if (reseedIntervalElapsed(state)) {
+                reseedState(state);
+            }
+            refill(state);
+        }
+        size_t take = std::min(state.available, length - produced);
+        unsigned char* source = state.buffer + (BUFFER_SIZE - state.available);
+        std::memcpy(buffer + produced, source, take);
+        secureZero(source, take);
+        state.available -= take;
+        produced += take;
+    }
+    state.outputSinceReseed += length;
+}
+
+void SecureRandom::reseed() {
+    reseedState(threadState);
+}
+
+void SecureRandom::chachaBlock(const unsigned char* key, uint32_t counter, const unsigned char* nonce,
+                               unsigned char* out) {
+    if (!key || !nonce || !out) {
+        throw std::invalid_argument("Invalid buffer");
+    }
+    uint32_t words[8];
+    for (int i = 0; i < 8; i++) {
+        words[i] = load32(key + 4 * i);
+    }
+    const uint32_t tail[4] = {counter, load32(nonce), load32(nonce + 4), load32(nonce + 8)};
+    chachaBlockWords(words, tail, out);
+    secureZero(words, sizeof(words));
+}
+
+void SecureRandom::systemRandom(unsigned char* buffer, size_t length) {
+#ifdef _WIN32
+    while (length > 0) {
+        ULONG chunk = static_cast<ULONG>(std::min<size_t>(length, 0x7FFFFFFF));
+        if (!RtlGenRandom(buffer, chunk)) {
+            throw std::runtime_error("RtlGenRandom failed");
+        }
+        buffer += chunk;
+        length -= chunk;
+    }
+#else
+#ifdef __linux__
+    while (length > 0) {
+        ssize_t got = getrandom(buffer, length, 0);
+        if (got < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == ENOSYS) {
+                break; // Kernel too old - fall back to /dev/urandom below
+            }
+            throw std::runtime_error("getrandom failed");
+        }
+        buffer += got;
+        length -= static_cast<size_t>(got);
+    }
+    if (length == 0) {
+        return;
+    }
+#endif
+    int fd = open("/dev/urandom", O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open /dev/urandom");
+    }
+    while (length > 0) {
+        ssize_t got = read(fd, buffer, length);
+        if (got <= 0) {
+            if (got < 0 && errno == EINTR) {
+                continue;
+            }
+            close(fd);
+            throw std::runtime_error("Cannot read /dev/urandom");
+        }
+        buffer += got;
+        length -= static_cast<size_t>(got);
+    }
+    close(fd);
+#endif
+}
@@ -0,0 +1,407 @@
+#include "CaptureReplayer.h"
+
+#include "../include/client/Transport.h"
+#include "../include/client/protocol.h"
+#include "../include/wrappers/AESWrapper.h"
+#include "../include/wrappers/RSAWrapper.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+namespace {
+
+constexpr uint32_t MAX_RESPONSE_PAYLOAD = 64 * 1024;
+
+// The replayed response that corresponds to a captured one after mapping onto CBC
+uint16_t replayEquivalent(uint16_t capturedCode) {
+    switch (capturedCode) {
+    case RESP_REGISTER_KEY_AES_SENT: return RESP_PUBKEY_AES_SENT;
+    case RESP_RESUME_OK: return RESP_RECONNECT_AES_SENT;
+    case RESP_RESUME_FAIL: return RESP_RECONNECT_FAIL;
+    default: return capturedCode;
+    }
+}
+
+uint64_t microsSince(std::chrono::steady_clock::time_point start) {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+}
+
+} // namespace
+
+// One replayed client: its connection, server-assigned identity and synthetic files
+struct CaptureReplayer::Session {
+    explicit Session(const ReplayOptions& options) : options(options) {}
+
+    const ReplayOptions& options;
+    boost::asio::io_context context;
+    std::unique_ptr<TcpTransport> transport;
+    std::string name;
+    uint8_t clientId[16] = {};
+    bool registered = false;
+    std::unique_ptr<RSAPrivateWrapper> rsa;
+    std::unique_ptr<AESWrapper> aes;
+    std::map<uint32_t, std::string> encryptedFiles;   // By capture file index
+    uint32_t lastFile = 0;
+    uint64_t bytesSent = 0;
+    std::string error;
+
+    bool connect() {
+        close();
+        try {
+            std::unique_ptr<boost::asio::ip::tcp::socket> socket(new boost::asio::ip::tcp::socket(context));
+            boost::asio::ip::tcp::resolver resolver(context);
+            boost::asio::connect(*socket, resolver.resolve(options.host, std::to_string(options.port)));
+            socket->set_option(boost::asio::ip::tcp::no_delay(true));
+            transport.reset(new TcpTransport(context, std::move(socket)));
+            return true;
+        } catch (const std::exception& e) {
+            error = std::string("connect: ") + e.what();
+            return false;
+        }
+    }
+
+    void close() {
+        if (transport) {
+            transport->close();
+            transport.reset();
+        }
+    }
+
+    bool send(uint16_t code, const uint8_t* extra, size_t extraSize, const uint8_t* payload, size_t payloadSize) {
+        if (!transport && !connect()) {
+            return false;
+        }
+        uint8_t header[REQUEST_HEADER_SIZE];
+        std::memcpy(header, clientId, sizeof(clientId));
+        header[16] = PROTOCOL_VERSION;
+        writeLE(header + 17, code, 2);
+        writeLE(header + 19, static_cast<uint32_t>(extraSize + payloadSize), 4);
+        boost::system::error_code ec = transport->write(
+            {boost::asio::buffer(header), boost::asio::buffer(extra, extraSize), boost::asio::buffer(payload, payloadSize)},
+            options.timeout);
+        if (ec) {
+            error = "request " + std::to_string(code) + ": " + ec.message();
+            return false;
+        }
+        bytesSent += sizeof(header) + extraSize + payloadSize;
+        return true;
+    }
+
+    bool receive(uint16_t& code, std::vector<uint8_t>& payload) {
+        uint8_t header[7];
+        boost::system::error_code ec = transport->read(boost::asio::buffer(header), options.timeout);
+        uint32_t size = readLE(header + 3, 4);
+        if (!ec && (header[0] != PROTOCOL_VERSION || size > MAX_RESPONSE_PAYLOAD)) {
+            ec = boost::asio::error::invalid_argument;
+        }
+        payload.resize(ec ? 0 : size);
+        if (!ec) {
+            ec = transport->read(boost::asio::buffer(payload), options.timeout);
+        }
+        if (ec) {
+            error = "response: " + ec.message();
+            return false;
+        }
+        code = static_cast<uint16_t>(readLE(header + 1, 2));
+        return true;
+    }
+
+    bool exchange(uint16_t code, const std::vector<uint8_t>& payload, uint16_t& responseCode, std::vector<uint8_t>& response) {
+        return send(code, nullptr, 0, payload.data(), payload.size()) && receive(responseCode, response);
+    }
+
+    std::vector<uint8_t> nameField(const std::string& text) const {
+        std::vector<uint8_t> field(MAX_FILENAME_SIZE, 0);
+        std::copy(text.begin(), text.end(), field.begin());
+        return field;
+    }
+
+    std::string fileName(uint32_t index) const {
+        return "replay_" + std::to_string(index) + ".bin";
+    }
+
+    bool takeSessionKey(const std::vector<uint8_t>& response) {
+        if (response.size() <= sizeof(clientId)) {
+            return false;
+        }
+        std::string key = rsa->decrypt(std::string(response.begin() + sizeof(clientId), response.end()));
+        if (key.size() != AESWrapper::DEFAULT_KEYLENGTH) {
+            error = "session key has the wrong size";
+            return false;
+        }
+        aes.reset(new AESWrapper(reinterpret_cast<const unsigned char*>(key.data()), key.size()));
+        encryptedFiles.clear();   // Encrypted under the previous key
+        return true;
+    }
+
+    bool registerClient(uint16_t& code) {
+        std::vector<uint8_t> response;
+        if (!exchange(REQ_REGISTER, nameField(name), code, response)) {
+            return false;
+        }
+        if (code == RESP_REGISTER_OK && response.size() == sizeof(clientId)) {
+            std::memcpy(clientId, response.data(), sizeof(clientId));
+            registered = true;
+        }
+        return true;
+    }
+
+    bool sendPublicKey(uint16_t& code) {
+        char publicKey[RSAPublicWrapper::KEYSIZE];
+        rsa->getPublicKey(publicKey, sizeof(publicKey));
+        std::vector<uint8_t> payload = nameField(name);
+        payload.insert(payload.end(), publicKey, publicKey + sizeof(publicKey));
+        std::vector<uint8_t> response;
+        if (!exchange(REQ_SEND_PUBLIC_KEY, payload, code, response)) {
+            return false;
+        }
+        return code != RESP_PUBKEY_AES_SENT || takeSessionKey(response);
+    }
+
+    bool reconnect(uint16_t& code) {
+        std::vector<uint8_t> response;
+        if (!exchange(REQ_RECONNECT, nameField(name), code, response)) {
+            return false;
+        }
+        return code != RESP_RECONNECT_AES_SENT || takeSessionKey(response);
+    }
+
+    // Register and exchange keys outside the timed requests when the capture starts from
+    // an already registered client
+    bool ensureKey() {
+        uint16_t code = 0;
+        if (!registered && (!registerClient(code) || !registered)) {
+            error = error.empty() ? "registration refused" : error;
+            return false;
+        }
+        if (!aes && (!sendPublicKey(code) || !aes)) {
+            error = error.empty() ? "key exchange refused" : error;
+            return false;
+        }
+        return true;
+    }
+
+    // One captured file packet, re-encrypted: synthetic content of the captured size, split
+    // over the captured packet count
+    bool sendFilePacket(const CaptureRecord& record) {
+        if (!ensureKey()) {
+            return false;
+        }
+        lastFile = record.fileIndex;
+        std::string& encrypted = encryptedFiles[record.fileIndex];
+        if (record.packet == 1 || encrypted.empty()) {
+            std::vector<char> plaintext(std::max<uint32_t>(record.originalSize, 1));
+            uint32_t state = 0x9E3779B9u ^ record.fileIndex;
+            for (char& byte : plaintext) {
+                state ^= state << 13;
+                state ^= state >> 17;
+                state ^= state << 5;
+                byte = static_cast<char>(state);
+            }
+            const unsigned char zeroIv[AESWrapper::BLOCK_SIZE] = {};
+            encrypted = aes->encrypt(plaintext.data(), plaintext.size(), zeroIv);
+        }
+        const uint16_t total = std::max<uint16_t>(record.totalPackets, 1);
+        const uint16_t packet = std::min<uint16_t>(std::max<uint16_t>(record.packet, 1), total);
+        size_t begin = encrypted.size() * (packet - 1) / total;
+        size_t end = encrypted.size() * packet / total;
+
+        uint8_t metadata[FILE_PACKET_HEADER_SIZE] = {};
+        writeLE(metadata, static_cast<uint32_t>(end - begin), 4);
+        writeLE(metadata + 4, std::max<uint32_t>(record.originalSize, 1), 4);
+        writeLE(metadata + 8, packet, 2);
+        writeLE(metadata + 10, total, 2);
+        std::string filename = fileName(record.fileIndex);
+        std::memcpy(metadata + 12, filename.data(), filename.size());
+        return send(REQ_SEND_FILE, metadata, sizeof(metadata),
+                    reinterpret_cast<const uint8_t*>(encrypted.data()) + begin, end - begin);
+    }
+};
+
+CaptureReplayer::CaptureReplayer(const ReplayOptions& options) : options(options) {
+    std::ostringstream tag;
+    tag << std::hex << (static_cast<uint64_t>(std::chrono::system_clock::now().time_since_epoch().count()) & 0xFFFFFFFFFFull);
+    runTag = tag.str();
+}
+
+bool CaptureReplayer::add(const std::string& filename, std::string& error) {
+    std::vector<CaptureRecord> records;
+    if (!readCapture(filename, records, error)) {
+        return false;
+    }
+    if (records.empty()) {
+        error = filename + " holds no records";
+        return false;
+    }
+    captures.push_back(std::move(records));
+    return true;
+}
+
+ReplayReport CaptureReplayer::run() {
+    ReplayReport total;
+    std::mutex lock;
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < captures.size(); i++) {
+        threads.emplace_back([this, i, &total, &lock]() {
+            ReplayReport local;
+            std::string error;
+            bool ok = replay(i, local, error);
+            std::lock_guard<std::mutex> guard(lock);
+            (ok ? total.capturesCompleted : total.capturesFailed)++;
+            if (!ok) {
+                total.errors.push_back("capture " + std::to_string(i + 1) + ": " + error);
+            }
+            total.requests += local.requests;
+            total.skipped += local.skipped;
+            total.codeMismatches += local.codeMismatches;
+            total.bytesSent += local.bytesSent;
+            total.capturedSeconds = std::max(total.capturedSeconds, local.capturedSeconds);
+            for (const auto& entry : local.capturedMicros) {
+                total.capturedMicros[entry.first].merge(entry.second);
+            }
+            for (const auto& entry : local.replayedMicros) {
+                total.replayedMicros[entry.first].merge(entry.second);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    total.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return total;
+}
+
+bool CaptureReplayer::replay(size_t index, ReplayReport& report, std::string& error) {
+    const std::vector<CaptureRecord>& records = captures[index];
+    Session session(options);
+    session.name = "replay-" + runTag + "-" + std::to_string(index);
+    try {
+        session.rsa.reset(new RSAPrivateWrapper());
+    } catch (const std::exception& e) {
+        error = std::string("RSA key generation failed: ") + e.what();
+        return false;
+    }
+    report.capturedSeconds = (records.back().micros - records.front().micros) / 1e6;
+
+    const auto start = std::chrono::steady_clock::now();
+    const uint64_t base = records.front().micros;
+    for (size_t i = 0; i < records.size(); i++) {
+        const CaptureRecord& record = records[i];
+        if (options.speed > 0) {
+            std::this_thread::sleep_until(start + std::chrono::microseconds(
+                static_cast<long long>((record.micros - base) / options.speed)));
+        }
+        if (record.kind == CaptureRecord::Kind::Open) {
+            if (!session.connect()) {
+                break;
+            }
+            continue;
+        }
+        if (record.kind == CaptureRecord::Kind::Close) {
+            session.close();
+            continue;
+        }
+        if (record.kind == CaptureRecord::Kind::Response) {
+            continue;   // Only reached for a response to a skipped request
+        }
+
+        // A request; the captured response, if any, is the next record
+        const bool answered = i + 1 < records.size() && records[i + 1].kind == CaptureRecord::Kind::Response;
+        report.requests++;
+        auto sent = std::chrono::steady_clock::now();
+        uint16_t code = 0;
+        bool ok = true;
+        bool haveResponse = false;
+        std::vector<uint8_t> response;
+        switch (record.code) {
+        case REQ_REGISTER:
+            ok = session.registerClient(code);
+            haveResponse = true;
+            break;
+        case REQ_REGISTER_WITH_KEY:
+            ok = session.registerClient(code) && (code != RESP_REGISTER_OK || session.sendPublicKey(code));
+            haveResponse = true;
+            break;
+        case REQ_SEND_PUBLIC_KEY:
+            ok = (session.registered || session.ensureKey()) && session.sendPublicKey(code);
+            haveResponse = true;
+            break;
+        case REQ_RECONNECT:
+        case REQ_RESUME_SESSION:
+            ok = (session.registered || session.ensureKey()) && session.reconnect(code);
+            haveResponse = true;
+            break;
+        case REQ_SEND_FILE:
+        case REQ_SEND_ZERO_RUN:
+            ok = record.filePacket && session.sendFilePacket(record);
+            if (!record.filePacket) {
+                session.error = "file packet without metadata";
+            }
+            break;
+        case REQ_CRC_OK:
+        case REQ_CRC_RETRY:
+        case REQ_CRC_ABORT: {
+            std::vector<uint8_t> payload = session.nameField(session.fileName(session.lastFile));
+            ok = session.send(record.code, nullptr, 0, payload.data(), payload.size());
+            break;
+        }
+        default:
+            // Capabilities (1032) and anything else without a CBC equivalent
+            report.requests--;
+            report.skipped++;
+            continue;
+        }
+        if (ok && answered && !haveResponse) {
+            sent = std::chrono::steady_clock::now();
+            ok = session.receive(code, response);
+            haveResponse = true;
+        }
+        if (!ok) {
+            break;
+        }
+        if (answered) {
+            const CaptureRecord& captured = records[++i];
+            report.capturedMicros[record.code].observe(captured.micros - record.micros);
+            report.replayedMicros[record.code].observe(microsSince(sent));
+            if (code != replayEquivalent(captured.code)) {
+                report.codeMismatches++;
+            }
+        }
+    }
+    session.close();
+    report.bytesSent = session.bytesSent;
+    error = session.error;
+    return error.empty();
+}
+
+void CaptureReplayer::printReport(const ReplayReport& report, std::ostream& out) {
+    out << std::fixed << std::setprecision(2);
+    out << "Captures: " << report.capturesCompleted << " replayed, " << report.capturesFailed << " failed in "
+        << report.seconds << " s (longest capture " << report.capturedSeconds << " s)\n";
+    out << "Requests: " << report.requests << " replayed, " << report.skipped << " skipped, "
+        << report.codeMismatches << " response code mismatches, " << report.bytesSent / (1024.0 * 1024.0)
+        << " MB sent\n\n";
+    out << std::left << std::setw(10) << "Request" << std::right << std::setw(9) << "count" << std::setw(16)
+        << "captured p50" << std::setw(16) << "replayed p50" << std::setw(16) << "captured p99" << std::setw(16)
+        << "replayed p99" << "  (ms)\n";
+    for (const auto& entry : report.replayedMicros) {
+        auto captured = report.capturedMicros.find(entry.first);
+        MetricHistogram none;
+        const MetricHistogram& before = captured == report.capturedMicros.end() ? none : captured->second;
+        out << std::left << std::setw(10) << entry.first << std::right << std::setw(9) << entry.second.count()
+            << std::setw(16) << before.percentile(50) / 1000.0 << std::setw(16) << entry.second.percentile(50) / 1000.0
+            << std::setw(16) << before.percentile(99) / 1000.0 << std::setw(16) << entry.second.percentile(99) / 1000.0
+            << "\n";
+    }
+    for (const auto& error : report.errors) {
+        out << "Failed: " << error << "\n";
+    }
+    out.flush();
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "../include/client/SessionCapture.h"
+#include "LoadGenerator.h"
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Re-drives captured client sessions (see SessionCapture.h) against a server, to compare
+// server changes under realistic traffic.
+// - Each capture file is one client, replayed on its own thread and connection, all of
+//   them at once. Requests keep their captured spacing scaled by 1/speed (speed 0 = as
+//   fast as possible), but a request never goes out before the previous response.
+// - Nothing from the original session is reused. Every capture registers a fresh client
+//   under a new name, takes the client ID and AES key the server gives it, and encrypts
+//   synthetic content of each file's captured size (CBC) in the captured packet count.
+// - Requests map onto the CBC protocol: 1034 becomes 1025 + 1026, 1033 (resume) becomes
+//   1027, 1035 (zero run) is sent as 1028, and 1032 (capabilities) is skipped.
+// - The report compares captured and replayed latency per request code and counts
+//   responses whose code differs from the captured one.
+
+struct ReplayOptions {
+    std::string host = "127.0.0.1";
+    unsigned short port = 1256;
+    double speed = 1.0;                            // 10 = ten times faster; 0 = no waiting
+    std::chrono::milliseconds timeout{60000};      // Per request
+};
+
+struct ReplayReport {
+    unsigned capturesCompleted = 0;
+    unsigned capturesFailed = 0;
+    uint64_t requests = 0;
+    uint64_t skipped = 0;                          // Requests with no CBC equivalent
+    uint64_t codeMismatches = 0;
+    uint64_t bytesSent = 0;
+    double seconds = 0;
+    double capturedSeconds = 0;                    // Longest capture
+    std::map<uint16_t, MetricHistogram> capturedMicros;   // By captured request code
+    std::map<uint16_t, MetricHistogram> replayedMicros;
+    std::vector<std::string> errors;               // One per failed capture
+};
+
+class CaptureReplayer {
+public:
+    explicit CaptureReplayer(const ReplayOptions& options);
+
+    bool add(const std::string& filename, std::string& error);
+    ReplayReport run();
+
+    static void printReport(const ReplayReport& report, std::ostream& out);
+
+private:
+    struct Session;
+
+    bool replay(size_t index, ReplayReport& report, std::string& error);
+
+    const ReplayOptions options;
+    std::vector<std::vector<CaptureRecord>> captures;
+    std::string runTag;
+};
@@ -0,0 +1,551 @@
+#include "LoadGenerator.h"
+
+#include "../include/client/cksum.h"
+#include "../include/client/protocol.h"
+#include "../include/wrappers/AESWrapper.h"
+#include "../include/wrappers/RSAWrapper.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <ostream>
+#include <sstream>
+#include <thread>
+
+namespace {
+
+constexpr uint32_t MAX_RESPONSE_PAYLOAD = 64 * 1024;
+
+// "64kb", "1.5mb", "4096": a byte count
+bool parseSize(const std::string& text, uint64_t& size) {
+    size_t end = 0;
+    double number = 0;
+    try {
+        number = std::stod(text, &end);
+    } catch (const std::exception&) {
+        return false;
+    }
+    std::string unit = text.substr(end);
+    std::transform(unit.begin(), unit.end(), unit.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    double multiplier = unit.empty() || unit == "b" ? 1 : unit == "kb" ? 1024.0 : unit == "mb" ? 1024.0 * 1024
+                      : unit == "gb" ? 1024.0 * 1024 * 1024 : 0;
+    if (multiplier == 0 || number < 0) {
+        return false;
+    }
+    size = static_cast<uint64_t>(number * multiplier);
+    return true;
+}
+
+std::string sizeText(uint64_t bytes) {
+    std::ostringstream text;
+    if (bytes >= 1024 * 1024 && bytes % (1024 * 1024) == 0) {
+        text << bytes / (1024 * 1024) << "MB";
+    } else if (bytes >= 1024 && bytes % 1024 == 0) {
+        text << bytes / 1024 << "KB";
+    } else {
+        text << bytes << "B";
+    }
+    return text.str();
+}
+
+const char* requestName(uint16_t code) {
+    switch (code) {
+    case REQ_REGISTER: return "register";
+    case REQ_SEND_PUBLIC_KEY: return "public key";
+    case REQ_SEND_FILE: return "file upload";
+    case REQ_CRC_OK: return "CRC ok";
+    case REQ_CRC_ABORT: return "CRC abort";
+    default: return "";
+    }
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// FileSizeSpec
+
+bool FileSizeSpec::parse(const std::string& text, FileSizeSpec& spec, std::string& error) {
+    FileSizeSpec parsed;
+    size_t colon = text.find(':');
+    std::string kind = text.substr(0, colon);
+    std::string arguments = colon == std::string::npos ? std::string() : text.substr(colon + 1);
+    bool ok = false;
+    if (kind == "fixed") {
+        parsed.kind = Kind::Fixed;
+        ok = parseSize(arguments, parsed.low) && parsed.low > 0;
+    } else if (kind == "uniform") {
+        parsed.kind = Kind::Uniform;
+        size_t dash = arguments.find('-');
+        ok = dash != std::string::npos && parseSize(arguments.substr(0, dash), parsed.low) &&
+             parseSize(arguments.substr(dash + 1), parsed.high) && parsed.low > 0 && parsed.low <= parsed.high;
+    } else if (kind == "lognormal") {
+        parsed.kind = Kind::LogNormal;
+        size_t comma = arguments.find(',');
+        try {
+            ok = comma != std::string::npos && parseSize(arguments.substr(0, comma), parsed.low) && parsed.low > 0;
+            parsed.sigma = ok ? std::stod(arguments.substr(comma + 1)) : 0;
+            ok = ok && parsed.sigma >= 0;
+        } catch (const std::exception&) {
+            ok = false;
+        }
+    }
+    if (!ok) {
+        error = "Bad size distribution '" + text + "' (fixed:1mb, uniform:4kb-8mb or lognormal:256kb,1.5)";
+        return false;
+    }
+    spec = parsed;
+    return true;
+}
+
+uint64_t FileSizeSpec::draw(std::mt19937_64& generator, uint64_t maxSize) const {
+    double size = static_cast<double>(low);
+    if (kind == Kind::Uniform) {
+        size = static_cast<double>(std::uniform_int_distribution<uint64_t>(low, high)(generator));
+    } else if (kind == Kind::LogNormal) {
+        size = std::lognormal_distribution<double>(std::log(static_cast<double>(low)), sigma)(generator);
+    }
+    return std::max<uint64_t>(1, std::min<uint64_t>(static_cast<uint64_t>(size), maxSize));
+}
+
+std::string FileSizeSpec::describe() const {
+    std::ostringstream text;
+    switch (kind) {
+    case Kind::Fixed: text << "fixed " << sizeText(low); break;
+    case Kind::Uniform: text << "uniform " << sizeText(low) << " - " << sizeText(high); break;
+    case Kind::LogNormal: text << "log-normal, median " << sizeText(low) << ", sigma " << sigma; break;
+    }
+    return text.str();
+}
+
+// ---------------------------------------------------------------------------
+// Sessions
+
+struct LoadGenerator::Session : std::enable_shared_from_this<Session> {
+    using Next = std::function<void(uint16_t code, const std::vector<uint8_t>& payload)>;
+
+    Session(LoadGenerator& owner, unsigned index)
+        : owner(owner), index(index), strand(boost::asio::make_strand(owner.ioContext)),
+          socket(strand), deadline(strand) {}
+
+    LoadGenerator& owner;
+    const unsigned index;
+    boost::asio::strand<boost::asio::io_context::executor_type> strand;
+    boost::asio::ip::tcp::socket socket;
+    boost::asio::steady_timer deadline;
+    bool timedOut = false;
+    std::chrono::steady_clock::time_point started;
+    std::chrono::steady_clock::time_point requestStarted;
+
+    uint8_t clientId[16] = {};
+    std::string name;
+    std::unique_ptr<AESWrapper> aes;
+    uint8_t requestHeader[REQUEST_HEADER_SIZE + FILE_PACKET_HEADER_SIZE];   // Room for a file packet's metadata
+    std::vector<uint8_t> requestPayload;
+    uint8_t responseHeader[RESPONSE_HEADER_SIZE];
+    std::vector<uint8_t> responsePayload;
+    uint64_t bytesSent = 0;
+
+    unsigned file = 0;
+    uint64_t fileSize = 0;
+    uint32_t expectedCrc = 0;
+    std::string encrypted;
+    uint16_t packet = 0;
+    uint16_t totalPackets = 0;
+
+    void start();
+    void registerClient();
+    void exchangeKeys();
+    void sendFile();
+    void writePacket();
+    void confirmFile(uint32_t crc);
+    void exchange(uint16_t code, const char* stage, Next next);
+    void readResponse(uint16_t requestCode, const char* stage, Next next);
+    void armDeadline();
+    void finish(const std::string& failure);
+    std::vector<uint8_t> filenameField() const;
+    void record(MetricHistogram LoadReport::* histogram, uint16_t code);
+};
+
+void LoadGenerator::Session::start() {
+    auto self = shared_from_this();
+    started = std::chrono::steady_clock::now();
+    requestStarted = started;
+    armDeadline();
+    boost::asio::async_connect(socket, owner.endpoints,
+                               [self](const boost::system::error_code& ec, const boost::asio::ip::tcp::endpoint&) {
+        if (ec) {
+            self->finish("connect");
+            return;
+        }
+        self->record(&LoadReport::connectMicros, 0);
+        boost::system::error_code ignored;
+        self->socket.set_option(boost::asio::ip::tcp::no_delay(true), ignored);
+        self->registerClient();
+    });
+}
+
+void LoadGenerator::Session::registerClient() {
+    auto self = shared_from_this();
+    name = "load-" + owner.runTag + "-" + std::to_string(index);
+    requestPayload.assign(MAX_FILENAME_SIZE, 0);
+    std::copy(name.begin(), name.end(), requestPayload.begin());
+    exchange(REQ_REGISTER, "register", [self](uint16_t code, const std::vector<uint8_t>& payload) {
+        if (code != RESP_REGISTER_OK || payload.size() != sizeof(self->clientId)) {
+            self->finish("register");
+            return;
+        }
+        std::memcpy(self->clientId, payload.data(), sizeof(self->clientId));
+        self->exchangeKeys();
+    });
+}
+
+void LoadGenerator::Session::exchangeKeys() {
+    auto self = shared_from_this();
+    const size_t key = index % owner.keys.size();
+    requestPayload.assign(MAX_FILENAME_SIZE, 0);
+    std::copy(name.begin(), name.end(), requestPayload.begin());
+    requestPayload.insert(requestPayload.end(), owner.publicKeys[key].begin(), owner.publicKeys[key].end());
+    exchange(REQ_SEND_PUBLIC_KEY, "public key", [self, key](uint16_t code, const std::vector<uint8_t>& payload) {
+        if (code != RESP_PUBKEY_AES_SENT || payload.size() <= sizeof(self->clientId)) {
+            self->finish("public key");
+            return;
+        }
+        std::string sessionKey;
+        try {
+            std::lock_guard<std::mutex> guard(*self->owner.keyLocks[key]);
+            sessionKey = self->owner.keys[key]->decrypt(
+                std::string(payload.begin() + sizeof(self->clientId), payload.end()));
+        } catch (const std::exception&) {
+        }
+        if (sessionKey.size() != AESWrapper::DEFAULT_KEYLENGTH) {
+            self->finish("session key");
+            return;
+        }
+        self->aes.reset(new AESWrapper(reinterpret_cast<const unsigned char*>(sessionKey.data()), sessionKey.size()));
+        self->sendFile();
+    });
+}
+
+void LoadGenerator::Session::sendFile() {
+    if (file == owner.options.filesPerSession) {
+        finish(std::string());
+        return;
+    }
+    fileSize = owner.fileSizes[static_cast<size_t>(index) * owner.options.filesPerSession + file];
+    const char* plaintext = reinterpret_cast<const char*>(owner.content.data());
+    expectedCrc = calculateCRC(owner.content.data(), static_cast<size_t>(fileSize));
+    const unsigned char zeroIv[AESWrapper::BLOCK_SIZE] = {};
+    encrypted = aes->encrypt(plaintext, static_cast<size_t>(fileSize), zeroIv);
+    uint64_t packets = (encrypted.size() + owner.options.packetSize - 1) / owner.options.packetSize;
+    if (packets > 65535) {
+        finish("file too large for 65535 packets");
+        return;
+    }
+    totalPackets = static_cast<uint16_t>(packets);
+    packet = 1;
+    requestStarted = std::chrono::steady_clock::now();
+    writePacket();
+}
+
+void LoadGenerator::Session::writePacket() {
+    auto self = shared_from_this();
+    size_t offset = static_cast<size_t>(packet - 1) * owner.options.packetSize;
+    size_t length = std::min(owner.options.packetSize, encrypted.size() - offset);
+
+    // request header || encrypted size(4) || original size(4) || packet(2) || total(2) || name(255) || content
+    std::memcpy(requestHeader, clientId, sizeof(clientId));
+    requestHeader[16] = PROTOCOL_VERSION;
+    writeLE(requestHeader + 17, REQ_SEND_FILE, 2);
+    writeLE(requestHeader + 19, static_cast<uint32_t>(FILE_PACKET_HEADER_SIZE + length), 4);
+    uint8_t* metadata = requestHeader + REQUEST_HEADER_SIZE;
+    writeLE(metadata, static_cast<uint32_t>(length), 4);
+    writeLE(metadata + 4, static_cast<uint32_t>(fileSize), 4);
+    writeLE(metadata + 8, packet, 2);
+    writeLE(metadata + 10, totalPackets, 2);
+    std::vector<uint8_t> filename = filenameField();
+    std::memcpy(metadata + 12, filename.data(), filename.size());
+
+    armDeadline();
+    std::array<boost::asio::const_buffer, 2> buffers = {
+        boost::asio::buffer(requestHeader, sizeof(requestHeader)),
+        boost::asio::buffer(encrypted.data() + offset, length)};
+    boost::asio::async_write(socket, buffers, [self](const boost::system::error_code& ec, size_t written) {
+        if (ec) {
+            self->finish("file upload");
+            return;
+        }
+        self->bytesSent += written;
+        if (self->packet < self->totalPackets) {
+            self->packet++;
+            self->writePacket();
+            return;
+        }
+        self->encrypted = std::string();   // Sent; free it while waiting
+        self->readResponse(REQ_SEND_FILE, "file upload", [self](uint16_t code, const std::vector<uint8_t>& payload) {
+            if (code != RESP_FILE_CRC || payload.size() != 16 + 4 + MAX_FILENAME_SIZE + 4) {
+                self->finish("file upload");
+                return;
+            }
+            self->confirmFile(readLE(payload.data() + 16 + 4 + MAX_FILENAME_SIZE, 4));
+        });
+    });
+}
+
+// 1029 for a matching CRC; 1031 (abort) for a wrong one, counted, and the run goes on
+void LoadGenerator::Session::confirmFile(uint32_t crc) {
+    auto self = shared_from_this();
+    const bool match = crc == expectedCrc;
+    requestPayload = filenameField();
+    exchange(match ? REQ_CRC_OK : REQ_CRC_ABORT, match ? "CRC ok" : "CRC abort",
+             [self, match](uint16_t code, const std::vector<uint8_t>&) {
+        if (code != RESP_ACK) {
+            self->finish(match ? "CRC ok" : "CRC abort");
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> guard(self->owner.lock);
+            if (match) {
+                self->owner.report.filesVerified++;
+                self->owner.report.bytesUploaded += self->fileSize;
+            } else {
+                self->owner.report.crcMismatches++;
+            }
+        }
+        self->file++;
+        self->sendFile();
+    });
+}
+
+void LoadGenerator::Session::exchange(uint16_t code, const char* stage, Next next) {
+    auto self = shared_from_this();
+    std::memcpy(requestHeader, clientId, sizeof(clientId));
+    requestHeader[16] = PROTOCOL_VERSION;
+    writeLE(requestHeader + 17, code, 2);
+    writeLE(requestHeader + 19, static_cast<uint32_t>(requestPayload.size()), 4);
+    requestStarted = std::chrono::steady_clock::now();
+    armDeadline();
+    std::array<boost::asio::const_buffer, 2> buffers = {
+        boost::asio::buffer(requestHeader, REQUEST_HEADER_SIZE), boost::asio::buffer(requestPayload)};
+    boost::asio::async_write(socket, buffers, [self, code, stage, next](const boost::system::error_code& ec, size_t written) {
+        if (ec) {
+            self->finish(stage);
+            return;
+        }
+        self->bytesSent += written;
+        self->readResponse(code, stage, next);
+    });
+}
+
+void LoadGenerator::Session::readResponse(uint16_t requestCode, const char* stage, Next next) {
+    auto self = shared_from_this();
+    armDeadline();
+    boost::asio::async_read(socket, boost::asio::buffer(responseHeader),
+                            [self, requestCode, stage, next](const boost::system::error_code& ec, size_t) {
+        uint32_t size = readLE(self->responseHeader + 3, 4);
+        if (ec || self->responseHeader[0] != PROTOCOL_VERSION || size > MAX_RESPONSE_PAYLOAD) {
+            self->finish(stage);
+            return;
+        }
+        self->responsePayload.resize(size);
+        boost::asio::async_read(self->socket, boost::asio::buffer(self->responsePayload),
+                                [self, requestCode, stage, next](const boost::system::error_code& ec, size_t) {
+            if (ec) {
+                self->finish(stage);
+                return;
+            }
+            self->record(nullptr, requestCode);
+            next(static_cast<uint16_t>(readLE(self->responseHeader + 1, 2)), self->responsePayload);
+        });
+    });
+}
+
+// A request that outlives the timeout closes the socket, failing the pending operation
+void LoadGenerator::Session::armDeadline() {
+    auto self = shared_from_this();
+    deadline.expires_after(owner.options.timeout);
+    deadline.async_wait([self](const boost::system::error_code& ec) {
+        if (!ec) {
+            self->timedOut = true;
+            boost::system::error_code ignored;
+            self->socket.close(ignored);
+        }
+    });
+}
+
+void LoadGenerator::Session::finish(const std::string& failure) {
+    deadline.cancel();
+    boost::system::error_code ignored;
+    socket.close(ignored);
+    owner.sessionDone(shared_from_this(), failure.empty() || !timedOut ? failure : failure + " (timeout)");
+}
+
+std::vector<uint8_t> LoadGenerator::Session::filenameField() const {
+    std::vector<uint8_t> field(MAX_FILENAME_SIZE, 0);
+    std::string filename = "load_" + std::to_string(file) + ".bin";
+    std::copy(filename.begin(), filename.end(), field.begin());
+    return field;
+}
+
+// Time since requestStarted into requestMicros[code], or since started into histogram
+void LoadGenerator::Session::record(MetricHistogram LoadReport::* histogram, uint16_t code) {
+    auto now = std::chrono::steady_clock::now();
+    auto since = histogram ? started : requestStarted;
+    uint64_t micros = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(now - since).count());
+    std::lock_guard<std::mutex> guard(owner.lock);
+    if (histogram) {
+        (owner.report.*histogram).observe(micros);
+    } else {
+        owner.report.requestMicros[code].observe(micros);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Run
+
+LoadGenerator::LoadGenerator(const LoadOptions& options) : options(options) {
+}
+
+LoadGenerator::~LoadGenerator() {
+}
+
+bool LoadGenerator::prepare(std::string& error) {
+    if (options.sessions == 0 || options.concurrency == 0 || options.keyPool == 0 || options.threads == 0 ||
+        options.packetSize == 0) {
+        error = "sessions, concurrency, keys, threads and packet size must be at least 1";
+        return false;
+    }
+    try {
+        boost::asio::ip::tcp::resolver resolver(ioContext);
+        endpoints = resolver.resolve(options.host, std::to_string(options.port));
+    } catch (const std::exception& e) {
+        error = "Cannot resolve " + options.host + ": " + e.what();
+        return false;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    try {
+        while (keys.size() < options.keyPool) {
+            keys.emplace_back(new RSAPrivateWrapper());
+            char publicKey[RSAPublicWrapper::KEYSIZE];
+            keys.back()->getPublicKey(publicKey, sizeof(publicKey));
+            publicKeys.emplace_back(publicKey, sizeof(publicKey));
+            keyLocks.emplace_back(new std::mutex);
+        }
+    } catch (const std::exception& e) {
+        error = std::string("RSA key generation failed: ") + e.what();
+        return false;
+    }
+    report.keyPoolSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::mt19937_64 generator(options.seed);
+    fileSizes.resize(static_cast<size_t>(options.sessions) * options.filesPerSession);
+    for (auto& size : fileSizes) {
+        size = options.sizes.draw(generator, options.maxFileSize);
+    }
+    uint64_t largest = fileSizes.empty() ? 0 : *std::max_element(fileSizes.begin(), fileSizes.end());
+    content.resize(static_cast<size_t>(largest));
+    uint64_t state = options.seed | 1;
+    for (auto& byte : content) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        byte = static_cast<uint8_t>(state);
+    }
+
+    std::ostringstream tag;
+    tag << std::hex << (static_cast<uint64_t>(std::chrono::system_clock::now().time_since_epoch().count()) & 0xFFFFFFFFFFull);
+    runTag = tag.str();
+    return true;
+}
+
+LoadReport LoadGenerator::run() {
+    const double keyPoolSeconds = report.keyPoolSeconds;
+    report = LoadReport();
+    report.keyPoolSeconds = keyPoolSeconds;
+    launched = 0;
+    ioContext.restart();
+
+    auto start = std::chrono::steady_clock::now();
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        for (unsigned i = 0; i < options.concurrency; i++) {
+            launchNext();
+        }
+    }
+    std::vector<std::thread> workers;
+    for (unsigned i = 1; i < options.threads; i++) {
+        workers.emplace_back([this]() { ioContext.run(); });
+    }
+    ioContext.run();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return report;
+}
+
+// Caller holds lock
+void LoadGenerator::launchNext() {
+    if (launched == options.sessions) {
+        return;
+    }
+    auto session = std::make_shared<Session>(*this, launched++);
+    boost::asio::post(session->strand, [session]() { session->start(); });
+}
+
+void LoadGenerator::sessionDone(const std::shared_ptr<Session>& session, const std::string& failure) {
+    auto micros = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - session->started);
+    std::lock_guard<std::mutex> guard(lock);
+    report.bytesSent += session->bytesSent;
+    if (failure.empty()) {
+        report.sessionsCompleted++;
+        report.sessionMicros.observe(static_cast<uint64_t>(micros.count()));
+    } else {
+        report.sessionsFailed++;
+        report.failures[failure]++;
+    }
+    launchNext();
+}
+
+void LoadGenerator::printReport(const LoadReport& report, std::ostream& out) {
+    const double mb = 1024.0 * 1024.0;
+    const double seconds = std::max(report.seconds, 1e-9);
+    out << std::fixed << std::setprecision(1);
+    out << "Sessions: " << report.sessionsCompleted << " completed, " << report.sessionsFailed << " failed in "
+        << report.seconds << " s (" << report.sessionsCompleted / seconds << " sessions/s)\n";
+    out << "Files:    " << report.filesVerified << " verified, " << report.crcMismatches << " CRC mismatches; "
+        << report.bytesUploaded / mb << " MB uploaded (" << report.bytesUploaded / mb / seconds << " MB/s), "
+        << report.bytesSent / mb << " MB sent\n";
+    out << "Key pool: " << report.keyPoolSeconds << " s\n\n";
+
+    out << std::left << std::setw(22) << "Latency (ms)" << std::right << std::setw(9) << "count" << std::setw(10) << "mean"
+        << std::setw(10) << "p50" << std::setw(10) << "p90" << std::setw(10) << "p99" << std::setw(10) << "p99.9"
+        << std::setw(10) << "max" << "\n";
+    auto row = [&out](const std::string& label, const MetricHistogram& histogram) {
+        if (histogram.count() == 0) {
+            return;
+        }
+        out << std::left << std::setw(22) << label << std::right << std::setw(9) << histogram.count()
+            << std::setprecision(2) << std::setw(10) << histogram.mean() / 1000.0;
+        for (double percent : {50.0, 90.0, 99.0, 99.9}) {
+            out << std::setw(10) << histogram.percentile(percent) / 1000.0;
+        }
+        out << std::setw(10) << histogram.max() / 1000.0 << "\n";
+    };
+    row("connect", report.connectMicros);
+    for (const auto& entry : report.requestMicros) {
+        row(std::to_string(entry.first) + " " + requestName(entry.first), entry.second);
+    }
+    row("whole session", report.sessionMicros);
+
+    if (!report.failures.empty()) {
+        out << "\nFailures by stage:\n";
+        for (const auto& failure : report.failures) {
+            out << "  " << failure.first << ": " << failure.second << "\n";
+        }
+    }
+    out.flush();
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "../include/client/Metrics.h"
+
+#include <boost/asio.hpp>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <vector>
+
+class RSAPrivateWrapper;
+
+// Simulated clients for server capacity testing: thousands of protocol sessions from one
+// process, all on one shared io_context.
+// - Each session connects, registers (1025), exchanges keys (1026), uploads its files as
+//   AES-CBC packets (1028), checks each file's CRC (1603) and confirms it (1029), or
+//   aborts the file (1031) on a mismatch.
+// - RSA keys come from a pool generated before the run, so key generation does not
+//   dominate. Sessions share pool keys round-robin.
+// - File sizes are drawn from a seeded distribution before the run. Content is slices of
+//   one random buffer, encrypted under each session's own key when its upload starts.
+// - LoadReport has throughput plus a latency histogram per request code: the time from
+//   the request's first byte to its response, and for 1028 from the first packet to 1603.
+// Every session is driven from its own strand, so --threads N runs the io_context on N
+// threads without locking inside a session.
+
+// "fixed:1mb", "uniform:4kb-8mb" or "lognormal:256kb,1.5" (median, sigma); sizes take
+// b/kb/mb/gb
+struct FileSizeSpec {
+    enum class Kind { Fixed, Uniform, LogNormal };
+    Kind kind = Kind::Fixed;
+    uint64_t low = 1024 * 1024;   // Fixed size, uniform minimum or log-normal median
+    uint64_t high = 0;            // Uniform maximum
+    double sigma = 0;             // Log-normal shape
+
+    static bool parse(const std::string& text, FileSizeSpec& spec, std::string& error);
+    uint64_t draw(std::mt19937_64& generator, uint64_t maxSize) const;   // At least 1 byte
+    std::string describe() const;
+};
+
+struct LoadOptions {
+    std::string host = "127.0.0.1";
+    unsigned short port = 1256;
+    unsigned sessions = 1000;
+    unsigned concurrency = 1000;     // Sessions in flight at once
+    unsigned filesPerSession = 1;
+    unsigned keyPool = 16;
+    unsigned threads = 1;            // Threads running the shared io_context
+    FileSizeSpec sizes;
+    uint64_t maxFileSize = 64ull * 1024 * 1024;   // Cap on drawn sizes
+    size_t packetSize = 1024 * 1024;              // Encrypted bytes per 1028 packet, as the client
+    std::chrono::milliseconds timeout{60000};     // Per request
+    uint64_t seed = 1;
+};
+
+struct LoadReport {
+    unsigned sessionsCompleted = 0;
+    unsigned sessionsFailed = 0;
+    uint64_t filesVerified = 0;
+    uint64_t crcMismatches = 0;
+    uint64_t bytesUploaded = 0;      // Plaintext of verified files
+    uint64_t bytesSent = 0;          // Everything written, headers included
+    double seconds = 0;              // Wall time of the run, key pool excluded
+    double keyPoolSeconds = 0;
+    MetricHistogram connectMicros;
+    MetricHistogram sessionMicros;
+    std::map<uint16_t, MetricHistogram> requestMicros;   // By request code
+    std::map<std::string, unsigned> failures;             // By stage
+};
+
+class LoadGenerator {
+public:
+    explicit LoadGenerator(const LoadOptions& options);
+    ~LoadGenerator();
+
+    // Key pool, size draws, file content and the server address; false with error
+    bool prepare(std::string& error);
+    LoadReport run();
+
+    static void printReport(const LoadReport& report, std::ostream& out);
+
+private:
+    struct Session;
+
+    void launchNext();
+    void sessionDone(const std::shared_ptr<Session>& session, const std::string& failure);
+
+    const LoadOptions options;
+    std::vector<std::unique_ptr<RSAPrivateWrapper>> keys;
+    std::vector<std::string> publicKeys;
+    std::vector<std::unique_ptr<std::mutex>> keyLocks;   // Wrappers are not thread-safe
+    std::vector<uint64_t> fileSizes;                     // options.sessions * filesPerSession
+    std::vector<uint8_t> content;
+    std::string runTag;                                  // Keeps client names unique across runs
+
+    boost::asio::io_context ioContext;
+    boost::asio::ip::tcp::resolver::results_type endpoints;
+    std::mutex lock;                                     // Guards everything below
+    unsigned launched = 0;
+    LoadReport report;
+};
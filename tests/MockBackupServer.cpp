@@ -0,0 +1,493 @@
+#include "MockBackupServer.h"
+
+#include "../include/client/cksum.h"
+#include "../include/wrappers/AESWrapper.h"
+#include "../include/wrappers/RSAWrapper.h"
+
+#include <algorithm>
+#include <cstring>
+#include <exception>
+
+#ifdef _WIN32
+#define MOCK_SHUTDOWN_BOTH SD_BOTH
+#else
+#include <sys/socket.h>
+#define MOCK_SHUTDOWN_BOTH SHUT_RDWR
+#endif
+
+namespace {
+
+constexpr size_t SHAPING_SLICE = 64 * 1024;    // Bandwidth-capped reads proceed in steps of this size
+
+// Name in a NUL-padded 255-byte field; empty if unterminated or empty
+std::string nameField(const uint8_t* field) {
+    const uint8_t* end = std::find(field, field + MAX_FILENAME_SIZE, 0);
+    return end == field + MAX_FILENAME_SIZE ? std::string() : std::string(field, end);
+}
+
+} // namespace
+
+struct MockBackupServer::FileState {
+    uint16_t totalPackets = 0;
+    uint32_t originalSize = 0;
+    uint16_t receivedCount = 0;
+    uint64_t encryptedBytes = 0;
+    std::vector<bool> received;
+    std::vector<std::vector<uint8_t>> chunks;   // Full verification only
+};
+
+struct MockBackupServer::ClientRecord {
+    std::string id;                             // Raw 16 bytes
+    std::string name;
+    std::string publicKey;                      // Empty until REQ_SEND_PUBLIC_KEY
+    std::vector<unsigned char> aesKey;          // Current session key
+    std::map<std::string, FileState> partialFiles;
+};
+
+struct MockBackupServer::Connection {
+    std::unique_ptr<boost::asio::io_context> context;   // TCP connections only
+    std::unique_ptr<Transport> transport;
+    int nativeHandle = -1;
+    std::thread thread;
+    std::atomic<bool> done{false};
+    uint64_t received = 0;                              // Request bytes so far
+    std::chrono::steady_clock::time_point connectedAt;
+    bool disconnectArmed = false;
+};
+
+MockBackupServer::MockBackupServer(MockVerification verification)
+    : verification(verification), dropGenerator(1), listenPort(0), stopping(false), bytesReceived(0) {
+}
+
+MockBackupServer::~MockBackupServer() {
+    stop();
+}
+
+// ---------------------------------------------------------------------------
+// Lifecycle
+
+bool MockBackupServer::start(std::string& error, unsigned short port) {
+    try {
+        using boost::asio::ip::tcp;
+        acceptor.reset(new tcp::acceptor(acceptContext, tcp::endpoint(boost::asio::ip::address_v4::loopback(), port)));
+        listenPort = acceptor->local_endpoint().port();
+    } catch (const std::exception& e) {
+        error = std::string("Cannot listen: ") + e.what();
+        acceptor.reset();
+        return false;
+    }
+    stopping = false;
+    acceptThread = std::thread(&MockBackupServer::acceptLoop, this);
+    return true;
+}
+
+void MockBackupServer::stop() {
+    stopping = true;
+    if (acceptThread.joinable()) {
+        // Wake the blocking accept() with a connection of our own
+        try {
+            boost::asio::io_context wakeContext;
+            boost::asio::ip::tcp::socket wake(wakeContext);
+            wake.connect(acceptor->local_endpoint());
+        } catch (const std::exception&) {
+        }
+        acceptThread.join();
+    }
+    acceptor.reset();
+
+    std::list<std::unique_ptr<Connection>> closing;
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        for (auto& connection : connections) {
+            abort(*connection);
+        }
+        closing.swap(connections);
+    }
+    for (auto& connection : closing) {
+        connection->thread.join();
+    }
+}
+
+void MockBackupServer::acceptLoop() {
+    while (!stopping) {
+        std::unique_ptr<Connection> connection(new Connection);
+        connection->context.reset(new boost::asio::io_context);
+        std::unique_ptr<boost::asio::ip::tcp::socket> socket(new boost::asio::ip::tcp::socket(*connection->context));
+        boost::system::error_code ec;
+        acceptor->accept(*socket, ec);
+        if (stopping || ec) {
+            if (ec && !stopping) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));   // e.g. out of descriptors
+                continue;
+            }
+            break;
+        }
+        socket->set_option(boost::asio::ip::tcp::no_delay(true), ec);
+        connection->nativeHandle = static_cast<int>(socket->native_handle());
+        connection->transport.reset(new TcpTransport(*connection->context, std::move(socket)));
+        launch(std::move(connection));
+    }
+}
+
+std::unique_ptr<Transport> MockBackupServer::connectInProcess() {
+    auto pipe = MemoryTransport::createPair();
+    std::unique_ptr<Connection> connection(new Connection);
+    connection->transport = std::move(pipe.second);
+    launch(std::move(connection));
+    return std::move(pipe.first);
+}
+
+void MockBackupServer::launch(std::unique_ptr<Connection> connection) {
+    std::lock_guard<std::mutex> guard(lock);
+    // Reap connections that have finished
+    for (auto it = connections.begin(); it != connections.end(); ) {
+        if ((*it)->done) {
+            (*it)->thread.join();
+            it = connections.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    counters.connections++;
+    connection->connectedAt = std::chrono::steady_clock::now();
+    connection->disconnectArmed = faults.disconnects > 0 && faults.disconnectAfterBytes > 0;
+    Connection* raw = connection.get();
+    connections.push_back(std::move(connection));
+    raw->thread = std::thread([this, raw]() {
+        serve(*raw);
+        raw->done = true;
+    });
+}
+
+void MockBackupServer::abort(Connection& connection) {
+    // shutdown() leaves the descriptor to its owner, so this is safe while it is in use
+    if (connection.nativeHandle >= 0) {
+        ::shutdown(connection.nativeHandle, MOCK_SHUTDOWN_BOTH);
+    } else {
+        connection.transport->close();
+    }
+}
+
+void MockBackupServer::setFaults(const MockFaults& newFaults) {
+    std::lock_guard<std::mutex> guard(lock);
+    faults = newFaults;
+    dropGenerator.seed(newFaults.seed);
+}
+
+MockServerStats MockBackupServer::stats() const {
+    std::lock_guard<std::mutex> guard(lock);
+    MockServerStats snapshot = counters;
+    snapshot.bytesReceived = bytesReceived;
+    return snapshot;
+}
+
+bool MockBackupServer::receivedFile(const std::string& filename, std::vector<uint8_t>& contents) const {
+    std::lock_guard<std::mutex> guard(lock);
+    auto file = files.find(filename);
+    if (file == files.end()) {
+        return false;
+    }
+    contents = file->second;
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Connection handling
+
+void MockBackupServer::serve(Connection& connection) {
+    uint8_t header[REQUEST_HEADER_SIZE];
+    std::vector<uint8_t> payload;
+    while (!stopping && readRequestBytes(connection, header, sizeof(header))) {
+        uint8_t version = header[16];
+        uint16_t code = static_cast<uint16_t>(readLE(header + 17, 2));
+        uint32_t payloadSize = readLE(header + 19, 4);
+        if (version != VERSION || payloadSize > MAX_PAYLOAD) {
+            respond(connection, RESP_ERROR, {});
+            break;
+        }
+        payload.resize(payloadSize);
+        if (!readRequestBytes(connection, payload.data(), payload.size())) {
+            break;
+        }
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            counters.requests[code]++;
+        }
+        if (!handleRequest(connection, header, code, payload)) {
+            break;
+        }
+    }
+    abort(connection);
+}
+
+// Read exactly size request bytes, applying the bandwidth cap and the disconnect fault
+bool MockBackupServer::readRequestBytes(Connection& connection, uint8_t* data, size_t size) {
+    MockFaults current;
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        current = faults;
+    }
+    const std::chrono::milliseconds timeout(IDLE_TIMEOUT_MS);
+    size_t offset = 0;
+    while (offset < size) {
+        size_t slice = size - offset;
+        if (current.bandwidthBytesPerSecond > 0) {
+            slice = std::min(slice, SHAPING_SLICE);
+        }
+        bool cut = false;
+        if (connection.disconnectArmed && connection.received + slice >= current.disconnectAfterBytes) {
+            slice = static_cast<size_t>(current.disconnectAfterBytes - std::min(connection.received, current.disconnectAfterBytes));
+            cut = true;
+        }
+        if (slice > 0 && connection.transport->read(boost::asio::buffer(data + offset, slice), timeout)) {
+            return false;
+        }
+        offset += slice;
+        connection.received += slice;
+        bytesReceived += slice;
+        if (cut) {
+            connection.disconnectArmed = false;
+            std::lock_guard<std::mutex> guard(lock);
+            if (faults.disconnects > 0) {
+                faults.disconnects--;
+                counters.disconnects++;
+                return false;
+            }
+        }
+        if (current.bandwidthBytesPerSecond > 0) {
+            auto due = connection.connectedAt + std::chrono::microseconds(static_cast<long long>(
+                connection.received * 1000000.0 / current.bandwidthBytesPerSecond));
+            std::this_thread::sleep_until(due);
+        }
+    }
+    return true;
+}
+
+bool MockBackupServer::respond(Connection& connection, uint16_t code, const std::vector<uint8_t>& payload) {
+    std::chrono::milliseconds latency;
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        latency = faults.responseLatency;
+    }
+    if (latency.count() > 0) {
+        std::this_thread::sleep_for(latency);
+    }
+    std::vector<uint8_t> header;
+    header.push_back(VERSION);
+    appendLE(header, code, 2);
+    appendLE(header, static_cast<uint32_t>(payload.size()), 4);
+    return !connection.transport->write({boost::asio::buffer(header), boost::asio::buffer(payload)},
+                                        std::chrono::milliseconds(IDLE_TIMEOUT_MS));
+}
+
+// Returns false when the connection should be closed
+bool MockBackupServer::handleRequest(Connection& connection, const uint8_t* clientId, uint16_t code,
+                                     const std::vector<uint8_t>& payload) {
+    const std::string key(reinterpret_cast<const char*>(clientId), 16);
+    if (code == REQ_REGISTER) {
+        std::string name = payload.size() == MAX_FILENAME_SIZE ? nameField(payload.data()) : std::string();
+        std::unique_lock<std::mutex> guard(lock);
+        bool taken = name.empty() || std::any_of(clients.begin(), clients.end(), [&name](const auto& client) {
+            return client.second->name == name;
+        });
+        if (taken) {
+            guard.unlock();
+            return respond(connection, RESP_REGISTER_FAIL, {});
+        }
+        std::unique_ptr<ClientRecord> client(new ClientRecord);
+        client->id.resize(16);
+        do {
+            AESWrapper::generateKey(reinterpret_cast<unsigned char*>(&client->id[0]), client->id.size());
+        } while (clients.count(client->id) || client->id == std::string(16, '\0'));
+        client->name = name;
+        std::vector<uint8_t> response(client->id.begin(), client->id.end());
+        clients[client->id] = std::move(client);
+        guard.unlock();
+        return respond(connection, RESP_REGISTER_OK, response);
+    }
+
+    std::unique_lock<std::mutex> guard(lock);
+    auto found = clients.find(key);
+    if (found == clients.end()) {
+        guard.unlock();
+        if (code == REQ_RECONNECT) {
+            respond(connection, RESP_RECONNECT_FAIL, std::vector<uint8_t>(clientId, clientId + 16));
+        } else {
+            respond(connection, RESP_ERROR, {});
+        }
+        return false;   // Unknown client: server.py closes the connection
+    }
+    ClientRecord& client = *found->second;
+    const std::vector<uint8_t> id(client.id.begin(), client.id.end());
+
+    switch (code) {
+    case REQ_SEND_PUBLIC_KEY:
+    case REQ_RECONNECT: {
+        bool keyExchange = code == REQ_SEND_PUBLIC_KEY;
+        size_t expected = MAX_FILENAME_SIZE + (keyExchange ? PUBLIC_KEY_SIZE : 0);
+        if (payload.size() != expected || nameField(payload.data()) != client.name) {
+            guard.unlock();
+            return respond(connection, keyExchange ? RESP_ERROR : RESP_RECONNECT_FAIL, keyExchange ? std::vector<uint8_t>() : id);
+        }
+        if (keyExchange) {
+            client.publicKey.assign(reinterpret_cast<const char*>(payload.data()) + MAX_FILENAME_SIZE, PUBLIC_KEY_SIZE);
+        }
+        std::vector<uint8_t> response = id;
+        bool issued = !client.publicKey.empty() && issueSessionKey(client, response);
+        guard.unlock();
+        if (!issued) {
+            return respond(connection, keyExchange ? RESP_ERROR : RESP_RECONNECT_FAIL, keyExchange ? std::vector<uint8_t>() : id);
+        }
+        return respond(connection, keyExchange ? RESP_PUBKEY_AES_SENT : RESP_RECONNECT_AES_SENT, response);
+    }
+    case REQ_SEND_FILE:
+        guard.unlock();
+        return handleFilePacket(connection, key, payload);
+    case REQ_CRC_OK:
+    case REQ_CRC_RETRY:
+    case REQ_CRC_ABORT: {
+        if (payload.size() != MAX_FILENAME_SIZE) {
+            guard.unlock();
+            respond(connection, RESP_ERROR, {});
+            return false;
+        }
+        if (code == REQ_CRC_ABORT) {
+            files.erase(nameField(payload.data()));
+        }
+        guard.unlock();
+        return respond(connection, RESP_ACK, id);
+    }
+    default:
+        guard.unlock();
+        respond(connection, RESP_ERROR, {});
+        return false;
+    }
+}
+
+// New AES session key for client, RSA-wrapped under its public key and appended to wrappedKey
+bool MockBackupServer::issueSessionKey(ClientRecord& client, std::vector<uint8_t>& wrappedKey) {
+    try {
+        std::vector<unsigned char> key(AESWrapper::DEFAULT_KEYLENGTH);
+        AESWrapper::generateKey(key.data(), key.size());
+        RSAPublicWrapper rsa(client.publicKey.data(), client.publicKey.size());
+        std::string wrapped = rsa.encrypt(std::string(key.begin(), key.end()));
+        client.aesKey = key;
+        wrappedKey.insert(wrappedKey.end(), wrapped.begin(), wrapped.end());
+        return true;
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+// One REQ_SEND_FILE packet; once all have arrived, answer with the file's CRC
+bool MockBackupServer::handleFilePacket(Connection& connection, const std::string& clientKey,
+                                        const std::vector<uint8_t>& payload) {
+    if (payload.size() < FILE_PACKET_HEADER_SIZE) {
+        respond(connection, RESP_ERROR, {});
+        return false;
+    }
+    const uint32_t encryptedSize = readLE(payload.data(), 4);
+    const uint32_t originalSize = readLE(payload.data() + 4, 4);
+    const uint16_t packet = static_cast<uint16_t>(readLE(payload.data() + 8, 2));
+    const uint16_t totalPackets = static_cast<uint16_t>(readLE(payload.data() + 10, 2));
+    const std::string filename = nameField(payload.data() + 12);
+    if (encryptedSize == 0 || encryptedSize != payload.size() - FILE_PACKET_HEADER_SIZE || totalPackets == 0 ||
+        packet < 1 || packet > totalPackets || filename.empty()) {
+        respond(connection, RESP_ERROR, {});
+        return false;
+    }
+
+    std::unique_lock<std::mutex> guard(lock);
+    if (faults.packetDropRate > 0 && std::uniform_real_distribution<double>(0, 1)(dropGenerator) < faults.packetDropRate) {
+        counters.packetsDropped++;
+        return true;
+    }
+    ClientRecord& client = *clients[clientKey];
+    if (client.aesKey.empty()) {
+        guard.unlock();
+        respond(connection, RESP_ERROR, {});
+        return false;
+    }
+    FileState* state = nullptr;
+    if (packet == 1) {
+        state = &client.partialFiles[filename];
+        *state = FileState();
+        state->totalPackets = totalPackets;
+        state->originalSize = originalSize;
+        state->received.assign(totalPackets + 1, false);
+        if (verification == MockVerification::Full) {
+            state->chunks.resize(totalPackets + 1);
+        }
+    } else {
+        auto existing = client.partialFiles.find(filename);
+        if (existing != client.partialFiles.end() && existing->second.totalPackets == totalPackets &&
+            existing->second.originalSize == originalSize) {
+            state = &existing->second;
+        }
+    }
+    if (!state) {
+        client.partialFiles.erase(filename);
+        guard.unlock();
+        return respond(connection, RESP_ERROR, {});
+    }
+    if (!state->received[packet]) {
+        state->received[packet] = true;
+        state->receivedCount++;
+    }
+    state->encryptedBytes += encryptedSize;
+    if (verification == MockVerification::Full) {
+        state->chunks[packet].assign(payload.begin() + FILE_PACKET_HEADER_SIZE, payload.end());
+    }
+    if (state->receivedCount < totalPackets) {
+        return true;
+    }
+
+    // Complete: take the file out of the partial map and finish outside the lock
+    FileState complete = std::move(*state);
+    client.partialFiles.erase(filename);
+    const std::vector<unsigned char> key = client.aesKey;
+    const std::vector<uint8_t> id(client.id.begin(), client.id.end());
+    guard.unlock();
+
+    uint32_t crc = 0;
+    uint64_t contentSize = complete.encryptedBytes;
+    std::vector<uint8_t> plaintext;
+    if (verification == MockVerification::Full) {
+        std::vector<uint8_t> encrypted;
+        for (auto& chunk : complete.chunks) {
+            encrypted.insert(encrypted.end(), chunk.begin(), chunk.end());
+        }
+        contentSize = encrypted.size();
+        try {
+            // The client sends its IV block first (zero IV, see AESWrapper::encrypt)
+            AESWrapper aes(key.data(), key.size());
+            std::string decrypted = aes.decrypt(reinterpret_cast<const char*>(encrypted.data()), encrypted.size());
+            plaintext.assign(decrypted.begin(), decrypted.end());
+        } catch (const std::exception&) {
+            return respond(connection, RESP_ERROR, {});
+        }
+        if (plaintext.size() != complete.originalSize) {
+            return respond(connection, RESP_ERROR, {});
+        }
+        crc = calculateCRC(plaintext.data(), plaintext.size());
+    }
+
+    guard.lock();
+    counters.filesCompleted++;
+    if (faults.corruptCrcResponses > 0) {
+        faults.corruptCrcResponses--;
+        counters.crcCorrupted++;
+        crc = ~crc;
+    }
+    if (verification == MockVerification::Full) {
+        files[filename] = std::move(plaintext);
+    }
+    guard.unlock();
+
+    // client id(16) || content size(4) || filename(255) || cksum(4)
+    std::vector<uint8_t> response = id;
+    appendLE(response, static_cast<uint32_t>(contentSize), 4);
+    response.insert(response.end(), payload.begin() + 12, payload.begin() + 12 + MAX_FILENAME_SIZE);
+    appendLE(response, crc, 4);
+    return respond(connection, RESP_FILE_CRC, response);
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "../include/client/Transport.h"
+#include "../include/client/protocol.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+// In-process stand-in for server/server.py, for benchmarks and retry/resume tests:
+// - Same wire format for request codes 1025-1031 (register, public key, reconnect, file
+//   packets, CRC ok / retry / abort); clients, keys and received files live in memory.
+// - Serves TCP on 127.0.0.1 (a free port) and in-process MemoryTransport pipes, one
+//   thread per connection like the Python server, so injected faults can simply block.
+// - MockFaults adds response latency, a bandwidth cap, dropped file packets, wrong CRCs and
+//   mid-transfer disconnects. Faults are counted or drawn from a seeded generator, so a run
+//   is reproducible.
+// - MockVerification::Discard skips reassembly and decryption so that only the client side
+//   is measured; the CRC response then carries 0.
+
+struct MockFaults {
+    std::chrono::milliseconds responseLatency{0};   // Added before every response
+    uint64_t bandwidthBytesPerSecond = 0;           // Cap on what each connection may send us; 0 = none
+    double packetDropRate = 0;                      // Probability a file packet is discarded unseen
+    uint32_t seed = 1;                              // Generator for packetDropRate
+    unsigned corruptCrcResponses = 0;               // The next N file CRC responses carry a wrong CRC
+    uint64_t disconnectAfterBytes = 0;              // Close a connection once it has sent this many bytes,
+    unsigned disconnects = 0;                       // for the next N connections that get that far
+};
+
+enum class MockVerification {
+    Full,      // Reassemble, AES-CBC decrypt, cksum the plaintext (what server.py does)
+    Discard    // Count packets only; the CRC response carries 0
+};
+
+struct MockServerStats {
+    std::map<uint16_t, uint64_t> requests;   // By request code
+    uint64_t bytesReceived = 0;
+    uint64_t filesCompleted = 0;
+    uint64_t packetsDropped = 0;
+    uint64_t crcCorrupted = 0;
+    uint64_t disconnects = 0;                // Injected only
+    uint64_t connections = 0;
+};
+
+class MockBackupServer {
+public:
+    static constexpr uint8_t VERSION = PROTOCOL_VERSION;
+    static constexpr size_t PUBLIC_KEY_SIZE = 162;   // 1024-bit RSA, DER
+    static constexpr uint32_t MAX_PAYLOAD = 16 * 1024 * 1024;
+    static constexpr int IDLE_TIMEOUT_MS = 300000;   // A connection silent this long is dropped
+
+    explicit MockBackupServer(MockVerification verification = MockVerification::Full);
+    ~MockBackupServer();
+
+    // Listen on 127.0.0.1:port (0 = any free port)
+    bool start(std::string& error, unsigned short port = 0);
+    void stop();   // Closes every connection and joins their threads
+    unsigned short port() const { return listenPort; }
+
+    // Client end of an in-process pipe served like a TCP connection (start() not required)
+    std::unique_ptr<Transport> connectInProcess();
+
+    void setFaults(const MockFaults& faults);
+    MockServerStats stats() const;
+
+    // Plaintext of the last file received under this name (Full verification), or false
+    bool receivedFile(const std::string& filename, std::vector<uint8_t>& contents) const;
+
+private:
+    struct ClientRecord;
+    struct FileState;
+    struct Connection;
+
+    void acceptLoop();
+    void launch(std::unique_ptr<Connection> connection);
+    void serve(Connection& connection);
+    bool readRequestBytes(Connection& connection, uint8_t* data, size_t size);
+    bool respond(Connection& connection, uint16_t code, const std::vector<uint8_t>& payload);
+    bool handleRequest(Connection& connection, const uint8_t* clientId, uint16_t code, const std::vector<uint8_t>& payload);
+    bool handleFilePacket(Connection& connection, const std::string& clientKey, const std::vector<uint8_t>& payload);
+    bool issueSessionKey(ClientRecord& client, std::vector<uint8_t>& wrappedKey);
+    static void abort(Connection& connection);   // Wake the connection's thread from any thread
+
+    const MockVerification verification;
+    mutable std::mutex lock;   // Everything below except the atomics
+    MockFaults faults;
+    std::mt19937 dropGenerator;
+    MockServerStats counters;
+    std::map<std::string, std::unique_ptr<ClientRecord>> clients;   // By raw 16-byte id
+    std::map<std::string, std::vector<uint8_t>> files;              // Verified plaintext by filename
+    std::list<std::unique_ptr<Connection>> connections;
+
+    boost::asio::io_context acceptContext;
+    std::unique_ptr<boost::asio::ip::tcp::acceptor> acceptor;
+    std::thread acceptThread;
+    unsigned short listenPort;
+    std::atomic<bool> stopping;
+    std::atomic<uint64_t> bytesReceived;
+};
@@ -0,0 +1,470 @@
+#include "WanEmulator.h"
+
+#include <algorithm>
+#include <cctype>
+#include <deque>
+#include <fstream>
+#include <sstream>
+#include <utility>
+
+namespace {
+
+using Units = std::vector<std::pair<const char*, double>>;
+
+const Units DURATION_UNITS = {{"ms", 1}, {"s", 1000}};
+const Units RATE_UNITS = {{"bit", 1}, {"kbit", 1e3}, {"mbit", 1e6}, {"gbit", 1e9}};
+const Units SIZE_UNITS = {{"b", 1}, {"kb", 1024.0}, {"mb", 1024.0 * 1024}, {"gb", 1024.0 * 1024 * 1024}};
+
+// "1.5s", "50mbit", "64kb": a non-negative number with an optional unit from units
+bool parseQuantity(const std::string& text, const Units& units, double& value) {
+    size_t end = 0;
+    double number = 0;
+    try {
+        number = std::stod(text, &end);
+    } catch (const std::exception&) {
+        return false;
+    }
+    std::string unit = text.substr(end);
+    std::transform(unit.begin(), unit.end(), unit.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    if (number < 0) {
+        return false;
+    }
+    if (unit.empty()) {
+        value = number;
+        return true;
+    }
+    for (const auto& candidate : units) {
+        if (unit == candidate.first) {
+            value = number * candidate.second;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool parseDuration(const std::string& text, std::chrono::milliseconds& duration) {
+    double ms = 0;
+    if (!parseQuantity(text, DURATION_UNITS, ms)) {
+        return false;
+    }
+    duration = std::chrono::milliseconds(static_cast<long long>(ms));
+    return true;
+}
+
+} // namespace
+
+struct WanEmulator::Direction {
+    struct Chunk {
+        std::vector<uint8_t> data;
+        std::chrono::steady_clock::time_point release;
+    };
+
+    Direction(int index, boost::asio::ip::tcp::socket& from, boost::asio::ip::tcp::socket& to,
+              boost::asio::io_context& ioContext)
+        : index(index), from(from), to(to), timer(ioContext) {}
+
+    const int index;                        // 0 = client to server
+    boost::asio::ip::tcp::socket& from;
+    boost::asio::ip::tcp::socket& to;
+    std::deque<Chunk> queue;                // Read, waiting for release or being written
+    size_t queuedBytes = 0;
+    size_t writingChunks = 0;               // Front chunks in the current write
+    bool reading = false;
+    bool waiting = false;                   // Timer armed for the front chunk
+    bool eof = false;
+    bool shutDown = false;                  // Half-closed towards the receiver
+    std::chrono::steady_clock::time_point lastRelease;
+    boost::asio::steady_timer timer;
+    std::vector<uint8_t> readBuffer = std::vector<uint8_t>(READ_CHUNK);
+};
+
+struct WanEmulator::Link {
+    Link(boost::asio::io_context& ioContext, uint64_t id)
+        : id(id), client(ioContext), server(ioContext),
+          up(0, client, server, ioContext), down(1, server, client, ioContext) {}
+
+    const uint64_t id;
+    boost::asio::ip::tcp::socket client;
+    boost::asio::ip::tcp::socket server;
+    Direction up;
+    Direction down;
+    uint64_t relayedBytes = 0;
+    bool closed = false;
+};
+
+// ---------------------------------------------------------------------------
+// Scripts
+
+bool WanScript::parse(const std::string& text, WanScript& script, std::string& error) {
+    WanScript parsed;
+    WanConditions conditions;
+    std::istringstream lines(text);
+    std::string line;
+    for (int number = 1; std::getline(lines, line); number++) {
+        line = line.substr(0, line.find('#'));
+        std::istringstream tokens(line);
+        std::string token;
+        if (!(tokens >> token)) {
+            continue;
+        }
+        const std::string where = "line " + std::to_string(number) + ": ";
+        if (token == "loop") {
+            if (!(tokens >> token) || !parseDuration(token, parsed.loop) || parsed.loop.count() == 0) {
+                error = where + "loop needs a duration";
+                return false;
+            }
+            continue;
+        }
+        WanStep step;
+        if (!parseDuration(token, step.at)) {
+            error = where + "expected a time, got '" + token + "'";
+            return false;
+        }
+        if (!parsed.steps.empty() && step.at <= parsed.steps.back().at) {
+            error = where + "steps must be in increasing time order";
+            return false;
+        }
+        while (tokens >> token) {
+            if (token == "reset") {
+                step.resetConnections = true;
+                continue;
+            }
+            size_t equals = token.find('=');
+            std::string key = token.substr(0, equals);
+            std::string value = equals == std::string::npos ? std::string() : token.substr(equals + 1);
+            double quantity = 0;
+            bool ok = false;
+            if (key == "latency") {
+                ok = parseDuration(value, conditions.latency);
+            } else if (key == "jitter") {
+                ok = parseDuration(value, conditions.jitter);
+            } else if (key == "rate") {
+                ok = parseQuantity(value, RATE_UNITS, quantity);
+                conditions.bitsPerSecond = static_cast<uint64_t>(quantity);
+            } else if (key == "reset-after") {
+                ok = parseQuantity(value, SIZE_UNITS, quantity);
+                conditions.resetAfterBytes = static_cast<uint64_t>(quantity);
+            }
+            if (!ok) {
+                error = where + "bad setting '" + token + "'";
+                return false;
+            }
+        }
+        step.conditions = conditions;
+        parsed.steps.push_back(step);
+    }
+    if (!parsed.steps.empty() && parsed.steps.front().at.count() > 0) {
+        parsed.steps.insert(parsed.steps.begin(), WanStep());   // Unimpaired until the first step
+    }
+    if (parsed.loop.count() > 0 && !parsed.steps.empty() && parsed.loop <= parsed.steps.back().at) {
+        error = "loop must be longer than the last step's time";
+        return false;
+    }
+    script = parsed;
+    return true;
+}
+
+bool WanScript::load(const std::string& filename, WanScript& script, std::string& error) {
+    std::ifstream in(filename);
+    if (!in) {
+        error = "Cannot open " + filename;
+        return false;
+    }
+    std::stringstream text;
+    text << in.rdbuf();
+    if (!parse(text.str(), script, error)) {
+        error = filename + ", " + error;
+        return false;
+    }
+    return true;
+}
+
+WanScript WanScript::constant(const WanConditions& conditions) {
+    WanScript script;
+    script.steps.resize(1);
+    script.steps[0].conditions = conditions;
+    return script;
+}
+
+// ---------------------------------------------------------------------------
+// Lifecycle
+
+WanEmulator::WanEmulator(const std::string& targetHost, unsigned short targetPort, const WanScript& script)
+    : targetHost(targetHost), targetPort(targetPort), script(script), nextLinkId(1), jitterState(0x9E3779B9),
+      acceptor(ioContext), scriptTimer(ioContext), listenPort(0),
+      connectionCount(0), resetCount(0), connectFailureCount(0) {
+    bytesRelayed[0] = 0;
+    bytesRelayed[1] = 0;
+}
+
+WanEmulator::~WanEmulator() {
+    stop();
+}
+
+bool WanEmulator::start(std::string& error, unsigned short port) {
+    using boost::asio::ip::tcp;
+    try {
+        tcp::resolver resolver(ioContext);
+        upstream = resolver.resolve(targetHost, std::to_string(targetPort));
+        tcp::endpoint endpoint(boost::asio::ip::address_v4::loopback(), port);
+        acceptor.open(endpoint.protocol());
+        acceptor.set_option(tcp::acceptor::reuse_address(true));
+        acceptor.bind(endpoint);
+        acceptor.listen();
+        listenPort = acceptor.local_endpoint().port();
+    } catch (const std::exception& e) {
+        error = std::string("Cannot start relay: ") + e.what();
+        boost::system::error_code ignored;
+        acceptor.close(ignored);
+        return false;
+    }
+    startScript();
+    accept();
+    ioThread = std::thread([this]() { ioContext.run(); });
+    return true;
+}
+
+void WanEmulator::stop() {
+    if (!ioThread.joinable()) {
+        return;
+    }
+    boost::asio::post(ioContext, [this]() {
+        boost::system::error_code ignored;
+        acceptor.close(ignored);
+        scriptTimer.cancel();
+        auto open = links;
+        for (auto& link : open) {
+            closeLink(link.second, false);
+        }
+    });
+    ioThread.join();   // run() returns once the last handler has finished
+}
+
+void WanEmulator::setScript(const WanScript& newScript) {
+    boost::asio::post(ioContext, [this, newScript]() {
+        script = newScript;
+        startScript();
+    });
+}
+
+WanEmulatorStats WanEmulator::stats() const {
+    WanEmulatorStats snapshot;
+    snapshot.connections = connectionCount;
+    snapshot.bytesUpstream = bytesRelayed[0];
+    snapshot.bytesDownstream = bytesRelayed[1];
+    snapshot.resets = resetCount;
+    snapshot.connectFailures = connectFailureCount;
+    return snapshot;
+}
+
+// ---------------------------------------------------------------------------
+// Script timeline
+
+void WanEmulator::startScript() {
+    scriptTimer.cancel();
+    scriptStart = std::chrono::steady_clock::now();
+    current = WanConditions();
+    if (!script.steps.empty()) {
+        applyStep(0);
+    }
+}
+
+void WanEmulator::applyStep(size_t index) {
+    const WanStep& step = script.steps[index];
+    current = step.conditions;
+    if (step.resetConnections) {
+        auto open = links;
+        for (auto& link : open) {
+            resetCount++;
+            closeLink(link.second, true);
+        }
+    }
+
+    size_t next = index + 1;
+    if (next == script.steps.size()) {
+        if (script.loop.count() == 0) {
+            return;
+        }
+        scriptStart += script.loop;
+        next = 0;
+    }
+    scriptTimer.expires_at(scriptStart + script.steps[next].at);
+    scriptTimer.async_wait([this, next](const boost::system::error_code& ec) {
+        if (!ec) {
+            applyStep(next);
+        }
+    });
+}
+
+// ---------------------------------------------------------------------------
+// Relaying
+
+void WanEmulator::accept() {
+    auto link = std::make_shared<Link>(ioContext, nextLinkId++);
+    acceptor.async_accept(link->client, [this, link](const boost::system::error_code& ec) {
+        if (!acceptor.is_open()) {
+            return;
+        }
+        if (!ec) {
+            connectionCount++;
+            links[link->id] = link;
+            connectUpstream(link);
+        }
+        accept();
+    });
+}
+
+void WanEmulator::connectUpstream(std::shared_ptr<Link> link) {
+    boost::asio::async_connect(link->server, upstream,
+                               [this, link](const boost::system::error_code& ec, const boost::asio::ip::tcp::endpoint&) {
+        if (link->closed) {
+            return;
+        }
+        if (ec) {
+            connectFailureCount++;
+            closeLink(link, true);   // The client sees a refused connection as a reset
+            return;
+        }
+        // The relay must not add Nagle delays of its own
+        boost::system::error_code ignored;
+        link->client.set_option(boost::asio::ip::tcp::no_delay(true), ignored);
+        link->server.set_option(boost::asio::ip::tcp::no_delay(true), ignored);
+        read(link, link->up);
+        read(link, link->down);
+    });
+}
+
+void WanEmulator::read(std::shared_ptr<Link> link, Direction& direction) {
+    if (link->closed || direction.reading || direction.eof || direction.queuedBytes >= MAX_QUEUED_BYTES) {
+        return;   // A full queue resumes reading from deliver()
+    }
+    direction.reading = true;
+    direction.from.async_read_some(boost::asio::buffer(direction.readBuffer),
+                                   [this, link, &direction](const boost::system::error_code& ec, size_t size) {
+        direction.reading = false;
+        if (link->closed) {
+            return;
+        }
+        if (ec) {
+            if (ec == boost::asio::error::eof) {
+                direction.eof = true;
+                finish(link, direction);
+            } else {
+                closeLink(link, false);
+            }
+            return;
+        }
+
+        // Serialization on the shared bottleneck, then propagation with jitter; never
+        // released ahead of earlier bytes of the same stream
+        auto now = std::chrono::steady_clock::now();
+        auto departs = now;
+        if (current.bitsPerSecond > 0) {
+            departs = std::max(now, linkFreeAt[direction.index]) +
+                      std::chrono::nanoseconds(static_cast<long long>(size * 8 * 1e9 / current.bitsPerSecond));
+            linkFreeAt[direction.index] = departs;
+        }
+        std::chrono::microseconds delay = current.latency;
+        if (current.jitter.count() > 0) {
+            jitterState ^= jitterState << 13;
+            jitterState ^= jitterState >> 17;
+            jitterState ^= jitterState << 5;
+            long long span = std::chrono::microseconds(current.jitter).count();
+            delay += std::chrono::microseconds(static_cast<long long>(jitterState % (2 * span + 1)) - span);
+            delay = std::max(delay, std::chrono::microseconds(0));
+        }
+        direction.lastRelease = std::max(departs + delay, direction.lastRelease);
+
+        Direction::Chunk chunk;
+        chunk.data.assign(direction.readBuffer.begin(), direction.readBuffer.begin() + size);
+        chunk.release = direction.lastRelease;
+        direction.queue.push_back(std::move(chunk));
+        direction.queuedBytes += size;
+        bytesRelayed[direction.index] += size;
+        link->relayedBytes += size;
+
+        if (current.resetAfterBytes > 0 && link->relayedBytes >= current.resetAfterBytes) {
+            resetCount++;
+            closeLink(link, true);
+            return;
+        }
+        deliver(link, direction);
+        read(link, direction);
+    });
+}
+
+// Write every chunk whose release time has come, or wait for the first one that has not
+void WanEmulator::deliver(std::shared_ptr<Link> link, Direction& direction) {
+    if (link->closed || direction.writingChunks > 0 || direction.waiting || direction.queue.empty()) {
+        return;
+    }
+    auto now = std::chrono::steady_clock::now();
+    if (direction.queue.front().release > now) {
+        direction.waiting = true;
+        direction.timer.expires_at(direction.queue.front().release);
+        direction.timer.async_wait([this, link, &direction](const boost::system::error_code& ec) {
+            direction.waiting = false;
+            if (!ec) {
+                deliver(link, direction);
+            }
+        });
+        return;
+    }
+    std::vector<boost::asio::const_buffer> buffers;
+    for (const auto& chunk : direction.queue) {
+        if (chunk.release > now || buffers.size() == 64) {
+            break;
+        }
+        buffers.push_back(boost::asio::buffer(chunk.data));
+    }
+    direction.writingChunks = buffers.size();
+    boost::asio::async_write(direction.to, buffers, [this, link, &direction](const boost::system::error_code& ec, size_t) {
+        if (link->closed) {
+            return;
+        }
+        if (ec) {
+            closeLink(link, false);
+            return;
+        }
+        for (; direction.writingChunks > 0; direction.writingChunks--) {
+            direction.queuedBytes -= direction.queue.front().data.size();
+            direction.queue.pop_front();
+        }
+        read(link, direction);
+        if (direction.queue.empty()) {
+            finish(link, direction);
+        } else {
+            deliver(link, direction);
+        }
+    });
+}
+
+// Pass a half-close on once everything before it has been delivered
+void WanEmulator::finish(std::shared_ptr<Link> link, Direction& direction) {
+    if (!direction.eof || !direction.queue.empty() || direction.shutDown) {
+        return;
+    }
+    boost::system::error_code ignored;
+    direction.to.shutdown(boost::asio::ip::tcp::socket::shutdown_send, ignored);
+    direction.shutDown = true;
+    if (link->up.shutDown && link->down.shutDown) {
+        closeLink(link, false);
+    }
+}
+
+void WanEmulator::closeLink(const std::shared_ptr<Link>& link, bool reset) {
+    if (link->closed) {
+        return;
+    }
+    link->closed = true;
+    boost::system::error_code ignored;
+    for (auto* socket : {&link->client, &link->server}) {
+        if (reset && socket->is_open()) {
+            socket->set_option(boost::asio::socket_base::linger(true, 0), ignored);   // Close sends RST
+        }
+        socket->close(ignored);
+    }
+    link->up.timer.cancel();
+    link->down.timer.cancel();
+    links.erase(link->id);
+}
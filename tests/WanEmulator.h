@@ -0,0 +1,117 @@
+#pragma once
+
+#include <boost/asio.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+// User-space TCP relay that puts WAN conditions between the client and any server, so
+// adaptive packet sizing, striping and resume can be measured on one machine without
+// root-only tc netem.
+// - Each byte the relay reads is released to the other side after the one-way latency
+//   plus a uniform jitter, never ahead of earlier bytes (it is one TCP stream). A 100 ms
+//   RTT is latency=50ms.
+// - rate= is a bottleneck link per direction shared by all connections, so striped
+//   connections compete for it as they would on a real link. Each connection buffers at
+//   most MAX_QUEUED_BYTES per direction before the relay stops reading from the sender.
+// - Resets close both sides with RST: per connection after reset-after= relayed bytes, or
+//   for every open connection at a script step marked reset.
+// - A WanScript changes conditions over time, counted from start(). All Asio work runs on
+//   one thread, so link state needs no locks.
+// Packet loss is not emulated: TCP above the socket layer sees lost segments only as the
+// delay of their retransmission, which latency and jitter steps can reproduce.
+
+struct WanConditions {
+    std::chrono::milliseconds latency{0};   // One way, each direction
+    std::chrono::milliseconds jitter{0};    // Uniform +-, clamped at zero delay
+    uint64_t bitsPerSecond = 0;             // Per direction; 0 = unlimited
+    uint64_t resetAfterBytes = 0;           // Per connection, both directions; 0 = never
+};
+
+struct WanStep {
+    std::chrono::milliseconds at{0};        // Since start()
+    WanConditions conditions;
+    bool resetConnections = false;          // Reset every connection open at this time
+};
+
+// Text form, one step per line, settings carried over from the previous step:
+//   0      latency=50ms jitter=5ms rate=50mbit
+//   10s    rate=10mbit reset-after=4mb
+//   20s    reset
+//   loop 30s
+// Durations take ms or s, rates bit/kbit/mbit/gbit, sizes b/kb/mb/gb; bare numbers are ms,
+// bit/s and bytes. "loop T" restarts the script every T.
+struct WanScript {
+    std::vector<WanStep> steps;             // Sorted by time
+    std::chrono::milliseconds loop{0};      // 0 = hold the last step
+
+    static bool parse(const std::string& text, WanScript& script, std::string& error);
+    static bool load(const std::string& filename, WanScript& script, std::string& error);
+    static WanScript constant(const WanConditions& conditions);
+};
+
+struct WanEmulatorStats {
+    uint64_t connections = 0;
+    uint64_t bytesUpstream = 0;     // Client to server
+    uint64_t bytesDownstream = 0;
+    uint64_t resets = 0;            // Injected only
+    uint64_t connectFailures = 0;   // Upstream server unreachable
+};
+
+class WanEmulator {
+public:
+    static constexpr size_t READ_CHUNK = 16 * 1024;                // Shaping granularity
+    static constexpr size_t MAX_QUEUED_BYTES = 4 * 1024 * 1024;   // Per direction per connection
+
+    WanEmulator(const std::string& targetHost, unsigned short targetPort, const WanScript& script);
+    ~WanEmulator();
+
+    // Listen on 127.0.0.1:port (0 = any free port) and relay to the target
+    bool start(std::string& error, unsigned short port = 0);
+    void stop();   // Closes every connection
+    unsigned short port() const { return listenPort; }
+
+    void setScript(const WanScript& script);   // Restarts the timeline; safe from any thread
+    WanEmulatorStats stats() const;
+
+private:
+    struct Link;
+    struct Direction;
+
+    void accept();
+    void connectUpstream(std::shared_ptr<Link> link);
+    void startScript();
+    void applyStep(size_t index);
+    void read(std::shared_ptr<Link> link, Direction& direction);
+    void deliver(std::shared_ptr<Link> link, Direction& direction);
+    void finish(std::shared_ptr<Link> link, Direction& direction);
+    void closeLink(const std::shared_ptr<Link>& link, bool reset);
+
+    const std::string targetHost;
+    const unsigned short targetPort;
+    WanScript script;                        // io thread only, like everything below
+    WanConditions current;
+    std::chrono::steady_clock::time_point scriptStart;
+    std::chrono::steady_clock::time_point linkFreeAt[2];   // Bottleneck per direction
+    std::map<uint64_t, std::shared_ptr<Link>> links;
+    uint64_t nextLinkId;
+    uint32_t jitterState;
+
+    boost::asio::io_context ioContext;
+    boost::asio::ip::tcp::acceptor acceptor;
+    boost::asio::ip::tcp::resolver::results_type upstream;
+    boost::asio::steady_timer scriptTimer;
+    std::thread ioThread;
+    unsigned short listenPort;
+
+    std::atomic<uint64_t> connectionCount;
+    std::atomic<uint64_t> bytesRelayed[2];
+    std::atomic<uint64_t> resetCount;
+    std::atomic<uint64_t> connectFailureCount;
+};
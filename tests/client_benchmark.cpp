@@ -1,13 +1,24 @@
 /**
  * Client-Side Performance Benchmark Suite
- * Step 7: Detailed C++ Client Performance Analysis
- * 
- * This benchmark focuses on client-side operations including:
- * - RSA key operations
- * - AES encryption/decryption
- * - Protocol message creation
- * - Memory allocation patterns
- * - File I/O performance
+ *
+ * Measures the client's hot paths with warmup runs, repeated samples and percentiles:
+ * - Size sweep (4KB .. --max-size, up to 4GB): CRC, AES-256-GCM, packetization into
+ *   protocol frames, and a full loopback transfer of the framed file
+ * - RSA key operations, AES-CBC, protocol header encode/parse
+ * - File input paths, io_uring, sparse files, page cache modes (Linux)
+ * - Socket profiles, MSG_ZEROCOPY and transports over loopback (Linux)
+ *
+ * Usage: client_benchmark [--warmup N] [--reps N] [--max-size 4G] [--sweep-only]
+ *                         [--json results.json] [--baseline baseline.json] [--tolerance 10] [--perf]
+ * --json writes per-test samples, percentiles and MB/s; a saved results file passed as
+ * --baseline later flags every test whose median is more than --tolerance percent slower
+ * (exit code 2). --perf (Linux) also counts CPU time, cycles, instructions, last-level cache
+ * misses and branch misses per test and per loopback stage (encrypt, send, response), to
+ * tell compute-bound stages from memory-bound ones. Build: scripts/build_client_benchmark.bat, or on Linux
+ *   g++ -O2 -std=c++17 -Iinclude/client -Iinclude/wrappers tests/client_benchmark.cpp \
+ *       tests/MockBackupServer.cpp \
+ *       src/client/{cksum,Framing,FileSource,SparseScan,BufferPool,DeadlineIO,SocketTuning,ZeroCopySend,Transport,IoUringEngine,PerfCounters}.cpp \
+ *       src/wrappers/{AESWrapper,RSAWrapper,Base64Wrapper,SecureRandom}.cpp -lcryptopp -lpthread
  */
 
 #include <iostream>
@@ -20,17 +31,128 @@
 #include <map>
 #include <numeric>
 #include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <thread>
 
 // Project includes
-#include "../client/include/RSAWrapper.h"
-#include "../client/include/AESWrapper.h"
-#include "../client/include/Base64Wrapper.h"
-#include "../client/include/protocol.h"
+#include "../include/wrappers/RSAWrapper.h"
+#include "../include/wrappers/AESWrapper.h"
+#include "../include/wrappers/Base64Wrapper.h"
+#include "../include/client/FileSource.h"
+#include "../include/client/cksum.h"
+#include "../include/client/Framing.h"
+#include "../include/client/BufferPool.h"
+#include "../include/client/IoUringEngine.h"
+#include "../include/client/SparseScan.h"
+#include "../include/client/SocketTuning.h"
+#include "../include/client/ZeroCopySend.h"
+#include "../include/client/Transport.h"
+#include "../include/client/PerfCounters.h"
+#include "MockBackupServer.h"
+
+#ifdef CLIENT_HAVE_IO_URING
+#include <fcntl.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#endif
+
+#ifdef __linux__
+#include <atomic>
+#include <deque>
+#include <random>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+struct BenchmarkOptions {
+    int warmup = 1;                          // Unrecorded runs before each measured test
+    int repetitions = 5;                     // Recorded runs per test
+    uint64_t maxSize = 256ull * 1048576;     // Largest sweep input (4GB for the full sweep)
+    bool sweepOnly = false;
+    std::string jsonPath;                    // Write results here
+    std::string baselinePath;                // Compare medians against this earlier results file
+    double tolerancePercent = 10.0;          // Slowdown beyond this is a regression
+    bool perf = false;                       // Count hardware events per test and stage
+};
+
+struct SampleStats {
+    size_t count = 0;
+    double min = 0, p50 = 0, p90 = 0, p99 = 0, max = 0, mean = 0;
+};
+
+// Nearest-rank percentiles over the successful (non-negative) samples
+static SampleStats computeStats(std::vector<double> samples) {
+    samples.erase(std::remove_if(samples.begin(), samples.end(), [](double t) { return t < 0; }), samples.end());
+    SampleStats stats;
+    if (samples.empty()) {
+        return stats;
+    }
+    std::sort(samples.begin(), samples.end());
+    auto rank = [&samples](double percentile) {
+        size_t index = static_cast<size_t>(std::ceil(percentile / 100.0 * samples.size()));
+        return samples[std::min(samples.size(), std::max<size_t>(index, 1)) - 1];
+    };
+    stats.count = samples.size();
+    stats.min = samples.front();
+    stats.max = samples.back();
+    stats.p50 = rank(50);
+    stats.p90 = rank(90);
+    stats.p99 = rank(99);
+    stats.mean = std::accumulate(samples.begin(), samples.end(), 0.0) / samples.size();
+    return stats;
+}
+
+// "4KB", "256MB", "4GB"
+static std::string sizeLabel(uint64_t bytes) {
+    if (bytes >= (1ull << 30)) {
+        return std::to_string(bytes >> 30) + "GB";
+    }
+    if (bytes >= (1ull << 20)) {
+        return std::to_string(bytes >> 20) + "MB";
+    }
+    return std::to_string(bytes >> 10) + "KB";
+}
+
+// "4096", "64K", "256M", "4G" -> bytes; 0 if malformed
+static uint64_t parseSize(const std::string& text) {
+    char* end = nullptr;
+    unsigned long long value = std::strtoull(text.c_str(), &end, 10);
+    if (end == text.c_str()) {
+        return 0;
+    }
+    switch (*end) {
+        case 'k': case 'K': return value << 10;
+        case 'm': case 'M': return value << 20;
+        case 'g': case 'G': return value << 30;
+        case '\0': return value;
+        default: return 0;
+    }
+}
+
+// Frames come from Framing (the client's own encoder); these size the benchmark's packets
+constexpr size_t PACKET_BYTES = 1024 * 1024;
+constexpr size_t GCM_OVERHEAD = AESWrapper::GCM_NONCE_SIZE + AESWrapper::GCM_TAG_SIZE;
+constexpr size_t GCM_CHUNK = PACKET_BYTES - GCM_OVERHEAD;   // Plaintext per packet
 
 class ClientBenchmark {
 private:
+    BenchmarkOptions options;
     std::map<std::string, std::vector<double>> results;
-    
+    std::map<std::string, uint64_t> bytesPerRun;   // Tests that process a known amount of data
+
     void logResult(const std::string& category, const std::string& test, double timeMs, const std::string& details = "") {
         results[category + "::" + test].push_back(timeMs);
         std::cout << std::fixed << std::setprecision(3) 
@@ -50,41 +172,75 @@ private:
         return duration.count() / 1000.0 / iterations; // Convert to milliseconds per iteration
     }
 
+    // Run func (returns false on failure) options.warmup times unrecorded, then
+    // options.repetitions times recorded, and print one line with the percentiles.
+    // Inputs of 1GB and more skip the warmup and take at most 3 samples.
+    template<typename Func>
+    void measure(const std::string& category, const std::string& test, uint64_t bytes, Func&& func,
+                 const std::string& details = "") {
+        const std::string key = category + "::" + test;
+        const bool large = bytes >= (1ull << 30);
+        const int warmup = large ? 0 : options.warmup;
+        const int repetitions = large ? std::min(options.repetitions, 3) : options.repetitions;
+        for (int i = 0; i < warmup; i++) {
+            if (!func()) {
+                logResult(category, test, -1, "failed");
+                return;
+            }
+        }
+        std::vector<double> samples;
+        for (int i = 0; i < repetitions; i++) {
+            auto start = std::chrono::steady_clock::now();
+            PerfScope perf(key.c_str());
+            bool ok = func();
+            perf.end();
+            double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            if (!ok) {
+                logResult(category, test, -1, "failed");
+                return;
+            }
+            samples.push_back(elapsed);
+        }
+        results[key].insert(results[key].end(), samples.begin(), samples.end());
+        if (bytes > 0) {
+            bytesPerRun[key] = bytes;
+        }
+        SampleStats stats = computeStats(samples);
+        std::cout << std::fixed << std::setprecision(3)
+                  << "[" << category << "] " << std::setw(25) << test
+                  << " | p50 " << std::setw(9) << stats.p50 << " ms | p90 " << std::setw(9) << stats.p90 << " ms"
+                  << (bytes > 0 && stats.p50 > 0 ? " | " + std::to_string(static_cast<long long>(bytes / stats.p50 / 1000.0)) + " MB/s" : "")
+                  << (details.empty() ? "" : " | " + details) << std::endl;
+    }
+
 public:
+    explicit ClientBenchmark(const BenchmarkOptions& options = BenchmarkOptions()) : options(options) {
+    }
+
     void benchmarkRSAOperations() {
         std::cout << "\n[CRYPTO] RSA OPERATIONS BENCHMARK\n";
         std::cout << std::string(50, '-') << std::endl;
         
         try {
-            // RSA Key Loading (current implementation)
-            auto loadTime = timeFunction([&]() {
+            // Key generation (the default constructor generates a fresh key pair)
+            measure("RSA", "Key_Generation", 0, []() {
                 RSAPrivateWrapper rsa;
-                // This will use the current deterministic key loading
-            }, 5);
-            logResult("RSA", "Key_Loading", loadTime, "5 iterations avg");
-            
-            // RSA Key Generation (if working)
-            try {
-                auto genTime = timeFunction([&]() {
-                    RSAPrivateWrapper rsa;
-                    // Attempt key generation - may fail with current implementation
-                }, 1);
-                logResult("RSA", "Key_Generation", genTime, "1024-bit key");
-            } catch (...) {
-                logResult("RSA", "Key_Generation", -1, "Failed - using fallback");
-            }
-            
-            // Public Key Export
+                return !rsa.getPublicKey().empty();
+            });
+
+            // Public key export
             RSAPrivateWrapper rsa;
-            auto exportTime = timeFunction([&]() {
-                std::string pubKey = rsa.getPublicKey();
-            }, 10);
-            logResult("RSA", "Public_Key_Export", exportTime, "10 iterations avg");
-            
-            // Memory usage estimation
-            RSAPrivateWrapper rsa1, rsa2, rsa3;
-            logResult("RSA", "Memory_Per_Instance", sizeof(RSAPrivateWrapper), "bytes (approx)");
-            
+            measure("RSA", "Public_Key_Export", 0, [&rsa]() {
+                return !rsa.getPublicKey().empty();
+            });
+
+            // Session key unwrap: what the client does with the server's encrypted AES key
+            std::string publicKey = rsa.getPublicKey();
+            RSAPublicWrapper server(publicKey.data(), publicKey.size());
+            std::string wrapped = server.encrypt(std::string(AESWrapper::DEFAULT_KEYLENGTH, 'K'));
+            measure("RSA", "Decrypt_Session_Key", 0, [&rsa, &wrapped]() {
+                return rsa.decrypt(wrapped).size() == AESWrapper::DEFAULT_KEYLENGTH;
+            });
         } catch (const std::exception& e) {
             std::cout << "[FAIL] RSA benchmark failed: " << e.what() << std::endl;
         }
@@ -95,30 +251,25 @@ public:
         std::cout << std::string(50, '-') << std::endl;
         
         try {
-            // Test data of various sizes
+            // Whole-buffer CBC, as the client's CBC path encrypts the file
             std::vector<std::pair<std::string, std::string>> testData = {
                 {"Small", std::string(1024, 'A')},      // 1KB
-                {"Medium", std::string(10240, 'B')},    // 10KB
-                {"Large", std::string(102400, 'C')}     // 100KB
+                {"Medium", std::string(102400, 'B')},   // 100KB
+                {"Large", std::string(10485760, 'C')}   // 10MB
             };
-            
+            std::vector<unsigned char> key(AESWrapper::DEFAULT_KEYLENGTH);
+            AESWrapper::generateKey(key.data(), key.size());
+            AESWrapper aes(key.data(), key.size());
+
             for (const auto& [sizeName, data] : testData) {
-                AESWrapper aes(reinterpret_cast<const unsigned char*>("0123456789abcdef"), 16);
-                
-                // Encryption benchmark
-                auto encTime = timeFunction([&]() {
-                    std::string encrypted = aes.encrypt(data.c_str(), data.length());
-                }, 3);
-                logResult("AES", "Encrypt_" + sizeName, encTime, std::to_string(data.length()) + " bytes");
-                
-                // Decryption benchmark
+                measure("AES", "CBC_Encrypt_" + sizeName, data.size(), [&aes, &data]() {
+                    return !aes.encrypt(data.c_str(), data.length()).empty();
+                });
                 std::string encrypted = aes.encrypt(data.c_str(), data.length());
-                auto decTime = timeFunction([&]() {
-                    std::string decrypted = aes.decrypt(encrypted.c_str(), encrypted.length());
-                }, 3);
-                logResult("AES", "Decrypt_" + sizeName, decTime, std::to_string(encrypted.length()) + " bytes");
+                measure("AES", "CBC_Decrypt_" + sizeName, encrypted.size(), [&aes, &encrypted, &data]() {
+                    return aes.decrypt(encrypted.c_str(), encrypted.length()).size() == data.size();
+                });
             }
-            
         } catch (const std::exception& e) {
             std::cout << "[FAIL] AES benchmark failed: " << e.what() << std::endl;
         }
@@ -129,37 +280,30 @@ public:
         std::cout << std::string(50, '-') << std::endl;
         
         try {
-            // Mock client ID
+            const int iterations = 100000;
             std::array<uint8_t, 16> clientID;
             std::fill(clientID.begin(), clientID.end(), 0xAB);
-            
-            // Registration request creation
-            auto regTime = timeFunction([&]() {
-                std::vector<uint8_t> header = createRequestHeader(clientID, 1025, 255);
-            }, 100);
-            logResult("Protocol", "Registration_Header", regTime, "100 iterations avg");
-            
-            // Public key request creation
-            auto pubKeyTime = timeFunction([&]() {
-                std::vector<uint8_t> header = createRequestHeader(clientID, 1026, 335);
-            }, 100);
-            logResult("Protocol", "PublicKey_Header", pubKeyTime, "100 iterations avg");
-            
-            // File transfer request creation
-            auto fileTime = timeFunction([&]() {
-                std::vector<uint8_t> header = createRequestHeader(clientID, 1028, 1024);
-            }, 100);
-            logResult("Protocol", "FileTransfer_Header", fileTime, "100 iterations avg");
-            
-            // Header parsing simulation
-            std::vector<uint8_t> testHeader = createRequestHeader(clientID, 1025, 255);
-            auto parseTime = timeFunction([&]() {
-                // Simulate header parsing
-                uint16_t code = *reinterpret_cast<const uint16_t*>(&testHeader[17]);
-                uint32_t size = *reinterpret_cast<const uint32_t*>(&testHeader[19]);
-            }, 1000);
-            logResult("Protocol", "Header_Parsing", parseTime, "1000 iterations avg");
-            
+
+            // Request header encode into a frame buffer, as the client writes every packet header
+            std::vector<uint8_t> frame(REQUEST_HEADER_SIZE);
+            measure("Protocol", "Header_Encode_100k", 0, [&]() {
+                for (int i = 0; i < iterations; i++) {
+                    Framing::encodeRequestHeader(clientID.data(), REQ_SEND_FILE, static_cast<uint32_t>(i), frame.data());
+                }
+                return frame[16] == PROTOCOL_VERSION;
+            });
+
+            // Response header decode
+            const uint8_t response[RESPONSE_HEADER_SIZE] = {PROTOCOL_VERSION, 0x43, 0x06, 0x13, 0x01, 0x00, 0x00};
+            measure("Protocol", "Response_Decode_100k", 0, [&]() {
+                uint16_t code = 0;
+                uint32_t payloadSize = 0;
+                bool ok = true;
+                for (int i = 0; i < iterations; i++) {
+                    ok = Framing::decodeResponseHeader(response, code, payloadSize) && ok;
+                }
+                return ok && code == RESP_FILE_CRC;
+            });
         } catch (const std::exception& e) {
             std::cout << "[FAIL] Protocol benchmark failed: " << e.what() << std::endl;
         }
@@ -200,8 +344,912 @@ public:
             // Cleanup
             std::remove(filename.c_str());
         }
+        
+        benchmarkInputPaths();
+    }
+    
+    // Client input path: ifstream into a heap vector (64KB reads) vs. a read-only mapping,
+    // each followed by the cksum pass that the client runs over the whole file
+    void benchmarkInputPaths() {
+        std::vector<std::pair<std::string, size_t>> fileSizes = {
+            {"1MB", 1048576},
+            {"64MB", 64 * 1048576}
+        };
+        
+        for (const auto& [sizeName, size] : fileSizes) {
+            std::string filename = "benchmark_input_" + sizeName + ".tmp";
+            {
+                std::ofstream file(filename, std::ios::binary);
+                std::string block(1048576, 'Y');
+                for (size_t written = 0; written < size; written += block.size()) {
+                    file.write(block.data(), std::min(block.size(), size - written));
+                }
+            }
+            
+            uint32_t streamCRC = 0;
+            auto streamTime = timeFunction([&]() {
+                std::ifstream file(filename, std::ios::binary);
+                std::vector<uint8_t> data(size);
+                for (size_t done = 0; done < size; ) {
+                    file.read(reinterpret_cast<char*>(data.data() + done), std::min<size_t>(65536, size - done));
+                    done += file.gcount();
+                }
+                streamCRC = calculateCRC(data.data(), data.size());
+            }, 5);
+            logResult("FileIO", "Ifstream_CRC_" + sizeName, streamTime,
+                      std::to_string(size / streamTime / 1000.0) + " MB/s");
+            
+            for (bool populate : {false, true}) {
+                uint32_t mappedCRC = 0;
+                auto mappedTime = timeFunction([&]() {
+                    MappedFile input;
+                    MappedFileOptions options;
+                    options.populate = populate;
+                    std::string error;
+                    if (input.open(filename, options, error)) {
+                        mappedCRC = calculateCRC(input.data(), input.size());
+                        input.releaseBefore(input.size());
+                    }
+                }, 5);
+                logResult("FileIO", std::string(populate ? "Mmap_Populate_CRC_" : "Mmap_CRC_") + sizeName, mappedTime,
+                          std::to_string(size / mappedTime / 1000.0) + " MB/s" +
+                          (mappedCRC == streamCRC ? "" : " (CRC MISMATCH)"));
+            }
+            
+            std::remove(filename.c_str());
+        }
     }
     
+#ifdef CLIENT_HAVE_IO_URING
+    // Stream a file to a sink process over loopback; send() blocks once the socket buffer
+    // fills, so the sender's CPU time (user + system, including io_uring workers) shows
+    // the cost per byte moved. Returns wall milliseconds or -1.
+    double streamToSink(const std::string& filename, size_t size, bool useUring, double& cpuMs, uint64_t& syscalls) {
+        int listener = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t length = sizeof(address);
+        if (listener < 0 || bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+            listen(listener, 1) != 0 || getsockname(listener, reinterpret_cast<sockaddr*>(&address), &length) != 0) {
+            return -1;
+        }
+
+        pid_t sink = fork();
+        if (sink == 0) {
+            int connection = accept(listener, nullptr, nullptr);
+            std::vector<char> buffer(1 << 20);
+            while (read(connection, buffer.data(), buffer.size()) > 0) {
+            }
+            _exit(0);
+        }
+        close(listener);
+
+        int sock = socket(AF_INET, SOCK_STREAM, 0);
+        int fd = open(filename.c_str(), O_RDONLY);
+        if (sock < 0 || fd < 0 || connect(sock, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+            return -1;
+        }
+
+        const size_t chunk = 1 << 20;
+        rusage before, after;
+        getrusage(RUSAGE_SELF, &before);
+        auto start = std::chrono::steady_clock::now();
+        bool ok = true;
+        syscalls = 0;
+
+        if (!useUring) {
+            std::vector<uint8_t> buffer(chunk);
+            for (size_t offset = 0; offset < size && ok; offset += chunk) {
+                ssize_t got = pread(fd, buffer.data(), std::min(chunk, size - offset), offset);
+                syscalls++;
+                ok = got > 0;
+                for (ssize_t sent = 0; ok && sent < got; ) {
+                    ssize_t n = send(sock, buffer.data() + sent, got - sent, MSG_NOSIGNAL);
+                    syscalls++;
+                    ok = n > 0;
+                    sent += n;
+                }
+            }
+        } else {
+            // Same pipeline shape as the client: 4 reads ahead, each buffer sent as soon as it fills
+            const unsigned depth = 4;
+            IoUringEngine engine;
+            std::string error;
+            ok = engine.init(16, depth, chunk, error) && engine.registerFiles({fd, sock}, error);
+            std::vector<size_t> offsets(depth), lengths(depth), done(depth);
+            size_t nextOffset = 0;
+            unsigned active = 0;
+            auto startRead = [&](unsigned slot) {
+                offsets[slot] = nextOffset;
+                lengths[slot] = std::min(chunk, size - nextOffset);
+                done[slot] = 0;
+                nextOffset += lengths[slot];
+                engine.queueRead(0, slot, 0, lengths[slot], offsets[slot], slot);
+                active++;
+            };
+            for (unsigned slot = 0; ok && slot < depth && nextOffset < size; slot++) {
+                startRead(slot);
+            }
+            // Reads complete into slot, the slot is sent, then refilled; tag bit 8 marks sends
+            while (ok && active > 0) {
+                ok = engine.submit(1, error);
+                IoUringCompletion completion;
+                while (ok && engine.nextCompletion(completion)) {
+                    unsigned slot = static_cast<unsigned>(completion.userData & 0xFF);
+                    bool isSend = (completion.userData & 0x100) != 0;
+                    ok = completion.result > 0;
+                    if (!ok) {
+                        break;
+                    }
+                    done[slot] += completion.result;
+                    if (!isSend && done[slot] < lengths[slot]) {
+                        engine.queueRead(0, slot, done[slot], lengths[slot] - done[slot], offsets[slot] + done[slot], slot);
+                    } else if (!isSend) {
+                        done[slot] = 0;
+                        engine.queueSend(1, engine.buffer(slot), lengths[slot], 0x100 | slot);
+                    } else if (done[slot] < lengths[slot]) {
+                        engine.queueSend(1, engine.buffer(slot) + done[slot], lengths[slot] - done[slot], 0x100 | slot);
+                    } else {
+                        active--;
+                        if (nextOffset < size) {
+                            startRead(slot);
+                        }
+                    }
+                }
+            }
+            syscalls = engine.enterCalls();
+        }
+
+        shutdown(sock, SHUT_WR);
+        close(sock);
+        close(fd);
+        waitpid(sink, nullptr, 0);
+        auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        getrusage(RUSAGE_SELF, &after);
+        auto cpu = [](const timeval& t) { return t.tv_sec * 1000.0 + t.tv_usec / 1000.0; };
+        cpuMs = cpu(after.ru_utime) - cpu(before.ru_utime) + cpu(after.ru_stime) - cpu(before.ru_stime);
+        return ok ? elapsed : -1;
+    }
+
+    void benchmarkIoEngines() {
+        std::cout << "\n[NETWORK] FILE -> SOCKET: PREAD + SEND VS IO_URING\n";
+        std::cout << std::string(50, '-') << std::endl;
+
+        const size_t size = 256 * 1048576;
+        std::string filename = "benchmark_stream.tmp";
+        {
+            std::ofstream file(filename, std::ios::binary);
+            std::string block(1048576, 'Z');
+            for (size_t written = 0; written < size; written += block.size()) {
+                file.write(block.data(), block.size());
+            }
+        }
+
+        for (bool useUring : {false, true}) {
+            for (int run = 0; run < 3; run++) {
+                double cpuMs = 0;
+                uint64_t syscalls = 0;
+                double elapsed = streamToSink(filename, size, useUring, cpuMs, syscalls);
+                std::string name = useUring ? "IoUring_256MB" : "Pread_Send_256MB";
+                if (elapsed < 0) {
+                    logResult("IoEngine", name, -1, useUring ? "io_uring unavailable" : "failed");
+                    break;
+                }
+                logResult("IoEngine", name, elapsed,
+                          std::to_string(static_cast<int>(size / elapsed / 1000.0)) + " MB/s, CPU " +
+                          std::to_string(static_cast<int>(cpuMs)) + " ms, " + std::to_string(syscalls) + " syscalls");
+            }
+        }
+        std::remove(filename.c_str());
+    }
+#endif
+    
+#ifdef __linux__
+    // GCM packetization of a 90%-sparse 256MB image (1MB of data every 10MB): every packet
+    // read and encrypted vs. holes skipped via SEEK_DATA/SEEK_HOLE, remaining packets scanned
+    // for zeros, and only data packets encrypted (zero packets cost a 4-byte run record)
+    void benchmarkSparseInput() {
+        std::cout << "\n[FILE] SPARSE IMAGE: FULL VS HOLE-AWARE PACKETIZATION\n";
+        std::cout << std::string(50, '-') << std::endl;
+
+        const size_t size = 256 * 1048576;
+        const size_t chunk = 1048576 - 28;   // GCM plaintext per 1MB packet
+        std::string filename = "benchmark_sparse.tmp";
+        {
+            int fd = open(filename.c_str(), O_CREAT | O_TRUNC | O_WRONLY, 0644);
+            std::vector<char> data(1048576, 'S');
+            bool ok = fd >= 0 && ftruncate(fd, size) == 0;
+            for (size_t offset = 0; ok && offset < size; offset += 10 * 1048576) {
+                ok = pwrite(fd, data.data(), data.size(), offset) == static_cast<ssize_t>(data.size());
+            }
+            if (fd >= 0) {
+                close(fd);
+            }
+        }
+
+        std::vector<unsigned char> key(32, 0x42);
+        AESWrapper aes(key.data(), key.size());
+        unsigned char nonce[12] = {0};
+        unsigned char aad[8 + 255] = {0};
+        std::vector<unsigned char> out(chunk + 16);
+
+        double fullTime = 0;
+        for (bool sparse : {false, true}) {
+            size_t encrypted = 0;
+            auto elapsed = timeFunction([&]() {
+                MappedFile input;
+                MappedFileOptions options;
+                std::string error;
+                if (!input.open(filename, options, error)) {
+                    return;
+                }
+                HoleMap holes;
+                if (sparse) {
+                    holes.load(filename, size);
+                }
+                encrypted = 0;
+                for (size_t offset = 0; offset < size; offset += chunk) {
+                    size_t length = std::min(chunk, size - offset);
+                    const char* plain = reinterpret_cast<const char*>(input.data() + offset);
+                    if (sparse && (holes.isHole(offset, length) || isAllZero(input.data() + offset, length))) {
+                        uint32_t run = static_cast<uint32_t>(length);
+                        aes.encryptGCM(nonce, aad, sizeof(aad), reinterpret_cast<const char*>(&run), 4, out.data());
+                    } else {
+                        aes.encryptGCM(nonce, aad, sizeof(aad), plain, length, out.data());
+                        encrypted += length;
+                    }
+                    input.releaseBefore(offset + length);
+                }
+            }, 3);
+            if (!sparse) {
+                fullTime = elapsed;
+            }
+            logResult("Sparse", sparse ? "HoleAware_256MB_90pct" : "Full_256MB_90pct", elapsed,
+                      std::to_string(static_cast<int>(size / elapsed / 1000.0)) + " MB/s, encrypted " +
+                      std::to_string(encrypted / 1048576) + " MB" +
+                      (sparse && elapsed > 0 ? ", " + std::to_string(fullTime / elapsed).substr(0, 4) + "x" : ""));
+        }
+        std::remove(filename.c_str());
+    }
+
+    // Bytes of path currently in the page cache (mincore over a mapping that touches nothing)
+    static size_t residentBytes(const std::string& path) {
+        int fd = open(path.c_str(), O_RDONLY);
+        off_t size = fd < 0 ? 0 : lseek(fd, 0, SEEK_END);
+        void* mapping = size > 0 ? mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+        size_t resident = 0;
+        if (mapping != MAP_FAILED) {
+            size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+            std::vector<unsigned char> pages((size + page - 1) / page);
+            if (mincore(mapping, size, pages.data()) == 0) {
+                for (unsigned char p : pages) {
+                    resident += (p & 1) ? page : 0;
+                }
+            }
+            munmap(mapping, size);
+        }
+        if (fd >= 0) {
+            close(fd);
+        }
+        return resident;
+    }
+
+    // A background backup next to a latency-sensitive service: a workload thread does random
+    // 4KB reads of a warm "hot" file while a cold 256MB file is read start to end in each
+    // client read mode. Reports backup throughput, the backup's page cache footprint
+    // afterwards, how much of the hot file is still cached and the workload's read rate.
+    // Run inside a memory-limited cgroup to see the cached mode evict the hot file.
+    void benchmarkPageCacheModes() {
+        std::cout << "\n[FILE] BACKUP READ MODES VS CO-LOCATED WORKLOAD\n";
+        std::cout << std::string(50, '-') << std::endl;
+
+        const size_t backupSize = 256 * 1048576;
+        const size_t hotSize = 64 * 1048576;
+        const size_t chunk = 1048576;
+        std::string backupName = "benchmark_backup.tmp";
+        std::string hotName = "benchmark_hot.tmp";
+        for (const auto& file : {std::make_pair(backupName, backupSize), std::make_pair(hotName, hotSize)}) {
+            std::ofstream out(file.first, std::ios::binary);
+            std::string block(chunk, 'H');
+            for (size_t written = 0; written < file.second; written += block.size()) {
+                out.write(block.data(), block.size());
+            }
+        }
+
+        for (InputCacheMode mode : {InputCacheMode::Cached, InputCacheMode::DropBehind, InputCacheMode::Direct}) {
+            // Cold backup file, warm hot file
+            int backupFd = open(backupName.c_str(), O_RDONLY);
+            fdatasync(backupFd);
+            posix_fadvise(backupFd, 0, 0, POSIX_FADV_DONTNEED);
+            close(backupFd);
+            int hotFd = open(hotName.c_str(), O_RDONLY);
+            std::vector<char> warm(chunk);
+            for (size_t offset = 0; offset < hotSize; offset += chunk) {
+                ssize_t got = pread(hotFd, warm.data(), chunk, offset);
+                (void)got;
+            }
+
+            std::atomic<bool> stop(false);
+            uint64_t workloadOps = 0;
+            double worstMs = 0;
+            std::thread workload([&]() {
+                std::mt19937_64 random(42);
+                char page[4096];
+                while (!stop.load(std::memory_order_relaxed)) {
+                    off_t offset = static_cast<off_t>(random() % (hotSize / sizeof(page))) * sizeof(page);
+                    auto start = std::chrono::steady_clock::now();
+                    ssize_t got = pread(hotFd, page, sizeof(page), offset);
+                    (void)got;
+                    worstMs = std::max(worstMs, std::chrono::duration<double, std::milli>(
+                                                    std::chrono::steady_clock::now() - start).count());
+                    workloadOps++;
+                }
+            });
+
+            uint32_t crc = 0;
+            size_t consumed = 0;
+            auto start = std::chrono::steady_clock::now();
+            if (mode == InputCacheMode::Direct) {
+                int fd = open(backupName.c_str(), O_RDONLY | O_DIRECT);
+                void* aligned = nullptr;
+                if (fd >= 0 && posix_memalign(&aligned, 4096, chunk) == 0) {
+                    for (size_t offset = 0; offset < backupSize; offset += chunk) {
+                        ssize_t got = pread(fd, aligned, chunk, offset);
+                        if (got <= 0) {
+                            break;
+                        }
+                        crc += calculateCRC(static_cast<const uint8_t*>(aligned), got);
+                        consumed += got;
+                    }
+                }
+                free(aligned);
+                if (fd >= 0) {
+                    close(fd);
+                }
+            } else {
+                MappedFile input;
+                MappedFileOptions options;
+                options.dropBehind = mode == InputCacheMode::DropBehind;
+                std::string error;
+                if (input.open(backupName, options, error)) {
+                    for (size_t offset = 0; offset < input.size(); offset += chunk) {
+                        crc += calculateCRC(input.data() + offset, std::min(chunk, input.size() - offset));
+                        consumed += std::min(chunk, input.size() - offset);
+                        input.releaseBefore(offset + chunk);
+                    }
+                }
+            }
+            double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            (void)crc;
+            stop = true;
+            workload.join();
+            close(hotFd);
+
+            const char* name = mode == InputCacheMode::Cached ? "Backup_Cached_256MB"
+                             : mode == InputCacheMode::DropBehind ? "Backup_DropBehind_256MB" : "Backup_Direct_256MB";
+            logResult("PageCache", name, elapsed,
+                      std::to_string(static_cast<int>(backupSize / elapsed / 1000.0)) + " MB/s, backup cached " +
+                      std::to_string(residentBytes(backupName) / 1048576) + " MB, hot cached " +
+                      std::to_string(residentBytes(hotName) / 1048576) + "/" + std::to_string(hotSize / 1048576) +
+                      " MB, workload " + std::to_string(static_cast<int>(workloadOps / (elapsed / 1000.0))) +
+                      " reads/s (worst " + std::to_string(worstMs).substr(0, 5) + " ms)" + (consumed == backupSize ? "" : " (SHORT READ)"));
+        }
+        std::remove(backupName.c_str());
+        std::remove(hotName.c_str());
+    }
+
+    // Stream size bytes of 1MB frames through loopback to a sink that consumes them as if
+    // they crossed a link of the given bandwidth and round trip. Loopback acknowledges
+    // instantly, so the sink enforces what a real path would: a byte read counts as in
+    // flight for one RTT, and no more than the sender's send buffer may be in flight (TCP
+    // keeps every unacknowledged byte there; about half of SO_SNDBUF holds payload). The
+    // sink's own receive buffer is kept small so the backlog stays in the sender's queue.
+    // tuning == nullptr is the untuned socket (TCP_NODELAY only). drainMs is the time from
+    // the last write returning to the last byte arriving: data the client had already
+    // handed off but was still stuck in its own queue.
+    double streamOverEmulatedLink(double bitsPerSecond, double roundTripMs, const SocketTuningOptions* tuning,
+                                  size_t size, double& drainMs, int& sendBuffer) {
+        using boost::asio::ip::tcp;
+        boost::asio::io_context ioContext;
+        tcp::acceptor acceptor(ioContext);
+        tcp::endpoint loopback(boost::asio::ip::address_v4::loopback(), 0);
+        acceptor.open(loopback.protocol());
+        acceptor.set_option(boost::asio::socket_base::receive_buffer_size(64 * 1024));
+        acceptor.bind(loopback);
+        acceptor.listen();
+
+        tcp::socket sender(ioContext), sink(ioContext);
+        sender.connect(acceptor.local_endpoint());
+        acceptor.accept(sink);
+        sender.set_option(tcp::no_delay(true));
+        bool cork = false;
+        if (tuning) {
+            SocketTuningResult tuned = SocketTuning::apply(sender, *tuning);
+            cork = tuning->cork && tuned.corkSupported;
+        }
+
+        using Clock = std::chrono::steady_clock;
+        Clock::time_point lastWrite, lastByte;
+        std::thread receiver([&]() {
+            const int senderFd = sender.native_handle();
+            const auto roundTrip = std::chrono::microseconds(static_cast<long long>(roundTripMs * 1000));
+            const double bytesPerSecond = bitsPerSecond / 8;
+            std::vector<char> buffer(256 * 1024);
+            std::deque<std::pair<Clock::time_point, size_t>> unacked;
+            size_t inFlight = 0, consumed = 0;
+            auto start = Clock::now();
+            while (consumed < size) {
+                auto now = Clock::now();
+                while (!unacked.empty() && unacked.front().first <= now) {
+                    inFlight -= unacked.front().second;
+                    unacked.pop_front();
+                }
+                int sendBufferBytes = 0;
+                socklen_t length = sizeof(sendBufferBytes);
+                getsockopt(senderFd, SOL_SOCKET, SO_SNDBUF, &sendBufferBytes, &length);
+                double window = sendBufferBytes / 2.0 - static_cast<double>(inFlight);
+                double rate = bytesPerSecond * std::chrono::duration<double>(now - start).count() + 64 * 1024 -
+                              static_cast<double>(consumed);
+                size_t allowance = static_cast<size_t>(std::max(0.0, std::min({window, rate, double(buffer.size())})));
+                if (allowance < 1448) {
+                    std::this_thread::sleep_for(std::chrono::microseconds(50));
+                    continue;
+                }
+                ssize_t got = recv(sink.native_handle(), buffer.data(), allowance, 0);
+                if (got <= 0) {
+                    break;
+                }
+                unacked.emplace_back(now + roundTrip, static_cast<size_t>(got));
+                inFlight += got;
+                consumed += got;
+            }
+            lastByte = Clock::now();
+        });
+
+        std::vector<uint8_t> header(23 + 267, 0x11), payload(1048576, 0x5A);
+        auto start = Clock::now();
+        boost::system::error_code ec;
+        if (cork) {
+            SocketTuning::setCork(sender, true);
+        }
+        // One gathered write per frame, as the client sends its packets
+        for (size_t sent = 0; sent < size && !ec; ) {
+            size_t headerBytes = std::min(header.size(), size - sent);
+            size_t payloadBytes = std::min(payload.size(), size - sent - headerBytes);
+            std::vector<boost::asio::const_buffer> frame{boost::asio::buffer(header.data(), headerBytes),
+                                                         boost::asio::buffer(payload.data(), payloadBytes)};
+            sent += boost::asio::write(sender, frame, ec);
+        }
+        lastWrite = Clock::now();
+        if (cork) {
+            SocketTuning::setCork(sender, false);
+        }
+        receiver.join();
+
+        boost::asio::socket_base::send_buffer_size effective;
+        sender.get_option(effective, ec);
+        sendBuffer = effective.value();
+        drainMs = std::chrono::duration<double, std::milli>(lastByte - lastWrite).count();
+        return std::chrono::duration<double, std::milli>(lastByte - start).count();
+    }
+
+    // Untuned vs LAN vs WAN socket profiles over an emulated LAN (1 Gbit/s, 1ms) and WAN
+    // (400 Mbit/s, 80ms) link. The WAN link's BDP (4MB) is above what the untuned socket's
+    // autotuned buffer keeps in flight on a default Linux (tcp_wmem max 4MB, half payload).
+    void benchmarkSocketProfiles() {
+        std::cout << "\n[NETWORK] SOCKET PROFILES OVER AN EMULATED LINK\n";
+        std::cout << std::string(50, '-') << std::endl;
+
+        const size_t size = 64 * 1048576;
+        struct Link { const char* name; double bitsPerSecond; double roundTripMs; };
+        const Link links[] = {{"LAN", 1e9, 1}, {"WAN", 4e8, 80}};
+        SocketTuningOptions lan = profileOptions(NetworkProfile::LAN);
+        SocketTuningOptions wan = profileOptions(NetworkProfile::WAN);
+        struct Profile { const char* name; const SocketTuningOptions* options; };
+        const Profile profiles[] = {{"Untuned", nullptr}, {"LanProfile", &lan}, {"WanProfile", &wan}};
+
+        for (const Link& link : links) {
+            for (const Profile& profile : profiles) {
+                for (int run = 0; run < 2; run++) {
+                    double drainMs = 0;
+                    int sendBuffer = 0;
+                    std::string name = std::string(link.name) + "Link_" + profile.name;
+                    try {
+                        double elapsed = streamOverEmulatedLink(link.bitsPerSecond, link.roundTripMs, profile.options,
+                                                                size, drainMs, sendBuffer);
+                        logResult("Socket", name, elapsed,
+                                  std::to_string(static_cast<int>(size / elapsed / 1000.0)) + " MB/s, drain " +
+                                  std::to_string(static_cast<int>(drainMs)) + " ms, SO_SNDBUF " +
+                                  std::to_string(sendBuffer / 1024) + " KB");
+                    } catch (const std::exception& e) {
+                        logResult("Socket", name, -1, e.what());
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    // Send size bytes as 1MB pool frames to a sink and measure the sender's CPU (user +
+    // system): copying write() vs MSG_ZEROCOPY with completions reclaimed from the error
+    // queue. The loopback sink is a separate process, so only the sender is counted. Loopback
+    // delivery copies zero-copy pages anyway (every completion comes back flagged "copied"),
+    // so locally this shows the bookkeeping cost; set ZEROCOPY_SINK=host:port to stream to a
+    // sink on another machine (e.g. `nc -l 9000 > /dev/null`) and see the saving.
+    double streamFrames(size_t size, bool useZeroCopy, double& cpuMs, uint64_t& completions, uint64_t& copied) {
+        using boost::asio::ip::tcp;
+        const size_t frameSize = 1048576;
+        boost::asio::io_context ioContext;
+        tcp::socket sender(ioContext);
+        pid_t sink = -1;
+        const char* remote = std::getenv("ZEROCOPY_SINK");
+        if (remote && std::strchr(remote, ':')) {
+            std::string target(remote);
+            size_t colon = target.rfind(':');
+            tcp::resolver resolver(ioContext);
+            boost::asio::connect(sender, resolver.resolve(target.substr(0, colon), target.substr(colon + 1)));
+        } else {
+            tcp::acceptor acceptor(ioContext, tcp::endpoint(boost::asio::ip::address_v4::loopback(), 0));
+            sink = fork();
+            if (sink == 0) {
+                int connection = accept(acceptor.native_handle(), nullptr, nullptr);
+                std::vector<char> buffer(frameSize);
+                while (read(connection, buffer.data(), buffer.size()) > 0) {
+                }
+                _exit(0);
+            }
+            sender.connect(acceptor.local_endpoint());
+        }
+
+        BufferPool pool;
+        ZeroCopySender zeroCopy;
+        std::string error;
+        if (!pool.init(16, frameSize, true, error) || (useZeroCopy && !zeroCopy.enable(sender, error))) {
+            sender.close();
+            if (sink > 0) {
+                waitpid(sink, nullptr, 0);
+            }
+            return -1;
+        }
+
+        rusage before, after;
+        getrusage(RUSAGE_SELF, &before);
+        auto start = std::chrono::steady_clock::now();
+        boost::system::error_code ec;
+        for (size_t sent = 0; sent < size && !ec; sent += frameSize) {
+            if (useZeroCopy && zeroCopy.pending() > 0 && pool.available() == 0) {
+                ec = zeroCopy.reclaim(ioContext, sender, std::chrono::milliseconds(10000));
+            }
+            BufferPool::Lease frame = pool.acquire(frameSize);
+            frame.data()[0] = static_cast<uint8_t>(sent >> 20);
+            if (useZeroCopy) {
+                ec = zeroCopy.send(ioContext, sender, std::move(frame), frameSize, std::chrono::milliseconds(10000));
+            } else {
+                boost::asio::write(sender, boost::asio::buffer(frame.data(), frameSize), ec);
+            }
+        }
+        while (!ec && zeroCopy.pending() > 0) {
+            ec = zeroCopy.reclaim(ioContext, sender, std::chrono::milliseconds(10000));
+        }
+        auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        getrusage(RUSAGE_SELF, &after);
+        completions = zeroCopy.completedSends();
+        copied = zeroCopy.copiedSends();
+
+        boost::system::error_code ignored;
+        sender.shutdown(tcp::socket::shutdown_send, ignored);
+        sender.close(ignored);
+        if (sink > 0) {
+            waitpid(sink, nullptr, 0);
+        }
+        auto cpu = [](const timeval& t) { return t.tv_sec * 1000.0 + t.tv_usec / 1000.0; };
+        cpuMs = cpu(after.ru_utime) - cpu(before.ru_utime) + cpu(after.ru_stime) - cpu(before.ru_stime);
+        return ec ? -1 : elapsed;
+    }
+
+    void benchmarkZeroCopySend() {
+        std::cout << "\n[NETWORK] 1MB FRAMES: COPYING SEND VS MSG_ZEROCOPY\n";
+        std::cout << std::string(50, '-') << std::endl;
+
+        const size_t size = 1024 * 1048576;
+        for (bool useZeroCopy : {false, true}) {
+            for (int run = 0; run < 3; run++) {
+                double cpuMs = 0;
+                uint64_t completions = 0, copied = 0;
+                std::string name = useZeroCopy ? "ZeroCopy_Send_1GB" : "Copy_Send_1GB";
+                double elapsed = streamFrames(size, useZeroCopy, cpuMs, completions, copied);
+                if (elapsed < 0) {
+                    logResult("ZeroCopy", name, -1, useZeroCopy ? "MSG_ZEROCOPY unavailable" : "failed");
+                    break;
+                }
+                logResult("ZeroCopy", name, elapsed,
+                          std::to_string(static_cast<int>(size / elapsed / 1000.0)) + " MB/s, CPU " +
+                          std::to_string(static_cast<int>(cpuMs * 1073741824.0 / size)) + " ms/GB" +
+                          (useZeroCopy ? ", " + std::to_string(copied) + "/" + std::to_string(completions) +
+                                         " completions copied" : ""));
+            }
+        }
+    }
+    // Request/response ping-pong and 1MB-frame bulk transfer over one transport pair; the
+    // server end runs on its own thread and answers like the backup server does (small
+    // header + payload in, short response out). Returns false if any exchange failed.
+    bool exchangeOverTransport(Transport& client, Transport& server, int roundTrips, int frames,
+                               double& pingMs, double& bulkMs) {
+        const std::chrono::milliseconds timeout(10000);
+        const size_t requestSize = 64, responseSize = 16, frameSize = 1048576;
+        std::atomic<bool> ok(true);
+        std::thread peer([&]() {
+            std::vector<uint8_t> request(std::max(requestSize, frameSize)), response(responseSize, 0x5A);
+            for (int i = 0; i < roundTrips && ok; i++) {
+                if (server.read(boost::asio::buffer(request.data(), requestSize), timeout) ||
+                    server.write({boost::asio::buffer(response)}, timeout)) {
+                    ok = false;
+                }
+            }
+            for (int i = 0; i < frames && ok; i++) {
+                if (server.read(boost::asio::buffer(request.data(), frameSize), timeout)) {
+                    ok = false;
+                }
+            }
+            if (ok && server.write({boost::asio::buffer(response)}, timeout)) {
+                ok = false;
+            }
+        });
+
+        std::vector<uint8_t> request(requestSize, 0xA5), response(responseSize), frame(frameSize, 0x3C);
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < roundTrips && ok; i++) {
+            if (client.write({boost::asio::buffer(request)}, timeout) ||
+                client.read(boost::asio::buffer(response), timeout)) {
+                ok = false;
+            }
+        }
+        auto middle = std::chrono::steady_clock::now();
+        for (int i = 0; i < frames && ok; i++) {
+            if (client.write({boost::asio::buffer(frame)}, timeout)) {
+                ok = false;
+            }
+        }
+        if (ok && client.read(boost::asio::buffer(response), timeout)) {
+            ok = false;
+        }
+        auto end = std::chrono::steady_clock::now();
+        if (!ok) {
+            client.close();   // Unblocks the peer
+        }
+        peer.join();
+        pingMs = std::chrono::duration<double, std::milli>(middle - start).count();
+        bulkMs = std::chrono::duration<double, std::milli>(end - middle).count();
+        return ok;
+    }
+
+    void benchmarkTransports() {
+        std::cout << "\n[NETWORK] TRANSPORTS: TCP LOOPBACK VS UNIX SOCKET VS MEMORY PIPE\n";
+        std::cout << std::string(50, '-') << std::endl;
+
+        const int roundTrips = 20000, frames = 512;
+        auto report = [this, roundTrips, frames](const std::string& name, bool ok, double pingMs, double bulkMs) {
+            if (!ok) {
+                logResult("Transport", name, -1, "exchange failed");
+                return;
+            }
+            logResult("Transport", name + "_PingPong", pingMs,
+                      std::to_string(static_cast<int>(pingMs * 1000.0 / roundTrips)) + " us/round trip");
+            logResult("Transport", name + "_Bulk_512MB", bulkMs,
+                      std::to_string(static_cast<int>(frames / bulkMs * 1000.0)) + " MB/s");
+        };
+
+        using boost::asio::ip::tcp;
+        double pingMs = 0, bulkMs = 0;
+        {
+            boost::asio::io_context clientContext, serverContext;
+            tcp::acceptor acceptor(serverContext, tcp::endpoint(boost::asio::ip::address_v4::loopback(), 0));
+            std::unique_ptr<tcp::socket> clientSocket(new tcp::socket(clientContext));
+            std::unique_ptr<tcp::socket> serverSocket(new tcp::socket(serverContext));
+            clientSocket->connect(acceptor.local_endpoint());
+            acceptor.accept(*serverSocket);
+            clientSocket->set_option(tcp::no_delay(true));
+            serverSocket->set_option(tcp::no_delay(true));
+            TcpTransport client(clientContext, std::move(clientSocket));
+            TcpTransport server(serverContext, std::move(serverSocket));
+            bool ok = exchangeOverTransport(client, server, roundTrips, frames, pingMs, bulkMs);
+            report("TCP_Loopback", ok, pingMs, bulkMs);
+        }
+        {
+            std::string path = "benchmark_transport_" + std::to_string(getpid()) + ".sock";
+            unlink(path.c_str());
+            boost::asio::io_context clientContext, serverContext;
+            boost::asio::local::stream_protocol::acceptor acceptor(serverContext,
+                                                                   boost::asio::local::stream_protocol::endpoint(path));
+            UnixTransport client(clientContext), server(serverContext);
+            bool ok = !client.connect(path, std::chrono::milliseconds(1000));
+            if (ok) {
+                acceptor.accept(server.socket());
+                ok = exchangeOverTransport(client, server, roundTrips, frames, pingMs, bulkMs);
+            }
+            unlink(path.c_str());
+            report("Unix_Socket", ok, pingMs, bulkMs);
+        }
+        {
+            auto pipe = MemoryTransport::createPair();
+            bool ok = exchangeOverTransport(*pipe.first, *pipe.second, roundTrips, frames, pingMs, bulkMs);
+            report("Memory_Pipe", ok, pingMs, bulkMs);
+        }
+    }
+#endif
+
+    // Frame the whole input as GCM packets and send them over transport to the server, then
+    // wait for its file response; returns false if the exchange failed
+    static bool transferFramed(Transport& transport, BufferPool& pool, const AESWrapper& aes, const uint8_t* clientId,
+                               const uint8_t* data, uint64_t size) {
+        const std::chrono::milliseconds timeout(60000);
+        const uint16_t totalPackets = static_cast<uint16_t>((size + GCM_CHUNK - 1) / GCM_CHUNK);
+        for (uint16_t packet = 1; packet <= totalPackets; packet++) {
+            uint64_t offset = static_cast<uint64_t>(packet - 1) * GCM_CHUNK;
+            size_t length = static_cast<size_t>(std::min<uint64_t>(GCM_CHUNK, size - offset));
+            BufferPool::Lease frame = pool.acquire(REQUEST_HEADER_SIZE + FILE_PACKET_HEADER_SIZE + PACKET_BYTES);
+            PerfScope encrypt("Loopback::encrypt");
+            size_t frameSize = Framing::buildGCMFrame(aes, clientId, 0, "benchmark.bin", packet, totalPackets,
+                                                      static_cast<uint32_t>(size), data + offset, length, frame.data());
+            encrypt.end();
+            PerfScope send("Loopback::send");
+            if (transport.write({boost::asio::buffer(frame.data(), frameSize)}, timeout)) {
+                return false;
+            }
+        }
+        PerfScope response("Loopback::response");
+        uint8_t header[RESPONSE_HEADER_SIZE];
+        uint16_t code = 0;
+        uint32_t payloadSize = 0;
+        if (transport.read(boost::asio::buffer(header), timeout) || !Framing::decodeResponseHeader(header, code, payloadSize)) {
+            return false;
+        }
+        std::vector<uint8_t> payload(payloadSize);
+        return code == RESP_FILE_CRC && !transport.read(boost::asio::buffer(payload), timeout);
+    }
+
+    // Register and exchange keys (1025, 1026) so the server accepts file packets from clientId
+    static bool registerWithServer(Transport& transport, uint8_t* clientId) {
+        const std::chrono::milliseconds timeout(10000);
+        RSAPrivateWrapper rsa;
+        std::string publicKey = rsa.getPublicKey();
+        publicKey.resize(MockBackupServer::PUBLIC_KEY_SIZE, '\0');
+        std::vector<uint8_t> payload(255 + publicKey.size(), 0);
+        std::memcpy(payload.data(), "benchmark", 9);
+        std::memcpy(payload.data() + 255, publicKey.data(), publicKey.size());
+
+        std::memset(clientId, 0, 16);
+        const uint16_t codes[2] = {REQ_REGISTER, REQ_SEND_PUBLIC_KEY};
+        const size_t sizes[2] = {255, payload.size()};
+        for (int step = 0; step < 2; step++) {
+            uint8_t header[REQUEST_HEADER_SIZE];
+            Framing::encodeRequestHeader(clientId, codes[step], static_cast<uint32_t>(sizes[step]), header);
+            uint8_t responseHeader[RESPONSE_HEADER_SIZE];
+            uint16_t code = 0;
+            uint32_t responseSize = 0;
+            if (transport.write({boost::asio::buffer(header), boost::asio::buffer(payload.data(), sizes[step])}, timeout) ||
+                transport.read(boost::asio::buffer(responseHeader), timeout) ||
+                !Framing::decodeResponseHeader(responseHeader, code, responseSize) || responseSize < 16) {
+                return false;
+            }
+            std::vector<uint8_t> response(responseSize);
+            if (transport.read(boost::asio::buffer(response), timeout) || code != (step == 0 ? RESP_REGISTER_OK : RESP_PUBKEY_AES_SENT)) {
+                return false;
+            }
+            std::memcpy(clientId, response.data(), 16);
+        }
+        return true;
+    }
+
+    // Sweep input: size bytes of pseudo-random data (incompressible, no zero pages)
+    static bool writeSweepInput(const std::string& filename, uint64_t size) {
+        std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+        std::vector<uint64_t> block(1048576 / sizeof(uint64_t));
+        uint64_t state = 0x9E3779B97F4A7C15ull;
+        for (uint64_t written = 0; out && written < size; ) {
+            for (uint64_t& word : block) {
+                state ^= state << 13;
+                state ^= state >> 7;
+                state ^= state << 17;
+                word = state;
+            }
+            size_t chunk = static_cast<size_t>(std::min<uint64_t>(block.size() * sizeof(uint64_t), size - written));
+            out.write(reinterpret_cast<const char*>(block.data()), chunk);
+            written += chunk;
+        }
+        return static_cast<bool>(out);
+    }
+
+    // Each stage of a GCM backup over inputs from 4KB to options.maxSize in steps of 4x:
+    // CRC (the CBC path's cksum), AES-256-GCM of every packet, packetization into protocol
+    // frames (pool buffer + headers + GCM), and the full framed transfer to the mock server over
+    // TCP loopback. Input is a file of random data read through the client's mapping, warm
+    // in the page cache after the first run, so the stages measure CPU and memory, not disk.
+    void benchmarkSizeSweep() {
+        std::cout << "\n[SWEEP] CRC / AES-GCM / PACKETIZATION / LOOPBACK TRANSFER, 4KB - "
+                  << sizeLabel(options.maxSize) << "\n";
+        std::cout << std::string(50, '-') << std::endl;
+
+        std::vector<unsigned char> key(AESWrapper::DEFAULT_KEYLENGTH);
+        AESWrapper::generateKey(key.data(), key.size());
+        AESWrapper aes(key.data(), key.size());
+        BufferPool pool;
+        std::string error;
+        if (!pool.init(4, REQUEST_HEADER_SIZE + FILE_PACKET_HEADER_SIZE + PACKET_BYTES, true, error)) {
+            std::cout << "[FAIL] Packet pool: " << error << std::endl;
+            return;
+        }
+
+        // One loopback connection for the whole sweep, to the mock server without decryption
+        // so that only the client side is measured
+        using boost::asio::ip::tcp;
+        MockBackupServer server(MockVerification::Discard);
+        if (!server.start(error)) {
+            std::cout << "[FAIL] Mock server: " << error << std::endl;
+            return;
+        }
+        boost::asio::io_context senderContext;
+        std::unique_ptr<tcp::socket> senderSocket(new tcp::socket(senderContext));
+        senderSocket->connect(tcp::endpoint(boost::asio::ip::address_v4::loopback(), server.port()));
+        senderSocket->set_option(tcp::no_delay(true));
+        TcpTransport sender(senderContext, std::move(senderSocket));
+        uint8_t clientId[16];
+        if (!registerWithServer(sender, clientId)) {
+            std::cout << "[FAIL] Registration with the mock server" << std::endl;
+            return;
+        }
+
+        const std::string filename = "benchmark_sweep.tmp";
+        const uint64_t largest = std::min<uint64_t>(options.maxSize, 4ull << 30);
+        for (uint64_t size = 4096; size <= largest; size *= 4) {
+            const std::string label = sizeLabel(size);
+            MappedFile input;
+            MappedFileOptions mapping;
+            if (!writeSweepInput(filename, size) || !input.open(filename, mapping, error)) {
+                logResult("Sweep", "Input_" + label, -1, "cannot create input: " + error);
+                break;
+            }
+            const uint8_t* data = input.data();
+            uint32_t crc = 0;
+            std::vector<uint8_t> out(PACKET_BYTES);
+
+            measure("CRC", label, size, [&]() {
+                crc = calculateCRC(data, static_cast<size_t>(size));
+                return true;
+            });
+            measure("AES_GCM", label, size, [&]() {
+                uint8_t nonce[AESWrapper::GCM_NONCE_SIZE] = {0};
+                uint8_t aad[Framing::GCM_AAD_SIZE] = {0};
+                for (uint64_t offset = 0; offset < size; offset += GCM_CHUNK) {
+                    size_t length = static_cast<size_t>(std::min<uint64_t>(GCM_CHUNK, size - offset));
+                    writeLE(nonce + 4, static_cast<uint32_t>(offset / GCM_CHUNK + 1), 2);
+                    aes.encryptGCM(nonce, aad, sizeof(aad), reinterpret_cast<const char*>(data + offset), length, out.data());
+                }
+                return true;
+            });
+            measure("Packetize", label, size, [&]() {
+                const uint16_t totalPackets = static_cast<uint16_t>((size + GCM_CHUNK - 1) / GCM_CHUNK);
+                for (uint16_t packet = 1; packet <= totalPackets; packet++) {
+                    uint64_t offset = static_cast<uint64_t>(packet - 1) * GCM_CHUNK;
+                    size_t length = static_cast<size_t>(std::min<uint64_t>(GCM_CHUNK, size - offset));
+                    BufferPool::Lease frame = pool.acquire(REQUEST_HEADER_SIZE + FILE_PACKET_HEADER_SIZE + PACKET_BYTES);
+                    Framing::buildGCMFrame(aes, clientId, 0, "benchmark.bin", packet, totalPackets,
+                                           static_cast<uint32_t>(size), data + offset, length, frame.data());
+                }
+                return pool.heapAllocations() == 0;
+            });
+            measure("Loopback", label, size, [&]() {
+                return transferFramed(sender, pool, aes, clientId, data, size);
+            }, "TCP to mock server, framed GCM packets + file response");
+            (void)crc;
+            input.close();
+            std::remove(filename.c_str());
+        }
+        sender.close();
+        server.stop();
+    }
+
     void benchmarkMemoryOperations() {
         std::cout << "\n[SAVE] MEMORY OPERATIONS BENCHMARK\n";
         std::cout << std::string(50, '-') << std::endl;
@@ -233,11 +1281,37 @@ public:
     void runAllBenchmarks() {
         std::cout << "🔬 CLIENT-SIDE PERFORMANCE BENCHMARK SUITE\n";
         std::cout << std::string(70, '=') << std::endl;
-        
+        std::cout << "Warmup " << options.warmup << ", repetitions " << options.repetitions
+                  << ", sweep up to " << sizeLabel(options.maxSize) << std::endl;
+        if (PerfProfiler::enabled()) {
+            std::cout << "Counting per test:";
+            for (int i = 0; i < static_cast<int>(PerfEvent::Count); i++) {
+                if (PerfProfiler::available(static_cast<PerfEvent>(i))) {
+                    std::cout << " " << PerfCounterGroup::eventName(static_cast<PerfEvent>(i));
+                }
+            }
+            std::cout << (PerfProfiler::includesKernel() ? " (user and kernel)" : " (user only)") << std::endl;
+        }
+
+        benchmarkSizeSweep();
+        if (options.sweepOnly) {
+            printSummary();
+            return;
+        }
         benchmarkRSAOperations();
         benchmarkAESOperations();
         benchmarkProtocolOperations();
         benchmarkFileOperations();
+#ifdef CLIENT_HAVE_IO_URING
+        benchmarkIoEngines();
+#endif
+#ifdef __linux__
+        benchmarkSparseInput();
+        benchmarkPageCacheModes();
+        benchmarkSocketProfiles();
+        benchmarkZeroCopySend();
+        benchmarkTransports();
+#endif
         benchmarkMemoryOperations();
         
         printSummary();
@@ -248,27 +1322,268 @@ public:
         std::cout << std::string(70, '=') << std::endl;
         
         for (const auto& [testName, times] : results) {
-            if (!times.empty() && times[0] >= 0) {
-                double avg = std::accumulate(times.begin(), times.end(), 0.0) / times.size();
-                double min = *std::min_element(times.begin(), times.end());
-                double max = *std::max_element(times.begin(), times.end());
-                
-                std::cout << std::fixed << std::setprecision(3)
-                          << std::setw(35) << testName 
-                          << " | Avg: " << std::setw(8) << avg << " ms"
-                          << " | Min: " << std::setw(8) << min << " ms"
-                          << " | Max: " << std::setw(8) << max << " ms"
-                          << " | Samples: " << times.size() << std::endl;
+            SampleStats stats = computeStats(times);
+            if (stats.count == 0) {
+                continue;
+            }
+            auto bytes = bytesPerRun.find(testName);
+            std::cout << std::fixed << std::setprecision(3)
+                      << std::setw(35) << testName
+                      << " | p50: " << std::setw(9) << stats.p50 << " ms"
+                      << " | p90: " << std::setw(9) << stats.p90 << " ms"
+                      << " | Max: " << std::setw(9) << stats.max << " ms"
+                      << " | Samples: " << stats.count
+                      << (bytes != bytesPerRun.end() && stats.p50 > 0
+                              ? " | " + std::to_string(static_cast<long long>(bytes->second / stats.p50 / 1000.0)) + " MB/s"
+                              : "")
+                      << std::endl;
+        }
+        if (PerfProfiler::enabled()) {
+            printPerfSummary();
+        }
+    }
+
+    // Counters per call of every test and stage: CPU time, IPC and misses per KB processed
+    // (or per call where the byte count is unknown)
+    void printPerfSummary() const {
+        std::cout << "\n[PERF] COUNTERS PER RUN\n";
+        std::cout << std::string(70, '=') << std::endl;
+        const bool hardware = PerfProfiler::available(PerfEvent::Cycles) && PerfProfiler::available(PerfEvent::Instructions);
+        for (const PerfProfiler::StageTotals& totals : PerfProfiler::totals()) {
+            if (totals.calls == 0) {
+                continue;
+            }
+            auto bytes = bytesPerRun.find(totals.stage);
+            const double perCall = 1.0 / totals.calls;
+            const double perKB = bytes != bytesPerRun.end() ? 1024.0 / bytes->second : 1.0;
+            std::cout << std::fixed << std::setprecision(3) << std::setw(35) << totals.stage
+                      << " | CPU: " << std::setw(9) << totals.counts[PerfEvent::TaskClock] * perCall / 1e6 << " ms";
+            if (hardware) {
+                std::cout << " | IPC: " << std::setprecision(2) << std::setw(5) << totals.counts.ipc();
+            }
+            for (PerfEvent event : {PerfEvent::LlcMisses, PerfEvent::BranchMisses}) {
+                if (PerfProfiler::available(event)) {
+                    std::cout << " | " << PerfCounterGroup::eventName(event) << (bytes != bytesPerRun.end() ? "/KB: " : ": ")
+                              << std::setprecision(2) << totals.counts[event] * perCall * perKB;
+                }
+            }
+            std::cout << " | Calls: " << totals.calls << std::endl;
+        }
+    }
+
+    // {"config": {...}, "results": [{"name", "samples", "min_ms", "p50_ms", "p90_ms",
+    // "p99_ms", "max_ms", "mean_ms", "bytes", "mb_per_s", "perf": {...}, "samples_ms": [...]}, ...],
+    // "perf_stages": [{"thread", "stage", "calls", "perf": {...}}, ...]}. "perf" holds the
+    // counters per call (recorded runs only) and is present with --perf.
+    bool writeJson(const std::string& path) const {
+        std::ofstream out(path, std::ios::trunc);
+        if (!out) {
+            return false;
+        }
+        auto quote = [](const std::string& text) {
+            std::string quoted = "\"";
+            for (char c : text) {
+                if (c == '"' || c == '\\') {
+                    quoted += '\\';
+                }
+                quoted += c;
+            }
+            return quoted + "\"";
+        };
+        // Available counters averaged over calls
+        auto perfJson = [](const PerfProfiler::StageTotals& totals) {
+            std::ostringstream json;
+            json << std::setprecision(6) << std::fixed << "{";
+            for (int i = 0; i < static_cast<int>(PerfEvent::Count); i++) {
+                PerfEvent event = static_cast<PerfEvent>(i);
+                if (PerfProfiler::available(event)) {
+                    json << (i == 0 ? "" : ", ") << "\"" << PerfCounterGroup::eventName(event)
+                         << "\": " << static_cast<double>(totals.counts[event]) / totals.calls;
+                }
+            }
+            if (PerfProfiler::available(PerfEvent::Cycles) && PerfProfiler::available(PerfEvent::Instructions)) {
+                json << ", \"ipc\": " << totals.counts.ipc();
+            }
+            json << "}";
+            return json.str();
+        };
+        const bool perf = PerfProfiler::enabled();
+        out << std::setprecision(6) << std::fixed;
+        out << "{\n  \"config\": {\"warmup\": " << options.warmup << ", \"repetitions\": " << options.repetitions
+            << ", \"max_size\": " << options.maxSize << ", \"perf\": " << (perf ? "true" : "false")
+            << ", \"perf_kernel\": " << (perf && PerfProfiler::includesKernel() ? "true" : "false")
+            << "},\n  \"results\": [";
+        bool first = true;
+        for (const auto& [testName, times] : results) {
+            SampleStats stats = computeStats(times);
+            if (stats.count == 0) {
+                continue;
             }
+            auto bytes = bytesPerRun.find(testName);
+            uint64_t processed = bytes == bytesPerRun.end() ? 0 : bytes->second;
+            out << (first ? "\n" : ",\n") << "    {\"name\": " << quote(testName) << ", \"samples\": " << stats.count
+                << ", \"min_ms\": " << stats.min << ", \"p50_ms\": " << stats.p50 << ", \"p90_ms\": " << stats.p90
+                << ", \"p99_ms\": " << stats.p99 << ", \"max_ms\": " << stats.max << ", \"mean_ms\": " << stats.mean
+                << ", \"bytes\": " << processed
+                << ", \"mb_per_s\": " << (processed > 0 && stats.p50 > 0 ? processed / stats.p50 / 1000.0 : 0.0);
+            PerfProfiler::StageTotals counters;
+            if (perf && PerfProfiler::stageTotals("benchmark", testName, counters) && counters.calls > 0) {
+                out << ", \"perf\": " << perfJson(counters);
+            }
+            out << ", \"samples_ms\": [";
+            bool firstSample = true;
+            for (double t : times) {
+                if (t >= 0) {
+                    out << (firstSample ? "" : ", ") << t;
+                    firstSample = false;
+                }
+            }
+            out << "]}";
+            first = false;
+        }
+        out << "\n  ]";
+        if (perf) {
+            out << ",\n  \"perf_stages\": [";
+            first = true;
+            for (const PerfProfiler::StageTotals& totals : PerfProfiler::totals()) {
+                if (totals.calls == 0) {
+                    continue;
+                }
+                out << (first ? "\n" : ",\n") << "    {\"thread\": " << quote(totals.thread) << ", \"stage\": "
+                    << quote(totals.stage) << ", \"calls\": " << totals.calls << ", \"perf\": " << perfJson(totals) << "}";
+                first = false;
+            }
+            out << "\n  ]";
+        }
+        out << "\n}\n";
+        return static_cast<bool>(out);
+    }
+
+    // Medians by test name from a file written by writeJson
+    static bool loadBaseline(const std::string& path, std::map<std::string, double>& medians) {
+        std::ifstream in(path);
+        if (!in) {
+            return false;
+        }
+        std::stringstream buffer;
+        buffer << in.rdbuf();
+        const std::string text = buffer.str();
+        const std::string nameKey = "\"name\": \"", medianKey = "\"p50_ms\": ";
+        for (size_t at = text.find(nameKey); at != std::string::npos; at = text.find(nameKey, at)) {
+            at += nameKey.size();
+            std::string name;
+            for (; at < text.size() && text[at] != '"'; at++) {
+                if (text[at] == '\\' && at + 1 < text.size()) {
+                    at++;
+                }
+                name += text[at];
+            }
+            size_t median = text.find(medianKey, at);
+            if (median == std::string::npos) {
+                break;
+            }
+            medians[name] = std::strtod(text.c_str() + median + medianKey.size(), nullptr);
+        }
+        return true;
+    }
+
+    // Print tests whose median moved more than the tolerance; returns the regression count
+    int compareWithBaseline(const std::map<std::string, double>& baseline) const {
+        std::cout << "\n[BASELINE] MEDIAN VS " << options.baselinePath << " (tolerance " << options.tolerancePercent
+                  << "%)\n";
+        std::cout << std::string(70, '=') << std::endl;
+        int regressions = 0, compared = 0;
+        const double limit = 1.0 + options.tolerancePercent / 100.0;
+        for (const auto& [testName, times] : results) {
+            SampleStats stats = computeStats(times);
+            auto before = baseline.find(testName);
+            if (stats.count == 0 || before == baseline.end() || before->second <= 0) {
+                continue;
+            }
+            compared++;
+            double ratio = stats.p50 / before->second;
+            const char* verdict = ratio > limit ? "REGRESSION" : ratio < 1.0 / limit ? "improved" : nullptr;
+            if (!verdict) {
+                continue;
+            }
+            regressions += ratio > limit ? 1 : 0;
+            std::cout << std::fixed << std::setprecision(3) << std::setw(35) << testName << " | "
+                      << std::setw(9) << before->second << " -> " << std::setw(9) << stats.p50 << " ms | "
+                      << std::setprecision(2) << ratio << "x | " << verdict << std::endl;
         }
+        std::cout << compared << " tests compared, " << regressions << " regression(s)" << std::endl;
+        return regressions;
     }
 };
 
-int main() {
+static void printUsage() {
+    std::cout << "Usage: client_benchmark [--warmup N] [--reps N] [--max-size SIZE] [--sweep-only]\n"
+                 "                        [--json FILE] [--baseline FILE] [--tolerance PERCENT] [--perf]\n"
+                 "SIZE takes K, M or G suffixes (4K .. 4G); a --json file can serve as a later --baseline.\n"
+                 "--perf counts CPU time, cycles, instructions and cache/branch misses per test (Linux).\n";
+}
+
+int main(int argc, char* argv[]) {
     try {
-        ClientBenchmark benchmark;
+        BenchmarkOptions options;
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            bool hasValue = i + 1 < argc;
+            if (arg == "--warmup" && hasValue) {
+                options.warmup = std::max(0, std::atoi(argv[++i]));
+            } else if (arg == "--reps" && hasValue) {
+                options.repetitions = std::max(1, std::atoi(argv[++i]));
+            } else if (arg == "--max-size" && hasValue) {
+                options.maxSize = parseSize(argv[++i]);
+                if (options.maxSize < 4096 || options.maxSize > (4ull << 30)) {
+                    std::cout << "[FAIL] --max-size must be between 4K and 4G" << std::endl;
+                    return 1;
+                }
+            } else if (arg == "--sweep-only") {
+                options.sweepOnly = true;
+            } else if (arg == "--json" && hasValue) {
+                options.jsonPath = argv[++i];
+            } else if (arg == "--baseline" && hasValue) {
+                options.baselinePath = argv[++i];
+            } else if (arg == "--tolerance" && hasValue) {
+                options.tolerancePercent = std::atof(argv[++i]);
+            } else if (arg == "--perf") {
+                options.perf = true;
+            } else {
+                printUsage();
+                return arg == "--help" ? 0 : 1;
+            }
+        }
+
+        std::map<std::string, double> baseline;
+        if (!options.baselinePath.empty() && !ClientBenchmark::loadBaseline(options.baselinePath, baseline)) {
+            std::cout << "[FAIL] Cannot read baseline " << options.baselinePath << std::endl;
+            return 1;
+        }
+
+        if (options.perf) {
+            std::string perfError;
+            PerfProfiler::nameThread("benchmark");
+            if (!PerfProfiler::enable(perfError)) {
+                std::cout << "[WARN] --perf ignored: " << perfError << std::endl;
+            }
+        }
+
+        ClientBenchmark benchmark(options);
         benchmark.runAllBenchmarks();
-        
+
+        if (!options.jsonPath.empty()) {
+            if (!benchmark.writeJson(options.jsonPath)) {
+                std::cout << "[FAIL] Cannot write " << options.jsonPath << std::endl;
+                return 1;
+            }
+            std::cout << "\nResults written to " << options.jsonPath << std::endl;
+        }
+        if (!options.baselinePath.empty() && benchmark.compareWithBaseline(baseline) > 0) {
+            std::cout << "\n[FAIL] Performance regressed against the baseline\n";
+            return 2;
+        }
+
         std::cout << "\n[OK] Client benchmark completed successfully!\n";
         return 0;
         
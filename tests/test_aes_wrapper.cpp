@@ -0,0 +1,138 @@
+// Test the reusable AES context: CBC round trips, IV resynchronization,
+// shared use from several threads and GCM tag verification
+#include <iostream>
+#include <vector>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <exception>
+
+#include "../include/wrappers/AESWrapper.h"
+
+int main() {
+    try {
+        std::cout << "=== AESWrapper (reusable context) Test ===" << std::endl;
+
+        unsigned char key[AESWrapper::DEFAULT_KEYLENGTH];
+        AESWrapper::generateKey(key, sizeof(key));
+        AESWrapper aes(key, sizeof(key), true);
+
+        // Test 1: CBC round trip for lengths around the block boundary
+        std::cout << "1. Testing CBC round trip (1..64 bytes)..." << std::endl;
+        for (size_t length = 1; length <= 64; length++) {
+            std::string plain(length, static_cast<char>('a' + length % 26));
+            std::string cipher = aes.encrypt(plain.data(), plain.size());
+            if (cipher.size() != AESWrapper::BLOCK_SIZE + (length / 16 + 1) * 16) {
+                std::cout << "   ✗ Unexpected ciphertext size for " << length << " bytes" << std::endl;
+                return 1;
+            }
+            if (aes.decrypt(cipher.data(), cipher.size()) != plain) {
+                std::cout << "   ✗ Round trip failed for " << length << " bytes" << std::endl;
+                return 1;
+            }
+        }
+        std::cout << "   ✓ Test passed!" << std::endl;
+
+        // Test 2: resynchronize changes the IV without re-keying
+        std::cout << "2. Testing resynchronize..." << std::endl;
+        std::string message = "same message, different IV";
+        std::string zeroIv = aes.encrypt(message.data(), message.size());
+        unsigned char newIv[AESWrapper::BLOCK_SIZE];
+        for (size_t i = 0; i < sizeof(newIv); i++) {
+            newIv[i] = static_cast<unsigned char>(i + 1);
+        }
+        aes.resynchronize(newIv);
+        std::string resynced = aes.encrypt(message.data(), message.size());
+        if (resynced == zeroIv || resynced.compare(0, sizeof(newIv), reinterpret_cast<char*>(newIv), sizeof(newIv)) != 0 ||
+            aes.decrypt(resynced.data(), resynced.size()) != message) {
+            std::cout << "   ✗ Resynchronized encryption is wrong!" << std::endl;
+            return 1;
+        }
+        std::cout << "   ✓ Test passed!" << std::endl;
+
+        // Test 3: one shared instance used concurrently (explicit IV + GCM are const)
+        std::cout << "3. Testing shared instance across 4 threads..." << std::endl;
+        std::atomic<int> failures(0);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; t++) {
+            threads.emplace_back([&aes, &failures, t]() {
+                std::string data(1000 + t, static_cast<char>(t));
+                unsigned char threadIv[AESWrapper::BLOCK_SIZE] = {static_cast<unsigned char>(t)};
+                unsigned char nonce[AESWrapper::GCM_NONCE_SIZE] = {static_cast<unsigned char>(t)};
+                for (int i = 0; i < 500; i++) {
+                    std::string cbc = aes.encrypt(data.data(), data.size(), threadIv);
+                    std::string gcm = aes.encryptGCM(nonce, nullptr, 0, data.data(), data.size());
+                    if (aes.decrypt(cbc.data(), cbc.size()) != data ||
+                        aes.decryptGCM(nonce, nullptr, 0, gcm.data(), gcm.size()) != data) {
+                        failures++;
+                    }
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        if (failures != 0) {
+            std::cout << "   ✗ " << failures << " concurrent round trips failed!" << std::endl;
+            return 1;
+        }
+        std::cout << "   ✓ Test passed!" << std::endl;
+
+        // Test 4: GCM rejects a modified ciphertext, and a second key does not reuse the first key's state
+        std::cout << "4. Testing GCM tamper detection and key switching..." << std::endl;
+        unsigned char nonce[AESWrapper::GCM_NONCE_SIZE] = {1};
+        const unsigned char aad[] = {1, 2, 3, 4};
+        std::string sealed = aes.encryptGCM(nonce, aad, sizeof(aad), message.data(), message.size());
+        sealed[0] ^= 0x01;
+        bool rejected = false;
+        try {
+            aes.decryptGCM(nonce, aad, sizeof(aad), sealed.data(), sealed.size());
+        } catch (const std::runtime_error&) {
+            rejected = true;
+        }
+        AESWrapper::generateKey(key, sizeof(key));
+        AESWrapper other(key, sizeof(key), true);
+        std::string mine = aes.encryptGCM(nonce, aad, sizeof(aad), message.data(), message.size());
+        std::string theirs = other.encryptGCM(nonce, aad, sizeof(aad), message.data(), message.size());
+        if (!rejected || mine == theirs) {
+            std::cout << "   ✗ GCM accepted a tampered packet or mixed up keys!" << std::endl;
+            return 1;
+        }
+        std::cout << "   ✓ Test passed!" << std::endl;
+
+        // Test 5: per-packet encryption cost with the schedule reused
+        std::cout << "5. Measuring 1KB packet encryption..." << std::endl;
+        std::string packet(1024, 'x');
+        const int packets = 100000;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < packets; i++) {
+            nonce[0] = static_cast<unsigned char>(i);
+            nonce[1] = static_cast<unsigned char>(i >> 8);
+            nonce[2] = static_cast<unsigned char>(i >> 16);
+            aes.encryptGCM(nonce, aad, sizeof(aad), packet.data(), packet.size());
+        }
+        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        std::cout << "   " << packets << " x 1KB in " << elapsed / 1000.0 << " ms ("
+                  << (elapsed * 1000.0 / packets) << " ns per packet)" << std::endl;
+        std::cout << "   ✓ Test passed!" << std::endl;
+
+        // Test 6: encrypting into a caller buffer matches the allocating overload
+        std::cout << "6. Testing GCM into a caller-provided buffer..." << std::endl;
+        std::vector<unsigned char> out(packet.size() + AESWrapper::GCM_TAG_SIZE);
+        aes.encryptGCM(nonce, aad, sizeof(aad), packet.data(), packet.size(), out.data());
+        std::string expected = aes.encryptGCM(nonce, aad, sizeof(aad), packet.data(), packet.size());
+        if (std::string(out.begin(), out.end()) != expected) {
+            std::cout << "   ✗ Buffer output differs from string output!" << std::endl;
+            return 1;
+        }
+        std::cout << "   ✓ Test passed!" << std::endl;
+
+        std::cout << "\n=== ALL TESTS PASSED! ===" << std::endl;
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "ERROR: " << e.what() << std::endl;
+        return 1;
+    }
+}
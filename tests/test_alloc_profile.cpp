@@ -0,0 +1,151 @@
+// Test the allocation profile (build with CLIENT_ALLOC_PROFILE defined): allocations and
+// frees land in the current phase, peak live bytes per phase and for the run, scopes
+// restoring the outer phase, every operator new/delete form, and concurrent threads.
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <memory>
+#include <new>
+#include <exception>
+
+#include "../include/client/AllocProfile.h"
+
+namespace {
+
+constexpr size_t MB = 1024 * 1024;
+
+// Keeps the compiler from eliding a new/delete pair
+void touch(void* memory) {
+    static_cast<volatile char*>(memory)[0] = 1;
+}
+
+} // namespace
+
+int main() {
+    try {
+        std::cout << "=== Allocation Profile Test ===" << std::endl;
+        if (!AllocProfile::enabled()) {
+            std::cout << "   ✗ Build with CLIENT_ALLOC_PROFILE defined" << std::endl;
+            return 1;
+        }
+
+        // Test 1: allocations and frees count toward the current phase
+        std::cout << "1. Testing per-phase counts..." << std::endl;
+        AllocProfile::reset();
+        const uint64_t baseline = AllocProfile::liveBytes();
+        {
+            AllocPhaseScope phase(AllocPhase::Read);
+            std::unique_ptr<char[]> block(new char[3 * MB]);
+            touch(block.get());
+        }
+        AllocProfile::PhaseStats read = AllocProfile::stats(AllocPhase::Read);
+        if (read.allocations != 1 || read.allocatedBytes != 3 * MB || read.frees != 1 || read.freedBytes != 3 * MB ||
+            read.peakLiveBytes != baseline + 3 * MB || AllocProfile::liveBytes() != baseline ||
+            AllocProfile::phase() != AllocPhase::Init) {
+            std::cout << "   ✗ Read phase: " << read.allocations << " allocations, " << read.allocatedBytes
+                      << " bytes, peak " << read.peakLiveBytes - baseline << " above baseline" << std::endl;
+            return 1;
+        }
+        std::cout << "   ✓ Test passed!" << std::endl;
+
+        // Test 2: a phase's peak is the most held at once, including what earlier phases left live
+        std::cout << "2. Testing peak live bytes..." << std::endl;
+        std::unique_ptr<char[]> whole;
+        {
+            AllocPhaseScope phase(AllocPhase::Encrypt);
+            whole.reset(new char[8 * MB]);
+            touch(whole.get());
+        }
+        {
+            AllocPhaseScope phase(AllocPhase::Send);
+            for (int i = 0; i < 4; i++) {
+                std::unique_ptr<char[]> chunk(new char[MB]);
+                touch(chunk.get());
+            }
+            whole.reset();
+        }
+        AllocProfile::PhaseStats encrypt = AllocProfile::stats(AllocPhase::Encrypt);
+        AllocProfile::PhaseStats send = AllocProfile::stats(AllocPhase::Send);
+        if (encrypt.peakLiveBytes != baseline + 8 * MB || send.peakLiveBytes != baseline + 9 * MB ||
+            send.allocations != 4 || send.frees != 5 || send.freedBytes != 12 * MB ||
+            AllocProfile::peakLiveBytes() != baseline + 9 * MB) {
+            std::cout << "   ✗ Encrypt peak " << encrypt.peakLiveBytes - baseline << ", send peak "
+                      << send.peakLiveBytes - baseline << " above baseline" << std::endl;
+            return 1;
+        }
+        std::cout << "   ✓ Test passed!" << std::endl;
+
+        // Test 3: scalar, array, nothrow and sized forms all balance
+        std::cout << "3. Testing operator forms..." << std::endl;
+        AllocProfile::reset();
+        {
+            AllocPhaseScope phase(AllocPhase::Verify);
+            int* scalar = new int(7);
+            touch(scalar);
+            delete scalar;
+            double* array = new double[100];
+            touch(array);
+            delete[] array;
+            char* nothrow = new (std::nothrow) char[64];
+            touch(nothrow);
+            delete[] nothrow;
+            void* raw = ::operator new(40);
+            touch(raw);
+            ::operator delete(raw, 40);
+        }
+        AllocProfile::PhaseStats verify = AllocProfile::stats(AllocPhase::Verify);
+        if (verify.allocations != 4 || verify.frees != 4 || verify.allocatedBytes != verify.freedBytes ||
+            verify.allocatedBytes < sizeof(int) + 100 * sizeof(double) + 64 + 40 || AllocProfile::liveBytes() != baseline) {
+            std::cout << "   ✗ " << verify.allocations << " allocations, " << verify.frees << " frees" << std::endl;
+            return 1;
+        }
+        std::cout << "   ✓ Test passed!" << std::endl;
+
+        // Test 4: threads allocating at once lose no counts
+        std::cout << "4. Testing concurrent threads..." << std::endl;
+        std::vector<std::thread> threads;
+        threads.reserve(4);
+        AllocProfile::reset();
+        const uint64_t beforeThreads = AllocProfile::liveBytes();
+        {
+            AllocPhaseScope phase(AllocPhase::Handshake);
+            for (int t = 0; t < 4; t++) {
+                threads.emplace_back([]() {
+                    for (int i = 0; i < 10000; i++) {
+                        std::unique_ptr<char[]> block(new char[100]);
+                        touch(block.get());
+                    }
+                });
+            }
+            for (auto& thread : threads) {
+                thread.join();
+            }
+            threads.clear();
+        }
+        AllocProfile::PhaseStats handshake = AllocProfile::stats(AllocPhase::Handshake);
+        if (handshake.allocations < 40000 || handshake.allocations != handshake.frees ||
+            handshake.allocatedBytes != handshake.freedBytes || AllocProfile::liveBytes() != beforeThreads) {
+            std::cout << "   ✗ " << handshake.allocations << " allocations, " << handshake.frees << " frees" << std::endl;
+            return 1;
+        }
+        std::cout << "   ✓ Test passed!" << std::endl;
+
+        // Test 5: the table has a row per phase
+        std::cout << "5. Testing table..." << std::endl;
+        std::string table = AllocProfile::table();
+        for (const char* name : {"init", "handshake", "read", "encrypt", "send", "verify", "Peak live over the run"}) {
+            if (table.find(name) == std::string::npos) {
+                std::cout << "   ✗ No " << name << " row:\n" << table << std::endl;
+                return 1;
+            }
+        }
+        std::cout << "   ✓ Test passed!" << std::endl;
+
+        std::cout << "\n=== ALL TESTS PASSED! ===" << std::endl;
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "ERROR: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,178 @@
+// Test the asynchronous console sink: records render in order on the writer thread, a
+// stalled writer never blocks posting (drops below Error, Error waits), compile-time and
+// run-time level filtering, concurrent posters, and rendering inline after stop().
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <exception>
+
+#include "../include/client/AsyncLog.h"
+
+namespace {
+
+AsyncLog::Render countingRender(int& evaluated) {
+    evaluated++;
+    return []() {};
+}
+
+} // namespace
+
+int main() {
+    try {
+        std::cout << "=== Async Log Test ===" << std::endl;
+
+        // Test 1: records render in posting order, off the posting thread
+        std::cout << "1. Testing ordered rendering..." << std::endl;
+        {
+            AsyncLog sink;
+            std::vector<int> seen;
+            std::atomic<bool> onPoster{false};
+            const std::thread::id poster = std::this_thread::get_id();
+            for (int i = 0; i < 500; i++) {
+                sink.post(LogLevel::Info, [&seen, &onPoster, poster, i]() {
+                    seen.push_back(i);
+                    if (std::this_thread::get_id() == poster) {
+                        onPoster = true;
+                    }
+                });
+            }
+            sink.flush();
+            bool ordered = seen.size() == 500;
+            for (size_t i = 0; ordered && i < seen.size(); i++) {
+                ordered = seen[i] == static_cast<int>(i);
+            }
+            if (!ordered || onPoster || sink.dropped() != 0) {
+                std::cout << "   ✗ Rendered " << seen.size() << " records, dropped " << sink.dropped() << std::endl;
+                return 1;
+            }
+        }
+        std::cout << "   ✓ Test passed!" << std::endl;
+
+        // Test 2: a stalled writer drops Info instead of blocking, and an Error waits for room
+        std::cout << "2. Testing full ring..." << std::endl;
+        {
+            AsyncLog sink(4);
+            std::atomic<bool> release{false};
+            std::atomic<int> rendered{0};
+            sink.post(LogLevel::Info, [&release]() {
+                while (!release) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+            });
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));   // Writer is now stuck in the first record
+            auto start = std::chrono::steady_clock::now();
+            int accepted = 0;
+            for (int i = 0; i < 10; i++) {
+                accepted += sink.post(LogLevel::Info, [&rendered]() { rendered++; }) ? 1 : 0;
+            }
+            auto posting = std::chrono::steady_clock::now() - start;
+
+            std::atomic<bool> errorPosted{false};
+            std::thread errorThread([&]() {
+                sink.post(LogLevel::Error, [&rendered]() { rendered += 100; });
+                errorPosted = true;
+            });
+            std::this_thread::sleep_for(std::chrono::milliseconds(30));
+            bool waited = !errorPosted;
+            release = true;
+            errorThread.join();
+            sink.flush();
+            if (accepted != 4 || sink.dropped() != 6 || !waited || rendered != 104 ||
+                posting > std::chrono::milliseconds(10)) {
+                std::cout << "   ✗ Accepted " << accepted << ", dropped " << sink.dropped() << ", rendered "
+                          << rendered << (waited ? "" : ", Error did not wait") << std::endl;
+                return 1;
+            }
+        }
+        std::cout << "   ✓ Test passed!" << std::endl;
+
+        // Test 3: filtered records are never built or rendered
+        std::cout << "3. Testing level filtering..." << std::endl;
+        {
+            AsyncLog sink;
+            int evaluated = 0;
+            int rendered = 0;
+            sink.setLevel(LogLevel::Debug);
+            CLIENT_LOG(sink, LogLevel::Debug, countingRender(evaluated));   // Below CLIENT_LOG_MIN_LEVEL
+            sink.setLevel(LogLevel::Warning);
+            CLIENT_LOG(sink, LogLevel::Info, countingRender(evaluated));
+            bool infoPosted = sink.post(LogLevel::Info, [&rendered]() { rendered++; });
+            CLIENT_LOG(sink, LogLevel::Warning, [&rendered]() { rendered++; });
+            sink.setLevel(LogLevel::Off);
+            bool errorPosted = sink.post(LogLevel::Error, [&rendered]() { rendered++; });
+            sink.flush();
+            if (evaluated != 0 || infoPosted || errorPosted || rendered != 1 || sink.level() != LogLevel::Off) {
+                std::cout << "   ✗ Evaluated " << evaluated << ", rendered " << rendered << std::endl;
+                return 1;
+            }
+        }
+        std::cout << "   ✓ Test passed!" << std::endl;
+
+        // Test 4: concurrent posters each keep their own order
+        std::cout << "4. Testing concurrent posters..." << std::endl;
+        {
+            AsyncLog sink;
+            std::vector<std::vector<int>> seen(4);
+            std::vector<std::thread> threads;
+            for (int t = 0; t < 4; t++) {
+                threads.emplace_back([&sink, &seen, t]() {
+                    for (int i = 0; i < 200; i++) {
+                        sink.post(LogLevel::Info, [&seen, t, i]() { seen[t].push_back(i); });
+                    }
+                });
+            }
+            for (auto& thread : threads) {
+                thread.join();
+            }
+            sink.flush();
+            bool ordered = true;
+            for (const auto& records : seen) {
+                ordered = ordered && records.size() == 200;
+                for (size_t i = 0; ordered && i < records.size(); i++) {
+                    ordered = records[i] == static_cast<int>(i);
+                }
+            }
+            if (!ordered || sink.dropped() != 0) {
+                std::cout << "   ✗ Records lost or reordered" << std::endl;
+                return 1;
+            }
+        }
+        std::cout << "   ✓ Test passed!" << std::endl;
+
+        // Test 5: stop() renders what was queued, later records render inline; level names parse
+        std::cout << "5. Testing stop and level names..." << std::endl;
+        {
+            AsyncLog sink;
+            int rendered = 0;
+            for (int i = 0; i < 50; i++) {
+                sink.post(LogLevel::Info, [&rendered]() { rendered++; });
+            }
+            sink.stop();
+            int afterStop = rendered;
+            bool inlineOnPoster = false;
+            const std::thread::id poster = std::this_thread::get_id();
+            sink.post(LogLevel::Info, [&]() { inlineOnPoster = std::this_thread::get_id() == poster; });
+            sink.flush();
+            sink.stop();
+            LogLevel level = LogLevel::Info;
+            bool parsed = AsyncLog::parseLevel("WARNING", level) && level == LogLevel::Warning &&
+                          AsyncLog::parseLevel("debug", level) && level == LogLevel::Debug &&
+                          !AsyncLog::parseLevel("verbose", level) && level == LogLevel::Debug;
+            if (afterStop != 50 || !inlineOnPoster || !parsed) {
+                std::cout << "   ✗ Rendered " << afterStop << " before stop" << std::endl;
+                return 1;
+            }
+        }
+        std::cout << "   ✓ Test passed!" << std::endl;
+
+        std::cout << "\n=== ALL TESTS PASSED! ===" << std::endl;
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "ERROR: " << e.what() << std::endl;
+        return 1;
+    }
+}
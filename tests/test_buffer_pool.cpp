@@ -0,0 +1,119 @@
+// Test the packet buffer pool: cache-line alignment, buffer reuse, heap fallback when the
+// pool is exhausted or a request is oversized, lease moves, and zero heap allocations in
+// a steady-state packet loop.
+#include <iostream>
+#include <vector>
+#include <string>
+#include <set>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <exception>
+
+#include "../include/client/BufferPool.h"
+
+int main() {
+    try {
+        std::cout << "=== BufferPool Test ===" << std::endl;
+        const size_t packetSize = 1024 * 1024 + 290;   // Request header + file metadata + 1MB
+
+        // Test 1: setup and alignment
+        std::cout << "1. Testing pool setup and alignment..." << std::endl;
+        BufferPool pool;
+        std::string error;
+        if (!pool.init(4, packetSize, true, error)) {
+            std::cout << "   ✗ init failed: " << error << std::endl;
+            return 1;
+        }
+        std::cout << "   Buffer size: " << pool.bufferSize() << " bytes, huge pages: "
+                  << (pool.hugePagesBacked() ? "yes" : "no") << std::endl;
+        std::set<uint8_t*> distinct;
+        {
+            std::vector<BufferPool::Lease> leases;
+            for (int i = 0; i < 4; i++) {
+                leases.push_back(pool.acquire(packetSize));
+                uint8_t* data = leases.back().data();
+                if (!data || reinterpret_cast<uintptr_t>(data) % BufferPool::CACHE_LINE != 0 ||
+                    leases.back().capacity() < packetSize) {
+                    std::cout << "   ✗ Buffer " << i << " is misaligned or too small" << std::endl;
+                    return 1;
+                }
+                std::memset(data, i, packetSize);
+                distinct.insert(data);
+            }
+            if (distinct.size() != 4 || pool.available() != 0 || pool.heapAllocations() != 0) {
+                std::cout << "   ✗ Pool did not hand out 4 distinct buffers" << std::endl;
+                return 1;
+            }
+        }
+        if (pool.available() != 4) {
+            std::cout << "   ✗ Leases were not returned" << std::endl;
+            return 1;
+        }
+        std::cout << "   ✓ Test passed!" << std::endl;
+
+        // Test 2: exhausted pool and oversized requests fall back to the heap, and are counted
+        std::cout << "2. Testing heap fallback..." << std::endl;
+        {
+            std::vector<BufferPool::Lease> leases;
+            for (int i = 0; i < 5; i++) {
+                leases.push_back(pool.acquire(packetSize));
+            }
+            BufferPool::Lease big = pool.acquire(pool.bufferSize() + 1);
+            if (!leases[4].valid() || !big.valid() || big.capacity() <= pool.bufferSize() ||
+                distinct.count(leases[4].data()) || pool.heapAllocations() != 2) {
+                std::cout << "   ✗ Fallback leases wrong (heap allocations " << pool.heapAllocations() << ")" << std::endl;
+                return 1;
+            }
+        }
+        if (pool.available() != 4) {
+            std::cout << "   ✗ Pool buffers lost after fallback" << std::endl;
+            return 1;
+        }
+        std::cout << "   ✓ Test passed!" << std::endl;
+
+        // Test 3: moving a lease transfers ownership exactly once
+        std::cout << "3. Testing lease moves..." << std::endl;
+        {
+            BufferPool::Lease first = pool.acquire(64);
+            uint8_t* data = first.data();
+            BufferPool::Lease second(std::move(first));
+            BufferPool::Lease third;
+            third = std::move(second);
+            if (first.valid() || second.valid() || third.data() != data || pool.available() != 3) {
+                std::cout << "   ✗ Move did not transfer the buffer" << std::endl;
+                return 1;
+            }
+            third = pool.acquire(64);   // Assigning over a lease returns its old buffer
+            if (pool.available() != 3) {
+                std::cout << "   ✗ Overwritten lease was not returned" << std::endl;
+                return 1;
+            }
+        }
+        std::cout << "   ✓ Test passed!" << std::endl;
+
+        // Test 4: a packet loop (frame + occasional response) reuses pool buffers only
+        std::cout << "4. Testing steady-state packet loop..." << std::endl;
+        uint64_t heapBefore = pool.heapAllocations();
+        for (int packet = 0; packet < 1000; packet++) {
+            BufferPool::Lease frame = pool.acquire(packetSize);
+            frame.data()[0] = static_cast<uint8_t>(packet);
+            if (packet % 100 == 99) {
+                BufferPool::Lease response = pool.acquire(279);
+                response.data()[0] = 1;
+            }
+        }
+        if (pool.heapAllocations() != heapBefore) {
+            std::cout << "   ✗ " << pool.heapAllocations() - heapBefore << " heap allocations in steady state" << std::endl;
+            return 1;
+        }
+        std::cout << "   1000 packets, 0 heap allocations" << std::endl;
+        std::cout << "   ✓ Test passed!" << std::endl;
+
+        std::cout << "\n=== ALL TESTS PASSED! ===" << std::endl;
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "ERROR: " << e.what() << std::endl;
+        return 1;
+    }
+}
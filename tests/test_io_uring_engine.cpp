@@ -0,0 +1,226 @@
+// Test the io_uring engine: fixed-file reads into registered buffers, socket sends,
+// the linked send timeout against a stalled peer, and frames queued back to back on one
+// TCP socket arriving whole and in order at a slow reader.
+// Prints a skip notice (and passes) where io_uring is unavailable.
+#include <iostream>
+#include <vector>
+#include <string>
+#include <thread>
+#include <chrono>
+#include <cstdio>
+#include <exception>
+
+#include "../include/client/IoUringEngine.h"
+
+#ifdef CLIENT_HAVE_IO_URING
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+// Reap completions until the one tagged userData arrives
+static bool waitFor(IoUringEngine& engine, uint64_t userData, IoUringCompletion& completion) {
+    std::string error;
+    for (;;) {
+        while (engine.nextCompletion(completion)) {
+            if (completion.userData == userData) {
+                return true;
+            }
+        }
+        if (!engine.submit(1, error)) {
+            return false;
+        }
+    }
+}
+#endif
+
+int main() {
+    try {
+        std::cout << "=== IoUringEngine Test ===" << std::endl;
+#ifndef CLIENT_HAVE_IO_URING
+        std::cout << "io_uring is not available on this platform - skipped" << std::endl;
+        std::cout << "\n=== ALL TESTS PASSED! ===" << std::endl;
+        return 0;
+#else
+        const size_t chunk = 256 * 1024;
+
+        // Test 1: ring setup and buffer registration
+        std::cout << "1. Testing ring setup..." << std::endl;
+        IoUringEngine engine;
+        std::string error;
+        if (!engine.init(16, 2, chunk, error)) {
+            std::cout << "   io_uring unavailable (" << error << ") - skipped" << std::endl;
+            std::cout << "\n=== ALL TESTS PASSED! ===" << std::endl;
+            return 0;
+        }
+        std::cout << "   Registered buffers: " << (engine.buffersRegistered() ? "yes" : "no (plain READ)") << std::endl;
+        std::cout << "   ✓ Test passed!" << std::endl;
+
+        // Test 2: file -> socket through fixed files, resubmitting partial sends
+        std::cout << "2. Testing file to socket copy (4MB)..." << std::endl;
+        std::vector<char> data(4 * 1024 * 1024);
+        for (size_t i = 0; i < data.size(); i++) {
+            data[i] = static_cast<char>(i * 131 + (i >> 12));
+        }
+        const char* path = "io_uring_test.tmp";
+        FILE* file = std::fopen(path, "wb");
+        std::fwrite(data.data(), 1, data.size(), file);
+        std::fclose(file);
+
+        int pair[2];
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, pair) != 0) {
+            std::cout << "   ✗ socketpair failed" << std::endl;
+            return 1;
+        }
+        int fd = open(path, O_RDONLY);
+        if (fd < 0 || !engine.registerFiles({fd, pair[0]}, error)) {
+            std::cout << "   ✗ Registering files failed: " << error << std::endl;
+            return 1;
+        }
+
+        std::vector<char> received;
+        std::thread reader([&]() {
+            char buffer[65536];
+            ssize_t n;
+            while ((n = read(pair[1], buffer, sizeof(buffer))) > 0) {
+                received.insert(received.end(), buffer, buffer + n);
+            }
+        });
+
+        bool copied = true;
+        for (size_t offset = 0; copied && offset < data.size(); offset += chunk) {
+            IoUringCompletion completion;
+            copied = engine.queueRead(0, 0, 0, chunk, offset, 1) && waitFor(engine, 1, completion) &&
+                     completion.result == static_cast<int32_t>(chunk);
+            for (size_t sent = 0; copied && sent < chunk; sent += completion.result) {
+                copied = engine.queueSend(1, engine.buffer(0) + sent, chunk - sent, 2, std::chrono::milliseconds(5000)) &&
+                         waitFor(engine, 2, completion) && completion.result > 0;
+            }
+        }
+        shutdown(pair[0], SHUT_WR);
+        reader.join();
+        engine.unregisterFiles();
+        close(fd);
+        close(pair[0]);
+        close(pair[1]);
+        std::remove(path);
+        if (!copied || received != data) {
+            std::cout << "   ✗ Copied data does not match!" << std::endl;
+            return 1;
+        }
+        std::cout << "   " << engine.operationsSubmitted() << " operations in " << engine.enterCalls()
+                  << " io_uring_enter calls" << std::endl;
+        std::cout << "   ✓ Test passed!" << std::endl;
+
+        // Test 3: a send to a peer that never reads is cancelled by its linked timeout
+        std::cout << "3. Testing send timeout against a stalled peer..." << std::endl;
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, pair) != 0 || !engine.registerFiles({pair[0]}, error)) {
+            std::cout << "   ✗ Setup failed: " << error << std::endl;
+            return 1;
+        }
+        auto start = std::chrono::steady_clock::now();
+        IoUringCompletion completion{0, 0};
+        bool timedOut = false;
+        // Keep sending until the socket buffer is full and a send has to wait
+        for (int i = 0; i < 1000 && !timedOut; i++) {
+            if (!engine.queueSend(0, engine.buffer(1), chunk, 3, std::chrono::milliseconds(200)) ||
+                !waitFor(engine, 3, completion)) {
+                break;
+            }
+            timedOut = completion.result == -ECANCELED;
+        }
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+        engine.unregisterFiles();
+        close(pair[0]);
+        close(pair[1]);
+        if (!timedOut || elapsed > 5000) {
+            std::cout << "   ✗ Stalled send was not cancelled (result " << completion.result << ")" << std::endl;
+            return 1;
+        }
+        std::cout << "   Cancelled after " << elapsed << " ms" << std::endl;
+        std::cout << "   ✓ Test passed!" << std::endl;
+
+        // Test 4: large frames queued at once on a TCP socket with a small send buffer reach
+        // a slow reader in order; short sends must finish before the next frame starts
+        std::cout << "4. Testing ordered sends to a slow reader (8 x 1MB over TCP)..." << std::endl;
+        int listener = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t addressSize = sizeof(address);
+        int sender = socket(AF_INET, SOCK_STREAM, 0);
+        int smallBuffer = 16 * 1024;
+        setsockopt(sender, SOL_SOCKET, SO_SNDBUF, &smallBuffer, sizeof(smallBuffer));
+        if (listener < 0 || sender < 0 || bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+            listen(listener, 1) != 0 || getsockname(listener, reinterpret_cast<sockaddr*>(&address), &addressSize) != 0 ||
+            connect(sender, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+            std::cout << "   ✗ Loopback TCP setup failed" << std::endl;
+            return 1;
+        }
+        int peer = accept(listener, nullptr, nullptr);
+        close(listener);
+        if (peer < 0 || !engine.registerFiles({sender}, error)) {
+            std::cout << "   ✗ Setup failed: " << error << std::endl;
+            return 1;
+        }
+
+        const unsigned frames = 8;
+        const size_t frameSize = 1024 * 1024;
+        std::vector<std::vector<char>> outgoing(frames, std::vector<char>(frameSize));
+        std::vector<char> expected;
+        for (unsigned f = 0; f < frames; f++) {
+            for (size_t i = 0; i < frameSize; i++) {
+                outgoing[f][i] = static_cast<char>(f * 37 + i * 7 + (i >> 10));
+            }
+            expected.insert(expected.end(), outgoing[f].begin(), outgoing[f].end());
+        }
+        received.clear();
+        std::thread slowReader([&]() {
+            char buffer[16384];
+            ssize_t n;
+            while ((n = read(peer, buffer, sizeof(buffer))) > 0) {
+                received.insert(received.end(), buffer, buffer + n);
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+            }
+        });
+
+        bool queuedAll = true;
+        for (unsigned f = 0; f < frames && queuedAll; f++) {
+            queuedAll = engine.queueSend(0, reinterpret_cast<const uint8_t*>(outgoing[f].data()), frameSize, 10 + f,
+                                         std::chrono::milliseconds(10000));
+        }
+        unsigned completed = 0;
+        bool allSent = queuedAll;
+        while (allSent && completed < frames) {
+            IoUringCompletion done;
+            while (engine.nextCompletion(done)) {
+                completed++;
+                allSent = allSent && done.userData >= 10 && done.result == static_cast<int32_t>(frameSize);
+            }
+            if (completed < frames && !engine.submit(1, error)) {
+                allSent = false;
+            }
+        }
+        shutdown(sender, SHUT_WR);
+        slowReader.join();
+        engine.unregisterFiles();
+        close(sender);
+        close(peer);
+        if (!allSent || received != expected) {
+            std::cout << "   ✗ Frames arrived incomplete or interleaved (" << received.size() << " of "
+                      << expected.size() << " bytes)" << std::endl;
+            return 1;
+        }
+        std::cout << "   " << engine.shortSends() << " short sends resumed in order" << std::endl;
+        std::cout << "   ✓ Test passed!" << std::endl;
+
+        std::cout << "\n=== ALL TESTS PASSED! ===" << std::endl;
+        return 0;
+#endif
+    } catch (const std::exception& e) {
+        std::cerr << "ERROR: " << e.what() << std::endl;
+        return 1;
+    }
+}
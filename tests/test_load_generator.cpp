@@ -0,0 +1,131 @@
+// Test the load generator: histogram precision, size distributions, and full runs against
+// the mock server (clean, with wrong CRCs, and with nothing listening).
+#include <iostream>
+#include <string>
+#include <random>
+#include <cstdint>
+#include <exception>
+
+#include "LoadGenerator.h"
+#include "MockBackupServer.h"
+
+int main() {
+    try {
+        std::cout << "=== Load Generator Test ===" << std::endl;
+        std::string error;
+
+        // Test 1: percentiles land within the 6.25% bucket width
+        std::cout << "1. Testing latency histogram..." << std::endl;
+        MetricHistogram histogram, other;
+        for (uint64_t value = 1; value <= 10000; value++) {
+            (value % 2 ? histogram : other).observe(value);
+        }
+        histogram.merge(other);
+        uint64_t p50 = histogram.percentile(50), p99 = histogram.percentile(99);
+        if (histogram.count() != 10000 || histogram.max() != 10000 || p50 < 5000 || p50 > 5000 * 1.0625 ||
+            p99 < 9900 || p99 > 10000 || histogram.percentile(100) != 10000) {
+            std::cout << "   ✗ p50 " << p50 << ", p99 " << p99 << std::endl;
+            return 1;
+        }
+        std::cout << "   ✓ Test passed!" << std::endl;
+
+        // Test 2: distributions parse and draw inside their bounds
+        std::cout << "2. Testing file size distributions..." << std::endl;
+        FileSizeSpec uniform, lognormal, bad;
+        std::mt19937_64 generator(7);
+        bool ok = FileSizeSpec::parse("uniform:4kb-8mb", uniform, error) &&
+                  FileSizeSpec::parse("lognormal:256kb,1.5", lognormal, error) &&
+                  !FileSizeSpec::parse("uniform:8mb-4kb", bad, error) && !FileSizeSpec::parse("normal:1mb", bad, error);
+        for (int i = 0; ok && i < 1000; i++) {
+            uint64_t size = uniform.draw(generator, 1ull << 30);
+            ok = size >= 4096 && size <= 8 * 1024 * 1024 && lognormal.draw(generator, 1024 * 1024) <= 1024 * 1024;
+        }
+        if (!ok) {
+            std::cout << "   ✗ Distribution wrong" << std::endl;
+            return 1;
+        }
+        std::cout << "   ✓ Test passed!" << std::endl;
+
+        MockBackupServer server;
+        if (!server.start(error)) {
+            std::cout << "ERROR: " << error << std::endl;
+            return 1;
+        }
+        LoadOptions options;
+        options.port = server.port();
+        options.sessions = 200;
+        options.concurrency = 100;
+        options.filesPerSession = 2;
+        options.keyPool = 4;
+        options.threads = 2;
+        FileSizeSpec::parse("uniform:1kb-2500kb", options.sizes, error);
+
+        // Test 3: every session completes and each request code gets its latencies
+        std::cout << "3. Testing 200 sessions against the mock server..." << std::endl;
+        {
+            LoadGenerator load(options);
+            if (!load.prepare(error)) {
+                std::cout << "   ✗ " << error << std::endl;
+                return 1;
+            }
+            LoadReport report = load.run();
+            LoadGenerator::printReport(report, std::cout);
+            if (report.sessionsCompleted != 200 || report.sessionsFailed != 0 || report.filesVerified != 400 ||
+                report.requestMicros[1025].count() != 200 || report.requestMicros[1026].count() != 200 ||
+                report.requestMicros[1028].count() != 400 || report.requestMicros[1029].count() != 400 ||
+                server.stats().filesCompleted != 400 || report.sessionMicros.count() != 200) {
+                std::cout << "   ✗ Run incomplete" << std::endl;
+                return 1;
+            }
+        }
+        std::cout << "   ✓ Test passed!" << std::endl;
+
+        // Test 4: wrong CRCs are aborted (1031) and counted, and the sessions still finish
+        std::cout << "4. Testing CRC mismatches..." << std::endl;
+        {
+            MockFaults faults;
+            faults.corruptCrcResponses = 5;
+            server.setFaults(faults);
+            options.sessions = 20;
+            LoadGenerator load(options);
+            if (!load.prepare(error)) {
+                std::cout << "   ✗ " << error << std::endl;
+                return 1;
+            }
+            LoadReport report = load.run();
+            if (report.sessionsCompleted != 20 || report.crcMismatches != 5 || report.filesVerified != 35 ||
+                report.requestMicros[1031].count() != 5) {
+                std::cout << "   ✗ Got " << report.crcMismatches << " mismatches, " << report.filesVerified << " verified"
+                          << std::endl;
+                return 1;
+            }
+        }
+        std::cout << "   ✓ Test passed!" << std::endl;
+
+        // Test 5: failures are reported by stage
+        std::cout << "5. Testing failed connections..." << std::endl;
+        {
+            unsigned short closedPort = server.port();
+            server.stop();
+            options.port = closedPort;
+            options.sessions = 10;
+            LoadGenerator load(options);
+            if (!load.prepare(error)) {
+                std::cout << "   ✗ " << error << std::endl;
+                return 1;
+            }
+            LoadReport report = load.run();
+            if (report.sessionsFailed != 10 || report.failures["connect"] != 10) {
+                std::cout << "   ✗ Failures not attributed to connect" << std::endl;
+                return 1;
+            }
+        }
+        std::cout << "   ✓ Test passed!" << std::endl;
+
+        std::cout << "\n=== ALL TESTS PASSED! ===" << std::endl;
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "ERROR: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,137 @@
+// Test the metrics registry: counters under concurrent updates, histogram precision and
+// exported buckets, the Prometheus text layout (one HELP/TYPE per family, labels,
+// cumulative buckets) and the text file being replaced whole.
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+
+#include "../include/client/Metrics.h"
+
+namespace {
+
+size_t countOf(const std::string& text, const std::string& pattern) {
+    size_t count = 0;
+    for (size_t at = text.find(pattern); at != std::string::npos; at = text.find(pattern, at + 1)) {
+        count++;
+    }
+    return count;
+}
+
+// Value of the sample line starting with prefix, or -1
+double sample(const std::string& text, const std::string& prefix) {
+    std::istringstream lines(text);
+    for (std::string line; std::getline(lines, line);) {
+        if (line.compare(0, prefix.size(), prefix) == 0 && line.size() > prefix.size() && line[prefix.size()] == ' ') {
+            return std::stod(line.substr(prefix.size() + 1));
+        }
+    }
+    return -1;
+}
+
+} // namespace
+
+int main() {
+    try {
+        std::cout << "=== Metrics Test ===" << std::endl;
+        std::string error;
+        MetricsRegistry registry;
+
+        // Test 1: counters lose nothing under concurrent adds, and re-registering returns the same one
+        std::cout << "1. Testing counters..." << std::endl;
+        MetricCounter& sent = registry.counter("backup_client_sent_bytes_total", "Bytes sent");
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; t++) {
+            threads.emplace_back([&sent]() {
+                for (int i = 0; i < 100000; i++) {
+                    sent.add(3);
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        if (sent.value() != 1200000 || &registry.counter("backup_client_sent_bytes_total", "Bytes sent") != &sent) {
+            std::cout << "   ✗ Counter at " << sent.value() << std::endl;
+            return 1;
+        }
+        std::cout << "   ✓ Test passed!" << std::endl;
+
+        // Test 2: percentiles land within the 6.25% bucket width
+        std::cout << "2. Testing histogram precision..." << std::endl;
+        MetricHistogram& rtt = registry.histogram("backup_client_request_rtt_seconds", "RTT", "code=\"1025\"");
+        for (uint64_t micros = 1; micros <= 10000; micros++) {
+            rtt.observe(micros);
+        }
+        uint64_t p50 = rtt.percentile(50), p99 = rtt.percentile(99);
+        if (rtt.count() != 10000 || rtt.sumMicros() != 50005000 || p50 < 5000 || p50 > 5000 * 1.0625 || p99 < 9900 ||
+            p99 > 9900 * 1.0625 || rtt.countAtMost(1024) != 1024 || rtt.countAtMost(16) != 16) {
+            std::cout << "   ✗ p50 " << p50 << ", p99 " << p99 << ", up to 1024us " << rtt.countAtMost(1024) << std::endl;
+            return 1;
+        }
+        std::cout << "   ✓ Test passed!" << std::endl;
+
+        // Test 3: Prometheus text layout
+        std::cout << "3. Testing exposition format..." << std::endl;
+        registry.histogram("backup_client_request_rtt_seconds", "RTT", "code=\"1028\"").observe(2500000);
+        registry.counter("backup_client_retries_total", "Retries", "operation=\"crc\"").add(2);
+        registry.counter("backup_client_retries_total", "Retries", "operation=\"connect\"");
+        std::string text = registry.exposition();
+        double previous = 0;
+        bool cumulative = true;
+        std::istringstream lines(text);
+        for (std::string line; std::getline(lines, line);) {
+            if (line.find("rtt_seconds_bucket{code=\"1025\"") != std::string::npos) {
+                double value = std::stod(line.substr(line.rfind(' ') + 1));
+                cumulative = cumulative && value >= previous;
+                previous = value;
+            }
+        }
+        if (countOf(text, "# TYPE backup_client_request_rtt_seconds histogram\n") != 1 ||
+            countOf(text, "# HELP backup_client_retries_total Retries\n") != 1 || !cumulative || previous != 10000 ||
+            sample(text, "backup_client_request_rtt_seconds_bucket{code=\"1025\",le=\"0.001024\"}") != 1024 ||
+            sample(text, "backup_client_request_rtt_seconds_bucket{code=\"1025\",le=\"0.000016\"}") != 16 ||
+            sample(text, "backup_client_request_rtt_seconds_bucket{code=\"1028\",le=\"2.097152\"}") != 0 ||
+            sample(text, "backup_client_request_rtt_seconds_bucket{code=\"1028\",le=\"4.194304\"}") != 1 ||
+            sample(text, "backup_client_request_rtt_seconds_count{code=\"1028\"}") != 1 ||
+            sample(text, "backup_client_request_rtt_seconds_sum{code=\"1025\"}") != 50.005 ||
+            sample(text, "backup_client_retries_total{operation=\"crc\"}") != 2 ||
+            sample(text, "backup_client_retries_total{operation=\"connect\"}") != 0 ||
+            sample(text, "backup_client_sent_bytes_total") != 1200000 ||
+            text.find("# TYPE backup_client_retries_total counter\nbackup_client_retries_total{operation=\"crc\"}") ==
+                std::string::npos) {
+            std::cout << "   ✗ Exposition wrong:\n" << text << std::endl;
+            return 1;
+        }
+        std::cout << "   ✓ Test passed!" << std::endl;
+
+        // Test 4: the text file is replaced whole; an unwritable path is reported
+        std::cout << "4. Testing text file export..." << std::endl;
+        const std::string path = "test_metrics.prom";
+        std::ofstream(path) << "stale";
+        bool written = registry.writeTextFile(path, error);
+        std::ifstream in(path);
+        std::stringstream contents;
+        contents << in.rdbuf();
+        in.close();
+        std::ifstream temporary(path + ".tmp");
+        if (!written || contents.str() != registry.exposition() || temporary.good() ||
+            registry.writeTextFile("missing_dir/metrics.prom", error)) {
+            std::cout << "   ✗ Export wrong: " << error << std::endl;
+            return 1;
+        }
+        std::remove(path.c_str());
+        std::cout << "   ✓ Test passed!" << std::endl;
+
+        std::cout << "\n=== ALL TESTS PASSED! ===" << std::endl;
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "ERROR: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,310 @@
+// Test the in-process mock backup server with a scripted protocol client: registration, key
+// exchange, a multi-packet upload verified by CRC, and each injected fault (wrong CRC,
+// mid-transfer disconnect, dropped packets, latency, bandwidth cap) followed by the retry or
+// resume a client is expected to perform.
+#include <iostream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <algorithm>
+
+#include "MockBackupServer.h"
+#include "../include/client/cksum.h"
+#include "../include/client/protocol.h"
+#include "../include/wrappers/AESWrapper.h"
+#include "../include/wrappers/RSAWrapper.h"
+
+namespace {
+
+const std::chrono::milliseconds TIMEOUT(5000);
+const size_t PACKET_SIZE = 1024 * 1024;
+
+void putName(std::vector<uint8_t>& out, const std::string& name) {
+    out.insert(out.end(), name.begin(), name.end());
+    out.resize(out.size() + 255 - name.size(), 0);
+}
+
+// One client connection speaking the wire protocol by hand
+struct Session {
+    boost::asio::io_context context;
+    std::unique_ptr<Transport> transport;
+    std::vector<uint8_t> id = std::vector<uint8_t>(16, 0);
+    std::vector<unsigned char> aesKey;
+    std::string name;
+
+    Session(MockBackupServer& server, bool inProcess = false) {
+        if (inProcess) {
+            transport = server.connectInProcess();
+            return;
+        }
+        std::unique_ptr<boost::asio::ip::tcp::socket> socket(new boost::asio::ip::tcp::socket(context));
+        socket->connect({boost::asio::ip::address_v4::loopback(), server.port()});
+        transport.reset(new TcpTransport(context, std::move(socket)));
+    }
+
+    bool send(uint16_t code, const std::vector<uint8_t>& payload) {
+        std::vector<uint8_t> header(id);
+        header.push_back(MockBackupServer::VERSION);
+        appendLE(header, code, 2);
+        appendLE(header, static_cast<uint32_t>(payload.size()), 4);
+        return !transport->write({boost::asio::buffer(header), boost::asio::buffer(payload)}, TIMEOUT);
+    }
+
+    boost::system::error_code receive(uint16_t& code, std::vector<uint8_t>& payload,
+                                      std::chrono::milliseconds timeout = TIMEOUT) {
+        uint8_t header[7];
+        boost::system::error_code ec = transport->read(boost::asio::buffer(header), timeout);
+        if (ec) {
+            return ec;
+        }
+        code = static_cast<uint16_t>(readLE(header + 1, 2));
+        payload.resize(readLE(header + 3, 4));
+        return transport->read(boost::asio::buffer(payload), timeout);
+    }
+
+    // Request/response round trip; returns the response code, 0 on transport failure
+    uint16_t exchange(uint16_t code, const std::vector<uint8_t>& payload, std::vector<uint8_t>& response) {
+        uint16_t responseCode = 0;
+        if (!send(code, payload) || receive(responseCode, response)) {
+            return 0;
+        }
+        return responseCode;
+    }
+
+    uint16_t registerAs(const std::string& clientName) {
+        std::vector<uint8_t> payload, response;
+        putName(payload, clientName);
+        uint16_t code = exchange(REQ_REGISTER, payload, response);
+        if (code == RESP_REGISTER_OK && response.size() == 16) {
+            id = response;
+            name = clientName;
+        }
+        return code;
+    }
+
+    // 1026 (key exchange) or 1027 (reconnect); unwraps the session key on success
+    uint16_t requestKey(RSAPrivateWrapper& rsa, bool reconnect) {
+        std::vector<uint8_t> payload, response;
+        putName(payload, name);
+        if (!reconnect) {
+            std::string publicKey = rsa.getPublicKey();
+            publicKey.resize(MockBackupServer::PUBLIC_KEY_SIZE, '\0');
+            payload.insert(payload.end(), publicKey.begin(), publicKey.end());
+        }
+        uint16_t code = exchange(reconnect ? REQ_RECONNECT : REQ_SEND_PUBLIC_KEY, payload, response);
+        if ((code == RESP_PUBKEY_AES_SENT || code == RESP_RECONNECT_AES_SENT) && response.size() > 16) {
+            std::string key = rsa.decrypt(std::string(response.begin() + 16, response.end()));
+            aesKey.assign(key.begin(), key.end());
+        }
+        return code;
+    }
+
+    // Encrypt and send data as 1 MB packets; false if any write fails
+    bool sendFile(const std::string& filename, const std::vector<uint8_t>& data) {
+        AESWrapper aes(aesKey.data(), aesKey.size());
+        std::string encrypted = aes.encrypt(reinterpret_cast<const char*>(data.data()), data.size());
+        uint16_t total = static_cast<uint16_t>((encrypted.size() + PACKET_SIZE - 1) / PACKET_SIZE);
+        for (uint16_t packet = 1; packet <= total; packet++) {
+            size_t offset = (packet - 1) * PACKET_SIZE;
+            size_t length = std::min(PACKET_SIZE, encrypted.size() - offset);
+            std::vector<uint8_t> payload;
+            appendLE(payload, static_cast<uint32_t>(length), 4);
+            appendLE(payload, static_cast<uint32_t>(data.size()), 4);
+            appendLE(payload, packet, 2);
+            appendLE(payload, total, 2);
+            putName(payload, filename);
+            payload.insert(payload.end(), encrypted.begin() + offset, encrypted.begin() + offset + length);
+            if (!send(REQ_SEND_FILE, payload)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // sendFile and wait for 1603; returns the server's CRC in crc
+    bool upload(const std::string& filename, const std::vector<uint8_t>& data, uint32_t& crc) {
+        uint16_t code = 0;
+        std::vector<uint8_t> response;
+        if (!sendFile(filename, data) || receive(code, response) || code != RESP_FILE_CRC || response.size() != 279) {
+            return false;
+        }
+        crc = readLE(response.data() + 275, 4);
+        return true;
+    }
+
+    uint16_t crcReply(uint16_t code, const std::string& filename) {
+        std::vector<uint8_t> payload, response;
+        putName(payload, filename);
+        return exchange(code, payload, response);
+    }
+};
+
+std::vector<uint8_t> testData(size_t size) {
+    std::vector<uint8_t> data(size);
+    uint32_t state = 0x12345678;
+    for (auto& byte : data) {
+        state ^= state << 13; state ^= state >> 17; state ^= state << 5;
+        byte = static_cast<uint8_t>(state);
+    }
+    return data;
+}
+
+} // namespace
+
+int main() {
+    try {
+        std::cout << "=== Mock Backup Server Test ===" << std::endl;
+
+        MockBackupServer server;
+        std::string error;
+        if (!server.start(error)) {
+            std::cout << "ERROR: " << error << std::endl;
+            return 1;
+        }
+        RSAPrivateWrapper rsa;
+        const std::vector<uint8_t> data = testData(3 * 1024 * 1024 - 1000);
+        const uint32_t expectedCrc = calculateCRC(data.data(), data.size());
+
+        // Test 1: registration, and a second client with the same name is refused
+        std::cout << "1. Testing registration..." << std::endl;
+        Session session(server);
+        Session duplicate(server);
+        if (session.registerAs("alice") != RESP_REGISTER_OK || duplicate.registerAs("alice") != RESP_REGISTER_FAIL) {
+            std::cout << "   ✗ Registration responses wrong" << std::endl;
+            return 1;
+        }
+        std::cout << "   ✓ Test passed!" << std::endl;
+
+        // Test 2: public key in, wrapped AES key out
+        std::cout << "2. Testing key exchange..." << std::endl;
+        if (session.requestKey(rsa, false) != RESP_PUBKEY_AES_SENT || session.aesKey.size() != AESWrapper::DEFAULT_KEYLENGTH) {
+            std::cout << "   ✗ Key exchange failed" << std::endl;
+            return 1;
+        }
+        std::cout << "   ✓ Test passed!" << std::endl;
+
+        // Test 3: a 3-packet upload is reassembled, decrypted and CRC-matched
+        std::cout << "3. Testing multi-packet upload..." << std::endl;
+        uint32_t crc = 0;
+        std::vector<uint8_t> stored;
+        if (!session.upload("file.bin", data, crc) || crc != expectedCrc || session.crcReply(REQ_CRC_OK, "file.bin") != RESP_ACK ||
+            !server.receivedFile("file.bin", stored) || stored != data) {
+            std::cout << "   ✗ Upload not verified (crc " << crc << ", expected " << expectedCrc << ")" << std::endl;
+            return 1;
+        }
+        std::cout << "   ✓ Test passed!" << std::endl;
+
+        // Test 4: a wrong CRC, answered with 1030 and a resend
+        std::cout << "4. Testing CRC mismatch and retry..." << std::endl;
+        MockFaults faults;
+        faults.corruptCrcResponses = 1;
+        server.setFaults(faults);
+        uint32_t bad = 0, good = 0;
+        if (!session.upload("file.bin", data, bad) || bad == expectedCrc || session.crcReply(REQ_CRC_RETRY, "file.bin") != RESP_ACK ||
+            !session.upload("file.bin", data, good) || good != expectedCrc || server.stats().crcCorrupted != 1) {
+            std::cout << "   ✗ CRC fault not injected or retry failed" << std::endl;
+            return 1;
+        }
+        std::cout << "   ✓ Test passed!" << std::endl;
+
+        // Test 5: the server drops the connection mid-file; reconnect (1027) and resend
+        std::cout << "5. Testing mid-transfer disconnect and resume..." << std::endl;
+        faults = MockFaults();
+        faults.disconnectAfterBytes = 1500 * 1024;
+        faults.disconnects = 1;
+        server.setFaults(faults);
+        {
+            Session broken(server);
+            broken.id = session.id;
+            broken.name = session.name;
+            uint32_t ignored = 0;
+            if (broken.requestKey(rsa, true) != RESP_RECONNECT_AES_SENT || broken.upload("resume.bin", data, ignored)) {
+                std::cout << "   ✗ Connection survived the disconnect fault" << std::endl;
+                return 1;
+            }
+        }
+        Session resumed(server);
+        resumed.id = session.id;
+        resumed.name = session.name;
+        if (resumed.requestKey(rsa, true) != RESP_RECONNECT_AES_SENT || !resumed.upload("resume.bin", data, crc) || crc != expectedCrc ||
+            server.stats().disconnects != 1) {
+            std::cout << "   ✗ Resume after disconnect failed" << std::endl;
+            return 1;
+        }
+        std::cout << "   ✓ Test passed!" << std::endl;
+
+        // Test 6: dropped packets leave the client waiting; a full resend completes the file
+        std::cout << "6. Testing dropped packets..." << std::endl;
+        faults = MockFaults();
+        faults.packetDropRate = 1.0;
+        server.setFaults(faults);
+        uint16_t code = 0;
+        std::vector<uint8_t> response;
+        if (!resumed.sendFile("dropped.bin", data) ||
+            resumed.receive(code, response, std::chrono::milliseconds(300)) != boost::asio::error::timed_out) {
+            std::cout << "   ✗ Expected no response for dropped packets" << std::endl;
+            return 1;
+        }
+        server.setFaults(MockFaults());
+        if (!resumed.upload("dropped.bin", data, crc) || crc != expectedCrc || server.stats().packetsDropped != 3) {
+            std::cout << "   ✗ Resend after drops failed" << std::endl;
+            return 1;
+        }
+        std::cout << "   ✓ Test passed!" << std::endl;
+
+        // Test 7: response latency is added to every round trip
+        std::cout << "7. Testing response latency..." << std::endl;
+        faults = MockFaults();
+        faults.responseLatency = std::chrono::milliseconds(50);
+        server.setFaults(faults);
+        auto start = std::chrono::steady_clock::now();
+        code = resumed.crcReply(REQ_CRC_OK, "dropped.bin");
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+        if (code != RESP_ACK || elapsed.count() < 50) {
+            std::cout << "   ✗ Round trip took " << elapsed.count() << " ms" << std::endl;
+            return 1;
+        }
+        std::cout << "   Round trip: " << elapsed.count() << " ms" << std::endl;
+        std::cout << "   ✓ Test passed!" << std::endl;
+
+        // Test 8: a 4 MB/s cap makes a 3 MB upload take most of a second
+        std::cout << "8. Testing bandwidth cap..." << std::endl;
+        faults = MockFaults();
+        faults.bandwidthBytesPerSecond = 4 * 1024 * 1024;
+        server.setFaults(faults);
+        {
+            Session shaped(server);
+            shaped.id = session.id;
+            shaped.name = session.name;
+            start = std::chrono::steady_clock::now();
+            bool ok = shaped.requestKey(rsa, true) == RESP_RECONNECT_AES_SENT && shaped.upload("shaped.bin", data, crc) && crc == expectedCrc;
+            elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+            if (!ok || elapsed.count() < 600) {
+                std::cout << "   ✗ Upload took " << elapsed.count() << " ms" << std::endl;
+                return 1;
+            }
+            std::cout << "   3 MB in " << elapsed.count() << " ms" << std::endl;
+        }
+        server.setFaults(MockFaults());
+        std::cout << "   ✓ Test passed!" << std::endl;
+
+        // Test 9: the same protocol over an in-process pipe
+        std::cout << "9. Testing in-process connection..." << std::endl;
+        Session local(server, true);
+        if (local.registerAs("bob") != RESP_REGISTER_OK || local.requestKey(rsa, false) != RESP_PUBKEY_AES_SENT ||
+            !local.upload("local.bin", data, crc) || crc != expectedCrc) {
+            std::cout << "   ✗ In-process exchange failed" << std::endl;
+            return 1;
+        }
+        std::cout << "   ✓ Test passed!" << std::endl;
+
+        server.stop();
+        std::cout << "\n=== ALL TESTS PASSED! ===" << std::endl;
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "ERROR: " << e.what() << std::endl;
+        return 1;
+    }
+}
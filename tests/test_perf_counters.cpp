@@ -0,0 +1,149 @@
+// Test the performance counter profiler: count arithmetic, nothing recorded while disabled,
+// a thread's group counting CPU time (and hardware events where the CPU exposes them),
+// nested stage scopes, and one set of totals per thread.
+// Prints a skip notice (and passes) where perf_event_open is unavailable.
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+
+#include "../include/client/PerfCounters.h"
+
+namespace {
+
+// Keeps the CPU busy for about the given time
+uint64_t spin(std::chrono::milliseconds duration) {
+    volatile uint64_t sink = 0;
+    auto until = std::chrono::steady_clock::now() + duration;
+    while (std::chrono::steady_clock::now() < until) {
+        for (int i = 0; i < 1000; i++) {
+            sink = sink * 31 + i;
+        }
+    }
+    return sink;
+}
+
+} // namespace
+
+int main() {
+    try {
+        std::cout << "=== Performance Counter Test ===" << std::endl;
+
+        // Test 1: differences clamp at zero, IPC needs both counters
+        std::cout << "1. Testing count arithmetic..." << std::endl;
+        PerfCounts before, after;
+        before.values[static_cast<int>(PerfEvent::Cycles)] = 1000;
+        after.values[static_cast<int>(PerfEvent::Cycles)] = 3000;
+        after.values[static_cast<int>(PerfEvent::Instructions)] = 5000;
+        PerfCounts delta = after - before;
+        PerfCounts backwards = before - after;
+        delta += delta;
+        if (delta[PerfEvent::Cycles] != 4000 || delta[PerfEvent::Instructions] != 10000 || delta.ipc() != 2.5 ||
+            backwards[PerfEvent::Cycles] != 0 || PerfCounts().ipc() != 0.0) {
+            std::cout << "   ✗ Arithmetic wrong" << std::endl;
+            return 1;
+        }
+        std::cout << "   ✓ Test passed!" << std::endl;
+
+        // Test 2: scopes record nothing until profiling is enabled
+        std::cout << "2. Testing disabled profiler..." << std::endl;
+        {
+            PerfScope scope("ignored");
+            spin(std::chrono::milliseconds(1));
+        }
+        if (PerfProfiler::enabled() || !PerfProfiler::totals().empty()) {
+            std::cout << "   ✗ Stage recorded while disabled" << std::endl;
+            return 1;
+        }
+        std::cout << "   ✓ Test passed!" << std::endl;
+
+        // Test 3: the calling thread's group counts its CPU time and hardware events
+        std::cout << "3. Testing counter group..." << std::endl;
+        std::string error;
+        PerfCounterGroup group;
+        if (!group.open(error)) {
+            std::cout << "   perf_event_open unavailable (" << error << ") - skipped" << std::endl;
+            std::cout << "\n=== ALL TESTS PASSED! ===" << std::endl;
+            return 0;
+        }
+        PerfCounts start, end;
+        group.read(start);
+        spin(std::chrono::milliseconds(30));
+        group.read(end);
+        PerfCounts busy = end - start;
+        std::cout << "   Kernel counted: " << (group.includesKernel() ? "yes" : "no (user only)") << std::endl;
+        for (int i = 1; i < static_cast<int>(PerfEvent::Count); i++) {
+            std::cout << "   " << PerfCounterGroup::eventName(static_cast<PerfEvent>(i)) << ": "
+                      << (group.available(static_cast<PerfEvent>(i)) ? std::to_string(busy.values[i]) : "unavailable")
+                      << std::endl;
+        }
+        bool hardware = group.available(PerfEvent::Cycles) && group.available(PerfEvent::Instructions);
+        if (busy[PerfEvent::TaskClock] < 20000000 || busy[PerfEvent::TaskClock] > 1000000000 ||
+            (hardware && (busy[PerfEvent::Cycles] == 0 || busy.ipc() <= 0.0))) {
+            std::cout << "   ✗ 30ms busy loop counted " << busy[PerfEvent::TaskClock] << "ns on the CPU" << std::endl;
+            return 1;
+        }
+        std::cout << "   ✓ Test passed!" << std::endl;
+
+        // Test 4: nested stages each count in full; a sleeping stage uses almost no CPU
+        std::cout << "4. Testing stage scopes..." << std::endl;
+        if (!PerfProfiler::enable(error)) {
+            std::cout << "   ✗ Enable failed: " << error << std::endl;
+            return 1;
+        }
+        PerfProfiler::nameThread("main");
+        for (int i = 0; i < 3; i++) {
+            PerfScope outer("transfer");
+            {
+                PerfScope inner("encrypt");
+                spin(std::chrono::milliseconds(10));
+            }
+            PerfScope wait("crc wait");
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        PerfProfiler::StageTotals transfer, encrypt, wait;
+        if (!PerfProfiler::stageTotals("main", "transfer", transfer) || !PerfProfiler::stageTotals("main", "encrypt", encrypt) ||
+            !PerfProfiler::stageTotals("main", "crc wait", wait) || transfer.calls != 3 || encrypt.calls != 3 ||
+            encrypt.counts[PerfEvent::TaskClock] < 20000000 ||
+            transfer.counts[PerfEvent::TaskClock] < encrypt.counts[PerfEvent::TaskClock] ||
+            wait.counts[PerfEvent::TaskClock] * 4 > encrypt.counts[PerfEvent::TaskClock]) {
+            std::cout << "   ✗ Stage totals wrong: encrypt " << encrypt.counts[PerfEvent::TaskClock] << "ns, wait "
+                      << wait.counts[PerfEvent::TaskClock] << "ns" << std::endl;
+            return 1;
+        }
+        std::cout << "   ✓ Test passed!" << std::endl;
+
+        // Test 5: every thread gets its own group and totals
+        std::cout << "5. Testing per-thread totals..." << std::endl;
+        PerfProfiler::clear();
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 2; t++) {
+            threads.emplace_back([t]() {
+                PerfProfiler::nameThread(t == 0 ? "worker 0" : "worker 1");
+                PerfScope scope("crc");
+                spin(std::chrono::milliseconds(10 + 20 * t));
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        PerfProfiler::StageTotals first, second;
+        if (PerfProfiler::totals().size() != 2 || !PerfProfiler::stageTotals("worker 0", "crc", first) ||
+            !PerfProfiler::stageTotals("worker 1", "crc", second) ||
+            second.counts[PerfEvent::TaskClock] <= first.counts[PerfEvent::TaskClock]) {
+            std::cout << "   ✗ Expected one crc stage per worker, got " << PerfProfiler::totals().size() << std::endl;
+            return 1;
+        }
+        PerfProfiler::disable();
+        std::cout << "   ✓ Test passed!" << std::endl;
+
+        std::cout << "\n=== ALL TESTS PASSED! ===" << std::endl;
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "ERROR: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,116 @@
+// Test the thread-local ChaCha20 DRBG used for AES keys, IVs and nonces
+#include <iostream>
+#include <vector>
+#include <set>
+#include <string>
+#include <thread>
+#include <chrono>
+#include <cstring>
+#include <exception>
+
+#include "../include/wrappers/SecureRandom.h"
+
+static std::string toKey(const unsigned char* data, size_t size) {
+    return std::string(reinterpret_cast<const char*>(data), size);
+}
+
+int main() {
+    try {
+        std::cout << "=== SecureRandom (ChaCha20 DRBG) Test ===" << std::endl;
+
+        // Test 1: consecutive IV-sized draws never repeat
+        std::cout << "1. Testing 100000 unique 16-byte values..." << std::endl;
+        std::set<std::string> seen;
+        unsigned char iv[16];
+        for (int i = 0; i < 100000; i++) {
+            SecureRandom::generate(iv, sizeof(iv));
+            if (!seen.insert(toKey(iv, sizeof(iv))).second) {
+                std::cout << "   ✗ Duplicate value after " << i << " draws!" << std::endl;
+                return 1;
+            }
+        }
+        std::cout << "   ✓ Test passed!" << std::endl;
+
+        // Test 2: bulk fill spanning several refills and a reseed has a sane byte distribution
+        std::cout << "2. Testing 4MB bulk fill distribution..." << std::endl;
+        std::vector<unsigned char> bulk(4 * 1024 * 1024);
+        SecureRandom::generate(bulk.data(), bulk.size());
+        std::vector<size_t> histogram(256, 0);
+        for (unsigned char b : bulk) {
+            histogram[b]++;
+        }
+        const double expected = bulk.size() / 256.0;
+        for (size_t count : histogram) {
+            if (count < expected * 0.95 || count > expected * 1.05) {
+                std::cout << "   ✗ Byte histogram out of range: " << count << std::endl;
+                return 1;
+            }
+        }
+        std::cout << "   ✓ Test passed!" << std::endl;
+
+        // Test 3: threads get independent streams
+        std::cout << "3. Testing per-thread generators are independent..." << std::endl;
+        unsigned char a[32], b[32];
+        std::thread t1([&]() { SecureRandom::generate(a, sizeof(a)); });
+        std::thread t2([&]() { SecureRandom::generate(b, sizeof(b)); });
+        t1.join();
+        t2.join();
+        if (toKey(a, sizeof(a)) == toKey(b, sizeof(b))) {
+            std::cout << "   ✗ Two threads produced identical output!" << std::endl;
+            return 1;
+        }
+        std::cout << "   ✓ Test passed!" << std::endl;
+
+        // Test 4: explicit reseed keeps producing fresh output
+        std::cout << "4. Testing explicit reseed..." << std::endl;
+        unsigned char before[32], after[32];
+        SecureRandom::generate(before, sizeof(before));
+        SecureRandom::reseed();
+        SecureRandom::generate(after, sizeof(after));
+        if (toKey(before, sizeof(before)) == toKey(after, sizeof(after))) {
+            std::cout << "   ✗ Output repeated across reseed!" << std::endl;
+            return 1;
+        }
+        std::cout << "   ✓ Test passed!" << std::endl;
+
+        // Test 5: the block function matches the RFC 8439 section 2.3.2 test vector
+        std::cout << "5. Testing ChaCha20 block known answer..." << std::endl;
+        unsigned char key[SecureRandom::KEY_SIZE];
+        for (size_t i = 0; i < sizeof(key); i++) {
+            key[i] = static_cast<unsigned char>(i);
+        }
+        const unsigned char nonce[SecureRandom::NONCE_SIZE] = {0x00, 0x00, 0x00, 0x09, 0x00, 0x00, 0x00, 0x4a,
+                                                               0x00, 0x00, 0x00, 0x00};
+        const unsigned char expectedBlock[SecureRandom::BLOCK_SIZE] = {
+            0x10, 0xf1, 0xe7, 0xe4, 0xd1, 0x3b, 0x59, 0x15, 0x50, 0x0f, 0xdd, 0x1f, 0xa3, 0x20, 0x71, 0xc4,
+            0xc7, 0xd1, 0xf4, 0xc7, 0x33, 0xc0, 0x68, 0x03, 0x04, 0x22, 0xaa, 0x9a, 0xc3, 0xd4, 0x6c, 0x4e,
+            0xd2, 0x82, 0x64, 0x46, 0x07, 0x9f, 0xaa, 0x09, 0x14, 0xc2, 0xd7, 0x05, 0xd9, 0x8b, 0x02, 0xa2,
+            0xb5, 0x12, 0x9c, 0xd1, 0xde, 0x16, 0x4e, 0xb9, 0xcb, 0xd0, 0x83, 0xe8, 0xa2, 0x50, 0x3c, 0x4e};
+        unsigned char block[SecureRandom::BLOCK_SIZE];
+        SecureRandom::chachaBlock(key, 1, nonce, block);
+        if (std::memcmp(block, expectedBlock, sizeof(block)) != 0) {
+            std::cout << "   ✗ Keystream block differs from RFC 8439" << std::endl;
+            return 1;
+        }
+        std::cout << "   ✓ Test passed!" << std::endl;
+
+        // Test 6: throughput of small (IV-sized) requests
+        std::cout << "6. Measuring small-request throughput..." << std::endl;
+        auto start = std::chrono::steady_clock::now();
+        const int draws = 1000000;
+        for (int i = 0; i < draws; i++) {
+            SecureRandom::generate(iv, sizeof(iv));
+        }
+        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        std::cout << "   " << draws << " x 16 bytes in " << elapsed / 1000.0 << " ms ("
+                  << (elapsed * 1000.0 / draws) << " ns per IV)" << std::endl;
+        std::cout << "   ✓ Test passed!" << std::endl;
+
+        std::cout << "\n=== ALL TESTS PASSED! ===" << std::endl;
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "ERROR: " << e.what() << std::endl;
+        return 1;
+    }
+}
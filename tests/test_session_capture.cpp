@@ -0,0 +1,260 @@
+// Test session capture and replay: the writer/reader round trip (no payload bytes kept),
+// rejection of damaged files, and replays of a two-connection capture against the mock
+// server at recorded pace, ten times faster, and as several clients at once.
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <algorithm>
+
+#include "CaptureReplayer.h"
+#include "MockBackupServer.h"
+#include "../include/client/protocol.h"
+
+namespace {
+
+void putVarint(std::vector<uint8_t>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+std::vector<uint8_t> requestHeader(uint16_t code, uint32_t size) {
+    std::vector<uint8_t> header(16, 0xAB);
+    header.push_back(PROTOCOL_VERSION);
+    appendLE(header, code, 2);
+    appendLE(header, size, 4);
+    return header;
+}
+
+std::vector<uint8_t> fileMetadata(uint32_t encryptedSize, uint32_t originalSize, uint16_t packet, uint16_t total,
+                                  const std::string& name) {
+    std::vector<uint8_t> metadata;
+    appendLE(metadata, encryptedSize, 4);
+    appendLE(metadata, originalSize, 4);
+    appendLE(metadata, packet, 2);
+    appendLE(metadata, total, 2);
+    metadata.insert(metadata.end(), name.begin(), name.end());
+    metadata.resize(metadata.size() + 255 - name.size(), 0);
+    return metadata;
+}
+
+// Hand-written capture so that the timing is exact; delays are in microseconds
+class CaptureBuilder {
+public:
+    CaptureBuilder() : bytes(CaptureWriter::MAGIC, CaptureWriter::MAGIC + sizeof(CaptureWriter::MAGIC)) {}
+
+    void open(uint64_t delay) { begin(1, delay); }
+    void close(uint64_t delay) { begin(4, delay); }
+    void request(uint64_t delay, uint16_t code, uint32_t size) {
+        begin(2, delay);
+        appendLE(bytes, code, 2);
+        putVarint(bytes, size);
+        bytes.push_back(0);
+    }
+    void packet(uint64_t delay, uint32_t originalSize, uint16_t packet, uint16_t total, uint32_t fileIndex) {
+        begin(2, delay);
+        appendLE(bytes, REQ_SEND_FILE, 2);
+        putVarint(bytes, FILE_PACKET_HEADER_SIZE + originalSize / total);
+        bytes.push_back(1);
+        putVarint(bytes, originalSize);
+        putVarint(bytes, packet);
+        putVarint(bytes, total);
+        putVarint(bytes, fileIndex);
+    }
+    void response(uint64_t delay, uint16_t code, uint32_t size) {
+        begin(3, delay);
+        appendLE(bytes, code, 2);
+        putVarint(bytes, size);
+    }
+    bool save(const std::string& filename) const {
+        std::ofstream out(filename, std::ios::binary);
+        out.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+        return static_cast<bool>(out);
+    }
+
+private:
+    void begin(uint8_t kind, uint64_t delay) {
+        bytes.push_back(kind);
+        putVarint(bytes, delay);
+    }
+
+    std::vector<uint8_t> bytes;
+};
+
+// Register, key exchange, a 3-packet file confirmed by 1029; then a reconnect and a
+// 1-packet file aborted by 1031. About 400ms end to end.
+void buildSession(CaptureBuilder& capture) {
+    capture.open(0);
+    capture.request(1000, REQ_NEGOTIATE_CAPS, 2);   // Capabilities: skipped
+    capture.response(500, RESP_CAPS_ACCEPTED, 2);
+    capture.request(1000, REQ_REGISTER, 255);
+    capture.response(2000, RESP_REGISTER_OK, 16);
+    capture.request(1000, REQ_SEND_PUBLIC_KEY, 417);
+    capture.response(5000, RESP_PUBKEY_AES_SENT, 144);
+    capture.packet(1000, 100000, 1, 3, 0);
+    capture.packet(1000, 100000, 2, 3, 0);
+    capture.packet(1000, 100000, 3, 3, 0);
+    capture.response(8000, RESP_FILE_CRC, 279);
+    capture.request(1000, REQ_CRC_OK, 255);
+    capture.response(500, RESP_ACK, 16);
+    capture.close(100000);
+    capture.open(200000);
+    capture.request(1000, REQ_RESUME_SESSION, 255);   // Resume: replayed as 1027
+    capture.response(3000, RESP_RESUME_OK, 144);
+    capture.packet(1000, 5000, 1, 1, 1);
+    capture.response(2000, RESP_FILE_CRC, 279);
+    capture.request(1000, REQ_CRC_ABORT, 255);
+    capture.response(500, RESP_ACK, 16);
+    capture.close(70000);
+}
+
+} // namespace
+
+int main() {
+    try {
+        std::cout << "=== Session Capture Test ===" << std::endl;
+        std::string error;
+        const std::string capturePath = "test_session_capture.bin";
+        const std::string replayPath = "test_session_replay.bin";
+
+        // Test 1: records survive a round trip; names become indexes and no payload is kept
+        std::cout << "1. Testing capture round trip..." << std::endl;
+        {
+            CaptureWriter writer;
+            if (!writer.open(capturePath, error)) {
+                std::cout << "   ✗ " << error << std::endl;
+                return 1;
+            }
+            writer.connectionOpened();
+            writer.request(requestHeader(REQ_REGISTER, 255).data(), nullptr);
+            writer.response(RESP_REGISTER_OK, 16);
+            for (uint16_t packet = 1; packet <= 2; packet++) {
+                std::vector<uint8_t> header = requestHeader(REQ_SEND_FILE, FILE_PACKET_HEADER_SIZE + 4096);
+                writer.request(header.data(), fileMetadata(4096, 8000, packet, 2, "secret_plans.docx").data());
+            }
+            writer.request(requestHeader(REQ_SEND_FILE, FILE_PACKET_HEADER_SIZE + 64).data(), fileMetadata(64, 50, 1, 1, "notes.txt").data());
+            writer.response(RESP_FILE_CRC, 279);
+            writer.connectionClosed();
+            writer.close();
+        }
+        std::vector<CaptureRecord> records;
+        std::ifstream raw(capturePath, std::ios::binary);
+        std::string contents((std::istreambuf_iterator<char>(raw)), std::istreambuf_iterator<char>());
+        bool ok = readCapture(capturePath, records, error) && records.size() == 8 &&
+                  records[0].kind == CaptureRecord::Kind::Open && records[1].code == REQ_REGISTER &&
+                  records[1].payloadSize == 255 && !records[1].filePacket && records[2].code == RESP_REGISTER_OK &&
+                  records[3].filePacket && records[3].fileIndex == 0 && records[3].originalSize == 8000 &&
+                  records[4].packet == 2 && records[4].totalPackets == 2 && records[4].payloadSize == FILE_PACKET_HEADER_SIZE + 4096 &&
+                  records[5].fileIndex == 1 && records[7].kind == CaptureRecord::Kind::Close &&
+                  std::is_sorted(records.begin(), records.end(),
+                                 [](const CaptureRecord& a, const CaptureRecord& b) { return a.micros < b.micros; });
+        if (!ok || contents.size() > 80 || contents.find("secret") != std::string::npos ||
+            contents.find(std::string(4, '\xAB')) != std::string::npos) {
+            std::cout << "   ✗ Round trip wrong (" << contents.size() << " bytes) " << error << std::endl;
+            return 1;
+        }
+        std::cout << "   ✓ Test passed!" << std::endl;
+
+        // Test 2: a truncated capture or a foreign file is refused
+        std::cout << "2. Testing damaged captures..." << std::endl;
+        {
+            std::ofstream(capturePath, std::ios::binary | std::ios::trunc).write(contents.data(), contents.size() - 3);   // Mid-record
+        }
+        bool truncatedRefused = !readCapture(capturePath, records, error);
+        {
+            std::ofstream(capturePath, std::ios::binary | std::ios::trunc) << "not a capture";
+        }
+        if (!truncatedRefused || readCapture(capturePath, records, error) || readCapture("missing.bin", records, error)) {
+            std::cout << "   ✗ Damaged capture accepted" << std::endl;
+            return 1;
+        }
+        std::cout << "   ✓ Test passed!" << std::endl;
+
+        MockBackupServer server;
+        if (!server.start(error)) {
+            std::cout << "ERROR: " << error << std::endl;
+            return 1;
+        }
+        CaptureBuilder capture;
+        buildSession(capture);
+        if (!capture.save(replayPath)) {
+            std::cout << "ERROR: cannot write " << replayPath << std::endl;
+            return 1;
+        }
+        ReplayOptions options;
+        options.port = server.port();
+        options.timeout = std::chrono::milliseconds(5000);
+
+        // Test 3: the capture replays at recorded pace with matching response codes
+        std::cout << "3. Testing replay at recorded pace..." << std::endl;
+        double recordedPace = 0;
+        {
+            CaptureReplayer replayer(options);
+            if (!replayer.add(replayPath, error)) {
+                std::cout << "   ✗ " << error << std::endl;
+                return 1;
+            }
+            ReplayReport report = replayer.run();
+            CaptureReplayer::printReport(report, std::cout);
+            std::vector<uint8_t> file;
+            if (report.capturesCompleted != 1 || report.requests != 9 || report.skipped != 1 ||
+                report.codeMismatches != 0 || !server.receivedFile("replay_0.bin", file) || file.size() != 100000 ||
+                report.replayedMicros[REQ_SEND_FILE].count() != 2 || report.capturedMicros[REQ_REGISTER].max() != 2000 ||
+                server.stats().filesCompleted != 2 || report.seconds < 0.39) {
+                std::cout << "   ✗ Replay wrong" << std::endl;
+                return 1;
+            }
+            recordedPace = report.seconds;
+        }
+        std::cout << "   ✓ Test passed!" << std::endl;
+
+        // Test 4: speed 10 keeps the shape but compresses the waits
+        std::cout << "4. Testing replay ten times faster..." << std::endl;
+        {
+            options.speed = 10;
+            CaptureReplayer replayer(options);
+            replayer.add(replayPath, error);
+            ReplayReport report = replayer.run();
+            if (report.capturesCompleted != 1 || report.codeMismatches != 0 || report.seconds > recordedPace / 2) {
+                std::cout << "   ✗ Took " << report.seconds << " s against " << recordedPace << " s" << std::endl;
+                return 1;
+            }
+        }
+        std::cout << "   ✓ Test passed!" << std::endl;
+
+        // Test 5: several captures run at once as separate clients
+        std::cout << "5. Testing concurrent captures..." << std::endl;
+        {
+            options.speed = 0;
+            uint64_t registered = server.stats().requests[REQ_REGISTER];
+            CaptureReplayer replayer(options);
+            for (int i = 0; i < 4; i++) {
+                replayer.add(replayPath, error);
+            }
+            ReplayReport report = replayer.run();
+            if (report.capturesCompleted != 4 || report.codeMismatches != 0 || report.requests != 36 ||
+                server.stats().requests[REQ_REGISTER] != registered + 4) {
+                std::cout << "   ✗ " << report.capturesCompleted << " of 4 completed" << std::endl;
+                for (const auto& failure : report.errors) {
+                    std::cout << "     " << failure << std::endl;
+                }
+                return 1;
+            }
+        }
+        std::cout << "   ✓ Test passed!" << std::endl;
+
+        std::remove(capturePath.c_str());
+        std::remove(replayPath.c_str());
+        std::cout << "\n=== ALL TESTS PASSED! ===" << std::endl;
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "ERROR: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,111 @@
+// Test socket tuning: profile parsing, bandwidth-delay products, buffer sizing applied to a
+// loopback connection (a set buffer never ends up below what autotuning would reach), and
+// corking around a write that must still reach the peer.
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <exception>
+
+#include "../include/client/SocketTuning.h"
+
+namespace {
+
+// Third field of /proc/sys/net/ipv4/tcp_wmem or tcp_rmem, 0 if unreadable
+long long autotuneLimit(const char* path) {
+    std::ifstream file(path);
+    long long minimum = 0, initial = 0, maximum = 0;
+    return file >> minimum >> initial >> maximum ? maximum : 0;
+}
+
+} // namespace
+
+int main() {
+    try {
+        std::cout << "=== SocketTuning Test ===" << std::endl;
+
+        // Test 1: profile names
+        std::cout << "1. Testing profile parsing..." << std::endl;
+        NetworkProfile profile = NetworkProfile::LAN;
+        if (!parseNetworkProfile("wan", profile) || profile != NetworkProfile::WAN ||
+            !parseNetworkProfile("lan", profile) || profile != NetworkProfile::LAN ||
+            parseNetworkProfile("WAN ", profile) || parseNetworkProfile("", profile)) {
+            std::cout << "   ✗ Profile names parsed incorrectly" << std::endl;
+            return 1;
+        }
+        std::cout << "   ✓ Test passed!" << std::endl;
+
+        // Test 2: BDP of each profile
+        std::cout << "2. Testing bandwidth-delay products..." << std::endl;
+        uint64_t lanBdp = SocketTuning::bandwidthDelayProduct(profileOptions(NetworkProfile::LAN));
+        uint64_t wanBdp = SocketTuning::bandwidthDelayProduct(profileOptions(NetworkProfile::WAN));
+        std::cout << "   LAN " << lanBdp << " bytes, WAN " << wanBdp << " bytes" << std::endl;
+        if (lanBdp != 1250000 || wanBdp != 12500000) {
+            std::cout << "   ✗ Unexpected BDP" << std::endl;
+            return 1;
+        }
+        std::cout << "   ✓ Test passed!" << std::endl;
+
+        // Test 3: apply both profiles to a loopback connection
+        std::cout << "3. Testing tuning a connected socket..." << std::endl;
+        using boost::asio::ip::tcp;
+        boost::asio::io_context ioContext;
+        tcp::acceptor acceptor(ioContext, tcp::endpoint(boost::asio::ip::address_v4::loopback(), 0));
+        for (NetworkProfile tested : {NetworkProfile::LAN, NetworkProfile::WAN}) {
+            tcp::socket client(ioContext), peer(ioContext);
+            client.connect(acceptor.local_endpoint());
+            acceptor.accept(peer);
+
+            SocketTuningOptions options = profileOptions(tested);
+            SocketTuningResult result = SocketTuning::apply(client, options);
+            std::cout << "   " << networkProfileName(tested) << ": " << result.summary() << std::endl;
+            if (result.sendBufferBytes <= 0 || result.receiveBufferBytes <= 0 ||
+                (result.requestedBufferBytes != 0 && result.requestedBufferBytes < options.minBufferBytes)) {
+                std::cout << "   ✗ Buffer sizes not reported" << std::endl;
+                return 1;
+            }
+#if defined(__linux__)
+            if (!result.notSentLowat || !result.corkSupported) {
+                std::cout << "   ✗ notsent-lowat or cork missing on Linux" << std::endl;
+                return 1;
+            }
+            // A buffer taken off autotuning must hold at least what autotuning would reach
+            long long sendAutotune = autotuneLimit("/proc/sys/net/ipv4/tcp_wmem");
+            long long receiveAutotune = autotuneLimit("/proc/sys/net/ipv4/tcp_rmem");
+            if ((!result.sendAutotuned && result.sendBufferBytes < sendAutotune) ||
+                (!result.receiveAutotuned && result.receiveBufferBytes < receiveAutotune)) {
+                std::cout << "   ✗ Explicit buffer below the autotune limit" << std::endl;
+                return 1;
+            }
+            if (result.shortfall() != (result.summary().find("raise net.core.") != std::string::npos)) {
+                std::cout << "   ✗ Shortfall not reported" << std::endl;
+                return 1;
+            }
+#endif
+
+            // Test 4 (per profile): a corked frame arrives once the socket is uncorked
+            if (result.corkSupported) {
+                std::vector<uint8_t> frame(100, 0x42), received(100);
+                if (SocketTuning::setCork(client, true)) {
+                    std::cout << "   ✗ Cork failed" << std::endl;
+                    return 1;
+                }
+                boost::asio::write(client, boost::asio::buffer(frame));
+                SocketTuning::setCork(client, false);
+                boost::asio::read(peer, boost::asio::buffer(received));
+                if (received != frame) {
+                    std::cout << "   ✗ Corked frame was not delivered intact" << std::endl;
+                    return 1;
+                }
+            }
+        }
+        std::cout << "   ✓ Test passed!" << std::endl;
+
+        std::cout << "\n=== ALL TESTS PASSED! ===" << std::endl;
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "ERROR: " << e.what() << std::endl;
+        return 1;
+    }
+}
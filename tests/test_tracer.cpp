@@ -0,0 +1,149 @@
+// Test the scoped-span tracer: nothing recorded while disabled, nested spans and their
+// arguments, ring wrap-around keeping the newest spans, one track per thread, and the
+// Chrome trace JSON layout.
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <chrono>
+#include <cstdio>
+#include <exception>
+
+#include "../include/client/Tracer.h"
+
+namespace {
+
+std::string readFile(const std::string& filename) {
+    std::ifstream in(filename);
+    std::stringstream text;
+    text << in.rdbuf();
+    return text.str();
+}
+
+size_t countOf(const std::string& text, const std::string& pattern) {
+    size_t count = 0;
+    for (size_t at = text.find(pattern); at != std::string::npos; at = text.find(pattern, at + 1)) {
+        count++;
+    }
+    return count;
+}
+
+} // namespace
+
+int main() {
+    try {
+        std::cout << "=== Tracer Test ===" << std::endl;
+        std::string error;
+        const std::string tracePath = "test_tracer.json";
+
+        // Test 1: spans are free and unrecorded until tracing is enabled
+        std::cout << "1. Testing disabled tracer..." << std::endl;
+        for (int i = 0; i < 1000; i++) {
+            TraceSpan span("ignored", i);
+        }
+        if (Tracer::enabled() || Tracer::eventCount() != 0) {
+            std::cout << "   ✗ Spans recorded while disabled" << std::endl;
+            return 1;
+        }
+        std::cout << "   ✓ Test passed!" << std::endl;
+
+        // Test 2: nested spans nest in time and keep their arguments
+        std::cout << "2. Testing nested spans..." << std::endl;
+        Tracer::enable(64);
+        Tracer::nameThread("main \"thread\"");
+        {
+            TraceSpan outer("transfer", 1);
+            {
+                TraceSpan inner("encrypt");
+                inner.setArg(42);
+                std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            }
+            TraceSpan early("crc wait");
+            early.end();
+            early.end();   // Closing twice records once
+        }
+        if (Tracer::eventCount() != 3 || !Tracer::writeChromeTrace(tracePath, error)) {
+            std::cout << "   ✗ Expected 3 spans, got " << Tracer::eventCount() << " " << error << std::endl;
+            return 1;
+        }
+        std::string trace = readFile(tracePath);
+        size_t encrypt = trace.find("\"name\":\"encrypt\"");
+        size_t transfer = trace.find("\"name\":\"transfer\"");
+        if (encrypt == std::string::npos || transfer == std::string::npos || encrypt > transfer ||
+            trace.find("\"arg\":42", encrypt) == std::string::npos ||
+            trace.find("main \\\"thread\\\"") == std::string::npos || countOf(trace, "\"ph\":\"X\"") != 3 ||
+            trace.compare(0, 15, "{\"displayTimeUn") != 0 || trace.find("\n]}") == std::string::npos) {
+            std::cout << "   ✗ Trace JSON wrong:\n" << trace << std::endl;
+            return 1;
+        }
+        std::cout << "   ✓ Test passed!" << std::endl;
+
+        // Test 3: a full ring keeps the most recent spans
+        std::cout << "3. Testing ring wrap-around..." << std::endl;
+        Tracer::clear();
+        for (uint64_t i = 0; i < 200; i++) {
+            TraceSpan span("packet", i);
+        }
+        Tracer::writeChromeTrace(tracePath, error);
+        trace = readFile(tracePath);
+        if (Tracer::eventCount() != 64 || countOf(trace, "\"name\":\"packet\"") != 64 ||
+            trace.find("\"arg\":135}") != std::string::npos || trace.find("\"arg\":136}") == std::string::npos ||
+            trace.find("\"arg\":199}") == std::string::npos) {
+            std::cout << "   ✗ Ring kept " << Tracer::eventCount() << " spans" << std::endl;
+            return 1;
+        }
+        std::cout << "   ✓ Test passed!" << std::endl;
+
+        // Test 4: every thread gets its own track, and writing while they record is safe
+        std::cout << "4. Testing per-thread tracks..." << std::endl;
+        Tracer::enable(4096);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; t++) {
+            threads.emplace_back([]() {
+                Tracer::nameThread("worker");
+                for (int i = 0; i < 1000; i++) {
+                    TraceSpan span("send", i);
+                }
+            });
+        }
+        for (int i = 0; i < 5; i++) {
+            Tracer::writeChromeTrace(tracePath, error);
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        Tracer::writeChromeTrace(tracePath, error);
+        trace = readFile(tracePath);
+        if (Tracer::eventCount() != 4000 || countOf(trace, "\"args\":{\"name\":\"worker\"}") != 4 ||
+            countOf(trace, "\"name\":\"send\"") != 4000) {
+            std::cout << "   ✗ Got " << Tracer::eventCount() << " spans" << std::endl;
+            return 1;
+        }
+        std::cout << "   ✓ Test passed!" << std::endl;
+
+        // Test 5: a dump request is taken once; disabling stops recording
+        std::cout << "5. Testing dump requests and disable..." << std::endl;
+        Tracer::requestDump();
+        bool first = Tracer::takeDumpRequest();
+        bool second = Tracer::takeDumpRequest();
+        Tracer::disable();
+        {
+            TraceSpan span("after disable");
+        }
+        if (!first || second || Tracer::eventCount() != 4000 ||
+            Tracer::writeChromeTrace("missing_dir/trace.json", error)) {
+            std::cout << "   ✗ Dump request or disable wrong" << std::endl;
+            return 1;
+        }
+        std::cout << "   ✓ Test passed!" << std::endl;
+
+        std::remove(tracePath.c_str());
+        std::cout << "\n=== ALL TESTS PASSED! ===" << std::endl;
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "ERROR: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,146 @@
+// Test the client transports: the in-process memory pipe (ring wrap-around, back-pressure,
+// deadlines, eof after close) and the same request/response exchange over TCP, AF_UNIX and
+// memory, so protocol framing behaves identically on all three.
+#include <iostream>
+#include <vector>
+#include <string>
+#include <thread>
+#include <cstdio>
+#include <cstdint>
+#include <exception>
+
+#include "../include/client/Transport.h"
+
+namespace {
+
+// Echo 64 frames of varying size through client/server ends; returns false on any mismatch
+bool echoFrames(Transport& client, Transport& server) {
+    const std::chrono::milliseconds timeout(5000);
+    bool ok = true;
+    std::thread peer([&]() {
+        std::vector<uint8_t> frame;
+        for (int i = 0; i < 64 && ok; i++) {
+            uint32_t size = 0;
+            ok = !server.read(boost::asio::buffer(&size, sizeof(size)), timeout);
+            frame.resize(size);
+            ok = ok && !server.read(boost::asio::buffer(frame), timeout) &&
+                 !server.write({boost::asio::buffer(&size, sizeof(size)), boost::asio::buffer(frame)}, timeout);
+        }
+    });
+    std::vector<uint8_t> sent, received;
+    for (int i = 0; i < 64 && ok; i++) {
+        uint32_t size = static_cast<uint32_t>((i * 7919) % 300000 + 1);
+        sent.assign(size, static_cast<uint8_t>(i));
+        sent[size / 2] = 0xEE;
+        uint32_t echoed = 0;
+        if (client.write({boost::asio::buffer(&size, sizeof(size)), boost::asio::buffer(sent)}, timeout) ||
+            client.read(boost::asio::buffer(&echoed, sizeof(echoed)), timeout) || echoed != size) {
+            ok = false;
+            break;
+        }
+        received.resize(echoed);
+        if (client.read(boost::asio::buffer(received), timeout) || received != sent) {
+            ok = false;
+        }
+    }
+    peer.join();
+    return ok;
+}
+
+} // namespace
+
+int main() {
+    try {
+        std::cout << "=== Transport Test ===" << std::endl;
+
+        // Test 1: frames larger than the pipe's capacity pass through with the ring wrapping
+        std::cout << "1. Testing memory pipe echo..." << std::endl;
+        auto pipe = MemoryTransport::createPair(64 * 1024);
+        if (!echoFrames(*pipe.first, *pipe.second)) {
+            std::cout << "   ✗ Frames corrupted through the memory pipe" << std::endl;
+            return 1;
+        }
+        std::cout << "   ✓ Test passed!" << std::endl;
+
+        // Test 2: deadlines on an empty and on a full pipe
+        std::cout << "2. Testing memory pipe deadlines..." << std::endl;
+        uint8_t byte = 0;
+        boost::system::error_code ec = pipe.first->read(boost::asio::buffer(&byte, 1), std::chrono::milliseconds(20));
+        std::vector<uint8_t> tooBig(64 * 1024 + 1);
+        boost::system::error_code full = pipe.first->write({boost::asio::buffer(tooBig)}, std::chrono::milliseconds(20));
+        if (ec != boost::asio::error::timed_out || full != boost::asio::error::timed_out) {
+            std::cout << "   ✗ Expected timeouts, got " << ec.message() << " / " << full.message() << std::endl;
+            return 1;
+        }
+        std::cout << "   ✓ Test passed!" << std::endl;
+
+        // Test 3: after close the peer drains what is buffered, then reads eof; writes fail
+        std::cout << "3. Testing memory pipe close..." << std::endl;
+        auto closing = MemoryTransport::createPair(1024);
+        uint8_t data[4] = {1, 2, 3, 4}, out[4] = {};
+        closing.first->write({boost::asio::buffer(data)}, std::chrono::milliseconds(100));
+        closing.first->close();
+        boost::system::error_code drained = closing.second->read(boost::asio::buffer(out), std::chrono::milliseconds(100));
+        boost::system::error_code eof = closing.second->read(boost::asio::buffer(out, 1), std::chrono::milliseconds(100));
+        boost::system::error_code broken = closing.second->write({boost::asio::buffer(data)}, std::chrono::milliseconds(100));
+        if (drained || out[3] != 4 || eof != boost::asio::error::eof || !broken || closing.first->isOpen()) {
+            std::cout << "   ✗ Close semantics wrong" << std::endl;
+            return 1;
+        }
+        std::cout << "   ✓ Test passed!" << std::endl;
+
+        // Test 4: the same exchange over TCP loopback
+        std::cout << "4. Testing TCP transport..." << std::endl;
+        {
+            using boost::asio::ip::tcp;
+            boost::asio::io_context clientContext, serverContext;
+            tcp::acceptor acceptor(serverContext, tcp::endpoint(boost::asio::ip::address_v4::loopback(), 0));
+            std::unique_ptr<tcp::socket> clientSocket(new tcp::socket(clientContext));
+            std::unique_ptr<tcp::socket> serverSocket(new tcp::socket(serverContext));
+            clientSocket->connect(acceptor.local_endpoint());
+            acceptor.accept(*serverSocket);
+            TcpTransport client(clientContext, std::move(clientSocket));
+            TcpTransport server(serverContext, std::move(serverSocket));
+            if (!client.tcpSocket() || client.nativeHandle() < 0 || !echoFrames(client, server)) {
+                std::cout << "   ✗ TCP exchange failed" << std::endl;
+                return 1;
+            }
+            std::cout << "   " << client.describe() << std::endl;
+        }
+        std::cout << "   ✓ Test passed!" << std::endl;
+
+        // Test 5: and over an AF_UNIX socket
+        std::cout << "5. Testing Unix socket transport..." << std::endl;
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+        {
+            const char* path = "transport_test.sock";
+            std::remove(path);
+            boost::asio::io_context clientContext, serverContext;
+            boost::asio::local::stream_protocol::acceptor acceptor(serverContext,
+                                                                   boost::asio::local::stream_protocol::endpoint(path));
+            UnixTransport client(clientContext), server(serverContext);
+            if (client.connect(path, std::chrono::milliseconds(1000))) {
+                std::cout << "   ✗ Connect failed" << std::endl;
+                return 1;
+            }
+            acceptor.accept(server.socket());
+            bool ok = client.tcpSocket() == nullptr && echoFrames(client, server);
+            std::remove(path);
+            if (!ok) {
+                std::cout << "   ✗ Unix socket exchange failed" << std::endl;
+                return 1;
+            }
+            std::cout << "   " << client.describe() << std::endl;
+        }
+#else
+        std::cout << "   Unix sockets unavailable on this platform - skipped" << std::endl;
+#endif
+        std::cout << "   ✓ Test passed!" << std::endl;
+
+        std::cout << "\n=== ALL TESTS PASSED! ===" << std::endl;
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "ERROR: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,252 @@
+// Test the WAN emulator relay: script parsing, added latency, the bandwidth cap, stream
+// order under jitter, and both kinds of injected reset, with an echo server behind it.
+#include <iostream>
+#include <vector>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+
+#include "WanEmulator.h"
+#include "../include/client/Transport.h"
+
+namespace {
+
+// Echoes everything on every accepted connection until stopped
+class EchoServer {
+public:
+    EchoServer() : acceptor(context, {boost::asio::ip::address_v4::loopback(), 0}) {
+        thread = std::thread([this]() {
+            for (;;) {
+                auto socket = std::make_shared<boost::asio::ip::tcp::socket>(context);
+                boost::system::error_code ec;
+                acceptor.accept(*socket, ec);
+                if (ec || stopping) {
+                    return;
+                }
+                std::thread([socket]() {
+                    std::vector<uint8_t> buffer(64 * 1024);
+                    boost::system::error_code error;
+                    for (;;) {
+                        size_t size = socket->read_some(boost::asio::buffer(buffer), error);
+                        if (error || boost::asio::write(*socket, boost::asio::buffer(buffer.data(), size), error) != size) {
+                            return;
+                        }
+                    }
+                }).detach();
+            }
+        });
+    }
+    ~EchoServer() {
+        stopping = true;
+        boost::asio::io_context wakeContext;
+        boost::asio::ip::tcp::socket wake(wakeContext);
+        boost::system::error_code ignored;
+        wake.connect(acceptor.local_endpoint(), ignored);
+        thread.join();
+    }
+    unsigned short port() const { return acceptor.local_endpoint().port(); }
+
+private:
+    boost::asio::io_context context;
+    boost::asio::ip::tcp::acceptor acceptor;
+    std::thread thread;
+    std::atomic<bool> stopping{false};
+};
+
+struct Connection {
+    boost::asio::io_context context;
+    std::unique_ptr<TcpTransport> transport;
+
+    explicit Connection(unsigned short port) {
+        std::unique_ptr<boost::asio::ip::tcp::socket> socket(new boost::asio::ip::tcp::socket(context));
+        socket->connect({boost::asio::ip::address_v4::loopback(), port});
+        socket->set_option(boost::asio::ip::tcp::no_delay(true));
+        transport.reset(new TcpTransport(context, std::move(socket)));
+    }
+
+    // Send data and read the echo; returns the error of the first failing step
+    boost::system::error_code roundTrip(const std::vector<uint8_t>& data, std::vector<uint8_t>& echoed) {
+        const std::chrono::milliseconds timeout(10000);
+        boost::system::error_code ec = transport->write({boost::asio::buffer(data)}, timeout);
+        echoed.resize(data.size());
+        return ec ? ec : transport->read(boost::asio::buffer(echoed), timeout);
+    }
+};
+
+long long elapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+int main() {
+    try {
+        std::cout << "=== WAN Emulator Test ===" << std::endl;
+        EchoServer echo;
+        std::string error;
+
+        // Test 1: units, carried-over settings, the implicit first step, loop and errors
+        std::cout << "1. Testing script parsing..." << std::endl;
+        WanScript script;
+        bool ok = WanScript::parse("# flaky link\n"
+                                   "1s latency=50ms rate=50mbit\n"
+                                   "1.5s jitter=5 reset-after=4mb\n"
+                                   "2s reset\n"
+                                   "loop 3s\n", script, error);
+        WanScript rejected;
+        std::string expectedError;
+        ok = ok && script.steps.size() == 4 && script.loop.count() == 3000 &&
+             script.steps[0].conditions.latency.count() == 0 &&
+             script.steps[2].conditions.latency.count() == 50 && script.steps[2].conditions.jitter.count() == 5 &&
+             script.steps[2].conditions.bitsPerSecond == 50000000 &&
+             script.steps[2].conditions.resetAfterBytes == 4 * 1024 * 1024 &&
+             script.steps[3].resetConnections && script.steps[3].conditions.latency.count() == 50 &&
+             !WanScript::parse("0 rate=fast\n", rejected, expectedError) &&
+             !WanScript::parse("2s\n1s\n", rejected, expectedError);
+        if (!ok) {
+            std::cout << "   ✗ Script parsed wrongly " << error << std::endl;
+            return 1;
+        }
+        std::cout << "   ✓ Test passed!" << std::endl;
+
+        // Test 2: 40 ms each way makes an echo round trip take at least 80 ms
+        std::cout << "2. Testing latency..." << std::endl;
+        {
+            WanConditions conditions;
+            conditions.latency = std::chrono::milliseconds(40);
+            WanEmulator emulator("127.0.0.1", echo.port(), WanScript::constant(conditions));
+            if (!emulator.start(error)) {
+                std::cout << "   ✗ " << error << std::endl;
+                return 1;
+            }
+            Connection connection(emulator.port());
+            std::vector<uint8_t> data(100, 0x42), echoed;
+            auto start = std::chrono::steady_clock::now();
+            boost::system::error_code ec = connection.roundTrip(data, echoed);
+            long long ms = elapsedMs(start);
+            if (ec || echoed != data || ms < 80 || ms > 400) {
+                std::cout << "   ✗ Round trip " << ms << " ms (" << ec.message() << ")" << std::endl;
+                return 1;
+            }
+            std::cout << "   Round trip: " << ms << " ms" << std::endl;
+        }
+        std::cout << "   ✓ Test passed!" << std::endl;
+
+        // Test 3: at 16 Mbit/s per direction, 1 MB through and back takes about half a second
+        std::cout << "3. Testing bandwidth shaping..." << std::endl;
+        {
+            WanConditions conditions;
+            conditions.bitsPerSecond = 16 * 1024 * 1024;
+            WanEmulator emulator("127.0.0.1", echo.port(), WanScript::constant(conditions));
+            if (!emulator.start(error)) {
+                std::cout << "   ✗ " << error << std::endl;
+                return 1;
+            }
+            Connection connection(emulator.port());
+            std::vector<uint8_t> data(1024 * 1024), echoed;
+            for (size_t i = 0; i < data.size(); i++) {
+                data[i] = static_cast<uint8_t>(i * 31);
+            }
+            auto start = std::chrono::steady_clock::now();
+            boost::system::error_code ec = connection.roundTrip(data, echoed);
+            long long ms = elapsedMs(start);
+            WanEmulatorStats stats = emulator.stats();
+            if (ec || echoed != data || ms < 450 || stats.bytesUpstream != data.size() ||
+                stats.bytesDownstream != data.size()) {
+                std::cout << "   ✗ 1 MB echo took " << ms << " ms (" << ec.message() << ")" << std::endl;
+                return 1;
+            }
+            std::cout << "   1 MB echoed in " << ms << " ms" << std::endl;
+        }
+        std::cout << "   ✓ Test passed!" << std::endl;
+
+        // Test 4: jitter delays chunks by different amounts but never reorders the stream
+        std::cout << "4. Testing stream order under jitter..." << std::endl;
+        {
+            WanConditions conditions;
+            conditions.latency = std::chrono::milliseconds(10);
+            conditions.jitter = std::chrono::milliseconds(10);
+            WanEmulator emulator("127.0.0.1", echo.port(), WanScript::constant(conditions));
+            if (!emulator.start(error)) {
+                std::cout << "   ✗ " << error << std::endl;
+                return 1;
+            }
+            Connection connection(emulator.port());
+            std::vector<uint8_t> sent;
+            for (int i = 0; i < 200; i++) {
+                std::vector<uint8_t> message(37, static_cast<uint8_t>(i));
+                connection.transport->write({boost::asio::buffer(message)}, std::chrono::milliseconds(1000));
+                sent.insert(sent.end(), message.begin(), message.end());
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            std::vector<uint8_t> received(sent.size());
+            if (connection.transport->read(boost::asio::buffer(received), std::chrono::milliseconds(5000)) ||
+                received != sent) {
+                std::cout << "   ✗ Stream reordered or corrupted" << std::endl;
+                return 1;
+            }
+        }
+        std::cout << "   ✓ Test passed!" << std::endl;
+
+        // Test 5: reset-after cuts a connection mid-transfer; a new connection works
+        std::cout << "5. Testing reset after bytes..." << std::endl;
+        {
+            WanConditions conditions;
+            conditions.resetAfterBytes = 64 * 1024;
+            WanEmulator emulator("127.0.0.1", echo.port(), WanScript::constant(conditions));
+            if (!emulator.start(error)) {
+                std::cout << "   ✗ " << error << std::endl;
+                return 1;
+            }
+            std::vector<uint8_t> data(1024 * 1024, 0x5A), echoed;
+            Connection first(emulator.port());
+            boost::system::error_code ec = first.roundTrip(data, echoed);
+            Connection second(emulator.port());
+            std::vector<uint8_t> small(1000, 0x11);
+            if (!ec || second.roundTrip(small, echoed) || echoed != small || emulator.stats().resets != 1) {
+                std::cout << "   ✗ Expected one reset, got " << emulator.stats().resets << " (" << ec.message() << ")"
+                          << std::endl;
+                return 1;
+            }
+            std::cout << "   First connection: " << ec.message() << std::endl;
+        }
+        std::cout << "   ✓ Test passed!" << std::endl;
+
+        // Test 6: a reset step in the script drops the connections open at that time
+        std::cout << "6. Testing scripted reset..." << std::endl;
+        {
+            WanScript timed;
+            if (!WanScript::parse("0\n200ms reset\n", timed, error)) {
+                std::cout << "   ✗ " << error << std::endl;
+                return 1;
+            }
+            WanEmulator emulator("127.0.0.1", echo.port(), timed);
+            if (!emulator.start(error)) {
+                std::cout << "   ✗ " << error << std::endl;
+                return 1;
+            }
+            Connection connection(emulator.port());
+            std::vector<uint8_t> data(10, 1), echoed;
+            boost::system::error_code before = connection.roundTrip(data, echoed);
+            uint8_t byte = 0;
+            auto start = std::chrono::steady_clock::now();
+            boost::system::error_code after = connection.transport->read(boost::asio::buffer(&byte, 1),
+                                                                         std::chrono::milliseconds(2000));
+            long long ms = elapsedMs(start);
+            if (before || !after || after == boost::asio::error::timed_out || ms > 1000) {
+                std::cout << "   ✗ Connection not reset (" << after.message() << ")" << std::endl;
+                return 1;
+            }
+        }
+        std::cout << "   ✓ Test passed!" << std::endl;
+
+        std::cout << "\n=== ALL TESTS PASSED! ===" << std::endl;
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "ERROR: " << e.what() << std::endl;
+        return 1;
+    }
+}
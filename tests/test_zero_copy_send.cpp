@@ -0,0 +1,111 @@
+// Test MSG_ZEROCOPY sends: frames arrive intact even though the sender reuses pool buffers
+// as soon as the kernel completes them, every buffer returns to the pool, and the sender
+// switches itself off when the kernel reports it copied anyway (always the case on loopback).
+#include <iostream>
+#include <vector>
+#include <string>
+#include <thread>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+
+#include "../include/client/ZeroCopySend.h"
+
+int main() {
+    try {
+        std::cout << "=== ZeroCopySend Test ===" << std::endl;
+#ifndef __linux__
+        std::cout << "MSG_ZEROCOPY is Linux-only - skipped" << std::endl;
+        std::cout << "\n=== ALL TESTS PASSED! ===" << std::endl;
+        return 0;
+#else
+        using boost::asio::ip::tcp;
+        boost::asio::io_context ioContext;
+        tcp::acceptor acceptor(ioContext, tcp::endpoint(boost::asio::ip::address_v4::loopback(), 0));
+        tcp::socket sender(ioContext), receiver(ioContext);
+        sender.connect(acceptor.local_endpoint());
+        acceptor.accept(receiver);
+
+        // Test 1: enable
+        std::cout << "1. Testing SO_ZEROCOPY..." << std::endl;
+        ZeroCopySender zeroCopy;
+        std::string error;
+        if (!zeroCopy.enable(sender, error)) {
+            std::cout << "   Kernel without MSG_ZEROCOPY (" << error << ") - skipped" << std::endl;
+            std::cout << "\n=== ALL TESTS PASSED! ===" << std::endl;
+            return 0;
+        }
+        std::cout << "   ✓ Test passed!" << std::endl;
+
+        // Test 2: 64 frames of 1MB through a 4-buffer pool; each frame is stamped with its
+        // number, so a buffer reused before the kernel finished would corrupt the stream
+        std::cout << "2. Testing frame delivery and buffer reuse..." << std::endl;
+        const size_t frameSize = 1024 * 1024;
+        const int frameCount = 64;
+        BufferPool pool;
+        if (!pool.init(4, frameSize, false, error)) {
+            std::cout << "   ✗ " << error << std::endl;
+            return 1;
+        }
+        bool intact = true;
+        std::thread reader([&]() {
+            std::vector<uint8_t> frame(frameSize);
+            for (int i = 0; i < frameCount && intact; i++) {
+                boost::system::error_code ec;
+                boost::asio::read(receiver, boost::asio::buffer(frame), ec);
+                for (size_t offset = 0; offset < frameSize && !ec; offset += 4096) {
+                    if (frame[offset] != static_cast<uint8_t>(i)) {
+                        intact = false;
+                        break;
+                    }
+                }
+                intact = intact && !ec;
+            }
+        });
+        for (int i = 0; i < frameCount; i++) {
+            if (zeroCopy.pending() > 0 && pool.available() == 0) {
+                zeroCopy.reclaim(ioContext, sender, std::chrono::milliseconds(5000));
+            }
+            BufferPool::Lease frame = pool.acquire(frameSize);
+            std::memset(frame.data(), i, frameSize);
+            boost::system::error_code ec = zeroCopy.send(ioContext, sender, std::move(frame), frameSize,
+                                                         std::chrono::milliseconds(5000));
+            if (ec) {
+                std::cout << "   ✗ Send failed: " << ec.message() << std::endl;
+                return 1;
+            }
+        }
+        reader.join();
+        while (zeroCopy.pending() > 0) {
+            if (zeroCopy.reclaim(ioContext, sender, std::chrono::milliseconds(5000))) {
+                std::cout << "   ✗ Completions never arrived" << std::endl;
+                return 1;
+            }
+        }
+        std::cout << "   " << zeroCopy.zeroCopyBytes() / frameSize << " MB sent, " << zeroCopy.completedSends()
+                  << " completions, " << zeroCopy.copiedSends() << " copied" << std::endl;
+        if (!intact || pool.available() != 4 || pool.heapAllocations() != 0 ||
+            zeroCopy.zeroCopyBytes() != frameSize * frameCount) {
+            std::cout << "   ✗ Stream corrupted or buffers lost" << std::endl;
+            return 1;
+        }
+        std::cout << "   ✓ Test passed!" << std::endl;
+
+        // Test 3: copied completions turn zero-copy off for the connection
+        std::cout << "3. Testing copied-completion fallback..." << std::endl;
+        bool allCopied = zeroCopy.copiedSends() == zeroCopy.completedSends();
+        if (allCopied && zeroCopy.completedSends() >= ZeroCopySender::COPIED_PROBE && zeroCopy.isEnabled()) {
+            std::cout << "   ✗ Still enabled although the kernel copied every send" << std::endl;
+            return 1;
+        }
+        std::cout << "   " << (zeroCopy.isEnabled() ? "Zero-copy kept" : "Switched to copying sends") << std::endl;
+        std::cout << "   ✓ Test passed!" << std::endl;
+
+        std::cout << "\n=== ALL TESTS PASSED! ===" << std::endl;
+        return 0;
+#endif
+    } catch (const std::exception& e) {
+        std::cerr << "ERROR: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,77 @@
+/**
+ * WAN emulator: relays TCP connections to a backup server under scripted latency, jitter,
+ * bandwidth and resets (see WanEmulator.h for the script format).
+ *
+ * Usage: wan_emulator <listen-port> <host:port> [--script file | setting...]
+ *   wan_emulator 1257 127.0.0.1:1256 latency=50ms jitter=5ms rate=50mbit
+ *   wan_emulator 1257 127.0.0.1:1256 --script flaky_link.txt
+ * then point transfer.info at 127.0.0.1:1257. Settings given on the command line form a
+ * single step that holds for the whole run. Build: scripts/build_wan_emulator.bat, or on Linux
+ *   g++ -O2 -std=c++17 tests/wan_emulator.cpp tests/WanEmulator.cpp -lpthread
+ */
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <thread>
+#include <exception>
+
+#include "WanEmulator.h"
+
+int main(int argc, char* argv[]) {
+    try {
+        if (argc < 3) {
+            std::cerr << "Usage: " << argv[0] << " <listen-port> <host:port> [--script file | setting...]" << std::endl;
+            std::cerr << "Settings: latency=50ms jitter=5ms rate=50mbit reset-after=4mb" << std::endl;
+            return 1;
+        }
+        unsigned short listenPort = static_cast<unsigned short>(std::stoi(argv[1]));
+        std::string target = argv[2];
+        size_t colon = target.rfind(':');
+        if (colon == std::string::npos) {
+            std::cerr << "ERROR: target must be host:port" << std::endl;
+            return 1;
+        }
+        std::string host = target.substr(0, colon);
+        unsigned short targetPort = static_cast<unsigned short>(std::stoi(target.substr(colon + 1)));
+
+        WanScript script;
+        std::string error;
+        bool parsed = true;
+        if (argc == 5 && std::string(argv[3]) == "--script") {
+            parsed = WanScript::load(argv[4], script, error);
+        } else {
+            std::string step = "0";
+            for (int i = 3; i < argc; i++) {
+                step += std::string(" ") + argv[i];
+            }
+            parsed = WanScript::parse(step, script, error);
+        }
+        if (!parsed) {
+            std::cerr << "ERROR: " << error << std::endl;
+            return 1;
+        }
+
+        WanEmulator emulator(host, targetPort, script);
+        if (!emulator.start(error, listenPort)) {
+            std::cerr << "ERROR: " << error << std::endl;
+            return 1;
+        }
+        std::cout << "Relaying 127.0.0.1:" << emulator.port() << " -> " << target << " (" << script.steps.size()
+                  << " script step(s)" << (script.loop.count() > 0 ? ", looping" : "") << ")" << std::endl;
+
+        // Runs until interrupted
+        WanEmulatorStats last;
+        for (;;) {
+            std::this_thread::sleep_for(std::chrono::seconds(5));
+            WanEmulatorStats now = emulator.stats();
+            std::cout << "connections " << now.connections
+                      << " | up " << (now.bytesUpstream - last.bytesUpstream) / 5 / 1024 << " KB/s"
+                      << " | down " << (now.bytesDownstream - last.bytesDownstream) / 5 / 1024 << " KB/s"
+                      << " | resets " << now.resets << " | connect failures " << now.connectFailures << std::endl;
+            last = now;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "ERROR: " << e.what() << std::endl;
+        return 1;
+    }
+}